@@ -93,6 +93,7 @@ int main(int argc, char* argv[]) {
 	CCLEvent* evt_comm;
 	CCLEvent* evt_exec;
 	/* Other variables. */
+	CCLEventWaitListStorage ewl_storage;
 	CCLEventWaitList ewl = NULL;
 	/* Profiler object. */
 	CCLProf* prof;
@@ -220,6 +221,10 @@ int main(int argc, char* argv[]) {
 		origin, region, 0, 0, input_image, NULL, &err);
 	HANDLE_ERROR(err);
 
+	/* Use a reusable event wait list, so that no allocations are
+	 * performed when waiting for events in each iteration. */
+	ewl = ccl_event_wait_list_init(&ewl_storage);
+
 	/* Run CA_ITERS iterations of the CA. */
 	for (cl_uint i = 0; i < CA_ITERS; ++i) {
 
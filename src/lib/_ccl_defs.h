@@ -84,6 +84,43 @@
  * by CCL_STRD. */
 #define G_ERR_DEBUG_STR CCL_STRD
 
+/* Begin tracing a host call, returning its start instant, or zero if
+ * host tracing is disabled. Defined in the profiler module. */
+guint64 ccl_prof_host_trace_begin(void);
+
+/* Record a host call which started at the given instant. Defined in
+ * the profiler module. */
+void ccl_prof_host_trace_end(
+	const char* func, guint64 t_start, gconstpointer obj);
+
+/**
+ * @internal
+ * Start tracing the current host call, if host tracing is enabled.
+ * Must be placed at the start of the traced function, and must be
+ * matched by a ::CCL_HOST_TRACE_END() before the function returns.
+ *
+ * @def CCL_HOST_TRACE_BEGIN()
+ * */
+/**
+ * @internal
+ * Finish tracing the current host call, recording it in the host trace
+ * buffer of the current thread.
+ *
+ * @param[in] obj Event wrapper produced by the traced call, used for
+ * aligning host and device time, or `NULL`.
+ *
+ * @def CCL_HOST_TRACE_END(obj)
+ * */
+#ifdef CCL_HOST_TRACING
+	#define CCL_HOST_TRACE_BEGIN() \
+		guint64 ccl_host_trace_t_start = ccl_prof_host_trace_begin()
+	#define CCL_HOST_TRACE_END(obj) \
+		ccl_prof_host_trace_end(G_STRFUNC, ccl_host_trace_t_start, (obj))
+#else
+	#define CCL_HOST_TRACE_BEGIN() do {} while (0)
+	#define CCL_HOST_TRACE_END(obj) do {} while (0)
+#endif
+
 /* Include error handling macros. */
 #include "_g_err_macros.h"
 
@@ -31,6 +31,24 @@
 #define __CCL_KERNEL_WRAPPER_H_
 
 #include "ccl_oclversions.h"
+#include "ccl_kernel_wrapper.h"
+
+/* Set kernel arguments from a NULL-terminated variable argument
+ * list. */
+void ccl_kernel_set_args_va(CCLKernel* krnl, va_list args_va);
+
+/* Set one kernel argument from its size and value, indicating if the
+ * value is the handle of a memory object or sampler. */
+void ccl_kernel_set_arg_value_full(CCLKernel* krnl, cl_uint arg_index,
+	size_t arg_size, const void* arg_value, cl_bool is_handle);
+
+/* Set the pending arguments of the given kernel in the OpenCL kernel
+ * object. */
+cl_int ccl_kernel_apply_args(CCLKernel* krnl, cl_uint* arg_index);
+
+/* Is the given kernel argument a wrapper object (e.g. a memory object
+ * or a sampler), instead of a local or private argument? */
+cl_bool ccl_arg_is_wrapper(CCLArg* arg);
 
 #ifdef CL_VERSION_1_2
 
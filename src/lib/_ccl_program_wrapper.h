@@ -0,0 +1,44 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * This header provides the prototypes of the functions which
+ * synchronize kernel creation with asynchronous program builds. This
+ * header is not part of the _cf4ocl_ public API.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef __CCL_PROGRAM_WRAPPER_H_
+#define __CCL_PROGRAM_WRAPPER_H_
+
+#include "ccl_program_wrapper.h"
+
+/* Wait for asynchronous builds of the given program which are in
+ * progress, and keep new ones from starting, such that kernels can be
+ * created. */
+void ccl_program_kernels_lock(CCLProgram* prg);
+
+/* Allow asynchronous builds of the given program to start again. */
+void ccl_program_kernels_unlock(CCLProgram* prg);
+
+#endif /* __CCL_PROGRAM_WRAPPER_H_ */
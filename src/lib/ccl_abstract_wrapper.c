@@ -35,10 +35,62 @@
 /* Generic function pointer for OpenCL clget**Info() functions. */
 typedef cl_int (*ccl_wrapper_info_fp)(void);
 
-/* Table of all existing wrappers. */
-static GHashTable* wrappers = NULL;
-/* Define lock for synchronizing access to table of all existing wrappers. */
-G_LOCK_DEFINE(wrappers);
+/* Number of shards in the registry of existing wrappers (must be a
+ * power of two). */
+#define CCL_WRAPPER_NUM_SHARDS 64
+
+/* Number of bits required to index a shard. */
+#define CCL_WRAPPER_SHARD_BITS 6
+
+/**
+ * @internal
+ * Shard of the registry of existing wrappers. Each shard keeps the
+ * wrappers whose OpenCL object address hashes to it, and has its own
+ * lock, so that threads wrapping and releasing unrelated OpenCL
+ * objects (e.g. events produced by different queues) do not contend
+ * for a single process-wide lock.
+ * */
+struct ccl_wrapper_shard {
+
+	/**
+	 * Table of existing wrappers in this shard, created on demand and
+	 * released when empty.
+	 * @private
+	 * */
+	GHashTable* table;
+
+	/**
+	 * Mutex for synchronizing access to this shard. Statically
+	 * allocated mutexes don't need to be initialized.
+	 * @private
+	 * */
+	GMutex mutex;
+
+};
+
+/* Registry of all existing wrappers, split into shards. */
+static struct ccl_wrapper_shard wrappers[CCL_WRAPPER_NUM_SHARDS];
+
+/* Compile-time check of the shard count. */
+G_STATIC_ASSERT((1 << CCL_WRAPPER_SHARD_BITS) == CCL_WRAPPER_NUM_SHARDS);
+
+/**
+ * @internal
+ * Determine the registry shard for a given OpenCL object. OpenCL
+ * objects are heap allocated, so the lower bits of their addresses
+ * carry little entropy; Fibonacci hashing spreads the upper bits
+ * evenly among shards.
+ *
+ * @param[in] cl_object OpenCL object.
+ * @return The registry shard for the given OpenCL object.
+ * */
+static inline struct ccl_wrapper_shard* ccl_wrapper_get_shard(
+	void* cl_object) {
+
+	guint64 h = (guint64) GPOINTER_TO_SIZE(cl_object);
+	h *= G_GUINT64_CONSTANT(0x9E3779B97F4A7C15);
+	return &wrappers[h >> (64 - CCL_WRAPPER_SHARD_BITS)];
+}
 
 /* Wrapper names ordered by their enum type. */
 static const char* ccl_class_names[] = {"Buffer", "Context", "Device", "Event",
@@ -77,16 +129,72 @@ static const ccl_wrapper_info_fp info_funs[] = {
 #endif
 };
 
+/* Initial number of entries in the information cache of a wrapper. */
+#define CCL_WRAPPER_INFO_INIT_CAP 8
+
+/**
+ * @internal
+ * Entry in the information cache of a wrapper.
+ * */
+struct ccl_wrapper_info_entry {
+
+	/**
+	 * Name of parameter which the information refers to.
+	 * @private
+	 * */
+	cl_uint param_name;
+
+	/**
+	 * Information object, replaced atomically.
+	 * @private
+	 * */
+	CCLWrapperInfo* info;
+
+};
+
+/**
+ * @internal
+ * Dense array of information cache entries. Entries are only appended,
+ * and the number of entries is published atomically after the new
+ * entry is written, so readers can scan the array without locking.
+ * When the array is full, a larger copy replaces it, and the old array
+ * is kept until the wrapper is destroyed, since readers may still be
+ * scanning it.
+ * */
+struct ccl_wrapper_info_array {
+
+	/**
+	 * Number of published entries, updated atomically.
+	 * @private
+	 * */
+	gint len;
+
+	/**
+	 * Maximum number of entries.
+	 * @private
+	 * */
+	gint cap;
+
+	/**
+	 * Cache entries.
+	 * @private
+	 * */
+	struct ccl_wrapper_info_entry entries[];
+
+};
+
 /**
  * Information about wrapped OpenCL objects.
  * */
 struct ccl_wrapper_info_table {
 
 	/**
-	 * Table containing information about the wrapped OpenCL object.
+	 * Current array of cached information about the wrapped OpenCL
+	 * object, published atomically. `NULL` if no information was
+	 * cached yet.
 	 * @private
 	 * */
-	GHashTable* table;
+	struct ccl_wrapper_info_array* array;
 
 	/**
 	 * List of replaced information about the wrapped OpenCL object.
@@ -95,14 +203,152 @@ struct ccl_wrapper_info_table {
 	GSList* old_info;
 
 	/**
-	 * Mutex for controlling thread access to the OpenCL object
-	 * information table.
+	 * List of replaced information arrays.
+	 * @private
+	 * */
+	GSList* old_arrays;
+
+	/**
+	 * Mutex for serializing updates to the information cache. Lookups
+	 * do not lock.
 	 * @private
 	 * */
 	GMutex mutex;
 
 };
 
+/**
+ * @internal
+ * Look up cached information about the wrapped OpenCL object, without
+ * locking.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper The wrapper object.
+ * @param[in] param_name Name of parameter which the information refers
+ * to.
+ * @return The cached information, or `NULL` if not cached.
+ * */
+static CCLWrapperInfo* ccl_wrapper_info_lookup(
+	CCLWrapper* wrapper, cl_uint param_name) {
+
+	/* Current cache array. */
+	struct ccl_wrapper_info_array* array =
+		g_atomic_pointer_get(&wrapper->info->array);
+	/* Number of published entries. */
+	gint len;
+
+	if (array == NULL) return NULL;
+
+	len = g_atomic_int_get(&array->len);
+	for (gint i = 0; i < len; ++i) {
+		if (array->entries[i].param_name == param_name)
+			return g_atomic_pointer_get(&array->entries[i].info);
+	}
+
+	return NULL;
+
+}
+
+/**
+ * @internal
+ * Can information successfully obtained for the given parameter be
+ * reused in subsequent queries, even if the cache is not explicitly
+ * requested? This is the case for event profiling information, which is
+ * only available after the command completes, and for a fixed set of
+ * platform and device parameters which describe properties that never
+ * change during the lifetime of the objects. Other parameters are only
+ * cached if requested.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] param_name Name of parameter.
+ * @param[in] info_type Type of information query.
+ * @return TRUE if information is immutable, FALSE otherwise.
+ * */
+static gboolean ccl_wrapper_info_is_immutable(
+	cl_uint param_name, CCLInfo info_type) {
+
+	switch (info_type) {
+		case CCL_INFO_EVENT_PROFILING:
+			return TRUE;
+		case CCL_INFO_PLATFORM:
+			switch (param_name) {
+				case CL_PLATFORM_PROFILE:
+				case CL_PLATFORM_VERSION:
+				case CL_PLATFORM_NAME:
+				case CL_PLATFORM_VENDOR:
+				case CL_PLATFORM_EXTENSIONS:
+					return TRUE;
+				default:
+					return FALSE;
+			}
+		case CCL_INFO_DEVICE:
+			switch (param_name) {
+				case CL_DEVICE_TYPE:
+				case CL_DEVICE_VENDOR_ID:
+				case CL_DEVICE_MAX_COMPUTE_UNITS:
+				case CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS:
+				case CL_DEVICE_MAX_WORK_ITEM_SIZES:
+				case CL_DEVICE_MAX_WORK_GROUP_SIZE:
+				case CL_DEVICE_ADDRESS_BITS:
+				case CL_DEVICE_MAX_MEM_ALLOC_SIZE:
+				case CL_DEVICE_MEM_BASE_ADDR_ALIGN:
+				case CL_DEVICE_GLOBAL_MEM_SIZE:
+				case CL_DEVICE_LOCAL_MEM_SIZE:
+				case CL_DEVICE_ENDIAN_LITTLE:
+				case CL_DEVICE_NAME:
+				case CL_DEVICE_VENDOR:
+				case CL_DRIVER_VERSION:
+				case CL_DEVICE_PROFILE:
+				case CL_DEVICE_VERSION:
+				case CL_DEVICE_OPENCL_C_VERSION:
+				case CL_DEVICE_EXTENSIONS:
+				case CL_DEVICE_PLATFORM:
+					return TRUE;
+				default:
+					return FALSE;
+			}
+		default:
+			return FALSE;
+	}
+
+}
+
+/**
+ * @internal
+ * Increase the reference count of the wrapper object, but only if it
+ * is not zero, i.e. if the wrapper is not being destroyed.
+ *
+ * @private @memberof ccl_wrapper
+ *
+ * @param[in] wrapper The wrapper object.
+ * @return `TRUE` if the reference count was increased, `FALSE`
+ * otherwise.
+ * */
+static gboolean ccl_wrapper_ref_if_alive(CCLWrapper* wrapper) {
+
+	/* Current reference count. */
+	gint ref_count;
+
+	/* Atomically increment reference count if it's not zero. */
+	do {
+		ref_count = g_atomic_int_get(&wrapper->ref_count);
+		if (ref_count == 0) return FALSE;
+	} while (!g_atomic_int_compare_and_exchange(
+		&wrapper->ref_count, ref_count, ref_count + 1));
+
+#ifdef CCL_DEBUG_OBJ_LIFETIME
+
+	/* Log referencing of wrapper. */
+	g_debug("New/ref. CCL%s(%p)",
+		ccl_wrapper_get_class_name(wrapper), (void*) wrapper->cl_object);
+
+#endif
+
+	return TRUE;
+}
+
 /* ********************************* */
 /* ****** Protected methods ******** */
 /* ********************************* */
@@ -127,18 +373,28 @@ CCLWrapper* ccl_wrapper_new(CCLClass class, void* cl_object, size_t size) {
 	/* The new wrapper object. */
 	CCLWrapper* w;
 
-	/* Lock access to table of all existing wrappers. */
-	G_LOCK(wrappers);
+	/* Registry shard where wrapper is or will be kept. */
+	struct ccl_wrapper_shard* shard = ccl_wrapper_get_shard(cl_object);
+
+	/* Lock access to registry shard. */
+	g_mutex_lock(&shard->mutex);
 
-	/* If table of all existing wrappers is not yet initialized,
-	 * initialize it. */
-	if (wrappers == NULL) {
-		wrappers = g_hash_table_new_full(
+	/* If shard table is not yet initialized, initialize it. */
+	if (shard->table == NULL) {
+		shard->table = g_hash_table_new_full(
 			g_direct_hash, g_direct_equal, NULL, NULL);
 	}
 
 	/* Check if requested wrapper already exists, and get it if so. */
-	w = g_hash_table_lookup(wrappers, cl_object);
+	w = g_hash_table_lookup(shard->table, cl_object);
+
+	/* If wrapper exists, increase its reference count, unless it
+	 * already reached zero. In that case the wrapper is being destroyed
+	 * by another thread and must not be resurrected. This happens when
+	 * the OpenCL implementation reuses the address of a just released
+	 * object (e.g. an event). */
+	if ((w != NULL) && (!ccl_wrapper_ref_if_alive(w)))
+		w = NULL;
 
 	if (w == NULL) {
 
@@ -151,17 +407,17 @@ CCLWrapper* ccl_wrapper_new(CCLClass class, void* cl_object, size_t size) {
 		w->info = g_slice_new0(struct ccl_wrapper_info_table);
 		g_mutex_init(&w->info->mutex);
 
-		/* Insert newly created wrapper in table of all existing
-		 * wrappers. */
-		g_hash_table_insert(wrappers, cl_object, w);
+		/* Insert newly created wrapper in registry shard, replacing a
+		 * wrapper which might be in the process of being destroyed. */
+		g_hash_table_replace(shard->table, cl_object, w);
 
-	}
+		/* Increase reference count of new wrapper. */
+		ccl_wrapper_ref(w);
 
-	/* Increase reference count of wrapper. */
-	ccl_wrapper_ref(w);
+	}
 
-	/* Unlock access to table of all existing wrappers. */
-	G_UNLOCK(wrappers);
+	/* Unlock access to registry shard. */
+	g_mutex_unlock(&shard->mutex);
 
 	/* Return requested wrapper. */
 	return w;
@@ -213,9 +469,29 @@ cl_bool ccl_wrapper_unref(CCLWrapper* wrapper, size_t size,
 	/* Decrement reference count and check if it reaches 0. */
 	if (g_atomic_int_dec_and_test(&wrapper->ref_count)) {
 
+		/* Registry shard where wrapper is kept. */
+		struct ccl_wrapper_shard* shard =
+			ccl_wrapper_get_shard(wrapper->cl_object);
+
 		/* Ref. count reached 0, so wrapper will be destroyed. */
 		destroyed = CL_TRUE;
 
+		/* Remove wrapper from registry shard before releasing the
+		 * OpenCL object, whose address may be immediately reused by the
+		 * OpenCL implementation. Only remove it if it wasn't already
+		 * replaced by a new wrapper for a reused address. Release shard
+		 * table if empty. */
+		g_mutex_lock(&shard->mutex);
+		if ((shard->table != NULL) && (g_hash_table_lookup(
+				shard->table, wrapper->cl_object) == wrapper)) {
+			g_hash_table_remove(shard->table, wrapper->cl_object);
+			if (g_hash_table_size(shard->table) == 0) {
+				g_hash_table_destroy(shard->table);
+				shard->table = NULL;
+			}
+		}
+		g_mutex_unlock(&shard->mutex);
+
 		/* Release the OpenCL wrapped object. */
 		if (rel_cl_fun != NULL) {
 			ocl_status = rel_cl_fun(wrapper->cl_object);
@@ -227,27 +503,23 @@ cl_bool ccl_wrapper_unref(CCLWrapper* wrapper, size_t size,
 			}
 		}
 
-		/* Destroy table containing wrapped object information. */
-		if (wrapper->info->table != NULL) {
-			g_hash_table_destroy(wrapper->info->table);
+		/* Destroy cache containing wrapped object information. */
+		if (wrapper->info->array != NULL) {
+			for (gint i = 0; i < wrapper->info->array->len; ++i)
+				ccl_wrapper_info_destroy(
+					wrapper->info->array->entries[i].info);
+			g_free(wrapper->info->array);
 		}
 		if (wrapper->info->old_info != NULL) {
 			g_slist_free_full(wrapper->info->old_info,
 				(GDestroyNotify) ccl_wrapper_info_destroy);
 		}
+		if (wrapper->info->old_arrays != NULL) {
+			g_slist_free_full(wrapper->info->old_arrays, g_free);
+		}
 		g_mutex_clear(&wrapper->info->mutex);
 		g_slice_free(struct ccl_wrapper_info_table, wrapper->info);
 
-		/* Remove wrapper from static table, release static table if
-		 * empty. */
-		G_LOCK(wrappers);
-		g_hash_table_remove(wrappers, wrapper->cl_object);
-		if (g_hash_table_size(wrappers) == 0) {
-			g_hash_table_destroy(wrappers);
-			wrappers = NULL;
-		}
-		G_UNLOCK(wrappers);
-
 		/* Destroy remaining wrapper fields. */
 		if (rel_fields_fun != NULL)
 			rel_fields_fun(wrapper);
@@ -282,43 +554,61 @@ void ccl_wrapper_add_info(CCLWrapper* wrapper, cl_uint param_name,
 	/* Make sure info is not NULL. */
 	g_return_if_fail(info != NULL);
 
-	/* Lock access to info table. */
+	/* Current cache array. */
+	struct ccl_wrapper_info_array* array;
+	/* Number of entries in current cache array. */
+	gint len;
+
+	/* Lock access to info table. Only updates are serialized, lookups
+	 * proceed concurrently. */
 	g_mutex_lock(&wrapper->info->mutex);
 
-	/* If information table is not yet initialized, then
-	 * initialize it. */
-	if (wrapper->info->table == NULL) {
-		wrapper->info->table = g_hash_table_new_full(
-			g_direct_hash, g_direct_equal,
-			NULL, (GDestroyNotify) ccl_wrapper_info_destroy);
+	array = wrapper->info->array;
+	len = array != NULL ? array->len : 0;
+
+	/* Check if information with same key is already present in
+	 * cache... */
+	for (gint i = 0; i < len; ++i) {
+		if (array->entries[i].param_name == param_name) {
+
+			/* ...if so, replace it, and move the existing information
+			 * to the list of old information, since clients may still
+			 * hold it. */
+			wrapper->info->old_info = g_slist_prepend(
+				wrapper->info->old_info, array->entries[i].info);
+			g_atomic_pointer_set(&array->entries[i].info, info);
+			goto unlock;
+		}
 	}
 
-	/* Check if information with same key as already present in
-	 * table... */
-	if (g_hash_table_contains(
-			wrapper->info->table, GUINT_TO_POINTER(param_name))) {
-
-		/* ...if so, move this information to the old information
-		 * table. */
-
-		/* Get existing information... */
-		CCLWrapperInfo* info_old =
-			(CCLWrapperInfo*) g_hash_table_lookup(
-				wrapper->info->table, GUINT_TO_POINTER(param_name));
-
-		/* ...and put it in table of old information. */
-		wrapper->info->old_info =
-			g_slist_prepend(wrapper->info->old_info, info_old);
-
-		/* Remove old info from info table without destroying it. */
-		g_hash_table_steal(
-			wrapper->info->table, GUINT_TO_POINTER(param_name));
-
+	/* If cache array is not yet initialized or is full, replace it
+	 * with a larger copy. The old array is kept, since it may still be
+	 * read by concurrent lookups. */
+	if ((array == NULL) || (len == array->cap)) {
+
+		struct ccl_wrapper_info_array* new_array;
+		gint cap = array != NULL ? 2 * array->cap : CCL_WRAPPER_INFO_INIT_CAP;
+
+		new_array = g_malloc(sizeof(struct ccl_wrapper_info_array)
+			+ cap * sizeof(struct ccl_wrapper_info_entry));
+		new_array->len = len;
+		new_array->cap = cap;
+		if (array != NULL) {
+			memcpy(new_array->entries, array->entries,
+				len * sizeof(struct ccl_wrapper_info_entry));
+			wrapper->info->old_arrays =
+				g_slist_prepend(wrapper->info->old_arrays, array);
+		}
+		g_atomic_pointer_set(&wrapper->info->array, new_array);
+		array = new_array;
 	}
 
-	/* Keep new information in information table. */
-	g_hash_table_insert(wrapper->info->table,
-		GUINT_TO_POINTER(param_name), info);
+	/* Write new entry, and only then publish it. */
+	array->entries[len].param_name = param_name;
+	array->entries[len].info = info;
+	g_atomic_int_set(&array->len, len + 1);
+
+unlock:
 
 	/* Unlock access to info table. */
 	g_mutex_unlock(&wrapper->info->mutex);
@@ -451,7 +741,8 @@ void* ccl_wrapper_unwrap(CCLWrapper* wrapper) {
  * case of error.
  * @param[in] info_type Type of information query to perform.
  * @param[in] use_cache TRUE if cached information is to be used, FALSE
- * to force a new query even if information is in cache.
+ * to force a new query even if information is in cache (unless the
+ * information never changes, e.g. the name of a device).
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
  * @return The requested information object. This object will
@@ -476,24 +767,17 @@ CCLWrapperInfo* ccl_wrapper_get_info(CCLWrapper* wrapper1,
 	/* Information object. */
 	CCLWrapperInfo* info = NULL;
 
-	/* Does info table cache contain requested information? */
-	gboolean contains;
-
 	/* Information function to use. */
 	ccl_wrapper_info_fp info_fun = info_funs[info_type];
 
-	/* Check if info table cache contains requested information. */
-	g_mutex_lock(&wrapper1->info->mutex);
-	contains = wrapper1->info->table != NULL
-		? g_hash_table_contains(
-			wrapper1->info->table, GUINT_TO_POINTER(param_name))
-		: FALSE;
-	g_mutex_unlock(&wrapper1->info->mutex);
+	/* Check if info cache contains requested information, if the cache
+	 * is to be used or if the information never changes. */
+	if (use_cache || ccl_wrapper_info_is_immutable(param_name, info_type))
+		info = ccl_wrapper_info_lookup(wrapper1, param_name);
 
 	/* Check if it is required to query OpenCL object, i.e. if info
-	 * table cache is not to be used or info table cache does not
-	 * contain requested info.  */
-	if ((!use_cache) || (!contains)) {
+	 * cache does not contain requested info or is not to be used. */
+	if (info == NULL) {
 
 		/* Let's query OpenCL object.*/
 		cl_int ocl_status;
@@ -541,15 +825,6 @@ CCLWrapperInfo* ccl_wrapper_get_info(CCLWrapper* wrapper1,
 		/* Keep information in information table. */
 		ccl_wrapper_add_info(wrapper1, param_name, info);
 
-	} else {
-
-		/* Requested info is already present in the info table,
-		 * retrieve it from there. */
-		g_mutex_lock(&wrapper1->info->mutex);
-		info = g_hash_table_lookup(
-			wrapper1->info->table, GUINT_TO_POINTER(param_name));
-		g_mutex_unlock(&wrapper1->info->mutex);
-
 	}
 
 	/* If we got here, everything is OK. */
@@ -560,11 +835,17 @@ error_handler:
 	/* If we got here there was an error, verify that it is so. */
 	g_assert(err == NULL || *err != NULL);
 
-	/* In case of error, return an all-zeros info if min_size is > 0. */
+	/* In case of error, return an all-zeros info if min_size is > 0.
+	 * It is kept with the replaced information, so that it is released
+	 * with the wrapper but never returned from the cache. */
+	if (info != NULL) ccl_wrapper_info_destroy(info);
+	info = NULL;
 	if (min_size > 0) {
-		if (info != NULL) ccl_wrapper_info_destroy(info);
 		info = ccl_wrapper_info_new(min_size);
-		ccl_wrapper_add_info(wrapper1, param_name, info);
+		g_mutex_lock(&wrapper1->info->mutex);
+		wrapper1->info->old_info =
+			g_slist_prepend(wrapper1->info->old_info, info);
+		g_mutex_unlock(&wrapper1->info->mutex);
 	}
 
 finish:
@@ -588,7 +869,8 @@ finish:
  * @param[in] min_size Minimum size of returned value in case of error.
  * @param[in] info_type Type of information query to perform.
  * @param[in] use_cache TRUE if cached information is to be used, FALSE
- * to force a new query even if information is in cache.
+ * to force a new query even if information is in cache (unless the
+ * information never changes, e.g. the name of a device).
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
  * @return A pointer to the requested information value. This
@@ -618,6 +900,103 @@ void* ccl_wrapper_get_info_value(CCLWrapper* wrapper1,
 	return diw != NULL ? diw->value : NULL;
 }
 
+/**
+ * Get pointer to a fixed-size information value, such as a scalar.
+ *
+ * This function should not be directly invoked in most circumstances. Use the
+ * `ccl_*_get_info_scalar()` macros instead.
+ *
+ * Unlike ccl_wrapper_get_info_value(), information not found in cache
+ * is obtained with a single call to the OpenCL implementation, avoiding
+ * a preliminary query for the information size. If the information does
+ * not fit in `size` bytes, or the query fails, this function behaves as
+ * ccl_wrapper_get_info_value().
+ *
+ * @public @memberof ccl_wrapper
+ *
+ * @param[in] wrapper1 The wrapper object to query.
+ * @param[in] wrapper2 A second wrapper object, required in some
+ * queries.
+ * @param[in] param_name Name of information/parameter to get value of.
+ * @param[in] size Size in bytes of information value.
+ * @param[in] info_type Type of information query to perform.
+ * @param[in] use_cache TRUE if cached information is to be used, FALSE
+ * to force a new query even if information is in cache (unless the
+ * information never changes, e.g. the name of a device).
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A pointer to the requested information value. This
+ * value will be automatically freed when the wrapper object is
+ * destroyed. If an error occurs, a pointer to a `size`d zero value is
+ * returned.
+ * */
+CCL_EXPORT
+void* ccl_wrapper_get_info_scalar(CCLWrapper* wrapper1,
+	CCLWrapper* wrapper2, cl_uint param_name, size_t size,
+	CCLInfo info_type, cl_bool use_cache, CCLErr** err) {
+
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Make sure wrapper1 is not NULL. */
+	g_return_val_if_fail(wrapper1 != NULL, NULL);
+
+	/* Make sure size is not zero. */
+	g_return_val_if_fail(size > 0, NULL);
+
+	/* Make sure info_type has a valid value. */
+	g_return_val_if_fail((info_type >= 0) && (info_type < CCL_INFO_END), NULL);
+
+	/* Information object. */
+	CCLWrapperInfo* info = NULL;
+
+	/* Information function to use. */
+	ccl_wrapper_info_fp info_fun = info_funs[info_type];
+
+	/* OpenCL status. */
+	cl_int ocl_status;
+
+	/* Size of information in bytes. Some implementations do not return
+	 * the size when getting the value, in which case it is assumed to
+	 * be the requested size. */
+	size_t size_ret = size;
+
+	/* Check if info cache contains requested information, if the cache
+	 * is to be used or if the information never changes. */
+	if (use_cache || ccl_wrapper_info_is_immutable(param_name, info_type))
+		info = ccl_wrapper_info_lookup(wrapper1, param_name);
+
+	if ((info != NULL) && (info->size >= size))
+		return info->value;
+
+	/* Get information directly into a new information object. */
+	info = ccl_wrapper_info_new(size);
+	ocl_status = (wrapper2 == NULL)
+		? ((ccl_wrapper_info_fp1) info_fun)(wrapper1->cl_object,
+			param_name, size, info->value, &size_ret)
+		: ((ccl_wrapper_info_fp2) info_fun)(wrapper1->cl_object,
+			wrapper2->cl_object, param_name, size, info->value,
+			&size_ret);
+
+	if ((ocl_status == CL_SUCCESS) && (size_ret > 0) && (size_ret <= size)) {
+
+		/* Keep information in information table. */
+		ccl_wrapper_add_info(wrapper1, param_name, info);
+
+	} else {
+
+		/* Information is larger than expected, unavailable, or the
+		 * query failed, so let the generic function handle it. */
+		ccl_wrapper_info_destroy(info);
+		info = ccl_wrapper_get_info(wrapper1, wrapper2, param_name,
+			size, info_type, CL_FALSE, err);
+
+	}
+
+	/* Return pointer to value. */
+	return info->value;
+}
+
 /**
  * Get information size.
  *
@@ -632,7 +1011,8 @@ void* ccl_wrapper_get_info_value(CCLWrapper* wrapper1,
  * @param[in] min_size Minimum size returned in case of error.
  * @param[in] info_type Type of information query to perform.
  * @param[in] use_cache TRUE if cached information is to be used, FALSE
- * to force a new query even if information is in cache.
+ * to force a new query even if information is in cache (unless the
+ * information never changes, e.g. the name of a device).
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
  * @return The requested information size. If an error occurs, a size of
@@ -675,7 +1055,7 @@ CCL_EXPORT
 cl_bool ccl_wrapper_memcheck() {
 
 	/* Check return variable. */
-	cl_bool check;
+	cl_bool check = CL_TRUE;
 
 #ifndef NDEBUG
 
@@ -689,57 +1069,70 @@ cl_bool ccl_wrapper_memcheck() {
 	gpointer addr;
 
 	/* Log string. */
-	GString* logstr = NULL;
+	GString* logstr = g_string_new("");
+
+	/* Number of existing wrappers. */
+	guint num_wrappers = 0;
 
 #endif
 
-	/* Lock access to wrappers variable. */
-	G_LOCK(wrappers);
+	/* Check all registry shards. */
+	for (guint i = 0; i < CCL_WRAPPER_NUM_SHARDS; ++i) {
 
-	/* Check if wrappers variable is set. */
-	check = (wrappers == NULL);
+		/* Lock access to current shard. */
+		g_mutex_lock(&wrappers[i].mutex);
 
-#ifndef NDEBUG
+		/* Check if shard table is set. */
+		if (wrappers[i].table != NULL) {
 
-	/* In debug mode, log existing wrappers. */
-	if (check) {
+			check = CL_FALSE;
 
-		/* Wrappers table is empty. */
-		g_debug("Wrappers table is empty");
+#ifndef NDEBUG
 
-	} else {
+			/* In debug mode, add existing wrappers to log string. */
 
-		/* Wrappers table is not empty, list them. */
+			/* Initialize iterator. */
+			g_hash_table_iter_init(&iter, wrappers[i].table);
 
-		/* Initialize iterator. */
-		g_hash_table_iter_init(&iter, wrappers);
+			/* Iterate over existing wrappers... */
+			while(g_hash_table_iter_next(&iter, &addr, (gpointer) &obj)) {
 
-		/* Initialize log string. */
-		logstr = g_string_new("");
-		g_string_append_printf(logstr,
-			"There are %u wrappers in table: ", g_hash_table_size(wrappers));
+				/*...and add their name and address to log string. */
+				g_string_append_printf(logstr, "\n%s(%p) ",
+					ccl_wrapper_get_class_name(obj), addr);
+				num_wrappers++;
 
-		/* Iterate over existing wrappers... */
-		while(g_hash_table_iter_next(&iter, &addr, (gpointer) &obj)) {
+			}
 
-			/*...and add their name and address to log string. */
-			g_string_append_printf(logstr, "\n%s(%p) ",
-				ccl_wrapper_get_class_name(obj), addr);
+#endif
 
 		}
 
-		/* Log existing wrappers.*/
-		g_debug("%s\n", logstr->str);
+		/* Unlock access to current shard. */
+		g_mutex_unlock(&wrappers[i].mutex);
 
-		/* Release string. */
-		g_string_free(logstr, TRUE);
+	}
+
+#ifndef NDEBUG
+
+	/* In debug mode, log existing wrappers. */
+	if (check) {
+
+		/* Wrappers table is empty. */
+		g_debug("Wrappers table is empty");
+
+	} else {
+
+		/* Wrappers table is not empty, list them. */
+		g_debug("There are %u wrappers in table: %s\n",
+			num_wrappers, logstr->str);
 
 	}
 
-#endif
+	/* Release string. */
+	g_string_free(logstr, TRUE);
 
-	/* Unlock access to wrappers variable. */
-	G_UNLOCK(wrappers);
+#endif
 
 	/* Return check. */
 	return check;
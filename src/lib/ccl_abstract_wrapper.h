@@ -79,6 +79,12 @@ void* ccl_wrapper_get_info_value(CCLWrapper* wrapper1,
 	CCLWrapper* wrapper2, cl_uint param_name, size_t min_size,
 	CCLInfo info_type, cl_bool use_cache, CCLErr** err);
 
+/* Get pointer to a fixed-size information value, such as a scalar. */
+CCL_EXPORT
+void* ccl_wrapper_get_info_scalar(CCLWrapper* wrapper1,
+	CCLWrapper* wrapper2, cl_uint param_name, size_t size,
+	CCLInfo info_type, cl_bool use_cache, CCLErr** err);
+
 /* Get information size. */
 CCL_EXPORT
 size_t ccl_wrapper_get_info_size(CCLWrapper* wrapper1,
@@ -0,0 +1,603 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of a pool of device buffers which recycles
+ * sub-buffers of large backing buffers.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_buffer_pool.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ * Size class of buffers which are not carved from backing buffers.
+ * */
+#define CCL_BUFFER_POOL_DEDICATED G_MAXUINT
+
+/**
+ * @internal
+ * A buffer allocated by a pool.
+ * */
+typedef struct ccl_buffer_pool_entry {
+
+	/**
+	 * Buffer wrapper.
+	 * @private
+	 * */
+	CCLBuffer* buf;
+
+	/**
+	 * Size class, or ::CCL_BUFFER_POOL_DEDICATED.
+	 * @private
+	 * */
+	cl_uint cls;
+
+	/**
+	 * Requested size, if the buffer is allocated.
+	 * @private
+	 * */
+	size_t size;
+
+	/**
+	 * Event of the last command which uses the buffer, if it was
+	 * released but not recycled yet.
+	 * @private
+	 * */
+	CCLEvent* last_use;
+
+} CCLBufferPoolEntry;
+
+/**
+ * Buffer pool class.
+ * */
+struct ccl_buffer_pool {
+
+	/**
+	 * Context where buffers are created.
+	 * @private
+	 * */
+	CCLContext* ctx;
+
+	/**
+	 * Flags of created buffers.
+	 * @private
+	 * */
+	cl_mem_flags flags;
+
+	/**
+	 * Size of backing buffers.
+	 * @private
+	 * */
+	size_t block_size;
+
+	/**
+	 * Sub-buffer alignment in bytes, which is also the size of the
+	 * smallest size class.
+	 * @private
+	 * */
+	size_t align;
+
+	/**
+	 * Number of size classes.
+	 * @private
+	 * */
+	cl_uint num_classes;
+
+	/**
+	 * Backing buffers.
+	 * @private
+	 * */
+	GPtrArray* blocks;
+
+	/**
+	 * Number of bytes carved from the most recent backing buffer.
+	 * @private
+	 * */
+	size_t block_used;
+
+	/**
+	 * Entries of all buffers managed by the pool, indexed by buffer
+	 * wrapper.
+	 * @private
+	 * */
+	GHashTable* entries;
+
+	/**
+	 * Free entries of each size class.
+	 * @private
+	 * */
+	GPtrArray** free;
+
+	/**
+	 * Released entries of each size class which are waiting for their
+	 * last use to complete.
+	 * @private
+	 * */
+	GQueue* pending;
+
+	/**
+	 * Current statistics.
+	 * @private
+	 * */
+	CCLBufferPoolStats stats;
+
+};
+
+/**
+ * @internal
+ * Size in bytes of a size class.
+ *
+ * @param[in] pool Buffer pool.
+ * @param[in] cls Size class.
+ * @return Size in bytes of the given size class.
+ * */
+static size_t ccl_buffer_pool_class_size(CCLBufferPool* pool, cl_uint cls) {
+
+	return pool->align << cls;
+
+}
+
+/**
+ * @internal
+ * Destroy an entry, releasing its buffer.
+ *
+ * @param[in] entry Entry to destroy.
+ * */
+static void ccl_buffer_pool_entry_destroy(CCLBufferPoolEntry* entry) {
+
+	if (entry->last_use != NULL) ccl_event_destroy(entry->last_use);
+	ccl_buffer_destroy(entry->buf);
+	g_slice_free(CCLBufferPoolEntry, entry);
+
+}
+
+/**
+ * @internal
+ * Move released entries of a size class whose last use is complete
+ * to the respective free list.
+ *
+ * @param[in] pool Buffer pool.
+ * @param[in] cls Size class.
+ * */
+static void ccl_buffer_pool_recycle(CCLBufferPool* pool, cl_uint cls) {
+
+	/* Released entries of size class, in release order. */
+	GQueue* pending = &pool->pending[cls];
+
+	while (!g_queue_is_empty(pending)) {
+
+		/* Oldest released entry. */
+		CCLBufferPoolEntry* entry = g_queue_peek_head(pending);
+		/* Execution status of its last use. */
+		cl_int status = CL_COMPLETE;
+		cl_int ocl_status;
+
+		/* Stop at the first entry still in use. Errors querying the
+		 * event are handled as if the command had terminated. */
+		ocl_status = clGetEventInfo(ccl_event_unwrap(entry->last_use),
+			CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(cl_int),
+			&status, NULL);
+		if ((ocl_status == CL_SUCCESS) && (status > CL_COMPLETE))
+			break;
+
+		/* Entry can be recycled. */
+		g_queue_pop_head(pending);
+		ccl_event_destroy(entry->last_use);
+		entry->last_use = NULL;
+		g_ptr_array_add(pool->free[cls], entry);
+
+	}
+}
+
+/**
+ * @internal
+ * Carve a new sub-buffer of the given size class, creating a new
+ * backing buffer if required.
+ *
+ * @param[in] pool Buffer pool.
+ * @param[in] cls Size class.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new entry, or `NULL` if an error occurs.
+ * */
+static CCLBufferPoolEntry* ccl_buffer_pool_carve(CCLBufferPool* pool,
+	cl_uint cls, CCLErr** err) {
+
+	/* Size of sub-buffer. */
+	size_t size = ccl_buffer_pool_class_size(pool, cls);
+	/* Sub-buffer wrapper. */
+	CCLBuffer* buf;
+	/* New entry. */
+	CCLBufferPoolEntry* entry;
+
+	/* Create new backing buffer if current one is exhausted. */
+	if ((pool->blocks->len == 0)
+		|| (pool->block_used + size > pool->block_size)) {
+
+		CCLBuffer* block = ccl_buffer_new(pool->ctx, pool->flags,
+			pool->block_size, NULL, err);
+		if (block == NULL) return NULL;
+
+		if (pool->blocks->len > 0)
+			pool->stats.bytes_wasted += pool->block_size - pool->block_used;
+		g_ptr_array_add(pool->blocks, block);
+		pool->block_used = 0;
+		pool->stats.num_blocks++;
+		pool->stats.bytes_reserved += pool->block_size;
+
+	}
+
+	/* Carve sub-buffer from current backing buffer. Offsets are always
+	 * multiples of the alignment, since so are all class sizes. */
+	buf = ccl_buffer_new_from_region(
+		g_ptr_array_index(pool->blocks, pool->blocks->len - 1),
+		0, pool->block_used, size, err);
+	if (buf == NULL) return NULL;
+	pool->block_used += size;
+
+	/* Create and register entry. */
+	entry = g_slice_new0(CCLBufferPoolEntry);
+	entry->buf = buf;
+	entry->cls = cls;
+	g_hash_table_insert(pool->entries, buf, entry);
+
+	return entry;
+
+}
+
+/**
+ * @addtogroup CCL_BUFFER_POOL
+ * @{
+ */
+
+/**
+ * Create a new buffer pool. Backing buffers are only created when
+ * required.
+ *
+ * @public @memberof ccl_buffer_pool
+ *
+ * @param[in] ctx Context wrapper object where buffers are created.
+ * @param[in] flags Flags of created buffers, as in ccl_buffer_new().
+ * Host pointer flags are not allowed.
+ * @param[in] block_size Size of backing buffers in bytes, which is also
+ * the largest allocation served by sub-buffers. Must be at least as
+ * large as the pool alignment.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new buffer pool, which should be destroyed with
+ * ccl_buffer_pool_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLBufferPool* ccl_buffer_pool_new(CCLContext* ctx, cl_mem_flags flags,
+	size_t block_size, CCLErr** err) {
+
+	/* Make sure ctx is not NULL. */
+	g_return_val_if_fail(ctx != NULL, NULL);
+	/* Make sure no host pointer flags are given. */
+	g_return_val_if_fail((flags & (CL_MEM_USE_HOST_PTR
+		| CL_MEM_COPY_HOST_PTR)) == 0, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Buffer pool. */
+	CCLBufferPool* pool = NULL;
+	/* Devices in context. */
+	CCLDevice* const* devs;
+	cl_uint num_devs;
+	/* Largest sub-buffer alignment in bytes. */
+	size_t align = 1;
+
+	/* Determine the largest sub-buffer alignment of all devices in
+	 * context. */
+	num_devs = ccl_context_get_num_devices(ctx, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	devs = ccl_context_get_all_devices(ctx, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	for (cl_uint i = 0; i < num_devs; ++i) {
+		cl_uint align_bits = ccl_device_get_info_scalar(devs[i],
+			CL_DEVICE_MEM_BASE_ADDR_ALIGN, cl_uint, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		align = MAX(align, align_bits / 8);
+	}
+
+	/* Check that backing buffers can hold at least one sub-buffer. */
+	g_if_err_create_goto(*err, CCL_ERROR, block_size < align,
+		CCL_ERROR_ARGS, error_handler,
+		"%s: block size (%" G_GSIZE_FORMAT " bytes) is smaller than the "
+		"sub-buffer alignment (%" G_GSIZE_FORMAT " bytes).", CCL_STRD,
+		(gsize) block_size, (gsize) align);
+
+	/* Create and initialize pool. */
+	pool = g_slice_new0(CCLBufferPool);
+	ccl_context_ref(ctx);
+	pool->ctx = ctx;
+	pool->flags = flags;
+	pool->block_size = block_size;
+	pool->align = align;
+	while ((align << pool->num_classes) <= block_size)
+		pool->num_classes++;
+	pool->blocks = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) ccl_buffer_destroy);
+	pool->entries = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+		NULL, (GDestroyNotify) ccl_buffer_pool_entry_destroy);
+	pool->free = g_new0(GPtrArray*, pool->num_classes);
+	pool->pending = g_new0(GQueue, pool->num_classes);
+	for (cl_uint i = 0; i < pool->num_classes; ++i) {
+		pool->free[i] = g_ptr_array_new();
+		g_queue_init(&pool->pending[i]);
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Return new buffer pool. */
+	return pool;
+
+}
+
+/**
+ * Destroy a buffer pool, releasing all its buffers. Buffers allocated
+ * from the pool must not be used after the pool is destroyed.
+ *
+ * @public @memberof ccl_buffer_pool
+ *
+ * @param[in] pool Buffer pool to destroy.
+ * */
+CCL_EXPORT
+void ccl_buffer_pool_destroy(CCLBufferPool* pool) {
+
+	/* Buffer pool to destroy cannot be NULL. */
+	g_return_if_fail(pool != NULL);
+
+	/* Warn about buffers which were not returned to the pool. */
+	if (pool->stats.bytes_in_use > 0)
+		g_warning("Buffer pool destroyed with %" G_GSIZE_FORMAT
+			" bytes still in use.", (gsize) pool->stats.bytes_in_use);
+
+	/* Release free lists and pending queues (entries are released with
+	 * the table of entries). */
+	for (cl_uint i = 0; i < pool->num_classes; ++i) {
+		g_ptr_array_free(pool->free[i], TRUE);
+		g_queue_clear(&pool->pending[i]);
+	}
+	g_free(pool->free);
+	g_free(pool->pending);
+
+	/* Release sub-buffers and dedicated buffers before backing
+	 * buffers. */
+	g_hash_table_destroy(pool->entries);
+	g_ptr_array_free(pool->blocks, TRUE);
+
+	/* Release context and pool. */
+	ccl_context_unref(pool->ctx);
+	g_slice_free(CCLBufferPool, pool);
+
+}
+
+/**
+ * Allocate a buffer from the pool. A released buffer of the same size
+ * class is recycled if its last use is complete; otherwise, a new
+ * sub-buffer is carved from a backing buffer. Allocations larger than
+ * the backing buffers are served by dedicated buffers.
+ *
+ * @public @memberof ccl_buffer_pool
+ *
+ * @param[in] pool Buffer pool.
+ * @param[in] size Requested size in bytes. The returned buffer may be
+ * larger.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A buffer wrapper, which belongs to the pool and should be
+ * returned to it with ccl_buffer_pool_release(), or `NULL` if an error
+ * occurs.
+ * */
+CCL_EXPORT
+CCLBuffer* ccl_buffer_pool_alloc(CCLBufferPool* pool, size_t size,
+	CCLErr** err) {
+
+	/* Make sure pool is not NULL. */
+	g_return_val_if_fail(pool != NULL, NULL);
+	/* Make sure size is not zero. */
+	g_return_val_if_fail(size > 0, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Size class. */
+	cl_uint cls = 0;
+	/* Allocated entry. */
+	CCLBufferPoolEntry* entry = NULL;
+
+	/* Determine size class. */
+	while ((cls < pool->num_classes)
+		&& (ccl_buffer_pool_class_size(pool, cls) < size))
+		cls++;
+
+	pool->stats.num_allocs++;
+
+	if (cls == pool->num_classes) {
+
+		/* Too large for backing buffers, create dedicated buffer. */
+		CCLBuffer* buf = ccl_buffer_new(
+			pool->ctx, pool->flags, size, NULL, err);
+		if (buf != NULL) {
+			entry = g_slice_new0(CCLBufferPoolEntry);
+			entry->buf = buf;
+			entry->cls = CCL_BUFFER_POOL_DEDICATED;
+			g_hash_table_insert(pool->entries, buf, entry);
+		}
+
+	} else {
+
+		/* Recycle a released sub-buffer if possible, otherwise carve a
+		 * new one. */
+		ccl_buffer_pool_recycle(pool, cls);
+		if (pool->free[cls]->len > 0) {
+			entry = g_ptr_array_remove_index_fast(
+				pool->free[cls], pool->free[cls]->len - 1);
+			pool->stats.num_hits++;
+			pool->stats.bytes_cached -= ccl_buffer_pool_class_size(pool, cls);
+		} else {
+			entry = ccl_buffer_pool_carve(pool, cls, err);
+		}
+
+	}
+
+	/* Update usage. */
+	if (entry != NULL) {
+		entry->size = size;
+		pool->stats.bytes_requested += size;
+		pool->stats.bytes_in_use += (entry->cls == CCL_BUFFER_POOL_DEDICATED)
+			? size : ccl_buffer_pool_class_size(pool, entry->cls);
+	}
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(entry != NULL ? entry->buf : NULL);
+
+	/* Return buffer. */
+	return (entry != NULL) ? entry->buf : NULL;
+
+}
+
+/**
+ * Return a buffer to the pool. The buffer will only be recycled once
+ * `last_use` completes. Dedicated buffers are released immediately,
+ * since OpenCL defers their release until commands using them are
+ * complete.
+ *
+ * @public @memberof ccl_buffer_pool
+ *
+ * @param[in] pool Buffer pool.
+ * @param[in] buf Buffer allocated with ccl_buffer_pool_alloc().
+ * @param[in] last_use Event of the last command which uses the buffer,
+ * or `NULL` if the buffer is not used by any pending command.
+ * */
+CCL_EXPORT
+void ccl_buffer_pool_release(CCLBufferPool* pool, CCLBuffer* buf,
+	CCLEvent* last_use) {
+
+	/* Make sure pool is not NULL. */
+	g_return_if_fail(pool != NULL);
+	/* Make sure buf is not NULL. */
+	g_return_if_fail(buf != NULL);
+
+	/* Entry of buffer. */
+	CCLBufferPoolEntry* entry = g_hash_table_lookup(pool->entries, buf);
+
+	/* Make sure buffer belongs to pool and is allocated. */
+	g_return_if_fail((entry != NULL) && (entry->size > 0));
+
+	/* Requested size of buffer. */
+	size_t size = entry->size;
+
+	/* Update usage. */
+	pool->stats.bytes_requested -= size;
+	entry->size = 0;
+
+	if (entry->cls == CCL_BUFFER_POOL_DEDICATED) {
+
+		/* Release dedicated buffer. */
+		pool->stats.bytes_in_use -= size;
+		g_hash_table_remove(pool->entries, buf);
+
+	} else {
+
+		/* Keep sub-buffer for recycling. */
+		size_t cls_size = ccl_buffer_pool_class_size(pool, entry->cls);
+		pool->stats.bytes_in_use -= cls_size;
+		pool->stats.bytes_cached += cls_size;
+
+		if (last_use != NULL) {
+			ccl_event_ref(last_use);
+			entry->last_use = last_use;
+			g_queue_push_tail(&pool->pending[entry->cls], entry);
+		} else {
+			g_ptr_array_add(pool->free[entry->cls], entry);
+		}
+	}
+}
+
+/**
+ * Get the alignment of buffers allocated by the pool, i.e. the largest
+ * `CL_DEVICE_MEM_BASE_ADDR_ALIGN` of the devices in the pool's
+ * context, in bytes. This is also the size of the smallest size class.
+ *
+ * @public @memberof ccl_buffer_pool
+ *
+ * @param[in] pool Buffer pool.
+ * @return Alignment of buffers allocated by the pool in bytes.
+ * */
+CCL_EXPORT
+size_t ccl_buffer_pool_get_alignment(CCLBufferPool* pool) {
+
+	/* Make sure pool is not NULL. */
+	g_return_val_if_fail(pool != NULL, 0);
+
+	return pool->align;
+
+}
+
+/**
+ * Get usage, hit rate and fragmentation statistics of the pool.
+ *
+ * @public @memberof ccl_buffer_pool
+ *
+ * @param[in] pool Buffer pool.
+ * @param[out] stats Location where to place the statistics.
+ * */
+CCL_EXPORT
+void ccl_buffer_pool_get_stats(CCLBufferPool* pool,
+	CCLBufferPoolStats* stats) {
+
+	/* Make sure pool is not NULL. */
+	g_return_if_fail(pool != NULL);
+	/* Make sure stats is not NULL. */
+	g_return_if_fail(stats != NULL);
+
+	/* Copy counters and determine ratios. */
+	*stats = pool->stats;
+	stats->hit_rate = (stats->num_allocs > 0)
+		? ((double) stats->num_hits) / stats->num_allocs : 0.0;
+	stats->internal_frag = (stats->bytes_in_use > 0)
+		? 1.0 - ((double) stats->bytes_requested) / stats->bytes_in_use
+		: 0.0;
+	stats->external_frag = (stats->bytes_reserved > 0)
+		? ((double) stats->bytes_wasted) / stats->bytes_reserved : 0.0;
+
+}
+
+/** @} */
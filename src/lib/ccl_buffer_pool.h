@@ -0,0 +1,204 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Definition of a pool of device buffers which recycles sub-buffers of
+ * large backing buffers.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_BUFFER_POOL_H_
+#define _CCL_BUFFER_POOL_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_context_wrapper.h"
+#include "ccl_buffer_wrapper.h"
+#include "ccl_event_wrapper.h"
+
+/**
+ * @defgroup CCL_BUFFER_POOL Buffer pools
+ *
+ * The buffer pool module provides a class which allocates device
+ * buffers as sub-buffers of large backing buffers, recycling them
+ * instead of creating and releasing OpenCL memory objects for each
+ * allocation.
+ *
+ * @warning The functions in this module are not thread-safe.
+ *
+ * Allocation sizes are rounded up to a size class, i.e. a power of two
+ * multiple of the largest `CL_DEVICE_MEM_BASE_ADDR_ALIGN` of the
+ * devices in the context, such that sub-buffer origins are always
+ * properly aligned. Each size class keeps a list of free sub-buffers.
+ * When the list is empty, a new sub-buffer is carved from the current
+ * backing buffer with ::ccl_buffer_new_from_region(), and a new
+ * backing buffer is created when the current one is exhausted.
+ * Allocations larger than the backing buffers are served by dedicated
+ * buffers, which are not recycled.
+ *
+ * Buffers are returned to the pool with ::ccl_buffer_pool_release(),
+ * optionally with the event of the last command which uses them. Such
+ * buffers are only recycled after the event completes, so that
+ * commands using a released buffer are not affected by later
+ * allocations.
+ *
+ * Pool usage, hit rate and fragmentation statistics are available
+ * through ::ccl_buffer_pool_get_stats().
+ *
+ * @note Requires OpenCL >= 1.1.
+ *
+ * _Example:_
+ *
+ * @code{.c}
+ * CCLBufferPool* pool;
+ * CCLBuffer* buf;
+ * CCLEvent* evt;
+ * @endcode
+ * @code{.c}
+ * pool = ccl_buffer_pool_new(ctx, CL_MEM_READ_WRITE, 64 * 1024 * 1024, NULL);
+ * @endcode
+ * @code{.c}
+ * buf = ccl_buffer_pool_alloc(pool, request_size, NULL);
+ * evt = ccl_buffer_enqueue_write(buf, queue, CL_FALSE, 0, request_size,
+ *     request_data, NULL, NULL);
+ * ccl_buffer_pool_release(pool, buf, evt);
+ * @endcode
+ * @code{.c}
+ * ccl_buffer_pool_destroy(pool);
+ * @endcode
+ *
+ * @{
+ */
+
+/**
+ * Buffer pool class.
+ * */
+typedef struct ccl_buffer_pool CCLBufferPool;
+
+/**
+ * Buffer pool statistics.
+ * */
+typedef struct ccl_buffer_pool_stats {
+
+	/**
+	 * Number of allocation requests.
+	 * @public
+	 * */
+	cl_ulong num_allocs;
+
+	/**
+	 * Number of allocation requests served with recycled buffers.
+	 * @public
+	 * */
+	cl_ulong num_hits;
+
+	/**
+	 * Fraction of allocation requests served with recycled buffers.
+	 * @public
+	 * */
+	double hit_rate;
+
+	/**
+	 * Number of backing buffers.
+	 * @public
+	 * */
+	cl_uint num_blocks;
+
+	/**
+	 * Total size of backing buffers, in bytes.
+	 * @public
+	 * */
+	size_t bytes_reserved;
+
+	/**
+	 * Size of the sub-buffers currently allocated, in bytes.
+	 * @public
+	 * */
+	size_t bytes_in_use;
+
+	/**
+	 * Size requested for the sub-buffers currently allocated, in bytes.
+	 * @public
+	 * */
+	size_t bytes_requested;
+
+	/**
+	 * Size of released sub-buffers available for recycling, in bytes.
+	 * @public
+	 * */
+	size_t bytes_cached;
+
+	/**
+	 * Size of the regions at the end of backing buffers which were too
+	 * small to be carved, in bytes.
+	 * @public
+	 * */
+	size_t bytes_wasted;
+
+	/**
+	 * Internal fragmentation, i.e. the fraction of allocated bytes
+	 * which were not requested due to size class rounding.
+	 * @public
+	 * */
+	double internal_frag;
+
+	/**
+	 * External fragmentation, i.e. the fraction of reserved bytes
+	 * which were wasted at the end of backing buffers.
+	 * @public
+	 * */
+	double external_frag;
+
+} CCLBufferPoolStats;
+
+/* Create a new buffer pool. */
+CCL_EXPORT
+CCLBufferPool* ccl_buffer_pool_new(CCLContext* ctx, cl_mem_flags flags,
+	size_t block_size, CCLErr** err);
+
+/* Destroy a buffer pool. */
+CCL_EXPORT
+void ccl_buffer_pool_destroy(CCLBufferPool* pool);
+
+/* Allocate a buffer from the pool. */
+CCL_EXPORT
+CCLBuffer* ccl_buffer_pool_alloc(CCLBufferPool* pool, size_t size,
+	CCLErr** err);
+
+/* Return a buffer to the pool. */
+CCL_EXPORT
+void ccl_buffer_pool_release(CCLBufferPool* pool, CCLBuffer* buf,
+	CCLEvent* last_use);
+
+/* Get the alignment of buffers allocated by the pool. */
+CCL_EXPORT
+size_t ccl_buffer_pool_get_alignment(CCLBufferPool* pool);
+
+/* Get usage, hit rate and fragmentation statistics of the pool. */
+CCL_EXPORT
+void ccl_buffer_pool_get_stats(CCLBufferPool* pool,
+	CCLBufferPoolStats* stats);
+
+/** @} */
+
+#endif
@@ -118,6 +118,9 @@ CCLBuffer* ccl_buffer_new(CCLContext* ctx, cl_mem_flags flags,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_mem buffer;
 	CCLBuffer* buf = NULL;
@@ -143,6 +146,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return new buffer wrapper. */
 	return buf;
 
@@ -183,6 +189,9 @@ CCLEvent* ccl_buffer_enqueue_read(CCLBuffer* buf, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_event event = NULL;
 	CCLEvent* evt = NULL;
@@ -217,6 +226,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -258,6 +270,9 @@ CCLEvent* ccl_buffer_enqueue_write(CCLBuffer* buf, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_event event = NULL;
 	CCLEvent* evt = NULL;
@@ -292,6 +307,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -337,6 +355,9 @@ void* ccl_buffer_enqueue_map(CCLBuffer* buf, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_event event = NULL;
 	CCLEvent* evt_inner = NULL;
@@ -376,6 +397,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt_inner);
+
 	/* Return host pointer. */
 	return ptr;
 
@@ -419,6 +443,9 @@ CCLEvent* ccl_buffer_enqueue_copy(CCLBuffer* src_buf,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_event event = NULL;
 	CCLEvent* evt = NULL;
@@ -454,6 +481,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -503,6 +533,9 @@ CCLEvent* ccl_buffer_enqueue_copy_to_image(CCLBuffer* src_buf,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -542,6 +575,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -574,6 +610,9 @@ CCLBuffer* ccl_buffer_new_from_region(CCLBuffer* buf,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL sub-buffer object- */
@@ -645,6 +684,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return sub-buffer. */
 	return subbuf;
 
@@ -701,6 +743,9 @@ CCLEvent* ccl_buffer_enqueue_read_rect(CCLBuffer* buf, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -786,6 +831,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -844,6 +892,9 @@ CCLEvent* ccl_buffer_enqueue_write_rect(CCLBuffer* buf, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -929,6 +980,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -985,6 +1039,9 @@ CCLEvent* ccl_buffer_enqueue_copy_rect(CCLBuffer* src_buf,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -1068,6 +1125,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -1108,6 +1168,9 @@ CCLEvent* ccl_buffer_enqueue_fill(CCLBuffer* buf, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -1186,6 +1249,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
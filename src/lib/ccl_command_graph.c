@@ -0,0 +1,1231 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of classes and methods for recording and replaying
+ * sequences of OpenCL commands.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_command_graph.h"
+#include "ccl_sampler_wrapper.h"
+#include "_ccl_abstract_wrapper.h"
+#include "_ccl_kernel_wrapper.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ * Type of recorded command.
+ * */
+typedef enum ccl_command_type {
+
+	/** Kernel execution. */
+	CCL_COMMAND_KERNEL,
+	/** Buffer read. */
+	CCL_COMMAND_BUFFER_READ,
+	/** Buffer write. */
+	CCL_COMMAND_BUFFER_WRITE,
+	/** Buffer copy. */
+	CCL_COMMAND_BUFFER_COPY,
+	/** Image read. */
+	CCL_COMMAND_IMAGE_READ,
+	/** Image write. */
+	CCL_COMMAND_IMAGE_WRITE,
+	/** Host wait. */
+	CCL_COMMAND_WAIT
+
+} CCLCommandType;
+
+/**
+ * @internal
+ * Kernel argument captured by a recorded kernel execution command.
+ * */
+typedef struct ccl_command_arg {
+
+	/**
+	 * Argument index.
+	 * @private
+	 * */
+	cl_uint index;
+
+	/**
+	 * Wrapper object (memory object or sampler), or `NULL` if the
+	 * argument is local or private.
+	 * @private
+	 * */
+	CCLArg* wrapper;
+
+	/**
+	 * Size of local or private argument.
+	 * @private
+	 * */
+	size_t size;
+
+	/**
+	 * Copy of private argument value, or `NULL` if argument is local.
+	 * @private
+	 * */
+	void* value;
+
+} CCLCommandArg;
+
+/**
+ * @internal
+ * Recorded command.
+ * */
+typedef struct ccl_command {
+
+	/**
+	 * Command type.
+	 * @private
+	 * */
+	CCLCommandType type;
+
+	/**
+	 * Index of queue where to enqueue command.
+	 * @private
+	 * */
+	cl_uint queue_idx;
+
+	/**
+	 * Position of the command dependencies in the graph's array of
+	 * dependencies.
+	 * @private
+	 * */
+	guint deps_start;
+
+	/**
+	 * Number of command dependencies.
+	 * @private
+	 * */
+	cl_uint num_deps;
+
+	/**
+	 * Do other commands depend on this one?
+	 * @private
+	 * */
+	cl_bool has_dependents;
+
+	/**
+	 * Is the transfer blocking?
+	 * @private
+	 * */
+	cl_bool blocking;
+
+	/**
+	 * Memory objects used by transfer commands (source first).
+	 * @private
+	 * */
+	CCLMemObj* mo[2];
+
+	/**
+	 * Buffer offsets (source first) or image origin.
+	 * @private
+	 * */
+	size_t offset[3];
+
+	/**
+	 * Buffer size (first element) or image region.
+	 * @private
+	 * */
+	size_t region[3];
+
+	/**
+	 * Image row and slice pitches.
+	 * @private
+	 * */
+	size_t pitch[2];
+
+	/**
+	 * Host pointer used by read and write commands.
+	 * @private
+	 * */
+	void* ptr;
+
+	/**
+	 * Kernel to execute.
+	 * @private
+	 * */
+	CCLKernel* krnl;
+
+	/**
+	 * Number of work dimensions.
+	 * @private
+	 * */
+	cl_uint work_dim;
+
+	/**
+	 * Global work offset, global work size and local work size.
+	 * @private
+	 * */
+	size_t gwo[3], gws[3], lws[3];
+
+	/**
+	 * Were a global work offset and a local work size specified?
+	 * @private
+	 * */
+	cl_bool has_gwo, has_lws;
+
+	/**
+	 * Captured kernel arguments.
+	 * @private
+	 * */
+	CCLCommandArg* args;
+
+	/**
+	 * Number of captured kernel arguments.
+	 * @private
+	 * */
+	cl_uint num_args;
+
+	/**
+	 * Name of events produced by the command, or `NULL` to use the
+	 * default event name.
+	 * @private
+	 * */
+	const char* name;
+
+} CCLCommand;
+
+/**
+ * Command graph class.
+ * */
+struct ccl_command_graph {
+
+	/**
+	 * Recorded commands.
+	 * @private
+	 * */
+	GArray* cmds;
+
+	/**
+	 * Dependencies of all recorded commands.
+	 * @private
+	 * */
+	GArray* deps;
+
+	/**
+	 * Number of queues required for replaying the graph.
+	 * @private
+	 * */
+	cl_uint num_queues;
+
+	/**
+	 * Events produced by commands during replay.
+	 * @private
+	 * */
+	cl_event* events;
+
+	/**
+	 * Capacity of the events array.
+	 * @private
+	 * */
+	guint events_cap;
+
+	/**
+	 * Scratch space for building event wait lists during replay.
+	 * @private
+	 * */
+	cl_event* wait_buf;
+
+	/**
+	 * Capacity of the event wait list scratch space.
+	 * @private
+	 * */
+	guint wait_cap;
+
+};
+
+/**
+ * @internal
+ * Release a reference to a wrapper object kept by a command graph.
+ *
+ * @param[in] wrapper Kernel, buffer, image or sampler wrapper object,
+ * or `NULL`.
+ * */
+static void ccl_command_graph_unref(CCLWrapper* wrapper) {
+
+	if (wrapper == NULL) return;
+
+	switch (wrapper->class) {
+		case CCL_KERNEL:
+			ccl_kernel_destroy((CCLKernel*) wrapper);
+			break;
+		case CCL_BUFFER:
+			ccl_buffer_destroy((CCLBuffer*) wrapper);
+			break;
+		case CCL_IMAGE:
+			ccl_image_destroy((CCLImage*) wrapper);
+			break;
+		case CCL_SAMPLER:
+			ccl_sampler_destroy((CCLSampler*) wrapper);
+			break;
+		default:
+			g_warning("Unexpected wrapper object in command graph.");
+	}
+}
+
+/**
+ * @internal
+ * Release the value of a captured kernel argument, or the reference
+ * to it if it is a wrapper object.
+ *
+ * @param[in] arg Captured kernel argument.
+ * */
+static void ccl_command_arg_clear(CCLCommandArg* arg) {
+
+	ccl_command_graph_unref((CCLWrapper*) arg->wrapper);
+	g_free(arg->value);
+	arg->value = NULL;
+	arg->wrapper = NULL;
+	arg->size = 0;
+
+}
+
+/**
+ * @internal
+ * Capture a kernel argument, referencing it if it is a wrapper object,
+ * or releasing it if it is a local or private argument.
+ *
+ * @param[out] carg Captured kernel argument.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg Argument to capture, of type ::CCLArg*, ::CCLBuffer*,
+ * ::CCLImage* or ::CCLSampler*.
+ * */
+static void ccl_command_arg_capture(
+	CCLCommandArg* carg, cl_uint arg_index, CCLArg* arg) {
+
+	carg->index = arg_index;
+
+	if (ccl_arg_is_wrapper(arg)) {
+
+		/* Wrappers are referenced by the graph. */
+		ccl_wrapper_ref((CCLWrapper*) arg);
+		carg->wrapper = arg;
+		carg->size = 0;
+		carg->value = NULL;
+
+	} else {
+
+		/* Keep a copy of private argument values. */
+		void* value = ccl_arg_value(arg);
+		carg->wrapper = NULL;
+		carg->size = ccl_arg_size(arg);
+		carg->value = (value != NULL) ? g_malloc(carg->size) : NULL;
+		if (value != NULL)
+			memcpy(carg->value, value, carg->size);
+		ccl_arg_destroy(arg);
+
+	}
+}
+
+/**
+ * @internal
+ * Add a new command to the command graph, recording its dependencies.
+ *
+ * @param[in] cg Command graph.
+ * @param[in] type Command type.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * the new command depends.
+ * @return The new command, or `NULL` if the dependencies are invalid.
+ * */
+static CCLCommand* ccl_command_graph_add(CCLCommandGraph* cg,
+	CCLCommandType type, cl_uint queue_idx,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* New command. */
+	CCLCommand cmd;
+
+	/* Check that dependencies refer to previously recorded commands. */
+	g_return_val_if_fail((num_deps == 0) || (deps != NULL), NULL);
+	for (cl_uint i = 0; i < num_deps; ++i) {
+		g_return_val_if_fail((deps[i] >= 0)
+			&& ((guint) deps[i] < cg->cmds->len), NULL);
+	}
+
+	/* Mark dependencies as having dependents, so that their events
+	 * are kept during replay. */
+	for (cl_uint i = 0; i < num_deps; ++i)
+		g_array_index(cg->cmds, CCLCommand, deps[i]).has_dependents =
+			CL_TRUE;
+
+	/* Keep track of the number of required queues. */
+	if ((type != CCL_COMMAND_WAIT) && (queue_idx >= cg->num_queues))
+		cg->num_queues = queue_idx + 1;
+
+	/* Initialize and add command. */
+	memset(&cmd, 0, sizeof(CCLCommand));
+	cmd.type = type;
+	cmd.queue_idx = queue_idx;
+	cmd.deps_start = cg->deps->len;
+	cmd.num_deps = num_deps;
+	g_array_append_vals(cg->deps, deps, num_deps);
+	g_array_append_val(cg->cmds, cmd);
+
+	/* Return the command just added. */
+	return &g_array_index(cg->cmds, CCLCommand, cg->cmds->len - 1);
+
+}
+
+/**
+ * @addtogroup CCL_COMMAND_GRAPH
+ * @{
+ */
+
+/**
+ * Create a new command graph object.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @return A new command graph object, which should be destroyed with
+ * ccl_command_graph_destroy().
+ * */
+CCL_EXPORT
+CCLCommandGraph* ccl_command_graph_new() {
+
+	/* Allocate memory for new command graph. */
+	CCLCommandGraph* cg = g_slice_new0(CCLCommandGraph);
+
+	/* Initialize arrays of commands and dependencies. */
+	cg->cmds = g_array_new(FALSE, FALSE, sizeof(CCLCommand));
+	cg->deps = g_array_new(FALSE, FALSE, sizeof(cl_int));
+
+	/* Return new command graph. */
+	return cg;
+
+}
+
+/**
+ * Destroy a command graph object.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph object to destroy.
+ * */
+CCL_EXPORT
+void ccl_command_graph_destroy(CCLCommandGraph* cg) {
+
+	/* Command graph to destroy cannot be NULL. */
+	g_return_if_fail(cg != NULL);
+
+	/* Release captured kernel arguments and referenced wrappers. */
+	for (guint i = 0; i < cg->cmds->len; ++i) {
+		CCLCommand* cmd = &g_array_index(cg->cmds, CCLCommand, i);
+		for (cl_uint j = 0; j < cmd->num_args; ++j)
+			ccl_command_arg_clear(&cmd->args[j]);
+		g_free(cmd->args);
+		ccl_command_graph_unref((CCLWrapper*) cmd->krnl);
+		ccl_command_graph_unref((CCLWrapper*) cmd->mo[0]);
+		ccl_command_graph_unref((CCLWrapper*) cmd->mo[1]);
+	}
+
+	/* Release arrays. */
+	g_array_free(cg->cmds, TRUE);
+	g_array_free(cg->deps, TRUE);
+	g_free(cg->events);
+	g_free(cg->wait_buf);
+
+	/* Release command graph. */
+	g_slice_free(CCLCommandGraph, cg);
+
+}
+
+/**
+ * Record a kernel execution command. The given kernel arguments are
+ * captured and set each time the command is replayed. Arguments which
+ * are not given (or given as ::ccl_arg_skip) keep the value they have
+ * in the kernel wrapper when the command is replayed.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] work_dim The number of dimensions used to specify the
+ * global work-items and work-items in the work-group (between 1 and
+ * 3).
+ * @param[in] global_work_offset Global work offset, or `NULL`.
+ * @param[in] global_work_size Global work size.
+ * @param[in] local_work_size Local work size, or `NULL`.
+ * @param[in] args A `NULL`-terminated array of arguments to capture,
+ * or `NULL`. Arguments must be of type ::CCLArg*, ::CCLBuffer*,
+ * ::CCLImage* or ::CCLSampler*. Local and private arguments are
+ * released by this function.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * this command depends.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_kernel(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLKernel* krnl, cl_uint work_dim,
+	const size_t* global_work_offset, const size_t* global_work_size,
+	const size_t* local_work_size, void** args,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure krnl is not NULL. */
+	g_return_val_if_fail(krnl != NULL, -1);
+	/* Make sure work dimensions are valid. */
+	g_return_val_if_fail((work_dim >= 1) && (work_dim <= 3), -1);
+	/* Make sure global_work_size is not NULL. */
+	g_return_val_if_fail(global_work_size != NULL, -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_KERNEL, queue_idx, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Keep kernel and work sizes. */
+	ccl_kernel_ref(krnl);
+	cmd->krnl = krnl;
+	cmd->work_dim = work_dim;
+	cmd->has_gwo = (global_work_offset != NULL);
+	cmd->has_lws = (local_work_size != NULL);
+	for (cl_uint i = 0; i < work_dim; ++i) {
+		cmd->gwo[i] = cmd->has_gwo ? global_work_offset[i] : 0;
+		cmd->gws[i] = global_work_size[i];
+		cmd->lws[i] = cmd->has_lws ? local_work_size[i] : 0;
+	}
+
+	/* Capture kernel arguments. */
+	if (args != NULL) {
+		for (cl_uint i = 0; args[i] != NULL; ++i) {
+			if (args[i] == ccl_arg_skip) continue;
+			ccl_command_graph_set_kernel_arg(
+				cg, (cl_int) (cg->cmds->len - 1), i, args[i]);
+		}
+	}
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Record a buffer read command.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] buf Buffer wrapper object.
+ * @param[in] blocking_read Indicates if the read operation is blocking
+ * or non-blocking.
+ * @param[in] offset The offset in bytes in the buffer object to read
+ * from.
+ * @param[in] size The size in bytes of data being read.
+ * @param[out] ptr The pointer to buffer in host memory where data is
+ * to be read into.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * this command depends.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_buffer_read(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLBuffer* buf, cl_bool blocking_read,
+	size_t offset, size_t size, void* ptr,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure buf is not NULL. */
+	g_return_val_if_fail(buf != NULL, -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_BUFFER_READ, queue_idx, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Keep transfer parameters. */
+	ccl_buffer_ref(buf);
+	cmd->mo[0] = (CCLMemObj*) buf;
+	cmd->blocking = blocking_read;
+	cmd->offset[0] = offset;
+	cmd->region[0] = size;
+	cmd->ptr = ptr;
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Record a buffer write command.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] buf Buffer wrapper object.
+ * @param[in] blocking_write Indicates if the write operation is
+ * blocking or non-blocking.
+ * @param[in] offset The offset in bytes in the buffer object to write
+ * to.
+ * @param[in] size The size in bytes of data being written.
+ * @param[in] ptr The pointer to buffer in host memory where data is to
+ * be written from.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * this command depends.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_buffer_write(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLBuffer* buf, cl_bool blocking_write,
+	size_t offset, size_t size, void* ptr,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure buf is not NULL. */
+	g_return_val_if_fail(buf != NULL, -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_BUFFER_WRITE, queue_idx, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Keep transfer parameters. */
+	ccl_buffer_ref(buf);
+	cmd->mo[0] = (CCLMemObj*) buf;
+	cmd->blocking = blocking_write;
+	cmd->offset[0] = offset;
+	cmd->region[0] = size;
+	cmd->ptr = ptr;
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Record a buffer copy command.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] src_buf Source buffer wrapper object.
+ * @param[in] dst_buf Destination buffer wrapper object.
+ * @param[in] src_offset The offset where to begin copying data from
+ * `src_buf`.
+ * @param[in] dst_offset The offset where to begin copying data into
+ * `dst_buf`.
+ * @param[in] size Size in bytes to copy.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * this command depends.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_buffer_copy(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLBuffer* src_buf, CCLBuffer* dst_buf,
+	size_t src_offset, size_t dst_offset, size_t size,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure buffers are not NULL. */
+	g_return_val_if_fail((src_buf != NULL) && (dst_buf != NULL), -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_BUFFER_COPY, queue_idx, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Keep transfer parameters. */
+	ccl_buffer_ref(src_buf);
+	ccl_buffer_ref(dst_buf);
+	cmd->mo[0] = (CCLMemObj*) src_buf;
+	cmd->mo[1] = (CCLMemObj*) dst_buf;
+	cmd->offset[0] = src_offset;
+	cmd->offset[1] = dst_offset;
+	cmd->region[0] = size;
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Record an image read command.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] img Image wrapper object.
+ * @param[in] blocking_read Indicates if the read operation is blocking
+ * or non-blocking.
+ * @param[in] origin Defines the @f$(x, y, z)@f$ offset in pixels in
+ * the 1D, 2D or 3D image, the @f$(x, y)@f$ offset and the image index
+ * in the 2D image array or the @f$(x)@f$ offset and the image index in
+ * the 1D image array.
+ * @param[in] region Defines the @f$(width, height, depth)@f$ in pixels
+ * of the 1D, 2D or 3D rectangle, the @f$(width, height)@f$ in pixels of
+ * the 2D rectangle and the number of images of a 2D image array or the
+ * @f$(width)@f$ in pixels of the 1D rectangle and the number of images
+ * of a 1D image array.
+ * @param[in] row_pitch The length of each row in bytes.
+ * @param[in] slice_pitch Size in bytes of the 2D slice of the 3D region
+ * of a 3D image or each image of a 1D or 2D image array being read.
+ * @param[out] ptr The pointer to a buffer in host memory where image
+ * data is to be read into.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * this command depends.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_image_read(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLImage* img, cl_bool blocking_read,
+	const size_t* origin, const size_t* region, size_t row_pitch,
+	size_t slice_pitch, void* ptr, cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure img is not NULL. */
+	g_return_val_if_fail(img != NULL, -1);
+	/* Make sure origin and region are not NULL. */
+	g_return_val_if_fail((origin != NULL) && (region != NULL), -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_IMAGE_READ, queue_idx, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Keep transfer parameters. */
+	ccl_image_ref(img);
+	cmd->mo[0] = (CCLMemObj*) img;
+	cmd->blocking = blocking_read;
+	memcpy(cmd->offset, origin, 3 * sizeof(size_t));
+	memcpy(cmd->region, region, 3 * sizeof(size_t));
+	cmd->pitch[0] = row_pitch;
+	cmd->pitch[1] = slice_pitch;
+	cmd->ptr = ptr;
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Record an image write command.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queue_idx Index of queue where to enqueue command.
+ * @param[in] img Image wrapper object.
+ * @param[in] blocking_write Indicates if the write operation is
+ * blocking or non-blocking.
+ * @param[in] origin Defines the @f$(x, y, z)@f$ offset in pixels in
+ * the 1D, 2D or 3D image, the @f$(x, y)@f$ offset and the image index
+ * in the 2D image array or the @f$(x)@f$ offset and the image index in
+ * the 1D image array.
+ * @param[in] region Defines the @f$(width, height, depth)@f$ in pixels
+ * of the 1D, 2D or 3D rectangle, the @f$(width, height)@f$ in pixels of
+ * the 2D rectangle and the number of images of a 2D image array or the
+ * @f$(width)@f$ in pixels of the 1D rectangle and the number of images
+ * of a 1D image array.
+ * @param[in] input_row_pitch The length of each row in bytes.
+ * @param[in] input_slice_pitch Size in bytes of the 2D slice of the 3D
+ * region of a 3D image or each image of a 1D or 2D image array being
+ * written.
+ * @param[in] ptr The pointer to a buffer in host memory where image
+ * data is to be written from.
+ * @param[in] num_deps Number of dependencies.
+ * @param[in] deps Indexes of previously recorded commands on which
+ * this command depends.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_image_write(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLImage* img, cl_bool blocking_write,
+	const size_t* origin, const size_t* region, size_t input_row_pitch,
+	size_t input_slice_pitch, void* ptr,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure img is not NULL. */
+	g_return_val_if_fail(img != NULL, -1);
+	/* Make sure origin and region are not NULL. */
+	g_return_val_if_fail((origin != NULL) && (region != NULL), -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_IMAGE_WRITE, queue_idx, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Keep transfer parameters. */
+	ccl_image_ref(img);
+	cmd->mo[0] = (CCLMemObj*) img;
+	cmd->blocking = blocking_write;
+	memcpy(cmd->offset, origin, 3 * sizeof(size_t));
+	memcpy(cmd->region, region, 3 * sizeof(size_t));
+	cmd->pitch[0] = input_row_pitch;
+	cmd->pitch[1] = input_slice_pitch;
+	cmd->ptr = ptr;
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Record a command which blocks the host until the given commands are
+ * complete. Commands which depend on a wait command are enqueued after
+ * the wait is over.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] num_deps Number of commands to wait for.
+ * @param[in] deps Indexes of previously recorded commands to wait for.
+ * @return Index of the recorded command, or a negative value if the
+ * given parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_command_graph_add_wait(CCLCommandGraph* cg,
+	cl_uint num_deps, const cl_int* deps) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, -1);
+	/* Make sure there are commands to wait for. */
+	g_return_val_if_fail(num_deps > 0, -1);
+
+	/* Recorded command. */
+	CCLCommand* cmd = ccl_command_graph_add(
+		cg, CCL_COMMAND_WAIT, 0, num_deps, deps);
+	if (cmd == NULL) return -1;
+
+	/* Return index of recorded command. */
+	return (cl_int) (cg->cmds->len - 1);
+
+}
+
+/**
+ * Update an argument of a recorded kernel execution command, or add
+ * it if it was not captured when the command was recorded.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] cmd Index of a recorded kernel execution command.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg Argument to set, of type ::CCLArg*, ::CCLBuffer*,
+ * ::CCLImage* or ::CCLSampler*. Local and private arguments are
+ * released by this function.
+ * */
+CCL_EXPORT
+void ccl_command_graph_set_kernel_arg(CCLCommandGraph* cg,
+	cl_int cmd, cl_uint arg_index, void* arg) {
+
+	/* Make sure cg is not NULL. */
+	g_return_if_fail(cg != NULL);
+	/* Make sure cmd is a valid command index. */
+	g_return_if_fail((cmd >= 0) && ((guint) cmd < cg->cmds->len));
+	/* Make sure arg is not NULL. */
+	g_return_if_fail(arg != NULL);
+
+	/* Recorded command. */
+	CCLCommand* command = &g_array_index(cg->cmds, CCLCommand, cmd);
+	/* Captured argument, and previously captured argument. */
+	CCLCommandArg* carg = NULL;
+	CCLCommandArg old_carg = { 0, NULL, 0, NULL };
+
+	/* Make sure command is a kernel execution command. */
+	g_return_if_fail(command->type == CCL_COMMAND_KERNEL);
+
+	/* Find previously captured argument with the same index. */
+	for (cl_uint i = 0; i < command->num_args; ++i) {
+		if (command->args[i].index == arg_index) {
+			carg = &command->args[i];
+			old_carg = *carg;
+			break;
+		}
+	}
+
+	/* If not found, add a new one. */
+	if (carg == NULL) {
+		command->args = g_renew(
+			CCLCommandArg, command->args, command->num_args + 1);
+		carg = &command->args[command->num_args];
+		command->num_args++;
+	}
+
+	/* Capture argument, and only then release the previous one, which
+	 * may be the same wrapper object. */
+	ccl_command_arg_capture(carg, arg_index, (CCLArg*) arg);
+	ccl_command_arg_clear(&old_carg);
+
+}
+
+/**
+ * Set the name of the events produced by a recorded command when the
+ * graph is replayed in a command queue in tracked mode. This is used to
+ * distinguish commands when profiling is performed with the
+ * @ref CCL_PROFILER "profiler module".
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] cmd Index of a recorded command.
+ * @param[in] name Event name, which must remain valid while the graph is
+ * in use, or `NULL` to use the default event name.
+ * @see ccl_event_set_name()
+ * */
+CCL_EXPORT
+void ccl_command_graph_set_name(CCLCommandGraph* cg,
+	cl_int cmd, const char* name) {
+
+	/* Make sure cg is not NULL. */
+	g_return_if_fail(cg != NULL);
+	/* Make sure cmd is a valid command index. */
+	g_return_if_fail((cmd >= 0) && ((guint) cmd < cg->cmds->len));
+
+	/* Set event name. */
+	g_array_index(cg->cmds, CCLCommand, cmd).name = name;
+
+}
+
+/**
+ * Exchange two memory objects in all recorded commands, i.e., commands
+ * which used `mo1` will use `mo2` instead and vice-versa. This is
+ * useful for replaying graphs which use ping-pong buffers, where the
+ * input and output of an iteration are swapped in the next one.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] mo1 A memory object wrapper.
+ * @param[in] mo2 Another memory object wrapper.
+ * */
+CCL_EXPORT
+void ccl_command_graph_swap_memobjs(CCLCommandGraph* cg,
+	CCLMemObj* mo1, CCLMemObj* mo2) {
+
+	/* Make sure cg is not NULL. */
+	g_return_if_fail(cg != NULL);
+	/* Make sure memory objects are not NULL. */
+	g_return_if_fail((mo1 != NULL) && (mo2 != NULL));
+
+	/* Keep both memory objects alive while swapping, since client code
+	 * may have released its own references to them, and the last
+	 * reference held by the graph may be released before the memory
+	 * object is swapped in by a later command. */
+	ccl_wrapper_ref((CCLWrapper*) mo1);
+	ccl_wrapper_ref((CCLWrapper*) mo2);
+
+	for (guint i = 0; i < cg->cmds->len; ++i) {
+
+		/* Recorded command. */
+		CCLCommand* cmd = &g_array_index(cg->cmds, CCLCommand, i);
+
+		/* Swap memory objects used by transfers. */
+		for (cl_uint j = 0; j < 2; ++j) {
+			if (cmd->mo[j] == mo1)
+				cmd->mo[j] = mo2;
+			else if (cmd->mo[j] == mo2)
+				cmd->mo[j] = mo1;
+			else
+				continue;
+			ccl_wrapper_ref((CCLWrapper*) cmd->mo[j]);
+			ccl_command_graph_unref((CCLWrapper*)
+				(cmd->mo[j] == mo1 ? mo2 : mo1));
+		}
+
+		/* Swap memory objects used as kernel arguments. */
+		for (cl_uint j = 0; j < cmd->num_args; ++j) {
+			if (cmd->args[j].wrapper == (CCLArg*) mo1)
+				cmd->args[j].wrapper = (CCLArg*) mo2;
+			else if (cmd->args[j].wrapper == (CCLArg*) mo2)
+				cmd->args[j].wrapper = (CCLArg*) mo1;
+			else
+				continue;
+			ccl_wrapper_ref((CCLWrapper*) cmd->args[j].wrapper);
+			ccl_command_graph_unref((CCLWrapper*)
+				(cmd->args[j].wrapper == (CCLArg*) mo1 ? mo2 : mo1));
+		}
+	}
+
+	/* Release the references taken above. Memory objects no longer
+	 * used by the graph or by client code are destroyed. */
+	ccl_command_graph_unref((CCLWrapper*) mo1);
+	ccl_command_graph_unref((CCLWrapper*) mo2);
+}
+
+/**
+ * Get the number of recorded commands.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @return Number of recorded commands.
+ * */
+CCL_EXPORT
+cl_uint ccl_command_graph_get_num_commands(CCLCommandGraph* cg) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, 0);
+
+	return cg->cmds->len;
+
+}
+
+/**
+ * Replay the recorded commands in the given command queues. Commands
+ * are enqueued in the order they were recorded, in the queue given by
+ * their queue index, and wait for the events of the commands they
+ * depend on. Commands without dependencies wait for the events in
+ * `evt_wait_lst`, if any.
+ *
+ * Events of commands on which no other command depends are not kept
+ * by the graph, and events are handed over to their queues with
+ * ::ccl_queue_produce_event(). Replaying does not perform any heap
+ * allocation in the steady state, apart from the event wrappers
+ * produced by queues in tracked mode.
+ *
+ * @public @memberof ccl_command_graph
+ *
+ * @param[in] cg Command graph.
+ * @param[in] queues Array of command queue wrappers, indexed by the
+ * queue indexes of recorded commands. The same queue can appear more
+ * than once.
+ * @param[in] num_queues Number of command queues in `queues`.
+ * @param[in,out] evt_wait_lst List of events that need to complete
+ * before commands without dependencies can be executed. The list will
+ * be cleared and can be reused by client code.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_command_graph_replay(CCLCommandGraph* cg,
+	CCLQueue* const* queues, cl_uint num_queues,
+	CCLEventWaitList* evt_wait_lst, CCLErr** err) {
+
+	/* Make sure cg is not NULL. */
+	g_return_val_if_fail(cg != NULL, CL_FALSE);
+	/* Make sure queues are given. */
+	g_return_val_if_fail((queues != NULL) && (num_queues > 0), CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* OpenCL status. */
+	cl_int ocl_status = CL_SUCCESS;
+	/* Function return status. */
+	cl_bool ret_status;
+	/* Index of current command. */
+	guint i = 0;
+
+	/* Check that enough queues were given. */
+	g_if_err_create_goto(*err, CCL_ERROR, num_queues < cg->num_queues,
+		CCL_ERROR_ARGS, error_handler,
+		"%s: command graph requires %u queues, but only %u were given.",
+		CCL_STRD, cg->num_queues, num_queues);
+
+	/* Make sure there is space for the events of all commands. */
+	if (cg->events_cap < cg->cmds->len) {
+		g_free(cg->events);
+		cg->events = g_new0(cl_event, cg->cmds->len);
+		cg->events_cap = cg->cmds->len;
+	}
+
+	for (i = 0; i < cg->cmds->len; ++i) {
+
+		/* Current command. */
+		CCLCommand* cmd = &g_array_index(cg->cmds, CCLCommand, i);
+		/* Event wait list for current command. */
+		cl_uint num_wait = 0;
+		const cl_event* wait = NULL;
+		/* Event produced by current command. */
+		cl_event event = NULL;
+		/* Command queue for current command. */
+		cl_command_queue queue;
+
+		queue = (cmd->type != CCL_COMMAND_WAIT)
+			? ccl_queue_unwrap(queues[cmd->queue_idx]) : NULL;
+
+		/* Build event wait list. */
+		if (cmd->num_deps > 0) {
+			if (cg->wait_cap < cmd->num_deps) {
+				cg->wait_buf = g_renew(cl_event, cg->wait_buf, cmd->num_deps);
+				cg->wait_cap = cmd->num_deps;
+			}
+			for (cl_uint j = 0; j < cmd->num_deps; ++j) {
+				cl_event dep_event = cg->events[g_array_index(
+					cg->deps, cl_int, cmd->deps_start + j)];
+				if (dep_event != NULL)
+					cg->wait_buf[num_wait++] = dep_event;
+			}
+			wait = (num_wait > 0) ? cg->wait_buf : NULL;
+		} else {
+			num_wait = ccl_event_wait_list_get_num_events(evt_wait_lst);
+			wait = ccl_event_wait_list_get_clevents(evt_wait_lst);
+		}
+
+		/* Enqueue command. */
+		switch (cmd->type) {
+
+			case CCL_COMMAND_KERNEL: {
+
+				/* Index of kernel argument. */
+				cl_uint arg_index = 0;
+
+				/* Set captured kernel arguments. */
+				for (cl_uint j = 0; j < cmd->num_args; ++j) {
+					CCLCommandArg* carg = &cmd->args[j];
+					if (carg->wrapper != NULL)
+						ccl_kernel_set_arg_value_full(cmd->krnl,
+							carg->index, ccl_arg_size(carg->wrapper),
+							ccl_arg_value(carg->wrapper), CL_TRUE);
+					else
+						ccl_kernel_set_arg_value(cmd->krnl, carg->index,
+							carg->size, carg->value);
+				}
+				ocl_status = ccl_kernel_apply_args(cmd->krnl, &arg_index);
+				g_if_err_create_goto(*err, CCL_OCL_ERROR,
+					CL_SUCCESS != ocl_status, ocl_status, error_handler,
+					"%s: unable to set kernel arg %d of command %u "
+					"(OpenCL error %d: %s).", CCL_STRD, arg_index, i,
+					ocl_status, ccl_err(ocl_status));
+
+				ocl_status = clEnqueueNDRangeKernel(queue,
+					ccl_kernel_unwrap(cmd->krnl), cmd->work_dim,
+					cmd->has_gwo ? cmd->gwo : NULL, cmd->gws,
+					cmd->has_lws ? cmd->lws : NULL, num_wait, wait, &event);
+				break;
+			}
+
+			case CCL_COMMAND_BUFFER_READ:
+				ocl_status = clEnqueueReadBuffer(queue,
+					ccl_memobj_unwrap(cmd->mo[0]), cmd->blocking,
+					cmd->offset[0], cmd->region[0], cmd->ptr,
+					num_wait, wait, &event);
+				break;
+
+			case CCL_COMMAND_BUFFER_WRITE:
+				ocl_status = clEnqueueWriteBuffer(queue,
+					ccl_memobj_unwrap(cmd->mo[0]), cmd->blocking,
+					cmd->offset[0], cmd->region[0], cmd->ptr,
+					num_wait, wait, &event);
+				break;
+
+			case CCL_COMMAND_BUFFER_COPY:
+				ocl_status = clEnqueueCopyBuffer(queue,
+					ccl_memobj_unwrap(cmd->mo[0]),
+					ccl_memobj_unwrap(cmd->mo[1]), cmd->offset[0],
+					cmd->offset[1], cmd->region[0], num_wait, wait, &event);
+				break;
+
+			case CCL_COMMAND_IMAGE_READ:
+				ocl_status = clEnqueueReadImage(queue,
+					ccl_memobj_unwrap(cmd->mo[0]), cmd->blocking,
+					cmd->offset, cmd->region, cmd->pitch[0], cmd->pitch[1],
+					cmd->ptr, num_wait, wait, &event);
+				break;
+
+			case CCL_COMMAND_IMAGE_WRITE:
+				ocl_status = clEnqueueWriteImage(queue,
+					ccl_memobj_unwrap(cmd->mo[0]), cmd->blocking,
+					cmd->offset, cmd->region, cmd->pitch[0], cmd->pitch[1],
+					cmd->ptr, num_wait, wait, &event);
+				break;
+
+			case CCL_COMMAND_WAIT:
+				ocl_status = (num_wait > 0)
+					? clWaitForEvents(num_wait, wait) : CL_SUCCESS;
+				break;
+
+		}
+
+		g_if_err_create_goto(*err, CCL_OCL_ERROR,
+			CL_SUCCESS != ocl_status, ocl_status, error_handler,
+			"%s: unable to replay command %u (OpenCL error %d: %s).",
+			CCL_STRD, i, ocl_status, ccl_err(ocl_status));
+
+		/* Keep event if other commands depend on this one, and hand it
+		 * over to the queue, naming its wrapper if required. */
+		if (event != NULL) {
+			CCLEvent* evt;
+			if (cmd->has_dependents) {
+				clRetainEvent(event);
+				cg->events[i] = event;
+			}
+			evt = ccl_queue_produce_event(queues[cmd->queue_idx], event);
+			if ((evt != NULL) && (cmd->name != NULL))
+				ccl_event_set_name(evt, cmd->name);
+		}
+
+	}
+
+	/* Clear event wait list. */
+	ccl_event_wait_list_clear(evt_wait_lst);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Release events kept during this replay. */
+	for (guint j = 0; j < i; ++j) {
+		if (cg->events[j] != NULL) {
+			clReleaseEvent(cg->events[j]);
+			cg->events[j] = NULL;
+		}
+	}
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/** @} */
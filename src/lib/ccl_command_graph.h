@@ -0,0 +1,199 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Definition of classes and methods for recording and replaying
+ * sequences of OpenCL commands.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_COMMAND_GRAPH_H_
+#define _CCL_COMMAND_GRAPH_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_queue_wrapper.h"
+#include "ccl_kernel_wrapper.h"
+#include "ccl_buffer_wrapper.h"
+#include "ccl_image_wrapper.h"
+
+/**
+ * @defgroup CCL_COMMAND_GRAPH Command graphs
+ *
+ * The command graph module provides classes and methods for recording
+ * a sequence of OpenCL commands, together with their dependencies,
+ * and replaying it many times with minimal host overhead.
+ *
+ * @warning The functions in this module are not thread-safe.
+ *
+ * Commands are recorded with the `ccl_command_graph_add_*()`
+ * functions, which return a non-negative command index. Each command
+ * is associated with a queue index, which selects the command queue
+ * in which the command will be enqueued from the array of queues
+ * passed to ::ccl_command_graph_replay(). This allows the same graph
+ * to be replayed in different queues, or with all queue indexes mapped
+ * to the same queue. Dependencies between commands are specified as
+ * arrays of indexes of previously recorded commands, and are
+ * automatically translated into event wait lists during replay. A
+ * special command added with ::ccl_command_graph_add_wait() blocks the
+ * host until its dependencies are complete.
+ *
+ * Kernel arguments are captured when kernel commands are recorded.
+ * Memory objects used by recorded commands can be exchanged between
+ * replays with ::ccl_command_graph_swap_memobjs(), which is useful for
+ * ping-pong buffers, while individual kernel arguments can be updated
+ * with ::ccl_command_graph_set_kernel_arg().
+ *
+ * Replaying a graph does not perform any heap allocation in the
+ * steady state, apart from the event wrappers produced by queues in
+ * tracked mode. Events produced during replay are handed to their
+ * queues with ::ccl_queue_produce_event(), so commands replayed in
+ * tracked queues can be analyzed by the @ref CCL_PROFILER "profiler
+ * module", while queues in untracked mode (see
+ * ::ccl_queue_set_untracked()) avoid event wrapping altogether.
+ *
+ * Wrapper objects used by recorded commands (kernels, memory objects
+ * and samplers) are referenced by the graph, and released when the
+ * graph is destroyed, so client code may destroy its own references
+ * in the meantime. Host pointers used by recorded transfers are not
+ * copied, and must remain valid while the graph is in use.
+ *
+ * _Example:_
+ *
+ * @code{.c}
+ * CCLCommandGraph* cg;
+ * CCLQueue* queues[2];
+ * cl_int cmd_read, cmd_exec;
+ * @endcode
+ * @code{.c}
+ * cg = ccl_command_graph_new();
+ * cmd_read = ccl_command_graph_add_image_read(cg, 0, img1, CL_FALSE,
+ *     origin, region, 0, 0, host_img, 0, NULL);
+ * cmd_exec = ccl_command_graph_add_kernel(cg, 1, krnl, 2, NULL, gws, lws,
+ *     (void*[]) { img1, img2, NULL }, 0, NULL);
+ * ccl_command_graph_add_wait(cg, 2, (cl_int[]) { cmd_read, cmd_exec });
+ * @endcode
+ * @code{.c}
+ * for (i = 0; i < n; ++i) {
+ *     ccl_command_graph_replay(cg, queues, 2, NULL, NULL);
+ *     ccl_command_graph_swap_memobjs(cg, (CCLMemObj*) img1, (CCLMemObj*) img2);
+ * }
+ * @endcode
+ * @code{.c}
+ * ccl_command_graph_destroy(cg);
+ * @endcode
+ *
+ * @{
+ */
+
+/**
+ * Command graph class.
+ * */
+typedef struct ccl_command_graph CCLCommandGraph;
+
+/* Create a new command graph object. */
+CCL_EXPORT
+CCLCommandGraph* ccl_command_graph_new(void);
+
+/* Destroy a command graph object. */
+CCL_EXPORT
+void ccl_command_graph_destroy(CCLCommandGraph* cg);
+
+/* Record a kernel execution command. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_kernel(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLKernel* krnl, cl_uint work_dim,
+	const size_t* global_work_offset, const size_t* global_work_size,
+	const size_t* local_work_size, void** args,
+	cl_uint num_deps, const cl_int* deps);
+
+/* Record a buffer read command. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_buffer_read(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLBuffer* buf, cl_bool blocking_read,
+	size_t offset, size_t size, void* ptr,
+	cl_uint num_deps, const cl_int* deps);
+
+/* Record a buffer write command. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_buffer_write(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLBuffer* buf, cl_bool blocking_write,
+	size_t offset, size_t size, void* ptr,
+	cl_uint num_deps, const cl_int* deps);
+
+/* Record a buffer copy command. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_buffer_copy(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLBuffer* src_buf, CCLBuffer* dst_buf,
+	size_t src_offset, size_t dst_offset, size_t size,
+	cl_uint num_deps, const cl_int* deps);
+
+/* Record an image read command. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_image_read(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLImage* img, cl_bool blocking_read,
+	const size_t* origin, const size_t* region, size_t row_pitch,
+	size_t slice_pitch, void* ptr, cl_uint num_deps, const cl_int* deps);
+
+/* Record an image write command. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_image_write(CCLCommandGraph* cg,
+	cl_uint queue_idx, CCLImage* img, cl_bool blocking_write,
+	const size_t* origin, const size_t* region, size_t input_row_pitch,
+	size_t input_slice_pitch, void* ptr,
+	cl_uint num_deps, const cl_int* deps);
+
+/* Record a command which blocks the host until the given commands are
+ * complete. */
+CCL_EXPORT
+cl_int ccl_command_graph_add_wait(CCLCommandGraph* cg,
+	cl_uint num_deps, const cl_int* deps);
+
+/* Update an argument of a recorded kernel execution command. */
+CCL_EXPORT
+void ccl_command_graph_set_kernel_arg(CCLCommandGraph* cg,
+	cl_int cmd, cl_uint arg_index, void* arg);
+
+/* Set the name of the events produced by a recorded command. */
+CCL_EXPORT
+void ccl_command_graph_set_name(CCLCommandGraph* cg,
+	cl_int cmd, const char* name);
+
+/* Exchange two memory objects in all recorded commands. */
+CCL_EXPORT
+void ccl_command_graph_swap_memobjs(CCLCommandGraph* cg,
+	CCLMemObj* mo1, CCLMemObj* mo2);
+
+/* Get the number of recorded commands. */
+CCL_EXPORT
+cl_uint ccl_command_graph_get_num_commands(CCLCommandGraph* cg);
+
+/* Replay the recorded commands in the given command queues. */
+CCL_EXPORT
+cl_bool ccl_command_graph_replay(CCLCommandGraph* cg,
+	CCLQueue* const* queues, cl_uint num_queues,
+	CCLEventWaitList* evt_wait_lst, CCLErr** err);
+
+/** @} */
+
+#endif
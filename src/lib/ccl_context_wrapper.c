@@ -252,6 +252,9 @@ CCLContext* ccl_context_new_from_filters_full(
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Error reporting object. */
 	CCLErr* err_internal = NULL;
 
@@ -291,6 +294,9 @@ finish:
 	/* Free array object containing device wrappers. */
 	if (devices != NULL) g_ptr_array_free(devices, TRUE);
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return ctx. */
 	return ctx;
 }
@@ -328,6 +334,9 @@ CCLContext* ccl_context_new_from_devices_full(
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Array of unwrapped devices. */
 	cl_device_id* cl_devices = NULL;
 	/* Context properties, in case the properties parameter is NULL. */
@@ -384,6 +393,9 @@ finish:
 	ccl_context_properties_default_free(properties, ctx_props);
 	g_slice_free1(sizeof(cl_device_id) * num_devices, cl_devices);
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return result of function call. */
 	return ctx;
 
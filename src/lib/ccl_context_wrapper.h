@@ -373,7 +373,7 @@ CCLDevice* const* ccl_context_get_all_devices(CCLContext* ctx,
  * If an error occurs, zero is returned.
  * */
 #define ccl_context_get_info_scalar(ctx, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) ctx, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) ctx, \
 		NULL, param_name, sizeof(param_type), \
 		CCL_INFO_CONTEXT, CL_FALSE, err))
 
@@ -144,6 +144,151 @@ const char* ccl_event_get_name(CCLEvent* evt) {
 
 }
 
+/**
+ * @internal
+ * Get a name for the given type of command, used as the final name of
+ * events without a name.
+ *
+ * @private @memberof ccl_event
+ *
+ * @param[in] ct Command type.
+ * @return Name of command type.
+ * */
+static const char* ccl_event_command_type_name(cl_command_type ct) {
+
+	/* Name to return. */
+	const char* final_name;
+
+	switch (ct) {
+		case CL_COMMAND_NDRANGE_KERNEL:
+			final_name = "NDRANGE_KERNEL";
+			break;
+		case CL_COMMAND_NATIVE_KERNEL:
+			final_name = "NATIVE_KERNEL";
+			break;
+		case CL_COMMAND_READ_BUFFER:
+			final_name = "READ_BUFFER";
+			break;
+		case CL_COMMAND_WRITE_BUFFER:
+			final_name = "WRITE_BUFFER";
+			break;
+		case CL_COMMAND_COPY_BUFFER:
+			final_name = "COPY_BUFFER";
+			break;
+		case CL_COMMAND_READ_IMAGE:
+			final_name = "READ_IMAGE";
+			break;
+		case CL_COMMAND_WRITE_IMAGE:
+			final_name = "WRITE_IMAGE";
+			break;
+		case CL_COMMAND_COPY_IMAGE:
+			final_name = "COPY_IMAGE";
+			break;
+		case CL_COMMAND_COPY_BUFFER_TO_IMAGE:
+			final_name = "COPY_BUFFER_TO_IMAGE";
+			break;
+		case CL_COMMAND_COPY_IMAGE_TO_BUFFER:
+			final_name = "COPY_IMAGE_TO_BUFFER";
+			break;
+		case CL_COMMAND_MAP_BUFFER:
+			final_name = "MAP_BUFFER";
+			break;
+		case CL_COMMAND_MAP_IMAGE:
+			final_name = "MAP_IMAGE";
+			break;
+		case CL_COMMAND_UNMAP_MEM_OBJECT:
+			final_name = "UNMAP_MEM_OBJECT";
+			break;
+		case CL_COMMAND_MARKER:
+			final_name = "MARKER";
+			break;
+		case CL_COMMAND_ACQUIRE_GL_OBJECTS:
+			final_name = "ACQUIRE_GL_OBJECTS";
+			break;
+		case CL_COMMAND_RELEASE_GL_OBJECTS:
+			final_name = "RELEASE_GL_OBJECTS";
+			break;
+		case CL_COMMAND_READ_BUFFER_RECT:
+			final_name = "READ_BUFFER_RECT";
+			break;
+		case CL_COMMAND_WRITE_BUFFER_RECT:
+			final_name = "WRITE_BUFFER_RECT";
+			break;
+		case CL_COMMAND_COPY_BUFFER_RECT:
+			final_name = "COPY_BUFFER_RECT";
+			break;
+		case CL_COMMAND_USER:
+			/* This is here just for completeness, as a user
+			 * event can't be profiled. */
+			final_name = "USER";
+			break;
+		case CL_COMMAND_BARRIER:
+			final_name = "BARRIER";
+			break;
+		case CL_COMMAND_MIGRATE_MEM_OBJECTS:
+			final_name = "MIGRATE_MEM_OBJECTS";
+			break;
+		case CL_COMMAND_FILL_BUFFER:
+			final_name = "FILL_BUFFER";
+			break;
+		case CL_COMMAND_FILL_IMAGE:
+			final_name = "FILL_IMAGE";
+			break;
+		case CL_COMMAND_SVM_FREE:
+			final_name = "SVM_FREE";
+			break;
+		case CL_COMMAND_SVM_MEMCPY:
+			final_name = "SVM_MEMCPY";
+			break;
+		case CL_COMMAND_SVM_MEMFILL:
+			final_name = "SVM_MEMFILL";
+			break;
+		case CL_COMMAND_SVM_MAP:
+			final_name = "SVM_MAP";
+			break;
+		case CL_COMMAND_SVM_UNMAP:
+			final_name = "SVM_UNMAP";
+			break;
+		case CL_COMMAND_GL_FENCE_SYNC_OBJECT_KHR:
+			final_name = "GL_FENCE_SYNC_OBJECT_KHR";
+			break;
+		case CL_COMMAND_ACQUIRE_D3D10_OBJECTS_KHR:
+			final_name = "ACQUIRE_D3D10_OBJECTS_KHR";
+			break;
+		case CL_COMMAND_RELEASE_D3D10_OBJECTS_KHR:
+			final_name = "RELEASE_D3D10_OBJECTS_KHR";
+			break;
+		case CL_COMMAND_ACQUIRE_DX9_MEDIA_SURFACES_KHR:
+			final_name = "ACQUIRE_DX9_MEDIA_SURFACES_KHR";
+			break;
+		case CL_COMMAND_RELEASE_DX9_MEDIA_SURFACES_KHR:
+			final_name = "RELEASE_DX9_MEDIA_SURFACES_KHR";
+			break;
+		case CL_COMMAND_ACQUIRE_D3D11_OBJECTS_KHR:
+			final_name = "ACQUIRE_D3D11_OBJECTS_KHR";
+			break;
+		case CL_COMMAND_RELEASE_D3D11_OBJECTS_KHR:
+			final_name = "RELEASE_D3D11_OBJECTS_KHR";
+			break;
+		case CL_COMMAND_ACQUIRE_EGL_OBJECTS_KHR:
+			final_name = "ACQUIRE_EGL_OBJECTS_KHR";
+			break;
+		case CL_COMMAND_RELEASE_EGL_OBJECTS_KHR:
+			final_name = "RELEASE_EGL_OBJECTS_KHR";
+			break;
+		case CL_COMMAND_EGL_FENCE_SYNC_OBJECT_KHR:
+			final_name = "EGL_FENCE_SYNC_OBJECT_KHR";
+			break;
+		default:
+			final_name = "UNKNOWN";
+			g_warning("Unknown event command type: 0x%x", ct);
+			break;
+	}
+
+	/* Return name. */
+	return final_name;
+}
+
 /**
  * Get the final event name for profiling purposes. If a name was not
  * explicitly set with ccl_event_set_name(), it will return a name
@@ -189,131 +334,7 @@ const char* ccl_event_get_final_name(CCLEvent* evt) {
 			return NULL;
 		}
 
-		switch (ct) {
-			case CL_COMMAND_NDRANGE_KERNEL:
-				final_name = "NDRANGE_KERNEL";
-				break;
-			case CL_COMMAND_NATIVE_KERNEL:
-				final_name = "NATIVE_KERNEL";
-				break;
-			case CL_COMMAND_READ_BUFFER:
-				final_name = "READ_BUFFER";
-				break;
-			case CL_COMMAND_WRITE_BUFFER:
-				final_name = "WRITE_BUFFER";
-				break;
-			case CL_COMMAND_COPY_BUFFER:
-				final_name = "COPY_BUFFER";
-				break;
-			case CL_COMMAND_READ_IMAGE:
-				final_name = "READ_IMAGE";
-				break;
-			case CL_COMMAND_WRITE_IMAGE:
-				final_name = "WRITE_IMAGE";
-				break;
-			case CL_COMMAND_COPY_IMAGE:
-				final_name = "COPY_IMAGE";
-				break;
-			case CL_COMMAND_COPY_BUFFER_TO_IMAGE:
-				final_name = "COPY_BUFFER_TO_IMAGE";
-				break;
-			case CL_COMMAND_COPY_IMAGE_TO_BUFFER:
-				final_name = "COPY_IMAGE_TO_BUFFER";
-				break;
-			case CL_COMMAND_MAP_BUFFER:
-				final_name = "MAP_BUFFER";
-				break;
-			case CL_COMMAND_MAP_IMAGE:
-				final_name = "MAP_IMAGE";
-				break;
-			case CL_COMMAND_UNMAP_MEM_OBJECT:
-				final_name = "UNMAP_MEM_OBJECT";
-				break;
-			case CL_COMMAND_MARKER:
-				final_name = "MARKER";
-				break;
-			case CL_COMMAND_ACQUIRE_GL_OBJECTS:
-				final_name = "ACQUIRE_GL_OBJECTS";
-				break;
-			case CL_COMMAND_RELEASE_GL_OBJECTS:
-				final_name = "RELEASE_GL_OBJECTS";
-				break;
-			case CL_COMMAND_READ_BUFFER_RECT:
-				final_name = "READ_BUFFER_RECT";
-				break;
-			case CL_COMMAND_WRITE_BUFFER_RECT:
-				final_name = "WRITE_BUFFER_RECT";
-				break;
-			case CL_COMMAND_COPY_BUFFER_RECT:
-				final_name = "COPY_BUFFER_RECT";
-				break;
-			case CL_COMMAND_USER:
-				/* This is here just for completeness, as a user
-				 * event can't be profiled. */
-				final_name = "USER";
-				break;
-			case CL_COMMAND_BARRIER:
-				final_name = "BARRIER";
-				break;
-			case CL_COMMAND_MIGRATE_MEM_OBJECTS:
-				final_name = "MIGRATE_MEM_OBJECTS";
-				break;
-			case CL_COMMAND_FILL_BUFFER:
-				final_name = "FILL_BUFFER";
-				break;
-			case CL_COMMAND_FILL_IMAGE:
-				final_name = "FILL_IMAGE";
-				break;
-			case CL_COMMAND_SVM_FREE:
-				final_name = "SVM_FREE";
-				break;
-			case CL_COMMAND_SVM_MEMCPY:
-				final_name = "SVM_MEMCPY";
-				break;
-			case CL_COMMAND_SVM_MEMFILL:
-				final_name = "SVM_MEMFILL";
-				break;
-			case CL_COMMAND_SVM_MAP:
-				final_name = "SVM_MAP";
-				break;
-			case CL_COMMAND_SVM_UNMAP:
-				final_name = "SVM_UNMAP";
-				break;
-			case CL_COMMAND_GL_FENCE_SYNC_OBJECT_KHR:
-				final_name = "GL_FENCE_SYNC_OBJECT_KHR";
-				break;
-			case CL_COMMAND_ACQUIRE_D3D10_OBJECTS_KHR:
-				final_name = "ACQUIRE_D3D10_OBJECTS_KHR";
-				break;
-			case CL_COMMAND_RELEASE_D3D10_OBJECTS_KHR:
-				final_name = "RELEASE_D3D10_OBJECTS_KHR";
-				break;
-			case CL_COMMAND_ACQUIRE_DX9_MEDIA_SURFACES_KHR:
-				final_name = "ACQUIRE_DX9_MEDIA_SURFACES_KHR";
-				break;
-			case CL_COMMAND_RELEASE_DX9_MEDIA_SURFACES_KHR:
-				final_name = "RELEASE_DX9_MEDIA_SURFACES_KHR";
-				break;
-			case CL_COMMAND_ACQUIRE_D3D11_OBJECTS_KHR:
-				final_name = "ACQUIRE_D3D11_OBJECTS_KHR";
-				break;
-			case CL_COMMAND_RELEASE_D3D11_OBJECTS_KHR:
-				final_name = "RELEASE_D3D11_OBJECTS_KHR";
-				break;
-			case CL_COMMAND_ACQUIRE_EGL_OBJECTS_KHR:
-				final_name = "ACQUIRE_EGL_OBJECTS_KHR";
-				break;
-			case CL_COMMAND_RELEASE_EGL_OBJECTS_KHR:
-				final_name = "RELEASE_EGL_OBJECTS_KHR";
-				break;
-			case CL_COMMAND_EGL_FENCE_SYNC_OBJECT_KHR:
-				final_name = "EGL_FENCE_SYNC_OBJECT_KHR";
-				break;
-			default:
-				final_name = "UNKNOWN";
-				g_warning("Unknown event command type: 0x%x", ct);
-				break;
-		}
+		final_name = ccl_event_command_type_name(ct);
 
 	}
 
@@ -361,6 +382,95 @@ cl_command_type ccl_event_get_command_type(
 	return ct;
 }
 
+/**
+ * Get the type of command which fired the given event, the command's
+ * queued, submit, start and end instants, and the final event name,
+ * in a single pass.
+ *
+ * Unlike the info macros, the information is obtained with one direct
+ * call to the OpenCL implementation per field and is not cached in the
+ * event wrapper, so no memory is allocated. As such, this function is
+ * appropriate for post-processing large numbers of events. The command
+ * must be complete, and must have been enqueued in a command queue
+ * with profiling enabled.
+ *
+ * @public @memberof ccl_event
+ *
+ * @param[in] evt Event wrapper.
+ * @param[out] rec Location where to place the event information. The
+ * event name is the one returned by ccl_event_get_final_name().
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return CL_TRUE if function terminates successfully, or CL_FALSE
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_event_get_timestamps(
+	CCLEvent* evt, CCLEventRecord* rec, CCLErr** err) {
+
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Make sure evt wrapper object is not NULL. */
+	g_return_val_if_fail(evt != NULL, CL_FALSE);
+
+	/* Make sure rec is not NULL. */
+	g_return_val_if_fail(rec != NULL, CL_FALSE);
+
+	/* The OpenCL event object. */
+	cl_event event = ccl_event_unwrap(evt);
+	/* Profiling parameters to get... */
+	const cl_profiling_info params[] = { CL_PROFILING_COMMAND_QUEUED,
+		CL_PROFILING_COMMAND_SUBMIT, CL_PROFILING_COMMAND_START,
+		CL_PROFILING_COMMAND_END };
+	/* ...and where to place them. */
+	cl_ulong* instants[] = { &rec->t_queued, &rec->t_submit,
+		&rec->t_start, &rec->t_end };
+	/* OpenCL status. */
+	cl_int ocl_status;
+	/* Function return status. */
+	cl_bool ret_status;
+
+	/* Get command type. */
+	ocl_status = clGetEventInfo(event, CL_EVENT_COMMAND_TYPE,
+		sizeof(cl_command_type), &rec->command_type, NULL);
+	g_if_err_create_goto(*err, CCL_OCL_ERROR,
+		CL_SUCCESS != ocl_status, ocl_status, error_handler,
+		"%s: unable to get event command type (OpenCL error %d: %s).",
+		CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+	/* Get profiling instants. */
+	for (guint i = 0; i < G_N_ELEMENTS(params); ++i) {
+		ocl_status = clGetEventProfilingInfo(event, params[i],
+			sizeof(cl_ulong), instants[i], NULL);
+		g_if_err_create_goto(*err, CCL_OCL_ERROR,
+			CL_SUCCESS != ocl_status, ocl_status, error_handler,
+			"%s: unable to get event profiling info (OpenCL error %d: %s).",
+			CCL_STRD, ocl_status, ccl_err(ocl_status));
+	}
+
+	/* Determine final name from the command type, if required. Names
+	 * are either set by client code or are static strings. */
+	rec->event_name = (evt->name != NULL)
+		? evt->name : ccl_event_command_type_name(rec->command_type);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Return status. */
+	return ret_status;
+
+}
+
 /**
  * Get the OpenCL version of the platform associated with this event
  * object. The version is returned as an integer, in the following
@@ -557,6 +667,9 @@ CCLEvent* ccl_user_event_new(CCLContext* ctx, CCLErr** err) {
 	/* Make sure ctx is not NULL. */
 	g_return_val_if_fail(ctx != NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL status. */
 	cl_int ocl_status;
 	/* Event wrapper object. */
@@ -617,6 +730,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event wrapper. */
 	return evt;
 
@@ -710,6 +826,75 @@ finish:
 
 }
 
+/**
+ * @internal
+ * Initialize event wait list storage.
+ *
+ * @param[out] storage Event wait list storage.
+ * @param[in] dynamic Was the storage dynamically allocated by the
+ * library?
+ * */
+static void ccl_event_wait_list_storage_init(
+	CCLEventWaitListStorage* storage, cl_bool dynamic) {
+
+	storage->num_events = 0;
+	storage->capacity = CCL_EVENT_WAIT_LIST_INLINE_SIZE;
+	storage->dynamic = dynamic;
+	storage->keep = CL_FALSE;
+
+}
+
+/**
+ * @internal
+ * Get the event wait list, allocating it if required.
+ *
+ * @param[in,out] evt_wait_lst Event wait list.
+ * @return Event wait list storage.
+ * */
+static CCLEventWaitListStorage* ccl_event_wait_list_get(
+	CCLEventWaitList* evt_wait_lst) {
+
+	if (*evt_wait_lst == NULL) {
+		*evt_wait_lst = g_slice_new(CCLEventWaitListStorage);
+		ccl_event_wait_list_storage_init(*evt_wait_lst, CL_TRUE);
+	}
+	return *evt_wait_lst;
+
+}
+
+/**
+ * @internal
+ * Append an OpenCL event to an event wait list, moving the events to
+ * the heap (or enlarging heap storage) if the list is full.
+ *
+ * @param[in] ewl Event wait list storage.
+ * @param[in] event OpenCL event to append.
+ * */
+static void ccl_event_wait_list_append(
+	CCLEventWaitListStorage* ewl, cl_event event) {
+
+	/* Enlarge list if required. */
+	if (ewl->num_events == ewl->capacity) {
+		if (ewl->capacity == CCL_EVENT_WAIT_LIST_INLINE_SIZE) {
+			cl_event* heap = g_new(cl_event, 2 * ewl->capacity);
+			memcpy(heap, ewl->events.inl, ewl->num_events * sizeof(cl_event));
+			ewl->events.heap = heap;
+		} else {
+			ewl->events.heap =
+				g_renew(cl_event, ewl->events.heap, 2 * ewl->capacity);
+		}
+		ewl->capacity *= 2;
+	}
+
+	/* Append event. */
+	if (ewl->capacity > CCL_EVENT_WAIT_LIST_INLINE_SIZE)
+		ewl->events.heap[ewl->num_events] = event;
+	else
+		ewl->events.inl[ewl->num_events] = event;
+	ewl->num_events++;
+
+}
+
 /**
  * Add event wrapper objects to an event wait list (variable argument
  * list version).
@@ -731,9 +916,8 @@ CCLEventWaitList* ccl_event_wait_list_add(
 	/* Current event wrapper object. */
 	CCLEvent* evt;
 
-	/* Initialize list if required. */
-	if (*evt_wait_lst == NULL)
-		*evt_wait_lst = g_ptr_array_new();
+	/* Event wait list storage, initialized if required. */
+	CCLEventWaitListStorage* ewl = ccl_event_wait_list_get(evt_wait_lst);
 
 	/* Initialize variable argument list. */
 	va_start(al, evt_wait_lst);
@@ -741,8 +925,8 @@ CCLEventWaitList* ccl_event_wait_list_add(
 	/* Get arguments (i.e. event wrapper objects). */
 	while ((evt = va_arg(al, CCLEvent*)) != NULL) {
 
-		/* Add event wrapper to array. */
-		g_ptr_array_add(*evt_wait_lst, ccl_event_unwrap(evt));
+		/* Add event wrapper to list. */
+		ccl_event_wait_list_append(ewl, ccl_event_unwrap(evt));
 
 	}
 
@@ -750,7 +934,7 @@ CCLEventWaitList* ccl_event_wait_list_add(
 	va_end(al);
 
 	/* Signal bug if no events have been given. */
-	g_return_val_if_fail((*evt_wait_lst)->len > 0, NULL);
+	g_return_val_if_fail(ewl->num_events > 0, NULL);
 
 	/* Return event wait list. */
 	return evt_wait_lst;
@@ -777,15 +961,14 @@ CCLEventWaitList* ccl_event_wait_list_add_v(
 	/* Check that events array contains events. */
 	g_return_val_if_fail(evts[0] != NULL, NULL);
 
-	/* Initialize list if required. */
-	if (*evt_wait_lst == NULL)
-		*evt_wait_lst = g_ptr_array_new();
+	/* Event wait list storage, initialized if required. */
+	CCLEventWaitListStorage* ewl = ccl_event_wait_list_get(evt_wait_lst);
 
 	/* Cycle through array of event wrapper objects. */
 	for (guint i = 0; evts[i] != NULL; ++i) {
 
-		/* Add wrapped cl_event to array. */
-		g_ptr_array_add(*evt_wait_lst, ccl_event_unwrap(evts[i]));
+		/* Add wrapped cl_event to list. */
+		ccl_event_wait_list_append(ewl, ccl_event_unwrap(evts[i]));
 
 	}
 
@@ -801,13 +984,117 @@ CCLEventWaitList* ccl_event_wait_list_add_v(
  * wait lists are automatically cleared when passed to
  * `ccl_*_enqueue_*()` functions.
  *
+ * Dynamically allocated event wait lists (i.e., lists initialized to
+ * `NULL`) are released, and `evt_wait_lst` is set to `NULL`. Event
+ * wait lists initialized with ::ccl_event_wait_list_init() are only
+ * emptied, keeping their capacity. Event wait lists in keep mode (see
+ * ::ccl_event_wait_list_set_keep()) are left intact.
+ *
  * @param[out] evt_wait_lst Event wait list.
  * */
 CCL_EXPORT
 void ccl_event_wait_list_clear(CCLEventWaitList* evt_wait_lst) {
 
+	if ((evt_wait_lst != NULL) && (*evt_wait_lst != NULL)
+		&& (!(*evt_wait_lst)->keep)) {
+
+		if ((*evt_wait_lst)->dynamic)
+			ccl_event_wait_list_dispose(evt_wait_lst);
+		else
+			(*evt_wait_lst)->num_events = 0;
+	}
+}
+
+/**
+ * Initialize a reusable event wait list in caller-provided storage,
+ * for example on the stack. When consumed by `ccl_*_enqueue_*()`
+ * functions, the returned event wait list is emptied but not released,
+ * keeping its capacity, such that it can be reused without additional
+ * allocations. If more than ::CCL_EVENT_WAIT_LIST_INLINE_SIZE events
+ * were added to the list, it should be released with
+ * ::ccl_event_wait_list_dispose() when no longer required.
+ *
+ * @param[out] storage Event wait list storage, which must remain valid
+ * while the event wait list is in use.
+ * @return A reusable, empty, event wait list.
+ * */
+CCL_EXPORT
+CCLEventWaitList ccl_event_wait_list_init(CCLEventWaitListStorage* storage) {
+
+	/* Check that storage is not NULL. */
+	g_return_val_if_fail(storage != NULL, NULL);
+
+	ccl_event_wait_list_storage_init(storage, CL_FALSE);
+	return storage;
+
+}
+
+/**
+ * Set whether `ccl_*_enqueue_*()` functions, as well as
+ * ::ccl_event_wait() and ::ccl_event_wait_list_clear(), should leave the
+ * event wait list intact. This allows the same set of dependencies to
+ * be used by several commands. Lists in keep mode can be emptied with
+ * ::ccl_event_wait_list_reset(), and must be released with
+ * ::ccl_event_wait_list_dispose().
+ *
+ * @param[in,out] evt_wait_lst Event wait list. If the list is `NULL`,
+ * an empty list is allocated.
+ * @param[in] keep `CL_TRUE` to leave the list intact, `CL_FALSE` to
+ * restore the default behavior.
+ * */
+CCL_EXPORT
+void ccl_event_wait_list_set_keep(
+	CCLEventWaitList* evt_wait_lst, cl_bool keep) {
+
+	/* Check that evt_wait_lst is not NULL. */
+	g_return_if_fail(evt_wait_lst != NULL);
+
+	ccl_event_wait_list_get(evt_wait_lst)->keep = keep;
+
+}
+
+/**
+ * Remove all events from an event wait list, keeping its capacity.
+ * Unlike ::ccl_event_wait_list_clear(), this function also empties
+ * lists in keep mode, and never releases the list.
+ *
+ * @param[in,out] evt_wait_lst Event wait list.
+ * */
+CCL_EXPORT
+void ccl_event_wait_list_reset(CCLEventWaitList* evt_wait_lst) {
+
+	if ((evt_wait_lst != NULL) && (*evt_wait_lst != NULL))
+		(*evt_wait_lst)->num_events = 0;
+
+}
+
+/**
+ * Release all memory held by an event wait list, independently of how
+ * it was created or of it being in keep mode. `evt_wait_lst` is set to
+ * `NULL`. Caller-provided storage can be reused with
+ * ::ccl_event_wait_list_init().
+ *
+ * @param[in,out] evt_wait_lst Event wait list.
+ * */
+CCL_EXPORT
+void ccl_event_wait_list_dispose(CCLEventWaitList* evt_wait_lst) {
+
 	if ((evt_wait_lst != NULL) && (*evt_wait_lst != NULL)) {
-		g_ptr_array_free(*evt_wait_lst, TRUE);
+
+		/* Event wait list storage. */
+		CCLEventWaitListStorage* ewl = *evt_wait_lst;
+
+		/* Release heap storage for events, if any. */
+		if (ewl->capacity > CCL_EVENT_WAIT_LIST_INLINE_SIZE)
+			g_free(ewl->events.heap);
+
+		/* Release list itself if dynamically allocated, or reset it
+		 * otherwise. */
+		if (ewl->dynamic)
+			g_slice_free(CCLEventWaitListStorage, ewl);
+		else
+			ccl_event_wait_list_storage_init(ewl, CL_FALSE);
+
 		*evt_wait_lst = NULL;
 	}
 }
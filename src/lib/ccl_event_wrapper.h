@@ -75,9 +75,66 @@
  * * ::ccl_event_get_profiling_info_array()
  * * ::ccl_event_get_profiling_info()
  *
+ * When processing many events, the ::ccl_event_get_timestamps() function
+ * gets the command type and all profiling instants of an event in a
+ * single pass, without caching them in the event wrapper.
+ *
  * @{
  */
 
+/**
+ * Compact profiling record of an event, as obtained with
+ * ccl_event_get_timestamps(). Also used for keeping the profiling
+ * information of events retired by a command queue with a bounded
+ * number of events.
+ *
+ * @see ccl_queue_set_max_events()
+ * */
+typedef struct ccl_event_record {
+
+	/**
+	 * Name of event which the record refers to.
+	 * @public
+	 * */
+	const char* event_name;
+
+	/**
+	 * Type of command which produced the event.
+	 * @public
+	 * */
+	cl_command_type command_type;
+
+	/**
+	 * Device time in nanoseconds when the command identified by event
+	 * is enqueued in a command-queue by the host.
+	 * @public
+	 * */
+	cl_ulong t_queued;
+
+	/**
+	 * Device time counter in nanoseconds when the command identified
+	 * by event that has been enqueued is submitted by the host to the
+	 * device associated with the command-queue.
+	 * @public
+	 * */
+	cl_ulong t_submit;
+
+	/**
+	 * Device time in nanoseconds when the command identified by event
+	 * starts execution on the device.
+	 * @public
+	 * */
+	cl_ulong t_start;
+
+	/**
+	 * Device time in nanoseconds when the command identified by event
+	 * has finished execution on the device.
+	 * @public
+	 * */
+	cl_ulong t_end;
+
+} CCLEventRecord;
+
 /**
  * Prototype for user event callback functions.
  *
@@ -117,6 +174,12 @@ CCL_EXPORT
 cl_command_type ccl_event_get_command_type(
 	CCLEvent* evt, CCLErr** err);
 
+/* Get the command type, profiling instants and final name of the
+ * given event in a single pass. */
+CCL_EXPORT
+cl_bool ccl_event_get_timestamps(
+	CCLEvent* evt, CCLEventRecord* rec, CCLErr** err);
+
 /* Get the OpenCL version of the platform associated with this event
  * object. */
 CCL_EXPORT
@@ -169,7 +232,7 @@ cl_bool ccl_user_event_set_status(
  * If an error occurs, zero is returned.
  * */
 #define ccl_event_get_info_scalar(evt, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) evt, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) evt, \
 		NULL, param_name, sizeof(param_type), CCL_INFO_EVENT, CL_FALSE, err))
 
 /**
@@ -224,7 +287,7 @@ cl_bool ccl_user_event_set_status(
  * If an error occurs, zero is returned.
  * */
 #define ccl_event_get_profiling_info_scalar(evt, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) evt, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) evt, \
 		NULL, param_name, sizeof(param_type), \
 		CCL_INFO_EVENT_PROFILING, CL_FALSE, err))
 
@@ -287,6 +350,20 @@ cl_bool ccl_user_event_set_status(
  * wait lists should be freed with the ::ccl_event_wait_list_clear()
  * function.
  *
+ * Event wait lists keep up to ::CCL_EVENT_WAIT_LIST_INLINE_SIZE events
+ * without additional allocations. Loops which repeatedly enqueue
+ * commands with event dependencies can avoid allocating and freeing a
+ * wait list in each iteration by keeping it in caller-provided storage,
+ * e.g. on the stack, initialized with ::ccl_event_wait_list_init().
+ * Such lists are not freed when consumed by `ccl_*_enqueue_*()`
+ * functions; instead, their length is reset and their capacity is
+ * kept. Additionally, ::ccl_event_wait_list_set_keep() places a wait
+ * list in a mode where `ccl_*_enqueue_*()` functions leave it intact,
+ * such that the same dependencies can be used by several commands. In
+ * any case, lists which may have grown beyond their inline capacity
+ * should be released with ::ccl_event_wait_list_dispose() once no
+ * longer required.
+ *
  * _Example 1:_
  *
  * @code{.c}
@@ -317,11 +394,84 @@ cl_bool ccl_user_event_set_status(
  * ccl_kernel_enqueue_ndrange(krnl, cq2, dim, offset, gws, lws,
  *     ccl_ewl(&evt_wait_lst, evt, NULL), NULL);
  * @endcode
+ *
+ * _Example 3:_
+ *
+ * @code{.c}
+ * CCLEventWaitListStorage ewl_storage;
+ * CCLEventWaitList evt_wait_lst = ccl_event_wait_list_init(&ewl_storage);
+ * @endcode
+ * @code{.c}
+ * for (i = 0; i < n; ++i) {
+ *     evt1 = ccl_buffer_enqueue_read(cq1, a_dev, CL_FALSE, 0, size, a_host[i], NULL, NULL);
+ *     evt2 = ccl_kernel_enqueue_ndrange(krnl, cq2, dim, offset, gws, lws, NULL, NULL);
+ *     ccl_event_wait(ccl_ewl(&evt_wait_lst, evt1, evt2, NULL), NULL);
+ * }
+ * @endcode
+ * @code{.c}
+ * ccl_event_wait_list_dispose(&evt_wait_lst);
+ * @endcode
  * @{
  */
 
-/** A list of event objects on which enqueued commands can wait. */
-typedef GPtrArray* CCLEventWaitList;
+/** Number of events kept in an event wait list without additional
+ * allocations. */
+#define CCL_EVENT_WAIT_LIST_INLINE_SIZE 8
+
+/**
+ * Event wait list storage. Can be provided by client code, e.g. on the
+ * stack, in order to create reusable event wait lists with
+ * ::ccl_event_wait_list_init(). The fields of this structure should
+ * not be directly accessed by client code.
+ * */
+typedef struct ccl_event_wait_list {
+
+	/**
+	 * Number of events in list.
+	 * @private
+	 * */
+	cl_uint num_events;
+
+	/**
+	 * Number of events which can be kept in list without
+	 * reallocation.
+	 * @private
+	 * */
+	cl_uint capacity;
+
+	/**
+	 * Was the list dynamically allocated by the library?
+	 * @private
+	 * */
+	cl_bool dynamic;
+
+	/**
+	 * Should `ccl_*_enqueue_*()` functions leave the list intact?
+	 * @private
+	 * */
+	cl_bool keep;
+
+	/**
+	 * OpenCL events, kept inline if they fit, or on the heap
+	 * otherwise.
+	 * @private
+	 * */
+	union {
+		cl_event inl[CCL_EVENT_WAIT_LIST_INLINE_SIZE];
+		cl_event* heap;
+	} events;
+
+} CCLEventWaitListStorage;
+
+/**
+ * A list of event objects on which enqueued commands can wait.
+ *
+ * @attention Up to version 2.1.0, this type was a GLib pointer array.
+ * Client code which relied on that must be updated, and client code
+ * built against previous versions must be rebuilt (see
+ * @ref ug_deps_ewl "event wait lists" in the user guide).
+ * */
+typedef CCLEventWaitListStorage* CCLEventWaitList;
 
 /**
  * Alias the for the ::ccl_event_wait_list_add() function. Intended as
@@ -345,6 +495,24 @@ CCLEventWaitList* ccl_event_wait_list_add_v(
 CCL_EXPORT
 void ccl_event_wait_list_clear(CCLEventWaitList* evt_wait_lst);
 
+/* Initialize a reusable event wait list in caller-provided storage. */
+CCL_EXPORT
+CCLEventWaitList ccl_event_wait_list_init(CCLEventWaitListStorage* storage);
+
+/* Set whether `ccl_*_enqueue_*()` functions should leave the event
+ * wait list intact. */
+CCL_EXPORT
+void ccl_event_wait_list_set_keep(
+	CCLEventWaitList* evt_wait_lst, cl_bool keep);
+
+/* Remove all events from an event wait list, keeping its capacity. */
+CCL_EXPORT
+void ccl_event_wait_list_reset(CCLEventWaitList* evt_wait_lst);
+
+/* Release all memory held by an event wait list. */
+CCL_EXPORT
+void ccl_event_wait_list_dispose(CCLEventWaitList* evt_wait_lst);
+
 /**
  * @internal
  * Get number of events in the event wait list.
@@ -357,7 +525,7 @@ void ccl_event_wait_list_clear(CCLEventWaitList* evt_wait_lst);
  * */
 #define ccl_event_wait_list_get_num_events(evt_wait_lst) \
 	((((evt_wait_lst) != NULL) && (*(evt_wait_lst) != NULL)) \
-	? (*(evt_wait_lst))->len \
+	? (*(evt_wait_lst))->num_events \
 	: 0)
 
 /**
@@ -368,11 +536,16 @@ void ccl_event_wait_list_clear(CCLEventWaitList* evt_wait_lst);
  * rarely be called from client code.
  *
  * @param[in] evt_wait_lst Event wait list.
- * @return Array of OpenCL cl_event objects in the event wait list.
+ * @return Array of OpenCL cl_event objects in the event wait list, or
+ * `NULL` if the list is empty.
  * */
 #define ccl_event_wait_list_get_clevents(evt_wait_lst) \
-	((((evt_wait_lst) != NULL) && (*(evt_wait_lst) != NULL)) \
-		? (const cl_event*) (*(evt_wait_lst))->pdata \
+	((((evt_wait_lst) != NULL) && (*(evt_wait_lst) != NULL) \
+		&& ((*(evt_wait_lst))->num_events > 0)) \
+		? (const cl_event*) ((*(evt_wait_lst))->capacity \
+			> CCL_EVENT_WAIT_LIST_INLINE_SIZE \
+			? (*(evt_wait_lst))->events.heap \
+			: (*(evt_wait_lst))->events.inl) \
 		: NULL)
 
 /** @} */
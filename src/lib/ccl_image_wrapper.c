@@ -234,6 +234,9 @@ CCLImage* ccl_image_new_v(CCLContext* ctx, cl_mem_flags flags,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Image wrapper object. */
 	CCLImage* img = NULL;
 	/* OpenCL image object. */
@@ -319,6 +322,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return image wrapper. */
 	return img;
 
@@ -494,6 +500,9 @@ CCLEvent* ccl_image_enqueue_read(CCLImage* img, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -533,6 +542,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -584,6 +596,9 @@ CCLEvent* ccl_image_enqueue_write(CCLImage* img, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -623,6 +638,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -673,6 +691,9 @@ CCLEvent* ccl_image_enqueue_copy(CCLImage* src_img, CCLImage* dst_img,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -712,6 +733,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -761,6 +785,9 @@ CCLEvent* ccl_image_enqueue_copy_to_buffer(CCLImage* src_img,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -800,6 +827,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -858,6 +888,9 @@ void* ccl_image_enqueue_map(CCLImage* img, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_event event = NULL;
 	CCLEvent* evt_inner = NULL;
@@ -898,6 +931,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt_inner);
+
 	/* Return host pointer. */
 	return ptr;
 
@@ -942,6 +978,9 @@ CCLEvent* ccl_image_enqueue_fill(CCLImage* img, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event object. */
@@ -1018,6 +1057,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -315,7 +315,7 @@ CCLEvent* ccl_image_enqueue_fill(CCLImage* img, CCLQueue* cq,
  * If an error occurs, zero is returned.
  * */
 #define ccl_image_get_info_scalar(img, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) img, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) img, \
 		NULL, param_name, sizeof(param_type), CCL_INFO_IMAGE, CL_FALSE, err))
 
 /**
@@ -29,6 +29,7 @@
 
 #include "ccl_kernel_arg.h"
 #include "_ccl_abstract_wrapper.h"
+#include "_ccl_kernel_wrapper.h"
 
 /**
  * @internal
@@ -78,9 +79,12 @@ CCLArg* ccl_arg_new(void* value, size_t size) {
 	/* Make sure size is > 0. */
 	g_return_val_if_fail(size > 0, NULL);
 
-	CCLArg* arg = g_slice_new(CCLArg);
+	/* The argument and a copy of its value are kept in a single block.
+	 * Arguments without value (local memory) don't require a copy. */
+	CCLArg* arg = g_slice_alloc(sizeof(CCLArg) + (value != NULL ? size : 0));
 
-	arg->cl_object = g_memdup((const void*) value, (guint) size);
+	arg->cl_object = (value != NULL)
+		? memcpy((void*) (arg + 1), value, size) : NULL;
 	arg->info = (void*) &arg_local_marker;
 	arg->ref_count = (gint) size;
 
@@ -103,11 +107,28 @@ void ccl_arg_destroy(CCLArg* arg) {
 	g_return_if_fail(arg != NULL);
 
 	if ccl_arg_is_local(arg) {
-		g_free(arg->cl_object);
-		g_slice_free(CCLArg, arg);
+		g_slice_free1(sizeof(CCLArg) + (arg->cl_object != NULL
+			? (size_t) arg->ref_count : 0), arg);
 	}
 }
 
+/**
+ * @internal
+ * Is the given kernel argument a wrapper object (e.g. a memory object
+ * or a sampler), instead of a local or private argument?
+ *
+ * @param[in] arg Kernel argument.
+ * @return `CL_TRUE` if argument is a wrapper object, `CL_FALSE`
+ * otherwise.
+ * */
+cl_bool ccl_arg_is_wrapper(CCLArg* arg) {
+
+	/* Make sure arg is not NULL. */
+	g_return_val_if_fail(arg != NULL, CL_FALSE);
+
+	return ccl_arg_is_local(arg) ? CL_FALSE : CL_TRUE;
+}
+
 /**
  * @internal
  * Get size in bytes of kernel argument.
@@ -107,11 +107,17 @@ void* ccl_arg_value(CCLArg* arg);
  *
  * @note The ::ccl_arg_local() and ::ccl_arg_priv() macros invoke the
  * ::ccl_arg_new() function, which returns a new ::CCLArg* object. ::CCLArg*
- * objects are destroyed when the kernel to which they were passed is released.
+ * objects are destroyed as soon as they are passed to a kernel, which keeps
+ * its own copy of the argument value.
  * For further control of argument instantiation, client code can use the
  * ::ccl_arg_full() macro instead of the ::ccl_arg_new() function in order to
  * respect the @ref ug_new_destroy "new/destroy" rule.
  *
+ * @note Kernel launches which must not perform any heap allocation can
+ * set private and local arguments with ::ccl_kernel_set_arg_value()
+ * instead, which copies the argument value directly into the kernel
+ * wrapper.
+ *
  * @attention A ::CCLArg* object can only be passed once to a kernel.
  * One way to guarantee this is to use the macros directly when setting
  * the kernel arguments, as shown in the example above.
@@ -129,8 +135,8 @@ extern const CCLArg* ccl_arg_skip;
 /**
  * Define a private kernel argument.
  *
- * The created object is automatically released when kernel is
- * enqueued.
+ * The created object is automatically released when it is passed
+ * to a kernel.
  *
  * @param[in] value Argument value. Must be a variable, not a literal
  * value.
@@ -145,8 +151,8 @@ extern const CCLArg* ccl_arg_skip;
  * Defines a local kernel argument, which allocates local memory
  * within the kernel with the specified size.
  *
- * The created object is automatically released when kernel is
- * enqueued.
+ * The created object is automatically released when it is passed
+ * to a kernel.
  *
  * @param[in] count Number of values of type given in next parameter.
  * @param[in] type Argument scalar type, such as `cl_int`, `cl_float`,
@@ -159,8 +165,8 @@ extern const CCLArg* ccl_arg_skip;
 /**
  * Defines a kernel argument with more control.
  *
- * The created object is automatically released when kernel is
- * enqueued.
+ * The created object is automatically released when it is passed
+ * to a kernel.
  *
  * @param[in] value Memory location of argument value. Can be NULL if
  * argument is local.
@@ -30,8 +30,88 @@
 #include "ccl_kernel_wrapper.h"
 #include "ccl_program_wrapper.h"
 #include "_ccl_abstract_wrapper.h"
+#include "_ccl_kernel_wrapper.h"
+#include "_ccl_program_wrapper.h"
 #include "_ccl_defs.h"
 
+/* Maximum size of argument values kept inline in argument slots. */
+#define CCL_KERNEL_ARG_INLINE_SIZE 64
+
+/* Maximum number of work size suggestions cached by a kernel
+ * wrapper. */
+#define CCL_KERNEL_WS_CACHE_MAX 64
+
+/* Maximum number of candidate local work sizes timed by the
+ * autotuner. */
+#define CCL_KERNEL_AUTOTUNE_MAX_CANDS 64
+
+/**
+ * @internal
+ * Copy of a kernel argument value, kept inline for small values (e.g.
+ * scalars, vectors and memory objects), and on the heap otherwise.
+ * */
+typedef struct ccl_kernel_arg_value {
+
+	/**
+	 * Size of the argument value, or zero if not set.
+	 * @private
+	 * */
+	size_t size;
+
+	/**
+	 * Is the argument value `NULL`, as is the case for local memory
+	 * arguments?
+	 * @private
+	 * */
+	gboolean is_null;
+
+	/**
+	 * Is the argument value the handle of an OpenCL memory object or
+	 * sampler? Such values are always set, since the handle of a
+	 * released object can be reused by a new object.
+	 * @private
+	 * */
+	gboolean is_handle;
+
+	/**
+	 * Argument value.
+	 * @private
+	 * */
+	union {
+		guint8 inl[CCL_KERNEL_ARG_INLINE_SIZE];
+		void* heap;
+	} value;
+
+} CCLKernelArgValue;
+
+/**
+ * @internal
+ * Kernel argument slot, holding the argument value to set before the
+ * next kernel execution, and the argument value currently set in the
+ * OpenCL kernel object.
+ * */
+typedef struct ccl_kernel_arg_slot {
+
+	/**
+	 * Argument value to set before the next kernel execution.
+	 * @private
+	 * */
+	CCLKernelArgValue pending;
+
+	/**
+	 * Argument value currently set in the OpenCL kernel object.
+	 * @private
+	 * */
+	CCLKernelArgValue current;
+
+	/**
+	 * Was the argument updated since the last kernel execution?
+	 * @private
+	 * */
+	gboolean dirty;
+
+} CCLKernelArgSlot;
+
 /**
  * Kernel wrapper class.
  *
@@ -46,13 +126,242 @@ struct ccl_kernel {
 	CCLWrapper base;
 
 	/**
-	 * Kernel arguments.
+	 * Kernel argument slots, indexed by argument index.
+	 * @private
+	 * */
+	CCLKernelArgSlot* args;
+
+	/**
+	 * Number of kernel argument slots.
+	 * @private
+	 * */
+	cl_uint num_slots;
+
+	/**
+	 * Number of kernel arguments to set before the next kernel
+	 * execution.
+	 * @private
+	 * */
+	cl_uint num_pending;
+
+	/**
+	 * Cache of work sizes suggested by
+	 * ccl_kernel_suggest_worksizes_full(), created on first use and
+	 * cleared when it holds ::CCL_KERNEL_WS_CACHE_MAX suggestions.
+	 * Accesses are protected by `ws_cache_lock`.
 	 * @private
 	 * */
-	GHashTable* args;
+	GHashTable* ws_cache;
 
+	/**
+	 * Generation of the tuning database when the cache of suggested
+	 * work sizes was last validated.
+	 * @private
+	 * */
+	gint ws_cache_gen;
 };
 
+/**
+ * @internal
+ * Get the location of the given argument value, or `NULL` if the
+ * argument value is `NULL`.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] av Argument value.
+ * @return Location of the argument value.
+ * */
+static inline void* ccl_kernel_arg_value_get(CCLKernelArgValue* av) {
+
+	if (av->is_null) return NULL;
+	return av->size > CCL_KERNEL_ARG_INLINE_SIZE
+		? av->value.heap : (void*) av->value.inl;
+
+}
+
+/**
+ * @internal
+ * Clear the given argument value, releasing heap storage if any.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] av Argument value.
+ * */
+static void ccl_kernel_arg_value_clear(CCLKernelArgValue* av) {
+
+	if ((av->size > CCL_KERNEL_ARG_INLINE_SIZE) && (!av->is_null))
+		g_free(av->value.heap);
+	av->size = 0;
+	av->is_null = FALSE;
+	av->is_handle = FALSE;
+
+}
+
+/**
+ * @internal
+ * Keep a copy of an argument value. Heap storage is only used, and
+ * reused if possible, for values larger than
+ * `CCL_KERNEL_ARG_INLINE_SIZE` bytes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] av Argument value where to keep the copy.
+ * @param[in] size Size of argument value.
+ * @param[in] value Location of argument value, or `NULL` for local
+ * memory arguments.
+ * */
+static void ccl_kernel_arg_value_set(
+	CCLKernelArgValue* av, size_t size, const void* value) {
+
+	/* Release or reuse heap storage. */
+	if ((value == NULL) || (size <= CCL_KERNEL_ARG_INLINE_SIZE)
+		|| (av->size != size) || (av->is_null)) {
+
+		ccl_kernel_arg_value_clear(av);
+		if ((value != NULL) && (size > CCL_KERNEL_ARG_INLINE_SIZE))
+			av->value.heap = g_malloc(size);
+	}
+
+	/* Keep copy of value. */
+	av->size = size;
+	av->is_null = (value == NULL);
+	if (value != NULL)
+		memcpy(ccl_kernel_arg_value_get(av), value, size);
+
+}
+
+/**
+ * @internal
+ * Are the given argument values the same?
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] av1 First argument value.
+ * @param[in] av2 Second argument value.
+ * @return `TRUE` if argument values are the same, `FALSE` otherwise.
+ * */
+static gboolean ccl_kernel_arg_value_equal(
+	CCLKernelArgValue* av1, CCLKernelArgValue* av2) {
+
+	return (av1->size == av2->size) && (av1->is_null == av2->is_null)
+		&& ((av1->is_null) || (memcmp(ccl_kernel_arg_value_get(av1),
+			ccl_kernel_arg_value_get(av2), av1->size) == 0));
+
+}
+
+/**
+ * @internal
+ * Set the pending argument value of the given slot in the OpenCL
+ * kernel object, unless it is a private value which is the same as the
+ * value currently set.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @return `CL_SUCCESS` if the argument was set or did not change, or
+ * an OpenCL error code otherwise, in which case the argument remains
+ * pending.
+ * */
+static cl_int ccl_kernel_arg_slot_apply(CCLKernel* krnl, cl_uint arg_index) {
+
+	/* Argument slot. */
+	CCLKernelArgSlot* slot = &krnl->args[arg_index];
+	/* OpenCL status. */
+	cl_int ocl_status = CL_SUCCESS;
+
+	/* Only call clSetKernelArg() if the value differs from the one
+	 * currently set, or if it is the handle of a memory object or
+	 * sampler. */
+	if ((slot->pending.is_handle)
+		|| (!ccl_kernel_arg_value_equal(&slot->pending, &slot->current))) {
+
+		ocl_status = clSetKernelArg(ccl_kernel_unwrap(krnl), arg_index,
+			slot->pending.size, ccl_kernel_arg_value_get(&slot->pending));
+
+		/* Keep a copy of the value which was set, or forget the current
+		 * value if it's not known anymore. */
+		if (ocl_status == CL_SUCCESS) {
+			ccl_kernel_arg_value_set(&slot->current, slot->pending.size,
+				ccl_kernel_arg_value_get(&slot->pending));
+		} else {
+			ccl_kernel_arg_value_clear(&slot->current);
+		}
+	}
+
+	/* Argument is no longer pending. */
+	if (ocl_status == CL_SUCCESS) {
+		slot->dirty = FALSE;
+		krnl->num_pending--;
+	}
+
+	return ocl_status;
+
+}
+
+/**
+ * @internal
+ * Set the pending arguments of the given kernel in the OpenCL kernel
+ * object, skipping those whose value did not change.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[out] arg_index Location where to place the index of the
+ * argument which could not be set, in case of error.
+ * @return `CL_SUCCESS` if all pending arguments were set, or an OpenCL
+ * error code otherwise.
+ * */
+cl_int ccl_kernel_apply_args(CCLKernel* krnl, cl_uint* arg_index) {
+
+	/* OpenCL status. */
+	cl_int ocl_status = CL_SUCCESS;
+
+	for (cl_uint i = 0; (krnl->num_pending > 0) && (i < krnl->num_slots);
+		++i) {
+
+		if (!krnl->args[i].dirty) continue;
+		ocl_status = ccl_kernel_arg_slot_apply(krnl, i);
+		if (ocl_status != CL_SUCCESS) {
+			*arg_index = i;
+			break;
+		}
+	}
+
+	return ocl_status;
+
+}
+
+/**
+ * @internal
+ * Get the argument slot for the given argument index, creating or
+ * enlarging the argument slots if necessary. Slots are initially sized
+ * from the number of kernel arguments.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @return Argument slot for the given argument index.
+ * */
+static CCLKernelArgSlot* ccl_kernel_arg_slot_get(
+	CCLKernel* krnl, cl_uint arg_index) {
+
+	if (arg_index >= krnl->num_slots) {
+		cl_uint num_slots = MAX(arg_index + 1, krnl->num_slots == 0
+			? ccl_kernel_get_info_scalar(
+				krnl, CL_KERNEL_NUM_ARGS, cl_uint, NULL)
+			: 2 * krnl->num_slots);
+		krnl->args = g_renew(CCLKernelArgSlot, krnl->args, num_slots);
+		memset(krnl->args + krnl->num_slots, 0,
+			(num_slots - krnl->num_slots) * sizeof(CCLKernelArgSlot));
+		krnl->num_slots = num_slots;
+	}
+
+	return &krnl->args[arg_index];
+
+}
+
 /**
  * @internal
  * Implementation of ::ccl_wrapper_release_fields() function for
@@ -68,8 +377,15 @@ static void ccl_kernel_release_fields(CCLKernel* krnl) {
 	g_return_if_fail(krnl != NULL);
 
 	/* Free kernel arguments. */
-	if (krnl->args != NULL)
-		g_hash_table_destroy(krnl->args);
+	for (cl_uint i = 0; i < krnl->num_slots; ++i) {
+		ccl_kernel_arg_value_clear(&krnl->args[i].pending);
+		ccl_kernel_arg_value_clear(&krnl->args[i].current);
+	}
+	g_free(krnl->args);
+
+	/* Free cache of suggested work sizes. */
+	if (krnl->ws_cache != NULL)
+		g_hash_table_destroy(krnl->ws_cache);
 
 }
 
@@ -127,6 +443,9 @@ CCLKernel* ccl_kernel_new(
 	/* Make sure kernel_name is not NULL. */
 	g_return_val_if_fail(kernel_name != NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Kernel wrapper object. */
 	CCLKernel* krnl = NULL;
 
@@ -136,9 +455,11 @@ CCLKernel* ccl_kernel_new(
 	/* The OpenCL kernel object. */
 	cl_kernel kernel = NULL;
 
-	/* Create kernel. */
+	/* Create kernel, waiting for asynchronous builds in progress. */
+	ccl_program_kernels_lock(prg);
 	kernel = clCreateKernel(ccl_program_unwrap(prg),
 		kernel_name, &ocl_status);
+	ccl_program_kernels_unlock(prg);
 	g_if_err_create_goto(*err, CCL_OCL_ERROR,
 		CL_SUCCESS != ocl_status, ocl_status, error_handler,
 		"%s: unable to create kernel (OpenCL error %d: %s).",
@@ -160,6 +481,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return kernel wrapper. */
 	return krnl;
 
@@ -185,9 +509,13 @@ void ccl_kernel_destroy(CCLKernel* krnl) {
 /**
  * Set one kernel argument. The argument is not immediatly set with the
  * clSetKernelArg() OpenCL function, but is instead kept in an argument
- * table for this kernel. The clSetKernelArg() function is called only
- * before kernel execution for arguments which have not yet been set or
- * have not been updated meanwhile.
+ * slot for this kernel. The clSetKernelArg() function is called only
+ * before kernel execution for arguments which have been updated
+ * meanwhile, and whose value differs from the one previously set.
+ *
+ * @note As such, client code which sets arguments of the wrapped
+ * OpenCL kernel directly with clSetKernelArg() should not mix this
+ * with the argument functions of the kernel wrapper.
  *
  * @warning This function is not thread-safe. For multi-threaded
  * access to the same kernel function, create multiple instances of
@@ -207,15 +535,112 @@ void ccl_kernel_set_arg(CCLKernel* krnl, cl_uint arg_index, void* arg) {
 	/* Make sure krnl is not NULL. */
 	g_return_if_fail(krnl != NULL);
 
-	/* Initialize table of kernel arguments if necessary. */
-	if (krnl->args == NULL) {
-		krnl->args = g_hash_table_new_full(g_direct_hash,
-			g_direct_equal, NULL, (GDestroyNotify) ccl_arg_destroy);
+	/* Keep a copy of the argument value, and release the argument
+	 * object (this is a no-op for memory object and sampler
+	 * wrappers). */
+	ccl_kernel_set_arg_value_full(krnl, arg_index,
+		ccl_arg_size((CCLArg*) arg), ccl_arg_value((CCLArg*) arg),
+		ccl_arg_is_wrapper((CCLArg*) arg));
+	ccl_arg_destroy((CCLArg*) arg);
+
+}
+
+/**
+ * Set one private or local memory kernel argument from its size and
+ * value, without requiring a ::CCLArg* object. The value is copied, and
+ * values up to 64 bytes are kept inline in the kernel wrapper, without
+ * heap allocations. As with ::ccl_kernel_set_arg(), the clSetKernelArg()
+ * OpenCL function is only called before kernel execution, and only if
+ * the value differs from the one previously set.
+ *
+ * @attention Memory objects and samplers must be set with
+ * ::ccl_kernel_set_arg() instead, since the handle of a released object
+ * can be reused by a new object.
+ *
+ * @warning This function is not thread-safe. For multi-threaded
+ * access to the same kernel function, create multiple instances of
+ * a kernel wrapper for the given kernel function with ccl_kernel_new(),
+ * one for each thread.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg_size Size in bytes of argument value, or the number
+ * of bytes of local memory to allocate if `arg_value` is `NULL`.
+ * @param[in] arg_value Location of argument value, or `NULL` for local
+ * memory arguments.
+ * */
+CCL_EXPORT
+void ccl_kernel_set_arg_value(CCLKernel* krnl, cl_uint arg_index,
+	size_t arg_size, const void* arg_value) {
+
+	/* Make sure krnl is not NULL. */
+	g_return_if_fail(krnl != NULL);
+	/* Make sure arg_size is > 0. */
+	g_return_if_fail(arg_size > 0);
+
+	ccl_kernel_set_arg_value_full(
+		krnl, arg_index, arg_size, arg_value, CL_FALSE);
+
+}
+
+/**
+ * @internal
+ * Set one kernel argument from its size and value, as described in
+ * ::ccl_kernel_set_arg_value(), indicating if the value is the handle
+ * of a memory object or sampler, in which case it is always set before
+ * the next kernel execution.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] arg_index Argument index.
+ * @param[in] arg_size Size in bytes of argument value, or the number
+ * of bytes of local memory to allocate if `arg_value` is `NULL`.
+ * @param[in] arg_value Location of argument value, or `NULL` for local
+ * memory arguments.
+ * @param[in] is_handle Is the argument value the handle of a memory
+ * object or sampler?
+ * */
+void ccl_kernel_set_arg_value_full(CCLKernel* krnl, cl_uint arg_index,
+	size_t arg_size, const void* arg_value, cl_bool is_handle) {
+
+	/* Argument slot. */
+	CCLKernelArgSlot* slot = ccl_kernel_arg_slot_get(krnl, arg_index);
+
+	/* Keep a copy of the argument value, replacing a value not yet
+	 * set. */
+	ccl_kernel_arg_value_set(&slot->pending, arg_size, arg_value);
+	slot->pending.is_handle = is_handle;
+	if (!slot->dirty) {
+		slot->dirty = TRUE;
+		krnl->num_pending++;
 	}
 
-	/* Keep argument in table. */
-	g_hash_table_replace(krnl->args, GUINT_TO_POINTER(arg_index),
-		(gpointer) arg);
+}
+
+/**
+ * @internal
+ * Set kernel arguments from a `NULL`-terminated variable argument
+ * list, in a single pass and without intermediate allocations.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl A kernel wrapper object.
+ * @param[in] args_va A `NULL`-terminated variable argument list of
+ * ::CCLArg*, ::CCLBuffer*, ::CCLImage* or ::CCLSampler* objects.
+ * */
+void ccl_kernel_set_args_va(CCLKernel* krnl, va_list args_va) {
+
+	/* Aux. arg. when cycling through the va_list. */
+	void* aux_arg;
+
+	/* Set each argument, ignoring "skip" arguments. */
+	for (cl_uint i = 0; (aux_arg = va_arg(args_va, void*)) != NULL; ++i) {
+		if (aux_arg == ccl_arg_skip) continue;
+		ccl_kernel_set_arg(krnl, i, aux_arg);
+	}
 
 }
 
@@ -254,55 +679,11 @@ void ccl_kernel_set_args(CCLKernel* krnl, ...) {
 
 	/* The va_list, which represents the variable argument list. */
 	va_list args_va;
-	/* Array of arguments, created from the va_list. */
-	void** args_array = NULL;
-	/* Number of arguments. */
-	guint num_args = 0;
-	/* Aux. arg. when cycling through the va_list. */
-	void* aux_arg;
 
-	/* Initialize the va_list. */
+	/* Set arguments directly from the va_list. */
 	va_start(args_va, krnl);
-
-	/* Get first argument. */
-	aux_arg = va_arg(args_va, void*);
-
-	/* Check if any arguments are given, and if so, populate array
-	 * of arguments. */
-	if (aux_arg != NULL) {
-
-		/* 1. Determine number of arguments. */
-
-		while (aux_arg != NULL) {
-			num_args++;
-			aux_arg = va_arg(args_va, void*);
-		}
-		va_end(args_va);
-
-		/* 2. Populate array of arguments. */
-
-		args_array = g_slice_alloc((num_args + 1) * sizeof(void*));
-		va_start(args_va, krnl);
-
-		for (guint i = 0; i < num_args; ++i) {
-			aux_arg = va_arg(args_va, void*);
-			args_array[i] = aux_arg;
-		}
-		va_end(args_va);
-		args_array[num_args] = NULL;
-
-	}
-
-	/* If any arguments are given... */
-	if (num_args > 0) {
-
-		/* Call the array version of this function.*/
-		ccl_kernel_set_args_v(krnl, args_array);
-
-		/* Free the array of arguments. */
-		g_slice_free1((num_args + 1) * sizeof(void*), args_array);
-
-	}
+	ccl_kernel_set_args_va(krnl, args_va);
+	va_end(args_va);
 
 }
 
@@ -402,6 +783,9 @@ CCLEvent* ccl_kernel_enqueue_ndrange(CCLKernel* krnl, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL status flag. */
 	cl_int ocl_status;
 
@@ -410,25 +794,15 @@ CCLEvent* ccl_kernel_enqueue_ndrange(CCLKernel* krnl, CCLQueue* cq,
 	/* Event wrapper. */
 	CCLEvent* evt;
 
-	/* Iterator for table of kernel arguments. */
-	GHashTableIter iter;
-	gpointer arg_index_ptr, arg_ptr;
+	/* Index of kernel argument. */
+	cl_uint arg_index = 0;
 
 	/* Set pending kernel arguments. */
-	if (krnl->args != NULL) {
-		g_hash_table_iter_init(&iter, krnl->args);
-		while (g_hash_table_iter_next(&iter, &arg_index_ptr, &arg_ptr)) {
-			cl_uint arg_index = GPOINTER_TO_UINT(arg_index_ptr);
-			CCLArg* arg = (CCLArg*) arg_ptr;
-			ocl_status = clSetKernelArg(ccl_kernel_unwrap(krnl), arg_index,
-				ccl_arg_size(arg), ccl_arg_value(arg));
-			g_if_err_create_goto(*err, CCL_OCL_ERROR,
-				CL_SUCCESS != ocl_status, ocl_status, error_handler,
-				"%s: unable to set kernel arg %d (OpenCL error %d: %s).",
-				CCL_STRD, arg_index, ocl_status, ccl_err(ocl_status));
-			g_hash_table_iter_remove(&iter);
-		}
-	}
+	ocl_status = ccl_kernel_apply_args(krnl, &arg_index);
+	g_if_err_create_goto(*err, CCL_OCL_ERROR,
+		CL_SUCCESS != ocl_status, ocl_status, error_handler,
+		"%s: unable to set kernel arg %d (OpenCL error %d: %s).",
+		CCL_STRD, arg_index, ocl_status, ccl_err(ocl_status));
 
 	/* Run kernel. */
 	ocl_status = clEnqueueNDRangeKernel(ccl_queue_unwrap(cq),
@@ -463,6 +837,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return evt. */
 	return evt;
 
@@ -472,8 +849,11 @@ finish:
  * Set kernel arguments and enqueue it for execution on a device.
  *
  * Internally this function sets kernel arguments by calling
- * ::ccl_kernel_set_args_v(), and enqueues the kernel for execution
- * by calling ::ccl_kernel_enqueue_ndrange().
+ * ::ccl_kernel_set_arg() for each argument in the variable argument
+ * list, and enqueues the kernel for execution by calling
+ * ::ccl_kernel_enqueue_ndrange(). The variable argument list is
+ * traversed only once, and no intermediate array of arguments is
+ * allocated.
  *
  * The ::ccl_kernel_set_args_and_enqueue_ndrange_v() function performs
  * the same operation but accepts an array of arguments instead.
@@ -529,57 +909,16 @@ CCLEvent* ccl_kernel_set_args_and_enqueue_ndrange(CCLKernel* krnl, CCLQueue* cq,
 	CCLEvent* evt;
 	/* The va_list, which represents the variable argument list. */
 	va_list args_va;
-	/* Array of arguments, to be created from the va_list. */
-	void** args_array = NULL;
-	/* Number of arguments. */
-	guint num_args = 0;
-	/* Aux. arg. when cycling through the va_list. */
-	void* aux_arg;
 
-	/* Initialize the va_list. */
+	/* Set kernel arguments directly from the va_list. */
 	va_start(args_va, err);
+	ccl_kernel_set_args_va(krnl, args_va);
+	va_end(args_va);
 
-	/* Get first argument. */
-	aux_arg = va_arg(args_va, void*);
-
-	/* Check if any arguments are given, and if so, populate array
-	 * of arguments. */
-	if (aux_arg != NULL) {
-
-		/* 1. Determine number of arguments. */
-
-		while (aux_arg != NULL) {
-			num_args++;
-			aux_arg = va_arg(args_va, void*);
-		}
-		va_end(args_va);
-
-		/* 2. Populate array of arguments. */
-
-		args_array = g_slice_alloc((num_args + 1) * sizeof(void*));
-		va_start(args_va, err);
-
-		for (guint i = 0; i < num_args; ++i) {
-			aux_arg = va_arg(args_va, void*);
-			args_array[i] = aux_arg;
-		}
-		va_end(args_va);
-		args_array[num_args] = NULL;
-
-	}
-
-	/* Set kernel arguments and run it. */
-	evt = ccl_kernel_set_args_and_enqueue_ndrange_v(krnl, cq, work_dim,
+	/* Run kernel. */
+	evt = ccl_kernel_enqueue_ndrange(krnl, cq, work_dim,
 		global_work_offset, global_work_size, local_work_size,
-		evt_wait_lst, args_array, err);
-
-	/* If any arguments are given... */
-	if (num_args > 0) {
-
-		/* Free the array of arguments. */
-		g_slice_free1((num_args + 1) * sizeof(void*), args_array);
-
-	}
+		evt_wait_lst, err);
 
 	/* Return event wrapper. */
 	return evt;
@@ -720,6 +1059,9 @@ CCLEvent* ccl_kernel_enqueue_native(CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL status flag. */
 	cl_int ocl_status;
 	/* OpenCL event. */
@@ -772,6 +1114,9 @@ finish:
 	if (num_mos > 0)
 		g_slice_free1(sizeof(cl_mem) * num_mos, mem_list);
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event wrapper. */
 	return evt;
 
@@ -862,64 +1207,612 @@ finish:
 	}
 
 /**
- * Suggest appropriate local (and optionally global) work sizes for the
- * given real work size, based on device and kernel characteristics.
- *
- * If the `gws` parameter is not `NULL`, it will be populated with a
- * global worksize which may be larger than the real work size
- * in order to better fit the kernel preferred multiple work size. As
- * such, kernels enqueued with global work sizes suggested by this
- * function should check if their global ID is within `real_worksize`.
+ * @internal
+ * Get the divisors of a number which are not larger than the given
+ * limit. The number is factorized by trial division, and the divisors
+ * are generated from its prime factors, such that the cost is
+ * @f$O(\sqrt{n})@f$ instead of @f$O(n)@f$. Trial division stops early
+ * once the candidate prime factors exceed the limit.
  *
- * @public @memberof ccl_kernel
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] n Number to get divisors of.
+ * @param[in] limit Maximum divisor.
+ * @return An array of divisors (of type `size_t`), in no particular
+ * order, which must be freed with g_array_free().
+ * */
+static GArray* ccl_kernel_divisors(size_t n, size_t limit) {
+
+	/* Divisors found so far. */
+	GArray* divs = g_array_new(FALSE, FALSE, sizeof(size_t));
+	/* Number of divisors before processing current prime factor. */
+	guint num_divs;
+	/* Candidate prime factor and divisor. */
+	size_t p, d;
+	/* Exponent of prime factor. */
+	guint e;
+
+	/* One is always a divisor. */
+	d = 1;
+	g_array_append_val(divs, d);
+	if (n == 0) return divs;
+
+	/* Factorize n, and for each prime factor p with exponent e,
+	 * multiply the existing divisors by p, p^2, ..., p^e. */
+	for (p = 2; (p <= n / p) || (n > 1); p = (p == 2) ? 3 : p + 2) {
+
+		/* If p is larger than sqrt(n), then n is prime. */
+		if (p > n / p) p = n;
+
+		/* The remaining prime factors are not smaller than p, so if p
+		 * is larger than the limit, no more divisors can be found. */
+		if (p > limit) break;
+
+		/* Get exponent of p. */
+		for (e = 0; n % p == 0; ++e) n /= p;
+		if (e == 0) continue;
+
+		/* Generate new divisors, discarding those larger than the
+		 * limit (multiplying them by other factors would only make
+		 * them larger). */
+		num_divs = divs->len;
+		for (guint i = 0; i < num_divs; ++i) {
+			d = g_array_index(divs, size_t, i);
+			for (guint k = 0; k < e; ++k) {
+				if (d > limit / p) break;
+				d *= p;
+				g_array_append_val(divs, d);
+			}
+		}
+	}
+
+	return divs;
+
+}
+
+/**
+ * @internal
+ * Get the largest divisor of a number which is not larger than the
+ * given limit.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] n Number to get divisor of.
+ * @param[in] limit Maximum divisor.
+ * @return The largest divisor of `n` not larger than `limit`, or 1 if
+ * there is none.
+ * */
+static size_t ccl_kernel_largest_divisor(size_t n, size_t limit) {
+
+	GArray* divs = ccl_kernel_divisors(n, limit);
+	size_t best = 1;
+
+	for (guint i = 0; i < divs->len; ++i)
+		best = MAX(best, g_array_index(divs, size_t, i));
+	g_array_free(divs, TRUE);
+
+	return best;
+
+}
+
+/**
+ * @internal
+ * Refine the first dimension of a suggested local work size with a
+ * cost model which favours compute unit occupancy and work-group sizes
+ * which are multiples of the preferred work-group size multiple.
+ *
+ * Candidates are divisors of the real work size if the global work size
+ * must be equal to the real work size, or multiples of the preferred
+ * work-group size multiple (and powers of two) otherwise. Each
+ * candidate is scored by the fraction of compute units with at least
+ * one work-group, halved if the work-group size is not a multiple of
+ * the preferred multiple, and divided by the relative amount of padding
+ * work-items. The largest candidate with the highest score is kept.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] dims Number of dimensions.
+ * @param[in] real_worksize The real work size.
+ * @param[in] padded Can the global work size be larger than the real
+ * work size?
+ * @param[in,out] lws Suggested local work size, of which the first
+ * dimension is refined.
+ * @param[in] wg_size_mult Preferred work-group size multiple.
+ * @param[in] wg_size_max Maximum work-group size.
+ * @param[in] max_wi_size Maximum local work size in first dimension.
+ * @param[in] cus Number of compute units in device.
+ * */
+static void ccl_kernel_occupancy_refine(cl_uint dims,
+	const size_t* real_worksize, gboolean padded, size_t* lws,
+	size_t wg_size_mult, size_t wg_size_max, size_t max_wi_size,
+	cl_uint cus) {
+
+	/* Work-group size and number of work-groups in other dimensions. */
+	size_t wg_other = 1;
+	double groups_other = 1.0;
+	/* Candidates for first dimension and their limit. */
+	GArray* cands;
+	size_t limit, c;
+	/* Best candidate and its score. */
+	size_t best = 0;
+	double best_score = -1.0;
+
+	for (cl_uint i = 1; i < dims; ++i) {
+		wg_other *= lws[i];
+		groups_other *= (double)
+			((real_worksize[i] + lws[i] - 1) / lws[i]);
+	}
+	limit = MIN(max_wi_size, wg_size_max / wg_other);
+	wg_size_mult = MAX(wg_size_mult, 1);
+
+	/* Get candidates. */
+	if (padded) {
+		cands = g_array_new(FALSE, FALSE, sizeof(size_t));
+		for (c = wg_size_mult; c <= limit; c += wg_size_mult)
+			g_array_append_val(cands, c);
+		for (c = 1; (c <= limit) && (c < wg_size_mult); c *= 2)
+			g_array_append_val(cands, c);
+	} else {
+		cands = ccl_kernel_divisors(real_worksize[0], limit);
+	}
+
+	/* Score candidates. */
+	for (guint i = 0; i < cands->len; ++i) {
+
+		size_t groups0;
+		double occupancy, waste, score;
+
+		c = g_array_index(cands, size_t, i);
+		groups0 = (real_worksize[0] + c - 1) / c;
+		occupancy = MIN(1.0, groups0 * groups_other / MAX(cus, 1));
+		waste = (double) (groups0 * c) / real_worksize[0] - 1.0;
+		score = occupancy / (1.0 + waste);
+		if ((c * wg_other) % wg_size_mult != 0) score /= 2.0;
+
+		/* Ties are broken in favour of larger work-groups. */
+		if ((score > best_score + 1e-9)
+			|| ((score > best_score - 1e-9) && (c > best))) {
+			best = c;
+			best_score = MAX(score, best_score);
+		}
+	}
+	g_array_free(cands, TRUE);
+
+	/* Keep best candidate, if any. */
+	if (best_score >= 0.0) lws[0] = best;
+
+}
+
+/**
+ * @internal
+ * Create a key for the cache of suggested work sizes.
+ *
+ * @private @memberof ccl_kernel
  *
- * @param[in] krnl Kernel wrapper object. If `NULL`, use only device
- * information for determining global and local worksizes.
  * @param[in] dev Device wrapper object.
- * @param[in] dims The number of dimensions used to specify the global
- * work-items and work-items in the work-group.
+ * @param[in] dims Number of dimensions.
+ * @param[in] real_worksize The real work size.
+ * @param[in] padded Can the global work size be larger than the real
+ * work size?
+ * @param[in] lws Maximum local work size given as input.
+ * @param[in] flags Work size suggestion flags.
+ * @return A new key, which must be freed with g_free().
+ * */
+static size_t* ccl_kernel_ws_key_new(CCLDevice* dev, cl_uint dims,
+	const size_t* real_worksize, gboolean padded, const size_t* lws,
+	CCLWorksizeFlags flags) {
+
+	size_t* key = g_new(size_t, 3 + 2 * dims);
+
+	key[0] = (size_t) ccl_device_unwrap(dev);
+	key[1] = ((size_t) flags << 1) | (padded ? 1 : 0);
+	key[2] = dims;
+	memcpy(key + 3, real_worksize, dims * sizeof(size_t));
+	memcpy(key + 3 + dims, lws, dims * sizeof(size_t));
+
+	return key;
+
+}
+
+/**
+ * @internal
+ * Hash function for keys of the cache of suggested work sizes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] key Key created with ccl_kernel_ws_key_new().
+ * @return Hash value.
+ * */
+static guint ccl_kernel_ws_key_hash(gconstpointer key) {
+
+	const size_t* k = key;
+	guint h = 17;
+
+	for (size_t i = 0; i < 3 + 2 * k[2]; ++i)
+		h = h * 31 + (guint) (k[i] ^ ((guint64) k[i] >> 32));
+
+	return h;
+
+}
+
+/**
+ * @internal
+ * Equality function for keys of the cache of suggested work sizes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] a Key created with ccl_kernel_ws_key_new().
+ * @param[in] b Key created with ccl_kernel_ws_key_new().
+ * @return `TRUE` if keys are equal, `FALSE` otherwise.
+ * */
+static gboolean ccl_kernel_ws_key_equal(gconstpointer a, gconstpointer b) {
+
+	const size_t* ka = a;
+	const size_t* kb = b;
+
+	return (ka[2] == kb[2])
+		&& (memcmp(ka, kb, (3 + 2 * ka[2]) * sizeof(size_t)) == 0);
+
+}
+
+/* Tuning database, loaded on first use. */
+static GKeyFile* tuning_db = NULL;
+
+/* File of the tuning database, or `NULL` for the default file. */
+static gchar* tuning_db_file = NULL;
+
+/* Protects the tuning database and its file name. */
+static GMutex tuning_db_lock;
+
+/* Generation of the tuning database, incremented whenever its file or
+ * contents change, so that kernels know when to discard their cached
+ * work size suggestions. */
+static gint tuning_db_gen = 0;
+
+/* Protects the caches of suggested work sizes of all kernel wrappers.
+ * Cache accesses are short, so a single lock suffices. */
+static GMutex ws_cache_lock;
+
+/**
+ * @internal
+ * Get the path of the tuning database file. Must be called with the
+ * tuning database lock held.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @return The path of the tuning database file, which must be freed
+ * with g_free().
+ * */
+static gchar* ccl_kernel_tuning_db_path() {
+
+	return (tuning_db_file != NULL)
+		? g_strdup(tuning_db_file)
+		: g_build_filename(
+			g_get_user_cache_dir(), "cf4ocl", "tuning.ini", NULL);
+
+}
+
+/**
+ * @internal
+ * Get the tuning database, loading it from its file if necessary. A
+ * missing or invalid file is handled as an empty database. Must be
+ * called with the tuning database lock held.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @return The tuning database.
+ * */
+static GKeyFile* ccl_kernel_tuning_db_get() {
+
+	gchar* path;
+
+	if (tuning_db == NULL) {
+		path = ccl_kernel_tuning_db_path();
+		tuning_db = g_key_file_new();
+		g_key_file_load_from_file(tuning_db, path, G_KEY_FILE_NONE, NULL);
+		g_free(path);
+	}
+
+	return tuning_db;
+
+}
+
+/**
+ * @internal
+ * Determine the group and key of a tuning database entry. The group
+ * identifies the device by name and driver version, and the key is
+ * composed of the kernel name and of the size class (bit length) of
+ * each real work size component, e.g. `some_kernel:11,10`.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims Number of dimensions.
  * @param[in] real_worksize The real worksize.
- * @param[out] gws Location where to place a "nice" global worksize for
- * the given kernel and device, which must be equal or larger than the `
- * real_worksize` and a multiple of `lws`. This memory location should
- * be pre-allocated with space for `dims` values of size `size_t`. If
- * `NULL` it is assumed that the global worksize must be equal to
- * `real_worksize`.
- * @param[in,out] lws This memory location, of size
- * `dims * sizeof(size_t)`, serves a dual purpose: 1) as an input,
- * containing the maximum allowed local work size for each dimension, or
- * zeros if these maximums are to be fetched from the given device
- * `CL_DEVICE_MAX_WORK_ITEM_SIZES` information (if the specified values
- * are larger than the device limits, the device limits are used
- * instead); 2) as an output, where to place a "nice" local worksize,
- * which is based and respects the limits of the given kernel and device
- * (and of the non-zero values given as input).
+ * @param[out] group Location where to place the group, which must be
+ * freed with g_free().
+ * @param[out] key Location where to place the key, which must be freed
+ * with g_free().
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
  * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
  * otherwise.
  * */
-CCL_EXPORT
-cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
-	cl_uint dims, const size_t* real_worksize, size_t* gws, size_t* lws,
+static cl_bool ccl_kernel_tuning_db_keys(CCLKernel* krnl, CCLDevice* dev,
+	cl_uint dims, const size_t* real_worksize, gchar** group, gchar** key,
 	CCLErr** err) {
 
-	/* Make sure dev is not NULL. */
-	g_return_val_if_fail(dev != NULL, CL_FALSE);
-	/* Make sure dims not zero. */
-	g_return_val_if_fail(dims > 0, CL_FALSE);
-	/* Make sure real_worksize is not NULL. */
-	g_return_val_if_fail(real_worksize != NULL, CL_FALSE);
-	/* Make sure lws is not NULL. */
-	g_return_val_if_fail(lws != NULL, CL_FALSE);
-	/* Make sure err is NULL or it is not set. */
-	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+	/* Device name, driver version and kernel name. */
+	const char* dev_name;
+	const char* drv_ver;
+	const char* krnl_name;
+	/* Key being built. */
+	GString* key_str;
+	/* Error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+
+	/* Get device and kernel names, and driver version. */
+	dev_name = ccl_device_get_info_array(
+		dev, CL_DEVICE_NAME, char*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	drv_ver = ccl_device_get_info_array(
+		dev, CL_DRIVER_VERSION, char*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	krnl_name = ccl_kernel_get_info_array(
+		krnl, CL_KERNEL_FUNCTION_NAME, char*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Group names can't contain square brackets or line breaks. */
+	*group = g_strdup_printf("%s (%s)", dev_name, drv_ver);
+	g_strdelimit(*group, "[]\r\n", '_');
+
+	/* Key is composed of kernel name and size classes. */
+	key_str = g_string_new(krnl_name);
+	for (cl_uint i = 0; i < dims; ++i) {
+		g_string_append_printf(key_str, "%c%u",
+			i == 0 ? ':' : ',', g_bit_storage(real_worksize[i]));
+	}
+	*key = g_string_free(key_str, FALSE);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * @internal
+ * Store a tuned local work size in the tuning database and save it to
+ * its file. The file is reloaded before the entry is stored, in order
+ * to keep entries saved meanwhile by other processes.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] group Group of entry, as given by
+ * ccl_kernel_tuning_db_keys().
+ * @param[in] key Key of entry, as given by ccl_kernel_tuning_db_keys().
+ * @param[in] dims Number of dimensions.
+ * @param[in] lws Tuned local work size.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_kernel_tuning_db_store(const gchar* group,
+	const gchar* key, cl_uint dims, const size_t* lws, CCLErr** err) {
+
+	/* Database file and its folder. */
+	gchar* path = NULL;
+	gchar* dir = NULL;
+	/* Database contents. */
+	gchar* data = NULL;
+	gsize len;
+	/* Entry value. */
+	gint* value;
+	/* Error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+
+	g_mutex_lock(&tuning_db_lock);
+
+	/* Reload database. */
+	if (tuning_db != NULL) {
+		g_key_file_free(tuning_db);
+		tuning_db = NULL;
+	}
+	ccl_kernel_tuning_db_get();
+
+	/* Store entry. */
+	value = g_new(gint, dims);
+	for (cl_uint i = 0; i < dims; ++i)
+		value[i] = (gint) lws[i];
+	g_key_file_set_integer_list(tuning_db, group, key, value, dims);
+	g_free(value);
+	g_atomic_int_inc(&tuning_db_gen);
+
+	/* Save database. The file is saved with g_file_set_contents(),
+	 * which writes to a temporary file in the same folder and renames
+	 * it, so readers only see complete files. */
+	path = ccl_kernel_tuning_db_path();
+	dir = g_path_get_dirname(path);
+	g_if_err_create_goto(*err, CCL_ERROR,
+		g_mkdir_with_parents(dir, 0700) != 0, CCL_ERROR_OTHER,
+		error_handler, "%s: unable to create folder '%s' for tuning "
+		"database.", CCL_STRD, dir);
+	data = g_key_file_to_data(tuning_db, &len, NULL);
+	g_file_set_contents(path, data, len, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	g_mutex_unlock(&tuning_db_lock);
+
+	/* Free stuff. */
+	g_free(data);
+	g_free(dir);
+	g_free(path);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * @internal
+ * Get local (and optionally global) work sizes from the tuning
+ * database. The tuned local work size is only used if it respects the
+ * kernel and device limits and the maximum local work sizes given in
+ * `lws`, and, if `gws` is `NULL`, if it is a divisor of the real work
+ * size. Errors are handled as a missing entry.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims Number of dimensions.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place the global worksize, or
+ * `NULL`.
+ * @param[in,out] lws Maximum local work sizes on input, tuned local
+ * work sizes on output (unchanged if no tuned local work size is used).
+ * @return `CL_TRUE` if a tuned local work size was used, `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_kernel_suggest_worksizes_tuned(CCLKernel* krnl,
+	CCLDevice* dev, cl_uint dims, const size_t* real_worksize,
+	size_t* gws, size_t* lws) {
+
+	/* Entry group and key. */
+	gchar* group = NULL;
+	gchar* key = NULL;
+	/* Tuned local work size. */
+	gint* tuned = NULL;
+	gsize num_tuned = 0;
+	/* Kernel and device limits. */
+	size_t* max_wi_sizes;
+	size_t wg_size_max;
+	size_t wg_size = 1;
+	/* Was a tuned local work size used? */
+	cl_bool found = CL_FALSE;
+	/* Error handling object. */
+	CCLErr* err_internal = NULL;
+
+	/* Look for tuned local work size. */
+	if (!ccl_kernel_tuning_db_keys(
+		krnl, dev, dims, real_worksize, &group, &key, &err_internal))
+		goto finish;
+	g_mutex_lock(&tuning_db_lock);
+	tuned = g_key_file_get_integer_list(
+		ccl_kernel_tuning_db_get(), group, key, &num_tuned, NULL);
+	g_mutex_unlock(&tuning_db_lock);
+	if ((tuned == NULL) || (num_tuned != dims)) goto finish;
+
+	/* Get kernel and device limits. */
+	max_wi_sizes = ccl_device_get_info_array(
+		dev, CL_DEVICE_MAX_WORK_ITEM_SIZES, size_t*, &err_internal);
+	if (err_internal != NULL) goto finish;
+	wg_size_max = ccl_kernel_get_workgroup_info_scalar(krnl, dev,
+		CL_KERNEL_WORK_GROUP_SIZE, size_t, &err_internal);
+	if (err_internal != NULL) {
+		g_clear_error(&err_internal);
+		wg_size_max = ccl_device_get_info_scalar(
+			dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err_internal);
+		if (err_internal != NULL) goto finish;
+	}
+
+	/* Check if tuned local work size respects the limits. */
+	for (cl_uint i = 0; i < dims; ++i) {
+		if ((tuned[i] <= 0)
+			|| ((size_t) tuned[i] > max_wi_sizes[i])
+			|| ((lws[i] != 0) && ((size_t) tuned[i] > lws[i]))
+			|| ((gws == NULL) && (real_worksize[i] % (size_t) tuned[i] != 0)))
+			goto finish;
+		wg_size *= (size_t) tuned[i];
+	}
+	if (wg_size > wg_size_max) goto finish;
+
+	/* Use tuned local work size, and find a global worksize which is a
+	 * multiple of it. */
+	for (cl_uint i = 0; i < dims; ++i) {
+		lws[i] = (size_t) tuned[i];
+		if (gws != NULL) {
+			gws[i] = ((real_worksize[i] / lws[i])
+				+ (((real_worksize[i] % lws[i]) > 0) ? 1 : 0))
+				* lws[i];
+		}
+	}
+	found = CL_TRUE;
+
+finish:
+
+	/* Free stuff. */
+	g_clear_error(&err_internal);
+	g_free(tuned);
+	g_free(key);
+	g_free(group);
+
+	/* Return whether a tuned local work size was used. */
+	return found;
+
+}
+
+/**
+ * @internal
+ * Determine local (and optionally global) work sizes, as described in
+ * ccl_kernel_suggest_worksizes_full(), without using the cache.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object, or `NULL`.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims Number of dimensions.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place the global worksize, or
+ * `NULL`.
+ * @param[in,out] lws Maximum local work sizes on input, suggested local
+ * work sizes on output.
+ * @param[in] flags Work size suggestion flags.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_kernel_suggest_worksizes_compute(CCLKernel* krnl,
+	CCLDevice* dev, cl_uint dims, const size_t* real_worksize,
+	size_t* gws, size_t* lws, CCLWorksizeFlags flags, CCLErr** err) {
 
 	/* The preferred workgroup size. */
 	size_t wg_size_mult = 0;
 	size_t wg_size_max = 0;
 	size_t wg_size = 1, wg_size_aux;
-	size_t* max_wi_sizes;
+	size_t* max_wi_sizes = NULL;
 	cl_uint dev_dims;
 	cl_bool ret_status;
 	size_t real_ws = 1;
@@ -937,10 +1830,12 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
 		"but %d were requested.",
 		CCL_STRD, dev_dims, dims);
 
-	/* Get max. work item sizes for device. */
+	/* Get max. work item sizes for device, keeping a copy which can
+	 * be modified without changing the device information. */
 	max_wi_sizes = ccl_device_get_info_array(
 		dev, CL_DEVICE_MAX_WORK_ITEM_SIZES, size_t*, &err_internal);
 	g_if_err_propagate_goto(err, err_internal, error_handler);
+	max_wi_sizes = g_memdup(max_wi_sizes, dims * sizeof(size_t));
 
 	/* For each dimension, if the user specified a maximum local work
 	 * size, the effective maximum local work size will be the minimum
@@ -1087,21 +1982,8 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
 					/* Previoulsy found lws[i] not usable, find
 					 * new one. Must be a divisor of real_worksize[i]
 					 * and respect the kernel and device maximum lws.*/
-					cl_uint best_lws_i = 1;
-					for (cl_uint j = 2; j <= real_worksize[i] / 2; ++j) {
-						/* If current value is higher than the kernel
-						 * and device limits, stop searching and use
-						 * the best one so far. */
-						if ((wg_size * j > wg_size_max)
-							|| (j > max_wi_sizes[i])) break;
-						/* Otherwise check if current value is divisor
-						 * of lws[i]. If so, keep it as the best so
-						 * far. */
-						if (real_worksize[i] % j == 0)
-							best_lws_i = j;
-					}
-					/* Keep the best divisor for current dimension. */
-					lws[i] = best_lws_i;
+					lws[i] = ccl_kernel_largest_divisor(real_worksize[i],
+						MIN(wg_size_max / wg_size, max_wi_sizes[i]));
 				}
 				/* Update absolute workgroup size (all dimensions). */
 				wg_size *= lws[i];
@@ -1109,7 +1991,640 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
 		}
 	}
 
-	/* If we got here, everything is OK. */
+	/* Optionally refine the local work size with the occupancy cost
+	 * model. */
+	if (flags & CCL_WORKSIZE_OCCUPANCY) {
+
+		/* Get number of compute units in device. */
+		cl_uint cus = ccl_device_get_info_scalar(
+			dev, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		/* Refine first dimension of local work size. */
+		ccl_kernel_occupancy_refine(dims, real_worksize, gws != NULL,
+			lws, wg_size_mult, wg_size_max, max_wi_sizes[0], cus);
+
+		/* Update global work size. */
+		if (gws != NULL) {
+			gws[0] = ((real_worksize[0] / lws[0])
+				+ (((real_worksize[0] % lws[0]) > 0) ? 1 : 0))
+				* lws[0];
+		}
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Release copy of max. work item sizes. */
+	g_free(max_wi_sizes);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Suggest appropriate local (and optionally global) work sizes for the
+ * given real work size, based on device and kernel characteristics.
+ *
+ * If the `gws` parameter is not `NULL`, it will be populated with a
+ * global worksize which may be larger than the real work size
+ * in order to better fit the kernel preferred multiple work size. As
+ * such, kernels enqueued with global work sizes suggested by this
+ * function should check if their global ID is within `real_worksize`.
+ *
+ * This function calls ccl_kernel_suggest_worksizes_full() with
+ * ::CCL_WORKSIZE_TUNED flags, i.e. a local work size found by
+ * ccl_kernel_autotune() is used if available and valid.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object. If `NULL`, use only device
+ * information for determining global and local worksizes.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims The number of dimensions used to specify the global
+ * work-items and work-items in the work-group.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place a "nice" global worksize for
+ * the given kernel and device, which must be equal or larger than the `
+ * real_worksize` and a multiple of `lws`. This memory location should
+ * be pre-allocated with space for `dims` values of size `size_t`. If
+ * `NULL` it is assumed that the global worksize must be equal to
+ * `real_worksize`.
+ * @param[in,out] lws This memory location, of size
+ * `dims * sizeof(size_t)`, serves a dual purpose: 1) as an input,
+ * containing the maximum allowed local work size for each dimension, or
+ * zeros if these maximums are to be fetched from the given device
+ * `CL_DEVICE_MAX_WORK_ITEM_SIZES` information (if the specified values
+ * are larger than the device limits, the device limits are used
+ * instead); 2) as an output, where to place a "nice" local worksize,
+ * which is based and respects the limits of the given kernel and device
+ * (and of the non-zero values given as input).
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
+	cl_uint dims, const size_t* real_worksize, size_t* gws, size_t* lws,
+	CCLErr** err) {
+
+	return ccl_kernel_suggest_worksizes_full(krnl, dev, dims,
+		real_worksize, gws, lws, CCL_WORKSIZE_TUNED, err);
+}
+
+/**
+ * Suggest appropriate local (and optionally global) work sizes for the
+ * given real work size, based on device and kernel characteristics,
+ * optionally using a cost model.
+ *
+ * Suggestions for kernels (i.e. when `krnl` is not `NULL`) are cached
+ * in the kernel wrapper for each combination of device, dimensions,
+ * real work size, maximum local work size given in `lws`, request of a
+ * global work size and `flags`. As such, repeated calls with the same
+ * parameters do not query the device and kernel again. The cache holds
+ * up to 64 suggestions, and is cleared when full. Access to the cache
+ * is synchronized, so this function can be called concurrently for the
+ * same kernel wrapper.
+ *
+ * If the `gws` parameter is not `NULL`, it will be populated with a
+ * global worksize which may be larger than the real work size
+ * in order to better fit the kernel preferred multiple work size. As
+ * such, kernels enqueued with global work sizes suggested by this
+ * function should check if their global ID is within `real_worksize`.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object. If `NULL`, use only device
+ * information for determining global and local worksizes.
+ * @param[in] dev Device wrapper object.
+ * @param[in] dims The number of dimensions used to specify the global
+ * work-items and work-items in the work-group.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place a "nice" global worksize for
+ * the given kernel and device, which must be equal or larger than the `
+ * real_worksize` and a multiple of `lws`. This memory location should
+ * be pre-allocated with space for `dims` values of size `size_t`. If
+ * `NULL` it is assumed that the global worksize must be equal to
+ * `real_worksize`.
+ * @param[in,out] lws This memory location, of size
+ * `dims * sizeof(size_t)`, serves a dual purpose: 1) as an input,
+ * containing the maximum allowed local work size for each dimension, or
+ * zeros if these maximums are to be fetched from the given device
+ * `CL_DEVICE_MAX_WORK_ITEM_SIZES` information (if the specified values
+ * are larger than the device limits, the device limits are used
+ * instead); 2) as an output, where to place a "nice" local worksize,
+ * which is based and respects the limits of the given kernel and device
+ * (and of the non-zero values given as input).
+ * @param[in] flags Flags which control how work sizes are suggested.
+ * With ::CCL_WORKSIZE_OCCUPANCY, the local work size in the first
+ * dimension is chosen to favour compute unit occupancy
+ * (`CL_DEVICE_MAX_COMPUTE_UNITS`), work-group sizes which are multiples
+ * of the preferred work-group size multiple and little padding. With
+ * ::CCL_WORKSIZE_TUNED (and if `krnl` is not `NULL`), a local work size
+ * found by ccl_kernel_autotune() for the kernel, device and global size
+ * class is used instead, as long as it respects the kernel and device
+ * limits, the maximum local work sizes given in `lws` and, if `gws` is
+ * `NULL`, is a divisor of `real_worksize`.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_kernel_suggest_worksizes_full(CCLKernel* krnl, CCLDevice* dev,
+	cl_uint dims, const size_t* real_worksize, size_t* gws, size_t* lws,
+	CCLWorksizeFlags flags, CCLErr** err) {
+
+	/* Make sure dev is not NULL. */
+	g_return_val_if_fail(dev != NULL, CL_FALSE);
+	/* Make sure dims not zero. */
+	g_return_val_if_fail(dims > 0, CL_FALSE);
+	/* Make sure real_worksize is not NULL. */
+	g_return_val_if_fail(real_worksize != NULL, CL_FALSE);
+	/* Make sure lws is not NULL. */
+	g_return_val_if_fail(lws != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Cache key and cached work sizes. */
+	size_t* key = NULL;
+	size_t* ws = NULL;
+	/* Current generation of the tuning database. */
+	gint gen = 0;
+	/* Result of function call. */
+	cl_bool ret_status;
+
+	/* Look for cached suggestion. */
+	if (krnl != NULL) {
+
+		key = ccl_kernel_ws_key_new(
+			dev, dims, real_worksize, gws != NULL, lws, flags);
+
+		g_mutex_lock(&ws_cache_lock);
+
+		/* Cached suggestions may not reflect the tuning database
+		 * anymore if it was changed in the meantime. */
+		gen = g_atomic_int_get(&tuning_db_gen);
+		if ((krnl->ws_cache != NULL) && (krnl->ws_cache_gen != gen))
+			g_hash_table_remove_all(krnl->ws_cache);
+		krnl->ws_cache_gen = gen;
+
+		if (krnl->ws_cache != NULL) {
+			ws = g_hash_table_lookup(krnl->ws_cache, key);
+			if (ws != NULL) {
+				if (gws != NULL) memcpy(gws, ws, dims * sizeof(size_t));
+				memcpy(lws, ws + dims, dims * sizeof(size_t));
+			}
+		}
+
+		g_mutex_unlock(&ws_cache_lock);
+
+		if (ws != NULL) {
+			g_free(key);
+			return CL_TRUE;
+		}
+	}
+
+	/* Determine work sizes, preferring valid tuned work sizes if
+	 * requested. */
+	if ((krnl != NULL) && (flags & CCL_WORKSIZE_TUNED)
+		&& ccl_kernel_suggest_worksizes_tuned(
+			krnl, dev, dims, real_worksize, gws, lws)) {
+		ret_status = CL_TRUE;
+	} else {
+		ret_status = ccl_kernel_suggest_worksizes_compute(
+			krnl, dev, dims, real_worksize, gws, lws, flags, err);
+	}
+
+	/* Keep successful suggestions for kernels in cache, unless the
+	 * tuning database changed in the meantime. Suggestions are
+	 * determined without holding the lock, so concurrent callers may
+	 * determine (and cache) the same suggestion. */
+	if (key != NULL) {
+		g_mutex_lock(&ws_cache_lock);
+		if (ret_status && (krnl->ws_cache_gen == gen)) {
+			if (krnl->ws_cache == NULL) {
+				krnl->ws_cache = g_hash_table_new_full(
+					ccl_kernel_ws_key_hash, ccl_kernel_ws_key_equal,
+					g_free, g_free);
+			} else if (g_hash_table_size(krnl->ws_cache)
+				>= CCL_KERNEL_WS_CACHE_MAX) {
+				g_hash_table_remove_all(krnl->ws_cache);
+			}
+			ws = g_new0(size_t, 2 * dims);
+			if (gws != NULL) memcpy(ws, gws, dims * sizeof(size_t));
+			memcpy(ws + dims, lws, dims * sizeof(size_t));
+			g_hash_table_insert(krnl->ws_cache, key, ws);
+		} else {
+			g_free(key);
+		}
+		g_mutex_unlock(&ws_cache_lock);
+	}
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * @internal
+ * Compare two `size_t` values, for sorting in ascending order.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] a Location of first value.
+ * @param[in] b Location of second value.
+ * @return Negative, zero or positive if the first value is smaller
+ * than, equal to or larger than the second value, respectively.
+ * */
+static gint ccl_kernel_size_cmp(gconstpointer a, gconstpointer b) {
+
+	size_t va = *((const size_t*) a);
+	size_t vb = *((const size_t*) b);
+
+	return (va > vb) - (va < vb);
+
+}
+
+/**
+ * @internal
+ * Add a candidate local work size to the candidates of the autotuner,
+ * if it is not already there.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] cands Candidate local work sizes, `dims` values (of type
+ * `size_t`) per candidate.
+ * @param[in] dims Number of dimensions.
+ * @param[in] lws Candidate local work size.
+ * */
+static void ccl_kernel_autotune_add(GArray* cands, cl_uint dims,
+	const size_t* lws) {
+
+	for (guint c = 0; c < cands->len; c += dims) {
+		if (memcmp(&g_array_index(cands, size_t, c), lws,
+			dims * sizeof(size_t)) == 0)
+			return;
+	}
+	g_array_append_vals(cands, lws, dims);
+
+}
+
+/**
+ * @internal
+ * Add combinations of the candidate local work size components of
+ * each dimension, whose total work-group size does not exceed the
+ * given maximum, to the candidates of the autotuner. Larger components
+ * are combined first, and no more combinations are added once the
+ * autotuner has ::CCL_KERNEL_AUTOTUNE_MAX_CANDS candidates.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] cands Candidate local work sizes, `dims` values (of type
+ * `size_t`) per candidate.
+ * @param[in] dims Number of dimensions.
+ * @param[in] vals Candidate local work size components (of type
+ * `size_t`) of each dimension, in ascending order.
+ * @param[in] dim Current dimension.
+ * @param[in,out] lws Local work size being built.
+ * @param[in] wg_size Work-group size of previous dimensions.
+ * @param[in] wg_size_max Maximum work-group size.
+ * */
+static void ccl_kernel_autotune_combine(GArray* cands, cl_uint dims,
+	GArray** vals, cl_uint dim, size_t* lws, size_t wg_size,
+	size_t wg_size_max) {
+
+	for (guint v = vals[dim]->len; v > 0; --v) {
+		if (cands->len >= CCL_KERNEL_AUTOTUNE_MAX_CANDS * dims) return;
+		lws[dim] = g_array_index(vals[dim], size_t, v - 1);
+		if (lws[dim] > wg_size_max / wg_size) continue;
+		if (dim + 1 < dims) {
+			ccl_kernel_autotune_combine(cands, dims, vals, dim + 1,
+				lws, wg_size * lws[dim], wg_size_max);
+		} else {
+			ccl_kernel_autotune_add(cands, dims, lws);
+		}
+	}
+
+}
+
+/**
+ * @internal
+ * Time kernel executions with the given local work size. The kernel is
+ * executed once for warm-up, and then `reps` times. Each execution is
+ * timed with the `CL_PROFILING_COMMAND_START` and
+ * `CL_PROFILING_COMMAND_END` instants of its event.
+ *
+ * @private @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] cq Command queue wrapper object, with profiling enabled.
+ * @param[in] dims Number of dimensions.
+ * @param[in] real_worksize The real worksize.
+ * @param[in] padded Can the global work size be larger than the real
+ * work size?
+ * @param[in] lws Local work size.
+ * @param[in] reps Number of timed executions.
+ * @param[out] time Location where to place the shortest execution time,
+ * in nanoseconds.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_kernel_autotune_time(CCLKernel* krnl, CCLQueue* cq,
+	cl_uint dims, const size_t* real_worksize, cl_bool padded,
+	const size_t* lws, cl_uint reps, cl_ulong* time, CCLErr** err) {
+
+	/* Global work size. */
+	size_t* gws = g_new(size_t, dims);
+	/* Event of current execution. */
+	CCLEvent* evt;
+	/* Start and end instants of current execution. */
+	cl_ulong t_start, t_end;
+	/* Error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+
+	/* Determine global work size. */
+	for (cl_uint i = 0; i < dims; ++i) {
+		gws[i] = padded
+			? ((real_worksize[i] / lws[i])
+				+ (((real_worksize[i] % lws[i]) > 0) ? 1 : 0)) * lws[i]
+			: real_worksize[i];
+	}
+
+	/* Execute kernel once for warm-up, and then reps times, keeping the
+	 * shortest execution time. */
+	*time = CL_ULONG_MAX;
+	for (cl_uint r = 0; r <= reps; ++r) {
+
+		evt = ccl_kernel_enqueue_ndrange(
+			krnl, cq, dims, NULL, gws, lws, NULL, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		ccl_queue_finish(cq, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		if (r == 0) continue;
+
+		/* In untracked mode, the event is only wrapped on demand. */
+		if (evt == NULL)
+			evt = ccl_queue_get_last_event(cq);
+
+		t_start = ccl_event_get_profiling_info_scalar(
+			evt, CL_PROFILING_COMMAND_START, cl_ulong, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		t_end = ccl_event_get_profiling_info_scalar(
+			evt, CL_PROFILING_COMMAND_END, cl_ulong, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		*time = MIN(*time, t_end - t_start);
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Free global work size. */
+	g_free(gws);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Empirically determine the fastest local (and optionally global) work
+ * sizes for the given real work size, and store the local work size in
+ * the tuning database.
+ *
+ * The kernel is executed with each candidate local work size, and the
+ * one with the shortest execution time is selected. Candidates include
+ * the suggestions of ccl_kernel_suggest_worksizes_full() with
+ * ::CCL_WORKSIZE_DEFAULT and ::CCL_WORKSIZE_OCCUPANCY flags, and all
+ * combinations of candidate components within the kernel and device
+ * limits and the maximum local work sizes given in `lws`, larger
+ * components first, up to a total of 64 candidates. If `gws` is
+ * not `NULL`, candidate components are powers of two (up to the
+ * smallest power of two not smaller than the real work size), and the
+ * global work size is padded to a multiple of the local work size;
+ * otherwise, candidate components are divisors of the real work size.
+ *
+ * Each candidate is executed once for warm-up and then `reps` times,
+ * the shortest execution time, as given by the profiling information
+ * of the respective events, being considered. Candidates which fail to
+ * execute (e.g. due to insufficient resources) are skipped. The kernel
+ * arguments must be set beforehand, and the kernel must produce the
+ * same results when executed several times. As with
+ * ccl_kernel_suggest_worksizes(), kernels executed with a padded global
+ * work size must check if their global ID is within `real_worksize`.
+ *
+ * The local work size found is stored in the tuning database, keyed by
+ * kernel name, device name and driver version, and the size class of
+ * the real work size (the bit length of each component), and is
+ * subsequently used by ccl_kernel_suggest_worksizes() and, with
+ * ::CCL_WORKSIZE_TUNED, by ccl_kernel_suggest_worksizes_full().
+ *
+ * @note The events of the kernel executions are kept by the command
+ * queue, as with any other enqueued command. As such, using a dedicated
+ * command queue is recommended. If the command queue is in untracked
+ * mode (see ccl_queue_set_untracked()), only the events of timed
+ * executions are wrapped, with ccl_queue_get_last_event().
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] cq Command queue wrapper object, which must have been
+ * created with the `CL_QUEUE_PROFILING_ENABLE` property.
+ * @param[in] dims The number of dimensions used to specify the global
+ * work-items and work-items in the work-group.
+ * @param[in] real_worksize The real worksize.
+ * @param[out] gws Location where to place the global worksize for the
+ * fastest local work size, or `NULL` if the global worksize must be
+ * equal to `real_worksize`.
+ * @param[in,out] lws As an input, the maximum allowed local work size
+ * for each dimension, or zeros if these maximums are to be fetched from
+ * the device; as an output, the fastest local work size found.
+ * @param[in] reps Number of timed executions of each candidate local
+ * work size.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if function returns successfully, `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_kernel_autotune(CCLKernel* krnl, CCLQueue* cq, cl_uint dims,
+	const size_t* real_worksize, size_t* gws, size_t* lws, cl_uint reps,
+	CCLErr** err) {
+
+	/* Make sure krnl is not NULL. */
+	g_return_val_if_fail(krnl != NULL, CL_FALSE);
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, CL_FALSE);
+	/* Make sure dims not zero. */
+	g_return_val_if_fail(dims > 0, CL_FALSE);
+	/* Make sure real_worksize is not NULL. */
+	g_return_val_if_fail(real_worksize != NULL, CL_FALSE);
+	/* Make sure lws is not NULL. */
+	g_return_val_if_fail(lws != NULL, CL_FALSE);
+	/* Make sure reps is not zero. */
+	g_return_val_if_fail(reps > 0, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Device associated with queue. */
+	CCLDevice* dev;
+	/* Queue properties. */
+	cl_command_queue_properties props;
+	/* Effective maximum local work sizes and work-group size. */
+	size_t* max_lws = NULL;
+	size_t wg_size_max;
+	/* Candidate local work size components of each dimension. */
+	GArray** vals = NULL;
+	/* Candidate local work sizes. */
+	GArray* cands = NULL;
+	/* Local and global work sizes being handled. */
+	size_t* cand_lws = g_new(size_t, dims);
+	size_t* cand_gws = g_new(size_t, dims);
+	/* Fastest local work size. */
+	size_t* best = NULL;
+	cl_ulong best_time = CL_ULONG_MAX, time;
+	/* Tuning database group and key. */
+	gchar* group = NULL;
+	gchar* key = NULL;
+	/* Error handling objects. */
+	CCLErr* err_internal = NULL;
+	CCLErr* err_cand = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+
+	/* Get device associated with queue. */
+	dev = ccl_queue_get_device(cq, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Execution times are obtained from event profiling information. */
+	props = ccl_queue_get_info_scalar(cq, CL_QUEUE_PROPERTIES,
+		cl_command_queue_properties, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	g_if_err_create_goto(*err, CCL_ERROR,
+		!(props & CL_QUEUE_PROFILING_ENABLE), CCL_ERROR_ARGS,
+		error_handler, "%s: command queue must have profiling enabled.",
+		CCL_STRD);
+
+	/* Heuristic suggestions are the first candidates. This also checks
+	 * if the device supports the requested dimensions. */
+	cands = g_array_new(FALSE, FALSE, sizeof(size_t));
+	memcpy(cand_lws, lws, dims * sizeof(size_t));
+	ccl_kernel_suggest_worksizes_compute(krnl, dev, dims, real_worksize,
+		gws != NULL ? cand_gws : NULL, cand_lws, CCL_WORKSIZE_DEFAULT,
+		&err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_kernel_autotune_add(cands, dims, cand_lws);
+	memcpy(cand_lws, lws, dims * sizeof(size_t));
+	ccl_kernel_suggest_worksizes_compute(krnl, dev, dims, real_worksize,
+		gws != NULL ? cand_gws : NULL, cand_lws, CCL_WORKSIZE_OCCUPANCY,
+		&err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_kernel_autotune_add(cands, dims, cand_lws);
+
+	/* Determine effective maximum local work sizes... */
+	max_lws = ccl_device_get_info_array(
+		dev, CL_DEVICE_MAX_WORK_ITEM_SIZES, size_t*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	max_lws = g_memdup(max_lws, dims * sizeof(size_t));
+	for (cl_uint i = 0; i < dims; ++i) {
+		if (lws[i] != 0)
+			max_lws[i] = MIN(max_lws[i], lws[i]);
+	}
+
+	/* ...and maximum work-group size. */
+	wg_size_max = ccl_kernel_get_workgroup_info_scalar(krnl, dev,
+		CL_KERNEL_WORK_GROUP_SIZE, size_t, &err_internal);
+	g_if_err_not_info_unavailable_propagate_goto(
+		err, err_internal, error_handler);
+	if (wg_size_max == 0) {
+		wg_size_max = ccl_device_get_info_scalar(
+			dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+	}
+
+	/* Determine candidate components of each dimension. */
+	vals = g_new0(GArray*, dims);
+	for (cl_uint i = 0; i < dims; ++i) {
+		if (gws != NULL) {
+			vals[i] = g_array_new(FALSE, FALSE, sizeof(size_t));
+			for (size_t l = 1; l <= max_lws[i]; l *= 2) {
+				g_array_append_val(vals[i], l);
+				if (l >= real_worksize[i]) break;
+			}
+		} else {
+			vals[i] = ccl_kernel_divisors(real_worksize[i], max_lws[i]);
+			g_array_sort(vals[i], ccl_kernel_size_cmp);
+		}
+	}
+
+	/* Add combinations of candidate components. */
+	ccl_kernel_autotune_combine(
+		cands, dims, vals, 0, cand_lws, 1, wg_size_max);
+
+	/* Time candidates, skipping those which fail to execute. */
+	for (guint c = 0; c < cands->len; c += dims) {
+		g_clear_error(&err_cand);
+		if (ccl_kernel_autotune_time(krnl, cq, dims, real_worksize,
+			gws != NULL, &g_array_index(cands, size_t, c), reps, &time,
+			&err_cand) && ((best == NULL) || (time < best_time))) {
+			best = &g_array_index(cands, size_t, c);
+			best_time = time;
+		}
+	}
+
+	/* If no candidate could be executed, report the last error. */
+	if (best == NULL) {
+		g_propagate_error(err, err_cand);
+		err_cand = NULL;
+		goto error_handler;
+	}
+
+	/* Store fastest local work size in tuning database. */
+	ccl_kernel_tuning_db_keys(
+		krnl, dev, dims, real_worksize, &group, &key, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_kernel_tuning_db_store(group, key, dims, best, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Output fastest work sizes. */
+	memcpy(lws, best, dims * sizeof(size_t));
+	if (gws != NULL) {
+		for (cl_uint i = 0; i < dims; ++i) {
+			gws[i] = ((real_worksize[i] / lws[i])
+				+ (((real_worksize[i] % lws[i]) > 0) ? 1 : 0))
+				* lws[i];
+		}
+	}
+
+	/* If we got here, everything is OK. */
 	g_assert(err == NULL || *err == NULL);
 	ret_status = CL_TRUE;
 	goto finish;
@@ -1122,11 +2637,58 @@ error_handler:
 
 finish:
 
+	/* Free stuff. */
+	g_clear_error(&err_cand);
+	if (vals != NULL) {
+		for (cl_uint i = 0; i < dims; ++i) {
+			if (vals[i] != NULL) g_array_free(vals[i], TRUE);
+		}
+		g_free(vals);
+	}
+	if (cands != NULL) g_array_free(cands, TRUE);
+	g_free(max_lws);
+	g_free(cand_lws);
+	g_free(cand_gws);
+	g_free(group);
+	g_free(key);
+
 	/* Return status. */
 	return ret_status;
 
 }
 
+/**
+ * Set the file of the tuning database, where local work sizes found by
+ * ccl_kernel_autotune() are stored. The database is a key file, which
+ * is loaded when first required. By default, the `cf4ocl/tuning.ini`
+ * file in the user's cache directory (e.g.
+ * `$XDG_CACHE_HOME/cf4ocl/tuning.ini`) is used.
+ *
+ * @public @memberof ccl_kernel
+ *
+ * @param[in] filename File of the tuning database, or `NULL` to use the
+ * default file.
+ * */
+CCL_EXPORT
+void ccl_kernel_set_tuning_db(const char* filename) {
+
+	g_mutex_lock(&tuning_db_lock);
+
+	/* Set file. */
+	g_free(tuning_db_file);
+	tuning_db_file = g_strdup(filename);
+
+	/* Discard database loaded from the previous file. */
+	if (tuning_db != NULL) {
+		g_key_file_free(tuning_db);
+		tuning_db = NULL;
+	}
+	g_atomic_int_inc(&tuning_db_gen);
+
+	g_mutex_unlock(&tuning_db_lock);
+
+}
+
 #ifdef CL_VERSION_1_2
 
 /**
@@ -85,6 +85,28 @@
  * * ::ccl_kernel_get_arg_info_array()
  * * ::ccl_kernel_get_arg_info()
  *
+ * The ccl_kernel_suggest_worksizes() and
+ * ccl_kernel_suggest_worksizes_full() functions suggest local (and
+ * optionally global) work sizes for a given real work size, based on
+ * device and kernel characteristics. Suggestions are cached in the
+ * kernel wrapper, so these functions can be called before each kernel
+ * execution. The later function accepts ::CCLWorksizeFlags, such as
+ * ::CCL_WORKSIZE_OCCUPANCY, which enables a cost model favouring
+ * compute unit occupancy.
+ *
+ * The ccl_kernel_autotune() function empirically determines the
+ * fastest local work size for a kernel, device and real work size, by
+ * timing kernel executions with a set of candidate local work sizes.
+ * The result is stored in a tuning database, a key file kept by default
+ * in the user's cache directory (see ccl_kernel_set_tuning_db()), keyed
+ * by kernel name, device and global size class (the bit length of each
+ * real work size component). Later calls to
+ * ccl_kernel_suggest_worksizes(), or to
+ * ccl_kernel_suggest_worksizes_full() with ::CCL_WORKSIZE_TUNED, use
+ * tuned local work sizes found in the database, as long as they respect
+ * the limits of the kernel and device and the requested maximum local
+ * work sizes.
+ *
  * _Example: getting a kernel wrapper from a program wrapper_
  *
  * @code{.c}
@@ -111,6 +133,29 @@
  * @{
  */
 
+/**
+ * Flags which control how work sizes are suggested by
+ * ccl_kernel_suggest_worksizes_full().
+ * */
+typedef enum ccl_worksize_flags {
+
+	/** Suggest the largest local work size allowed by the kernel and
+	 * device, based on the preferred work-group size multiple. */
+	CCL_WORKSIZE_DEFAULT   = 0,
+
+	/** Choose the local work size in the first dimension with a cost
+	 * model which favours occupancy of all compute units, work-group
+	 * sizes which are multiples of the preferred work-group size
+	 * multiple and little padding. */
+	CCL_WORKSIZE_OCCUPANCY = 1 << 0,
+
+	/** Use the local work size found by ccl_kernel_autotune() for the
+	 * kernel, device and global size class, if it exists in the tuning
+	 * database and respects the kernel, device and requested limits. */
+	CCL_WORKSIZE_TUNED     = 1 << 1
+
+} CCLWorksizeFlags;
+
 /* Get the kernel wrapper for the given OpenCL kernel. */
 CCL_EXPORT
 CCLKernel* ccl_kernel_new_wrap(cl_kernel kernel);
@@ -129,6 +174,11 @@ void ccl_kernel_destroy(CCLKernel* krnl);
 CCL_EXPORT
 void ccl_kernel_set_arg(CCLKernel* krnl, cl_uint arg_index, void* arg);
 
+/* Set one kernel argument from its size and value. */
+CCL_EXPORT
+void ccl_kernel_set_arg_value(CCLKernel* krnl, cl_uint arg_index,
+	size_t arg_size, const void* arg_value);
+
 /* Set all kernel arguments. This function accepts a variable list of
  * arguments which must end with `NULL`. */
 CCL_EXPORT
@@ -182,6 +232,25 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
 	cl_uint dims, const size_t* real_worksize, size_t* gws, size_t* lws,
 	CCLErr** err);
 
+/* Suggest appropriate global and local worksizes for the given real
+ * work size, based on device and kernel characteristics, optionally
+ * using a cost model. */
+CCL_EXPORT
+cl_bool ccl_kernel_suggest_worksizes_full(CCLKernel* krnl, CCLDevice* dev,
+	cl_uint dims, const size_t* real_worksize, size_t* gws, size_t* lws,
+	CCLWorksizeFlags flags, CCLErr** err);
+
+/* Empirically determine the fastest local worksize for the given real
+ * work size, and store it in the tuning database. */
+CCL_EXPORT
+cl_bool ccl_kernel_autotune(CCLKernel* krnl, CCLQueue* cq, cl_uint dims,
+	const size_t* real_worksize, size_t* gws, size_t* lws, cl_uint reps,
+	CCLErr** err);
+
+/* Set the file of the tuning database. */
+CCL_EXPORT
+void ccl_kernel_set_tuning_db(const char* filename);
+
 /**
  * Get a ::CCLWrapperInfo kernel information object.
  *
@@ -214,7 +283,7 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
  * If an error occurs, zero is returned.
  * */
 #define ccl_kernel_get_info_scalar(krnl, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) (krnl), \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) (krnl), \
 		NULL, (param_name), sizeof(param_type), \
 		CCL_INFO_KERNEL, CL_FALSE, (err)))
 
@@ -275,7 +344,7 @@ cl_bool ccl_kernel_suggest_worksizes(CCLKernel* krnl, CCLDevice* dev,
  * */
 #define ccl_kernel_get_workgroup_info_scalar(krnl, dev, param_name, \
 	param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) (krnl), \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) (krnl), \
 		(CCLWrapper*) (dev), (param_name), sizeof(param_type), \
 		CCL_INFO_KERNEL_WORKGROUP, CL_FALSE, (err)))
 
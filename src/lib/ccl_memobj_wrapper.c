@@ -149,6 +149,9 @@ CCLEvent* ccl_memobj_enqueue_unmap(CCLMemObj* mo, CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event. */
@@ -188,6 +191,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return evt. */
 	return evt;
 
@@ -320,6 +326,9 @@ CCLEvent* ccl_memobj_enqueue_migrate(CCLMemObj** mos, cl_uint num_mos,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function status. */
 	cl_int ocl_status;
 	/* OpenCL event. */
@@ -408,6 +417,9 @@ finish:
 	/* Release stuff. */
 	if (mem_objects) g_slice_free1(sizeof(cl_mem) * num_mos, mem_objects);
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return evt. */
 	return evt;
 
@@ -128,7 +128,7 @@ CCLEvent* ccl_memobj_enqueue_migrate(CCLMemObj** mos, cl_uint num_mos,
  * If an error occurs, zero is returned.
  * */
 #define ccl_memobj_get_info_scalar(mo, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) mo, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) mo, \
 		NULL, param_name, sizeof(param_type), CCL_INFO_MEMOBJ, CL_FALSE, err))
 
 /**
@@ -26,8 +26,15 @@
  * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
  * */
 
+/* Required for clock_gettime() when compiling with -std=c99. */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+	#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include "ccl_profiler.h"
 #include "_ccl_defs.h"
+#include <math.h>
+#include <time.h>
 
 /**
  * @internal
@@ -64,7 +71,14 @@
  * sort criteria separately.
  * */
 #define ccl_prof_get_sort(userdata) \
-	{0x0F & *((int*) userdata), 0xF0 & *((int*) userdata)}
+	{0x0F & *((int*) userdata), 0xFF0 & *((int*) userdata)}
+
+/**
+ * @internal
+ * Number of bits, below the most significant one, which are kept
+ * exactly when recording durations in a ::CCLProfHist histogram.
+ * */
+#define CCL_PROF_HIST_SUB_BITS 7
 
 /**
  * @internal
@@ -81,6 +95,174 @@ typedef struct ccl_prof_sort_data {
 
 } CCLProfSort;
 
+/**
+ * @internal
+ * Device time interval of a recently consumed event, used for
+ * determining event overlaps in streaming mode.
+ * */
+typedef struct ccl_prof_interval {
+
+	/** Start instant. */
+	cl_ulong t_start;
+
+	/** End instant. */
+	cl_ulong t_end;
+
+	/** Event name ID. */
+	cl_uint event_name_id;
+
+} CCLProfInterval;
+
+/**
+ * @internal
+ * Histogram of event durations, with logarithmically sized buckets. Each
+ * power of two is divided into 2^::CCL_PROF_HIST_SUB_BITS buckets, such
+ * that durations are recorded with a relative error below 1%. The
+ * number of events, total duration, minimum and maximum durations, mean
+ * and variance are kept exactly.
+ * */
+typedef struct ccl_prof_hist {
+
+	/** Number of recorded durations. */
+	cl_uint count;
+
+	/** Sum of recorded durations. */
+	cl_ulong sum;
+
+	/** Minimum recorded duration. */
+	cl_ulong min;
+
+	/** Maximum recorded duration. */
+	cl_ulong max;
+
+	/** Mean of recorded durations. */
+	double mean;
+
+	/** Sum of squared differences from the mean. */
+	double m2;
+
+	/** Number of durations in each bucket. */
+	cl_ulong* buckets;
+
+	/** Number of allocated buckets. */
+	guint num_buckets;
+
+} CCLProfHist;
+
+/** Magic string identifying binary trace files. */
+#define CCL_PROF_BIN_MAGIC "CF4OCLTR"
+
+/** Version of the binary trace format. */
+#define CCL_PROF_BIN_VERSION 1
+
+/** Value used for detecting the byte order of binary trace files. */
+#define CCL_PROF_BIN_BYTE_ORDER 0x01020304
+
+/** Number of records buffered by the binary trace writer. */
+#define CCL_PROF_BIN_BUFSIZE 4096
+
+/** Maximum number of unconsumed host API calls kept for each thread,
+ * and for all exited threads. */
+#define CCL_PROF_HOST_TRACE_MAX_CALLS 65536
+
+/**
+ * @internal
+ * Header of binary trace files.
+ * */
+typedef struct ccl_prof_bin_header {
+
+	/** Magic string, ::CCL_PROF_BIN_MAGIC (not null-terminated). */
+	char magic[8];
+
+	/** Format version, ::CCL_PROF_BIN_VERSION. */
+	guint32 version;
+
+	/** ::CCL_PROF_BIN_BYTE_ORDER in the byte order of the writer. */
+	guint32 byte_order;
+
+	/** Number of event names in the string table. */
+	guint32 num_event_names;
+
+	/** Number of queue names in the string table. */
+	guint32 num_queue_names;
+
+	/** Size in bytes of the string table, a multiple of 8. */
+	guint64 strings_size;
+
+	/** Number of event records. */
+	guint64 num_records;
+
+} CCLProfBinHeader;
+
+/**
+ * @internal
+ * Fixed-width event record of binary trace files.
+ * */
+typedef struct ccl_prof_bin_record {
+
+	/** Queued instant. */
+	guint64 t_queued;
+
+	/** Submit instant. */
+	guint64 t_submit;
+
+	/** Start instant. */
+	guint64 t_start;
+
+	/** End instant. */
+	guint64 t_end;
+
+	/** Type of command which produced the event. */
+	guint32 command_type;
+
+	/** Queue name ID. */
+	guint32 queue_id;
+
+	/** Event name ID. */
+	guint32 event_name_id;
+
+	/** Unused, keeps records 8-byte aligned. */
+	guint32 reserved;
+
+} CCLProfBinRecord;
+
+/**
+ * @internal
+ * Event profiling information stored column-wise, i.e. as a structure
+ * of arrays, with one element per event in each array. Event and queue
+ * names are kept as integer IDs.
+ * */
+typedef struct ccl_prof_info_cols {
+
+	/** Number of events. */
+	guint len;
+
+	/** Number of events which can be held without reallocation. */
+	guint cap;
+
+	/** Event name IDs. */
+	cl_uint* event_name_id;
+
+	/** Command queue name IDs. */
+	cl_uint* queue_name_id;
+
+	/** Type of command which produced each event. */
+	cl_command_type* command_type;
+
+	/** Queued instants. */
+	cl_ulong* t_queued;
+
+	/** Submit instants. */
+	cl_ulong* t_submit;
+
+	/** Start instants. */
+	cl_ulong* t_start;
+
+	/** End instants. */
+	cl_ulong* t_end;
+
+} CCLProfInfoCols;
+
 /**
  * Profile class, contains profiling information of OpenCL
  * queues and events.
@@ -116,6 +298,13 @@ struct ccl_prof {
 	 * */
 	GHashTable* queues;
 
+	/**
+	 * Names of profiled command queues, indexed by command queue name
+	 * ID.
+	 * @private
+	 * */
+	GPtrArray* queue_names;
+
 	/**
 	 * Total number of events.
 	 * @private
@@ -123,16 +312,18 @@ struct ccl_prof {
 	cl_uint num_events;
 
 	/**
-	 * Instants (start and end) of all events.
+	 * Indexes (in ::CCLProf::infos) of events which used device time,
+	 * i.e. with distinct start and end instants. Each of these events
+	 * has two instants: `2 * i` (start) and `2 * i + 1` (end).
 	 * @private
 	 * */
-	GList* instants;
+	GArray* instants;
 
 	/**
-	 * List of all events profiling information.
+	 * Profiling information of all events.
 	 * @private
 	 * */
-	GList* infos;
+	CCLProfInfoCols infos;
 
 	/**
 	 * Aggregate statistics for all events in
@@ -153,17 +344,41 @@ struct ccl_prof {
 	 * */
 	GList* agg_iter;
 
+	/**
+	 * Order in which event profiling information is iterated.
+	 * @private
+	 * */
+	cl_uint* info_order;
+
 	/**
 	 * Event info iterator.
 	 * @private
 	 * */
-	GList* info_iter;
+	guint info_iter;
+
+	/**
+	 * Event profiling information object returned by the iterator.
+	 * @private
+	 * */
+	CCLProfInfo info_curr;
+
+	/**
+	 * Order in which event instants are iterated.
+	 * @private
+	 * */
+	cl_uint* inst_order;
 
 	/**
 	 * Event instant iterator.
 	 * @private
 	 * */
-	GList* inst_iter;
+	guint inst_iter;
+
+	/**
+	 * Event instant object returned by the iterator.
+	 * @private
+	 * */
+	CCLProfInst inst_curr;
 
 	/**
 	 * Overlaps iterator.
@@ -202,6 +417,101 @@ struct ccl_prof {
 	 * */
 	GTimer* timer;
 
+	/**
+	 * Flag indicating if events are being consumed incrementally with
+	 * ccl_prof_poll().
+	 * @private
+	 * */
+	gboolean stream;
+
+	/**
+	 * Duration histograms updated incrementally in streaming mode
+	 * (key: event name, value: ::CCLProfHist object).
+	 * @private
+	 * */
+	GHashTable* stream_hists;
+
+	/**
+	 * Overlap matrix updated incrementally in streaming mode, indexed
+	 * by event name IDs.
+	 * @private
+	 * */
+	cl_ulong* stream_overlaps;
+
+	/**
+	 * Number of rows (and columns) of the streaming mode overlap matrix.
+	 * @private
+	 * */
+	cl_uint stream_overlaps_dim;
+
+	/**
+	 * Total overlap time determined in streaming mode.
+	 * @private
+	 * */
+	cl_ulong stream_total_overlap;
+
+	/**
+	 * Intervals of consumed events which may still overlap with events
+	 * not yet consumed (array of ::CCLProfInterval).
+	 * @private
+	 * */
+	GArray* stream_window;
+
+	/**
+	 * End instant of the latest event consumed from each queue (key:
+	 * queue name, value: pointer to `cl_ulong`).
+	 * @private
+	 * */
+	GHashTable* stream_t_last;
+
+	/**
+	 * Consume host API calls recorded with host tracing?
+	 * @private
+	 * */
+	gboolean host_trace;
+
+	/**
+	 * Host API calls consumed by this profile object (array of
+	 * ::CCLProfHostCall).
+	 * @private
+	 * */
+	GArray* host_calls;
+
+	/**
+	 * Index of host API calls which produced events (key: event
+	 * wrapper, value: index in `host_calls` plus one). Only used while
+	 * calculating.
+	 * @private
+	 * */
+	GHashTable* host_objs;
+
+	/**
+	 * Lower and upper bounds of the offset between the host and device
+	 * clocks, determined from the events produced by host API calls.
+	 * @private
+	 * */
+	gint64 host_offset_lo, host_offset_hi;
+
+	/**
+	 * Number of events used to bound the host/device clock offset.
+	 * @private
+	 * */
+	guint host_offset_samples;
+
+	/**
+	 * Offset to add to host instants for converting them into device
+	 * time.
+	 * @private
+	 * */
+	gint64 host_offset;
+
+	/**
+	 * Binary trace file mapped by ccl_prof_new_from_bin_file(), which
+	 * holds the event and queue names.
+	 * @private
+	 * */
+	GMappedFile* mapped;
+
 };
 
 /* Default export options. */
@@ -217,271 +527,545 @@ static CCLProfExportOptions export_options = {
 
 /**
  * @internal
- * Create new event instant.
- *
- * @private @memberof ccl_prof_inst
- *
- * @param[in] event_name Name of event.
- * @param[in] queue_name Name of command queue associated with event.
- * @param[in] id Id of event.
- * @param[in] instant Even instant in nanoseconds.
- * @param[in] type Type of event instant: CCL_PROF_INST_TYPE_START or
- * CCL_PROF_INST_TYPE_END.
- * @return A new event instant.
- */
-static CCLProfInst* ccl_prof_inst_new(const char* event_name,
-	const char* queue_name, cl_uint id, cl_ulong instant,
-	CCLProfInstType type) {
+ * A host API call recorded with host tracing.
+ * */
+typedef struct ccl_prof_host_call {
 
-	/* Allocate memory for event instant data structure. */
-	CCLProfInst* inst = g_slice_new(CCLProfInst);
+	/** Name of called function. */
+	const char* func;
 
-	/* Initialize structure fields. */
-	inst->event_name = event_name;
-	inst->queue_name = queue_name;
-	inst->id = id;
-	inst->instant = instant;
-	inst->type = type;
+	/** Host instant (ns) at which the call started. */
+	guint64 t_start;
 
-	/* Return event instant data structure. */
-	return inst;
-}
+	/** Host instant (ns) at which the call returned. */
+	guint64 t_end;
+
+	/** Object produced by the call, e.g. an event wrapper, or `NULL`. */
+	gconstpointer obj;
+
+	/** Number of thread which performed the call, starting at 1. */
+	guint thread;
+
+} CCLProfHostCall;
 
 /**
  * @internal
- * Free an event instant.
- *
- * @private @memberof ccl_prof_inst
- *
- * @param[in] instant Event instant to destroy.
- */
-static void ccl_prof_inst_destroy(CCLProfInst* instant) {
+ * Per-thread buffer of recorded host API calls.
+ * */
+typedef struct ccl_prof_host_buf {
 
-	g_return_if_fail(instant != NULL);
+	/** Synchronizes the owner thread with a consuming profile object. */
+	GMutex lock;
 
-	g_slice_free(CCLProfInst, instant);
-}
+	/** Recorded calls (array of ::CCLProfHostCall). */
+	GArray* calls;
+
+	/** Number of calls discarded because the buffer was full. */
+	guint dropped;
+
+	/** Number of thread which owns the buffer, starting at 1. */
+	guint thread;
+
+} CCLProfHostBuf;
+
+static void ccl_prof_host_buf_exit(gpointer data);
+
+/* Is host tracing enabled? */
+static volatile gint host_trace_enabled = 0;
+
+/* Host trace buffer of the current thread, merged into the calls of
+ * exited threads when the thread exits. */
+static GPrivate host_trace_buf = G_PRIVATE_INIT(ccl_prof_host_buf_exit);
+
+/* Host trace buffers of all live threads which performed traced
+ * calls. */
+static GPtrArray* host_trace_bufs = NULL;
+
+/* Calls recorded by threads which have exited (array of
+ * ::CCLProfHostCall), and number of their calls which were discarded
+ * because the array was full. */
+static GArray* host_trace_exited = NULL;
+static guint host_trace_exited_dropped = 0;
+
+/* Number of threads which performed traced calls. */
+static guint host_trace_num_threads = 0;
+
+/* Protects the list of host trace buffers, the calls of exited
+ * threads and the number of threads. */
+static GMutex host_trace_bufs_lock;
 
 /**
  * @internal
- * Compares two event instants for sorting within a GList. It is
- * an implementation of GCompareDataFunc from GLib.
+ * Get the current instant of the host monotonic clock.
  *
- * @private @memberof ccl_prof_inst
- *
- * @param[in] a First event instant to compare.
- * @param[in] b Second event instant to compare.
- * @param[in] userdata Defines the sort criteria and order.
- * @return Negative value if a < b; zero if a = b; positive value if
- * a > b.
- */
-static gint ccl_prof_inst_comp(
-	gconstpointer a, gconstpointer b, gpointer userdata) {
+ * @return Current instant of the host monotonic clock, in nanoseconds.
+ * */
+static guint64 ccl_prof_host_now() {
+
+#if defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((guint64) ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+	return ((guint64) g_get_monotonic_time()) * 1000;
+#endif
 
-	/* Cast input parameters to event instant data structures. */
-	CCLProfInst* ev_inst1 = (CCLProfInst*) a;
-	CCLProfInst* ev_inst2 = (CCLProfInst*) b;
-	CCLProfSort sort = ccl_prof_get_sort(userdata);
-	/* Perform comparison. */
-	switch ((CCLProfInstSort) sort.criteria) {
-		gint result;
-		case CCL_PROF_INST_SORT_INSTANT:
-			/* Sort by instant */
-			return CCL_PROF_CMP_INT(ev_inst1->instant, ev_inst2->instant,
-				sort.order);
-		case CCL_PROF_INST_SORT_ID:
-			/* Sort by ID */
-			result = CCL_PROF_CMP_INT(ev_inst1->id, ev_inst2->id,
-				sort.order);
-			if (result != 0) return result;
-			if (ev_inst1->type == CCL_PROF_INST_TYPE_START)
-				return sort.order ? 1 : -1;
-			if (ev_inst1->type == CCL_PROF_INST_TYPE_END)
-				return sort.order ? -1 : 1;
-		/* We shouldn't get here. */
-		default:
-			g_warning("Unknown PROF_INST sort criteria/order.");
-			return 0;
-	}
 }
 
 /**
  * @internal
- * Create a new aggregate statistic for events of a given type.
- *
- * @private @memberof ccl_prof_agg
+ * Release the host trace buffer of an exiting thread, keeping its
+ * recorded calls (up to ::CCL_PROF_HOST_TRACE_MAX_CALLS calls of
+ * exited threads) until they are consumed by a profile object.
  *
- * @param[in] event_name Name of event.
- * @return New aggregate statistic.
+ * @param[in] data Host trace buffer of the exiting thread.
  * */
-static CCLProfAgg* ccl_prof_agg_new(const char* event_name) {
-	CCLProfAgg* agg = g_slice_new(CCLProfAgg);
-	agg->event_name = event_name;
-	return agg;
+static void ccl_prof_host_buf_exit(gpointer data) {
+
+	/* Trace buffer of exiting thread. */
+	CCLProfHostBuf* buf = (CCLProfHostBuf*) data;
+	/* Number of calls to keep. */
+	guint num_keep;
+
+	/* Once the buffer is no longer listed, no profile object can
+	 * consume it, so its lock is not required. */
+	g_mutex_lock(&host_trace_bufs_lock);
+	g_ptr_array_remove(host_trace_bufs, buf);
+	if (host_trace_exited == NULL) {
+		host_trace_exited =
+			g_array_new(FALSE, FALSE, sizeof(CCLProfHostCall));
+	}
+	num_keep = MIN(buf->calls->len,
+		CCL_PROF_HOST_TRACE_MAX_CALLS - host_trace_exited->len);
+	g_array_append_vals(host_trace_exited, buf->calls->data, num_keep);
+	host_trace_exited_dropped +=
+		buf->dropped + (buf->calls->len - num_keep);
+	g_mutex_unlock(&host_trace_bufs_lock);
+
+	/* Release buffer. */
+	g_array_free(buf->calls, TRUE);
+	g_mutex_clear(&buf->lock);
+	g_free(buf);
+
 }
 
 /**
  * @internal
- * Free an aggregate statistic.
+ * Start tracing a host API call. Used by the ::CCL_HOST_TRACE_BEGIN()
+ * macro.
  *
- * @private @memberof ccl_prof_agg
- *
- * @param[in] agg Aggregate statistic to free.
+ * @return The host instant at which the call started, or zero if host
+ * tracing is disabled.
  * */
-static void ccl_prof_agg_destroy(CCLProfAgg* agg) {
-	g_return_if_fail(agg != NULL);
-	g_slice_free(CCLProfAgg, agg);
+guint64 ccl_prof_host_trace_begin() {
+
+	return g_atomic_int_get(&host_trace_enabled) ? ccl_prof_host_now() : 0;
+
 }
 
 /**
  * @internal
- * Compares two aggregate event data instances for sorting
- * within a GList. It is an implementation of GCompareDataFunc from GLib.
- *
- * @private @memberof ccl_prof_agg
+ * Record a host API call in the current thread's trace buffer. Used by
+ * the ::CCL_HOST_TRACE_END() macro.
  *
- * @param[in] a First aggregate event data instance to compare.
- * @param[in] b Second aggregate event data instance to compare.
- * @param[in] userdata Defines the sort criteria and order.
- * @return Negative value if a < b; zero if a = b; positive value if
- * a > b.
- */
-static gint ccl_prof_agg_comp(
-	gconstpointer a, gconstpointer b, gpointer userdata) {
-
-	/* Cast input parameters to event instant data structures. */
-	CCLProfAgg* ev_agg1 = (CCLProfAgg*) a;
-	CCLProfAgg* ev_agg2 = (CCLProfAgg*) b;
-	CCLProfSort sort = ccl_prof_get_sort(userdata);
-
-	/* Perform comparison. */
-	switch ((CCLProfAggSort) sort.criteria) {
-
-		/* Sort by event name. */
-		case CCL_PROF_AGG_SORT_NAME:
-			return CCL_PROF_CMP_STR(ev_agg1->event_name,
-				ev_agg2->event_name, sort.order);
-
-		/* Sort by absolute time. */
-		case CCL_PROF_AGG_SORT_TIME:
-			return CCL_PROF_CMP_INT(ev_agg1->absolute_time,
-				ev_agg2->absolute_time, sort.order);
-
-		/* We shouldn't get here. */
-		default:
-			g_warning("Unknown PROF_AGG sort criteria/order.");
-			return 0;
+ * @param[in] func Name of called function.
+ * @param[in] t_start Value returned by ccl_prof_host_trace_begin() when
+ * the call started.
+ * @param[in] obj Object produced by the call, or `NULL`.
+ * */
+void ccl_prof_host_trace_end(
+	const char* func, guint64 t_start, gconstpointer obj) {
+
+	/* Trace buffer of current thread. */
+	CCLProfHostBuf* buf;
+	/* Call to record. */
+	CCLProfHostCall call;
+
+	/* Calls started while tracing was disabled are not recorded. */
+	if (t_start == 0) return;
+
+	call.func = func;
+	call.t_start = t_start;
+	call.t_end = ccl_prof_host_now();
+	call.obj = obj;
+
+	/* Get trace buffer of current thread, creating and registering it
+	 * in the first traced call. */
+	buf = (CCLProfHostBuf*) g_private_get(&host_trace_buf);
+	if (buf == NULL) {
+		buf = g_new0(CCLProfHostBuf, 1);
+		g_mutex_init(&buf->lock);
+		buf->calls = g_array_new(FALSE, FALSE, sizeof(CCLProfHostCall));
+		g_mutex_lock(&host_trace_bufs_lock);
+		if (host_trace_bufs == NULL)
+			host_trace_bufs = g_ptr_array_new();
+		g_ptr_array_add(host_trace_bufs, buf);
+		buf->thread = ++host_trace_num_threads;
+		g_mutex_unlock(&host_trace_bufs_lock);
+		g_private_set(&host_trace_buf, buf);
 	}
+	call.thread = buf->thread;
+
+	/* Record call, unless the buffer is full. The buffer lock is only
+	 * contended while a profile object is consuming the recorded
+	 * calls. */
+	g_mutex_lock(&buf->lock);
+	if (buf->calls->len < CCL_PROF_HOST_TRACE_MAX_CALLS)
+		g_array_append_val(buf->calls, call);
+	else
+		buf->dropped++;
+	g_mutex_unlock(&buf->lock);
 
 }
 
 /**
  * @internal
- * Create a new event profiling information object.
+ * Move the host API calls recorded by all threads into the given
+ * profile object, and index the calls which produced an object.
  *
- * @private @memberof ccl_prof_info
+ * @private @memberof ccl_prof
  *
- * @param[in] event_name Name of event.
- * @param[in] command_type Type of command which produced the event.
- * @param[in] queue_name Name of command queue which generated this
- * event.
- * @param[in] t_queued Device time in nanoseconds when the command
- * identified by event is enqueued in a command-queue by the host.
- * @param[in] t_submit Device time counter in nanoseconds when the
- * command identified by event that has been enqueued is submitted by
- * the host to the device associated with the command-queue.
- * @param[in] t_start Device time in nanoseconds when the command
- * identified by event starts execution on the device.
- * @param[in] t_end Device time in nanoseconds when the command
- * identified by event has finished execution on the device.
- * @return A new event profiling information object.
- * */
-static CCLProfInfo* ccl_prof_info_new(const char* event_name,
-	cl_command_type command_type, const char* queue_name,
-	cl_ulong t_queued, cl_ulong t_submit, cl_ulong t_start,
-	cl_ulong t_end) {
-
-	CCLProfInfo* info = g_slice_new(CCLProfInfo);
-
-	info->event_name = event_name;
-	info->command_type = command_type;
-	info->queue_name = queue_name;
-	info->t_queued = t_queued;
-	info->t_submit = t_submit;
-	info->t_start = t_start;
-	info->t_end = t_end;
-
-	return info;
+ * @param[in] prof Profile object.
+ * */
+static void ccl_prof_host_trace_consume(CCLProf* prof) {
+
+	/* Number of calls discarded because buffers were full. */
+	guint dropped;
+
+	prof->host_calls = g_array_new(FALSE, FALSE, sizeof(CCLProfHostCall));
+	prof->host_objs = g_hash_table_new(g_direct_hash, g_direct_equal);
+	prof->host_offset_lo = -G_MAXINT64;
+	prof->host_offset_hi = G_MAXINT64;
+
+	/* Drain calls of exited threads and buffers of live threads. */
+	g_mutex_lock(&host_trace_bufs_lock);
+	dropped = host_trace_exited_dropped;
+	host_trace_exited_dropped = 0;
+	if (host_trace_exited != NULL) {
+		g_array_append_vals(prof->host_calls, host_trace_exited->data,
+			host_trace_exited->len);
+		g_array_free(host_trace_exited, TRUE);
+		host_trace_exited = NULL;
+	}
+	for (guint i = 0;
+		host_trace_bufs != NULL && i < host_trace_bufs->len; ++i) {
+
+		CCLProfHostBuf* buf = g_ptr_array_index(host_trace_bufs, i);
+		g_mutex_lock(&buf->lock);
+		g_array_append_vals(prof->host_calls, buf->calls->data,
+			buf->calls->len);
+		g_array_set_size(buf->calls, 0);
+		dropped += buf->dropped;
+		buf->dropped = 0;
+		g_mutex_unlock(&buf->lock);
+	}
+	g_mutex_unlock(&host_trace_bufs_lock);
+
+	if (dropped > 0)
+		g_warning("%u host API calls were not traced because trace "
+			"buffers were full.", dropped);
+
+	/* Index calls by produced object. If an object address was reused,
+	 * the latest call wins. */
+	for (guint i = 0; i < prof->host_calls->len; ++i) {
+		CCLProfHostCall* call =
+			&g_array_index(prof->host_calls, CCLProfHostCall, i);
+		if (call->obj != NULL)
+			g_hash_table_insert(prof->host_objs,
+				(gpointer) call->obj, GUINT_TO_POINTER(i + 1));
+	}
+
 }
 
 /**
  * @internal
- * Free an event profiling information object.
+ * Narrow the bounds of the offset between host and device clocks using
+ * the given event. If the event was produced by a traced host API call,
+ * the device instant at which it was queued must have occurred during
+ * the call.
  *
- * @private @memberof ccl_prof_info
+ * @private @memberof ccl_prof
  *
- * @param[in] info Event profiling information object to free.
+ * @param[in] prof Profile object.
+ * @param[in] evt Event wrapper.
+ * @param[in] t_queued Device instant at which the event was queued.
  * */
-static void ccl_prof_info_destroy(CCLProfInfo* info) {
-	g_return_if_fail(info != NULL);
-	g_slice_free(CCLProfInfo, info);
-}
+static void ccl_prof_host_trace_align(
+	CCLProf* prof, CCLEvent* evt, cl_ulong t_queued) {
 
-/**
+	/* Index of call which produced the event, plus one. */
+	guint idx;
+	/* Call which produced the event. */
+	CCLProfHostCall* call;
+
+	if ((prof->host_objs == NULL) || (t_queued == 0)) return;
+
+	idx = GPOINTER_TO_UINT(g_hash_table_lookup(prof->host_objs, evt));
+	if (idx == 0) return;
+
+	call = &g_array_index(prof->host_calls, CCLProfHostCall, idx - 1);
+	prof->host_offset_lo = MAX(prof->host_offset_lo,
+		(gint64) t_queued - (gint64) call->t_end);
+	prof->host_offset_hi = MIN(prof->host_offset_hi,
+		(gint64) t_queued - (gint64) call->t_start);
+	prof->host_offset_samples++;
+
+}
+
+/**
+ * @internal
+ * Determine the offset between host and device clocks from the bounds
+ * gathered with ccl_prof_host_trace_align(), and release the index of
+ * calls by produced object.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * */
+static void ccl_prof_host_trace_finish(CCLProf* prof) {
+
+	if (prof->host_offset_samples == 0) {
+		/* Without events produced by traced calls, clocks are assumed
+		 * to be the same. */
+		prof->host_offset = 0;
+		if (prof->host_calls->len > 0)
+			g_info("No events to align host and device clocks, " \
+				"assuming a zero offset.");
+	} else if (prof->host_offset_lo <= prof->host_offset_hi) {
+		/* Use center of the interval consistent with all events. */
+		prof->host_offset = prof->host_offset_lo
+			+ (prof->host_offset_hi - prof->host_offset_lo) / 2;
+	} else {
+		/* Bounds are inconsistent (e.g. due to clock drift), use the
+		 * lower bound, so that no event is queued before its call. */
+		prof->host_offset = prof->host_offset_lo;
+	}
+
+	g_hash_table_destroy(prof->host_objs);
+	prof->host_objs = NULL;
+
+}
+
+/**
+ * @internal
+ * Determine the histogram bucket for a given duration.
+ *
+ * @param[in] value Duration.
+ * @return Bucket index.
+ * */
+static guint ccl_prof_hist_bucket(cl_ulong value) {
+
+	/* Number of least significant bits dropped from value. */
+	guint shift = 0;
+
+	/* Keep the CCL_PROF_HIST_SUB_BITS + 1 most significant bits. */
+	while ((value >> shift) >> (CCL_PROF_HIST_SUB_BITS + 1)) shift++;
+
+	return (shift << CCL_PROF_HIST_SUB_BITS) + (guint) (value >> shift);
+
+}
+
+/**
+ * @internal
+ * Add a duration to a histogram.
+ *
+ * @param[in] hist Histogram.
+ * @param[in] value Duration to add.
+ * */
+static void ccl_prof_hist_add(CCLProfHist* hist, cl_ulong value) {
+
+	/* Histogram bucket for duration. */
+	guint bucket = ccl_prof_hist_bucket(value);
+	/* Difference from current mean. */
+	double delta = (double) value - hist->mean;
+
+	/* Grow buckets if necessary. */
+	if (bucket >= hist->num_buckets) {
+		guint num_buckets = MAX(bucket + 1, 2 * hist->num_buckets);
+		hist->buckets = g_renew(cl_ulong, hist->buckets, num_buckets);
+		memset(hist->buckets + hist->num_buckets, 0,
+			(num_buckets - hist->num_buckets) * sizeof(cl_ulong));
+		hist->num_buckets = num_buckets;
+	}
+
+	/* Update histogram and exact statistics (Welford's algorithm for
+	 * mean and variance). */
+	hist->buckets[bucket]++;
+	hist->min = hist->count > 0 ? MIN(hist->min, value) : value;
+	hist->max = hist->count > 0 ? MAX(hist->max, value) : value;
+	hist->count++;
+	hist->sum += value;
+	hist->mean += delta / hist->count;
+	hist->m2 += delta * ((double) value - hist->mean);
+
+}
+
+/**
+ * @internal
+ * Estimate a quantile of the durations recorded in a histogram.
+ *
+ * @param[in] hist Histogram.
+ * @param[in] q Quantile, between 0 and 1.
+ * @return Estimated quantile, i.e. the midpoint of the bucket which
+ * contains it, clamped to the minimum and maximum recorded durations.
+ * */
+static cl_ulong ccl_prof_hist_quantile(const CCLProfHist* hist, double q) {
+
+	/* Rank of quantile and cumulative number of durations. */
+	cl_ulong rank, cumul = 0;
+	/* Current bucket. */
+	guint bucket;
+
+	if (hist->count == 0) return 0;
+
+	/* Determine rank of quantile. */
+	rank = (cl_ulong) ceil(q * hist->count);
+	rank = CLAMP(rank, 1, hist->count);
+
+	/* Find bucket containing the rank. */
+	for (bucket = 0; bucket < hist->num_buckets; ++bucket) {
+		cumul += hist->buckets[bucket];
+		if (cumul >= rank) break;
+	}
+
+	/* Determine midpoint of bucket. */
+	guint shift = bucket >> CCL_PROF_HIST_SUB_BITS;
+	shift = shift > 0 ? shift - 1 : 0;
+	cl_ulong low = ((cl_ulong) (bucket - (shift << CCL_PROF_HIST_SUB_BITS)))
+		<< shift;
+	cl_ulong mid = low + (((G_GUINT64_CONSTANT(1) << shift) - 1) / 2);
+
+	return CLAMP(mid, hist->min, hist->max);
+
+}
+
+/**
+ * @internal
+ * Set the duration statistics of an aggregate statistic from a
+ * histogram.
+ *
+ * @param[in] hist Histogram.
+ * @param[out] agg Aggregate statistic.
+ * */
+static void ccl_prof_hist_fill_agg(
+	const CCLProfHist* hist, CCLProfAgg* agg) {
+
+	agg->absolute_time = hist->sum;
+	agg->count = hist->count;
+	agg->min = hist->min;
+	agg->max = hist->max;
+	agg->mean = hist->mean;
+	agg->stddev = hist->count > 1
+		? sqrt(hist->m2 / (hist->count - 1)) : 0.0;
+	agg->p50 = ccl_prof_hist_quantile(hist, 0.50);
+	agg->p95 = ccl_prof_hist_quantile(hist, 0.95);
+	agg->p99 = ccl_prof_hist_quantile(hist, 0.99);
+
+}
+
+/**
+ * @internal
+ * Free a histogram allocated with g_slice_new0().
+ *
+ * @param[in] hist Histogram to free.
+ * */
+static void ccl_prof_hist_destroy(CCLProfHist* hist) {
+	g_return_if_fail(hist != NULL);
+	g_free(hist->buckets);
+	g_slice_free(CCLProfHist, hist);
+}
+
+/**
+ * @internal
+ * Create a new aggregate statistic for events of a given type.
+ *
+ * @private @memberof ccl_prof_agg
+ *
+ * @param[in] event_name Name of event.
+ * @return New aggregate statistic.
+ * */
+static CCLProfAgg* ccl_prof_agg_new(const char* event_name) {
+	CCLProfAgg* agg = g_slice_new0(CCLProfAgg);
+	agg->event_name = event_name;
+	return agg;
+}
+
+/**
  * @internal
- * Compares two event profiling information instances for sorting
+ * Free an aggregate statistic.
+ *
+ * @private @memberof ccl_prof_agg
+ *
+ * @param[in] agg Aggregate statistic to free.
+ * */
+static void ccl_prof_agg_destroy(CCLProfAgg* agg) {
+	g_return_if_fail(agg != NULL);
+	g_slice_free(CCLProfAgg, agg);
+}
+
+/**
+ * @internal
+ * Compares two aggregate event data instances for sorting
  * within a GList. It is an implementation of GCompareDataFunc from GLib.
  *
- * @private @memberof ccl_prof_info
+ * @private @memberof ccl_prof_agg
  *
- * @param[in] a First event profiling information instance to compare.
- * @param[in] b Second event profiling information instance to compare.
+ * @param[in] a First aggregate event data instance to compare.
+ * @param[in] b Second aggregate event data instance to compare.
  * @param[in] userdata Defines the sort criteria and order.
  * @return Negative value if a < b; zero if a = b; positive value if
  * a > b.
  */
-static gint ccl_prof_info_comp(
+static gint ccl_prof_agg_comp(
 	gconstpointer a, gconstpointer b, gpointer userdata) {
 
 	/* Cast input parameters to event instant data structures. */
-	CCLProfInfo* ev1 = (CCLProfInfo*) a;
-	CCLProfInfo* ev2 = (CCLProfInfo*) b;
+	CCLProfAgg* ev_agg1 = (CCLProfAgg*) a;
+	CCLProfAgg* ev_agg2 = (CCLProfAgg*) b;
 	CCLProfSort sort = ccl_prof_get_sort(userdata);
-	/* Perform comparison. */
-	switch ((CCLProfInfoSort) sort.criteria) {
-
-		 /* Sort aggregate event data instances by event name. */
-		case CCL_PROF_INFO_SORT_NAME_EVENT:
-			return CCL_PROF_CMP_STR(ev1->event_name, ev2->event_name,
-				sort.order);
 
-		 /* Sort aggregate event data instances by queue name. */
-		case CCL_PROF_INFO_SORT_NAME_QUEUE:
-			return CCL_PROF_CMP_STR(ev1->queue_name, ev2->queue_name,
-				sort.order);
-
-		 /* Sort aggregate event data instances by queued time. */
-		case CCL_PROF_INFO_SORT_T_QUEUED:
-			return CCL_PROF_CMP_INT(ev1->t_queued, ev2->t_queued,
-				sort.order);
+	/* Perform comparison. */
+	switch ((CCLProfAggSort) sort.criteria) {
 
-		 /* Sort aggregate event data instances by submit time. */
-		case CCL_PROF_INFO_SORT_T_SUBMIT:
-			return CCL_PROF_CMP_INT(ev1->t_submit, ev2->t_submit,
-				sort.order);
+		/* Sort by event name. */
+		case CCL_PROF_AGG_SORT_NAME:
+			return CCL_PROF_CMP_STR(ev_agg1->event_name,
+				ev_agg2->event_name, sort.order);
 
-		 /* Sort aggregate event data instances by start time. */
-		case CCL_PROF_INFO_SORT_T_START:
-			return CCL_PROF_CMP_INT(ev1->t_start, ev2->t_start,
-				sort.order);
+		/* Sort by absolute time. */
+		case CCL_PROF_AGG_SORT_TIME:
+			return CCL_PROF_CMP_INT(ev_agg1->absolute_time,
+				ev_agg2->absolute_time, sort.order);
 
-		 /* Sort aggregate event data instances by end time. */
-		case CCL_PROF_INFO_SORT_T_END:
-			return CCL_PROF_CMP_INT(ev1->t_end, ev2->t_end, sort.order);
+		/* Sort by duration statistics. */
+		case CCL_PROF_AGG_SORT_COUNT:
+			return CCL_PROF_CMP_INT(ev_agg1->count,
+				ev_agg2->count, sort.order);
+		case CCL_PROF_AGG_SORT_MEAN:
+			return CCL_PROF_CMP_INT(ev_agg1->mean,
+				ev_agg2->mean, sort.order);
+		case CCL_PROF_AGG_SORT_STDDEV:
+			return CCL_PROF_CMP_INT(ev_agg1->stddev,
+				ev_agg2->stddev, sort.order);
+		case CCL_PROF_AGG_SORT_MIN:
+			return CCL_PROF_CMP_INT(ev_agg1->min,
+				ev_agg2->min, sort.order);
+		case CCL_PROF_AGG_SORT_MAX:
+			return CCL_PROF_CMP_INT(ev_agg1->max,
+				ev_agg2->max, sort.order);
+		case CCL_PROF_AGG_SORT_P50:
+			return CCL_PROF_CMP_INT(ev_agg1->p50,
+				ev_agg2->p50, sort.order);
+		case CCL_PROF_AGG_SORT_P95:
+			return CCL_PROF_CMP_INT(ev_agg1->p95,
+				ev_agg2->p95, sort.order);
+		case CCL_PROF_AGG_SORT_P99:
+			return CCL_PROF_CMP_INT(ev_agg1->p99,
+				ev_agg2->p99, sort.order);
 
 		/* We shouldn't get here. */
 		default:
-			g_warning("Unknown PROF_INFO sort criteria/order.");
+			g_warning("Unknown PROF_AGG sort criteria/order.");
 			return 0;
 	}
 
@@ -573,6 +1157,87 @@ static gint ccl_prof_overlap_comp(
 
 }
 
+/**
+ * @internal
+ * Add the profiling record of an event for profiling.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] cq_name_id Command queue name ID.
+ * @param[in] rec Profiling record of event.
+ * */
+static void ccl_prof_add_record(CCLProf* prof, cl_uint cq_name_id,
+	const CCLEventRecord* rec) {
+
+	/* Event name ID. */
+	gpointer event_name_id;
+	/* Event profiling information columns. */
+	CCLProfInfoCols* infos = &prof->infos;
+	/* Index of event in columns. */
+	guint idx = infos->len;
+
+	/* Update number of profilable events. */
+	prof->num_events++;
+
+	/* Check if event name is already registered in the table of event
+	 * names... */
+	if (!g_hash_table_lookup_extended(
+		prof->event_names, rec->event_name, NULL, &event_name_id)) {
+		/* ...if not, register it. */
+		event_name_id =
+			GUINT_TO_POINTER(g_hash_table_size(prof->event_names));
+		g_hash_table_insert(
+			prof->event_names,
+			(gpointer) rec->event_name,
+			event_name_id);
+	}
+
+	/* Grow columns if necessary. */
+	if (infos->len == infos->cap) {
+		infos->cap = infos->cap > 0 ? 2 * infos->cap : 256;
+		infos->event_name_id =
+			g_renew(cl_uint, infos->event_name_id, infos->cap);
+		infos->queue_name_id =
+			g_renew(cl_uint, infos->queue_name_id, infos->cap);
+		infos->command_type =
+			g_renew(cl_command_type, infos->command_type, infos->cap);
+		infos->t_queued = g_renew(cl_ulong, infos->t_queued, infos->cap);
+		infos->t_submit = g_renew(cl_ulong, infos->t_submit, infos->cap);
+		infos->t_start = g_renew(cl_ulong, infos->t_start, infos->cap);
+		infos->t_end = g_renew(cl_ulong, infos->t_end, infos->cap);
+	}
+
+	/* Add event information to columns. */
+	infos->event_name_id[idx] = GPOINTER_TO_UINT(event_name_id);
+	infos->queue_name_id[idx] = cq_name_id;
+	infos->command_type[idx] = rec->command_type;
+	infos->t_queued[idx] = rec->t_queued;
+	infos->t_submit[idx] = rec->t_submit;
+	infos->t_start[idx] = rec->t_start;
+	infos->t_end[idx] = rec->t_end;
+	infos->len++;
+
+	/* If end instant occurs after start instant... */
+	if (rec->t_end > rec->t_start) {
+
+		/* Add event to list of events with start and end instants. */
+		g_array_append_val(prof->instants, idx);
+
+		/* Check if start instant is the oldest instant. If so, keep it. */
+		if (rec->t_start < prof->t_start)
+			prof->t_start = rec->t_start;
+
+	} else {
+
+		g_info("Event '%s' did not use device time. As such its "\
+			"start and end instants will not be added to the list of "\
+			"event instants.", rec->event_name);
+
+	}
+
+}
+
 /**
  * @internal
  * Add event for profiling.
@@ -580,115 +1245,79 @@ static gint ccl_prof_overlap_comp(
  * @private @memberof ccl_prof
  *
  * @param[in] prof Profile object.
- * @param[in] cq_name Command queue name.
+ * @param[in] cq_name_id Command queue name ID.
  * @param[in] evt Event wrapper object.
  * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
  * reporting is to be ignored.
  * */
-static void ccl_prof_add_event(CCLProf* prof, const char* cq_name,
+static void ccl_prof_add_event(CCLProf* prof, cl_uint cq_name_id,
 	CCLEvent* evt, CCLErr** err) {
 
 	/* Make sure err is NULL or it is not set. */
 	g_return_if_fail(err == NULL || *err == NULL);
 	/* Make sure profile object is not NULL. */
 	g_return_if_fail(prof != NULL);
-	/* Make sure command queue name is not NULL. */
-	g_return_if_fail(cq_name != NULL);
 	/* Make sure event wrapper is not NULL. */
 	g_return_if_fail(evt != NULL);
 
-	/* Event name ID. */
-	cl_uint* event_name_id;
-	/* Specific event ID. */
-	cl_uint event_id;
-	/* Event instants. */
-	cl_ulong instant_queued, instant_submit, instant_start, instant_end;
-	/* Type of command which produced the event. */
-	cl_command_type command_type;
-	/* Event instant objects. */
-	CCLProfInst* evinst_start;
-	CCLProfInst* evinst_end;
+	/* Profiling record of event. */
+	CCLEventRecord rec;
 	/* Internal error handling object. */
 	CCLErr* err_internal = NULL;
 
-	/* Event name. */
-	const char* event_name;
-
-	/* Get event name. */
-	event_name = ccl_event_get_final_name(evt);
-
-	/* Get event queued instant. */
-	instant_queued = ccl_event_get_profiling_info_scalar(
-		evt, CL_PROFILING_COMMAND_QUEUED, cl_ulong, &err_internal);
-	g_if_err_propagate_goto(err, err_internal, error_handler);
-
-	/* Get event submit instant. */
-	instant_submit = ccl_event_get_profiling_info_scalar(
-		evt, CL_PROFILING_COMMAND_SUBMIT, cl_ulong, &err_internal);
-	g_if_err_propagate_goto(err, err_internal, error_handler);
-
-	/* Get event start instant. */
-	instant_start = ccl_event_get_profiling_info_scalar(
-		evt, CL_PROFILING_COMMAND_START, cl_ulong, &err_internal);
-	g_if_err_propagate_goto(err, err_internal, error_handler);
-
-	/* Get event end instant. */
-	instant_end = ccl_event_get_profiling_info_scalar(
-		evt, CL_PROFILING_COMMAND_END, cl_ulong, &err_internal);
-	g_if_err_propagate_goto(err, err_internal, error_handler);
-
-	/* Get command type. */
-	command_type = ccl_event_get_info_scalar(
-		evt, CL_EVENT_COMMAND_TYPE, cl_command_type, &err_internal);
+	/* Get event name, command type and profiling instants. */
+	ccl_event_get_timestamps(evt, &rec, &err_internal);
 	g_if_err_propagate_goto(err, err_internal, error_handler);
 
-	/* If we get here, update number of profilable events, and get an ID
-	 * for the given event. */
-	event_id = ++prof->num_events;
+	/* If we get here, add the event record. */
+	ccl_prof_add_record(prof, cq_name_id, &rec);
 
-	/* Check if event name is already registered in the table of event
-	 * names... */
-	if (!g_hash_table_contains(prof->event_names, event_name)) {
-		/* ...if not, register it. */
-		event_name_id =
-			GUINT_TO_POINTER(g_hash_table_size(prof->event_names));
-		g_hash_table_insert(
-			prof->event_names,
-			(gpointer) event_name,
-			(gpointer) event_name_id);
-	}
+	/* Use event for aligning host and device clocks, if it was
+	 * produced by a traced host API call. */
+	ccl_prof_host_trace_align(prof, evt, rec.t_queued);
 
-	/* If end instant occurs after start instant... */
-	if (instant_end > instant_start) {
-
-		/* Add event start instant to list of event instants. */
-		evinst_start = ccl_prof_inst_new(event_name, cq_name, event_id,
-			instant_start, CCL_PROF_INST_TYPE_START);
-		prof->instants = g_list_prepend(
-			prof->instants, (gpointer) evinst_start);
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
 
-		/* Add event end instant to list of event instants. */
-		evinst_end = ccl_prof_inst_new(event_name, cq_name, event_id,
-			instant_end, CCL_PROF_INST_TYPE_END);
-		prof->instants = g_list_prepend(
-			prof->instants, (gpointer) evinst_end);
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
 
-		/* Check if start instant is the oldest instant. If so, keep it. */
-		if (instant_start < prof->t_start)
-			prof->t_start = instant_start;
+finish:
 
-	} else {
+	/* Return. */
+	return;
+}
 
-		g_info("Event '%s' did not use device time. As such its "\
-			"start and end instants will not be added to the list of "\
-			"event instants.", event_name);
+/**
+ * @internal
+ * Check that the given command queue has profiling enabled.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] cq_name Command queue name.
+ * @param[in] cq Command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * */
+static void ccl_prof_check_queue(
+	const char* cq_name, CCLQueue* cq, CCLErr** err) {
 
-	}
+	/* Queue properties. */
+	cl_command_queue_properties qprop;
+	/* Internal error reporting object. */
+	CCLErr* err_internal = NULL;
 
-	/* Add event information to list of event information..*/
-	prof->infos = g_list_prepend(prof->infos,
-		(gpointer) ccl_prof_info_new(event_name, command_type, cq_name,
-			instant_queued, instant_submit, instant_start, instant_end));
+	/* Check that queue has profiling enabled. */
+	qprop = ccl_queue_get_info_scalar(cq, CL_QUEUE_PROPERTIES,
+		cl_command_queue_properties, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	g_if_err_create_goto(*err, CCL_ERROR,
+		(qprop & CL_QUEUE_PROFILING_ENABLE) == 0, CCL_ERROR_OTHER,
+		error_handler,
+		"%s: the '%s' queue does not have profiling enabled.",
+		CCL_STRD, cq_name);
 
 	/* If we got here, everything is OK. */
 	g_assert(err == NULL || *err == NULL);
@@ -727,8 +1356,6 @@ static void ccl_prof_process_queues(CCLProf* prof, CCLErr** err) {
 	/* Command queue name and wrapper. */
 	gpointer cq_name;
 	gpointer cq;
-	/* Queue properties. */
-	cl_command_queue_properties qprop;
 	/* Internal error reporting object. */
 	CCLErr* err_internal = NULL;
 
@@ -737,14 +1364,22 @@ static void ccl_prof_process_queues(CCLProf* prof, CCLErr** err) {
 	while (g_hash_table_iter_next(&iter, &cq_name, &cq)) {
 
 		/* Check that queue has profiling enabled. */
-		qprop = ccl_queue_get_info_scalar(cq, CL_QUEUE_PROPERTIES,
-			cl_command_queue_properties, &err_internal);
+		ccl_prof_check_queue(
+			(const char*) cq_name, (CCLQueue*) cq, &err_internal);
 		g_if_err_propagate_goto(err, err_internal, error_handler);
-		g_if_err_create_goto(*err, CCL_ERROR,
-			(qprop & CL_QUEUE_PROFILING_ENABLE) == 0, CCL_ERROR_OTHER,
-			error_handler,
-			"%s: the '%s' queue does not have profiling enabled.",
-			CCL_STRD, (char*) cq_name);
+
+		/* Register queue name. */
+		cl_uint cq_name_id = prof->queue_names->len;
+		g_ptr_array_add(prof->queue_names, cq_name);
+
+		/* Add the profiling records of events retired by the current
+		 * command queue. */
+		cl_uint num_recs;
+		const CCLEventRecord* recs =
+			ccl_queue_get_event_records((CCLQueue*) cq, &num_recs);
+		for (cl_uint i = 0; i < num_recs; ++i) {
+			ccl_prof_add_record(prof, cq_name_id, &recs[i]);
+		}
 
 		/* Iterate over the events in current command queue. */
 		CCLEvent* evt;
@@ -752,8 +1387,7 @@ static void ccl_prof_process_queues(CCLProf* prof, CCLErr** err) {
 		while ((evt = ccl_queue_iter_event_next((CCLQueue*) cq))) {
 
 			/* Add event for profiling. */
-			ccl_prof_add_event(
-				prof, (const char*) cq_name, evt, &err_internal);
+			ccl_prof_add_event(prof, cq_name_id, evt, &err_internal);
 			if ((err_internal != NULL) &&
 				(((err_internal->domain == CCL_OCL_ERROR) &&
                  (err_internal->code == CL_PROFILING_INFO_NOT_AVAILABLE))
@@ -795,94 +1429,467 @@ finish:
 
 /**
  * @internal
- * Determine aggregate event statistics.
+ * Make sure the streaming mode overlap matrix can hold the given number
+ * of event names.
  *
  * @private @memberof ccl_prof
  *
- * @param[in] prof The profile object.
+ * @param[in] prof Profile object.
+ * @param[in] num_event_names Number of event names.
  * */
-static void ccl_prof_calc_agg(CCLProf* prof) {
-
-	/* Make sure profile object is not NULL. */
-	g_return_if_fail(prof != NULL);
-
-	/* Hash table iterator. */
-	GHashTableIter iter;
-	/* Aux. hash table for aggregate statistics. */
-	GHashTable* agg_table;
-	/* A pointer for a event name. */
-	gpointer event_name;
-	/* Aggregate event info. */
-	CCLProfAgg* evagg = NULL;
-	/* Type of sorting to perform on event list. */
-	int sort_type;
-	/* Aux. pointer for event data structure kept in a GList. */
-	GList* curr_evinst_container = NULL;
-	/* A pointer to a CCLProfAgg (agg. event info) variable. */
-	gpointer value_agg;
-	/* Auxiliary aggregate event info variable.*/
-	CCLProfAgg* curr_agg = NULL;
-
-	/* Create table of aggregate statistics. */
-	agg_table = g_hash_table_new(g_str_hash, g_str_equal);
-
-	/* Initalize table, and set aggregate values to zero. */
-	g_hash_table_iter_init(&iter, prof->event_names);
-	while (g_hash_table_iter_next(&iter, &event_name, NULL)) {
-		evagg = ccl_prof_agg_new(event_name);
-		evagg->absolute_time = 0;
-		g_hash_table_insert(
-			agg_table, event_name, (gpointer) evagg);
+static void ccl_prof_stream_grow_overlaps(
+	CCLProf* prof, cl_uint num_event_names) {
+
+	/* New overlap matrix and its dimension. */
+	cl_ulong* overlaps;
+	cl_uint dim = prof->stream_overlaps_dim;
+
+	/* Is the matrix large enough? */
+	if (num_event_names <= dim) return;
+
+	/* Grow geometrically and copy existing overlaps. */
+	while (dim < num_event_names) dim = dim > 0 ? 2 * dim : 8;
+	overlaps = g_new0(cl_ulong, dim * dim);
+	for (cl_uint i = 0; i < prof->stream_overlaps_dim; ++i) {
+		memcpy(overlaps + i * dim,
+			prof->stream_overlaps + i * prof->stream_overlaps_dim,
+			prof->stream_overlaps_dim * sizeof(cl_ulong));
 	}
+	g_free(prof->stream_overlaps);
+	prof->stream_overlaps = overlaps;
+	prof->stream_overlaps_dim = dim;
+}
 
-	/* Sort event instants by eid, and then by START, END order. */
-	sort_type = CCL_PROF_INST_SORT_ID | CCL_PROF_SORT_ASC;
-	prof->instants = g_list_sort_with_data(
-		prof->instants, ccl_prof_inst_comp,
-		(gpointer) &sort_type);
-
-	/* Iterate through all event instants and determine total times. */
-	curr_evinst_container = prof->instants;
-	while (curr_evinst_container) {
-
-		/* Loop aux. variables. */
-		CCLProfInst* curr_evinst = NULL;
-		cl_ulong start_inst, end_inst;
-
-		/* Get START event instant. */
-		curr_evinst = (CCLProfInst*) curr_evinst_container->data;
-		start_inst = curr_evinst->instant;
+/**
+ * @internal
+ * Update the streaming mode profiling information with the profiling
+ * record of an event.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] cq_name Command queue name.
+ * @param[in] rec Profiling record of event.
+ * */
+static void ccl_prof_stream_record(CCLProf* prof, const char* cq_name,
+	const CCLEventRecord* rec) {
 
-		/* Get END event instant */
-		curr_evinst_container = curr_evinst_container->next;
-		curr_evinst = (CCLProfInst*) curr_evinst_container->data;
-		end_inst = curr_evinst->instant;
+	/* Event name ID. */
+	gpointer p_id;
+	cl_uint event_name_id;
+	/* Duration histogram for event name. */
+	CCLProfHist* hist;
+	/* Interval of event. */
+	CCLProfInterval ivl;
+	/* End instant of latest event consumed from queue. */
+	cl_ulong* t_last;
+
+	/* Update number of profilable events. */
+	prof->num_events++;
 
-		/* Add new interval to respective aggregate value. */
-		curr_agg = (CCLProfAgg*) g_hash_table_lookup(
-			agg_table, curr_evinst->event_name);
-		curr_agg->absolute_time += end_inst - start_inst;
-		prof->total_events_time += end_inst - start_inst;
+	/* Check if event name is already registered in the table of event
+	 * names... */
+	if (!g_hash_table_lookup_extended(
+		prof->event_names, rec->event_name, NULL, &p_id)) {
 
-		/* Get next START event instant. */
-		curr_evinst_container = curr_evinst_container->next;
+		/* ...if not, register it, and create a duration histogram
+		 * for it. */
+		p_id = GUINT_TO_POINTER(g_hash_table_size(prof->event_names));
+		g_hash_table_insert(
+			prof->event_names, (gpointer) rec->event_name, p_id);
+		g_hash_table_insert(
+			prof->event_name_ids, p_id, (gpointer) rec->event_name);
+		g_hash_table_insert(prof->stream_hists,
+			(gpointer) rec->event_name, g_slice_new0(CCLProfHist));
+		ccl_prof_stream_grow_overlaps(
+			prof, g_hash_table_size(prof->event_names));
 	}
-
-	/* Determine relative times. */
-	g_hash_table_iter_init(&iter, agg_table);
-	while (g_hash_table_iter_next(&iter, &event_name, &value_agg)) {
-		curr_agg = (CCLProfAgg*) value_agg;
-		curr_agg->relative_time =
-			((double) curr_agg->absolute_time)
-			/
-			((double) prof->total_events_time);
+	event_name_id = GPOINTER_TO_UINT(p_id);
+
+	/* Events which did not use device time are only counted. */
+	if (rec->t_end <= rec->t_start) {
+		g_info("Event '%s' did not use device time. As such it "\
+			"will not be taken into account in aggregate statistics "\
+			"and overlaps.", rec->event_name);
+		return;
 	}
 
-	/* Keep a list of aggregates. */
-	prof->aggs = g_hash_table_get_values(agg_table);
+	/* Update duration histogram and total time. */
+	hist = (CCLProfHist*) g_hash_table_lookup(
+		prof->stream_hists, rec->event_name);
+	ccl_prof_hist_add(hist, rec->t_end - rec->t_start);
+	prof->total_events_time += rec->t_end - rec->t_start;
+
+	/* Check if start instant is the oldest instant. If so, keep it. */
+	if (rec->t_start < prof->t_start)
+		prof->t_start = rec->t_start;
+
+	/* Determine overlaps with recently consumed events. */
+	for (guint i = 0; i < prof->stream_window->len; ++i) {
+
+		CCLProfInterval* other =
+			&g_array_index(prof->stream_window, CCLProfInterval, i);
+		cl_ulong ovlp_start = MAX(other->t_start, rec->t_start);
+		cl_ulong ovlp_end = MIN(other->t_end, rec->t_end);
+
+		if (ovlp_end > ovlp_start) {
+			cl_uint ueid_min = MIN(event_name_id, other->event_name_id);
+			cl_uint ueid_max = MAX(event_name_id, other->event_name_id);
+			prof->stream_overlaps[
+				ueid_min * prof->stream_overlaps_dim + ueid_max] +=
+				ovlp_end - ovlp_start;
+			prof->stream_total_overlap += ovlp_end - ovlp_start;
+		}
+	}
 
-	/* Release aux. hash table. */
-	g_hash_table_destroy(agg_table);
+	/* Keep event interval for determining future overlaps. */
+	ivl.t_start = rec->t_start;
+	ivl.t_end = rec->t_end;
+	ivl.event_name_id = event_name_id;
+	g_array_append_val(prof->stream_window, ivl);
+
+	/* Update end instant of latest event consumed from queue. */
+	t_last = (cl_ulong*) g_hash_table_lookup(prof->stream_t_last, cq_name);
+	if (t_last == NULL) {
+		t_last = g_new0(cl_ulong, 1);
+		g_hash_table_insert(prof->stream_t_last, (gpointer) cq_name, t_last);
+	}
+	if (rec->t_end > *t_last) *t_last = rec->t_end;
+
+}
+
+/**
+ * @internal
+ * Fill a profile object with the profiling information incrementally
+ * determined in streaming mode by another (or the same) profile object.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] dst Profile object to fill.
+ * @param[in] src Profile object in streaming mode.
+ * */
+static void ccl_prof_stream_fill(CCLProf* dst, CCLProf* src) {
+
+	/* Hash table iterator. */
+	GHashTableIter iter;
+	/* Event name and respective duration histogram or ID. */
+	gpointer event_name, hist, event_name_id;
+	/* Number of event names. */
+	cl_uint num_event_names = g_hash_table_size(src->event_names);
+
+	/* Copy tables of event names and IDs, as created by
+	 * ccl_prof_calc(). */
+	if (dst != src) {
+		dst->event_names = g_hash_table_new(g_str_hash, g_str_equal);
+		dst->event_name_ids =
+			g_hash_table_new(g_direct_hash, g_direct_equal);
+		g_hash_table_iter_init(&iter, src->event_names);
+		while (g_hash_table_iter_next(
+			&iter, &event_name, &event_name_id)) {
+			g_hash_table_insert(
+				dst->event_names, event_name, event_name_id);
+			g_hash_table_insert(
+				dst->event_name_ids, event_name_id, event_name);
+		}
+	}
+
+	/* Queue names are not kept in streaming mode, so the table of
+	 * queue names is empty. */
+	if (dst->queue_names == NULL)
+		dst->queue_names = g_ptr_array_new();
+
+	/* Copy aggregate statistics, determining relative times. */
+	g_hash_table_iter_init(&iter, src->stream_hists);
+	while (g_hash_table_iter_next(&iter, &event_name, &hist)) {
+		CCLProfAgg* agg = ccl_prof_agg_new((const char*) event_name);
+		ccl_prof_hist_fill_agg((CCLProfHist*) hist, agg);
+		agg->relative_time = src->total_events_time > 0
+			? ((double) agg->absolute_time)
+				/ ((double) src->total_events_time)
+			: 0.0;
+		dst->aggs = g_list_prepend(dst->aggs, (gpointer) agg);
+	}
+
+	/* Populate list of overlaps. */
+	for (cl_uint i = 0; i < num_event_names; i++) {
+		for (cl_uint j = 0; j < num_event_names; j++) {
+			cl_ulong duration =
+				src->stream_overlaps[i * src->stream_overlaps_dim + j];
+			if (duration > 0) {
+				CCLProfOverlap* ovlp = ccl_prof_overlap_new(
+					(const char*) g_hash_table_lookup(
+						src->event_name_ids, GUINT_TO_POINTER(i)),
+					(const char*) g_hash_table_lookup(
+						src->event_name_ids, GUINT_TO_POINTER(j)),
+					duration);
+				dst->overlaps = g_list_prepend(
+					dst->overlaps, (gpointer) ovlp);
+			}
+		}
+	}
+
+	/* Copy totals. */
+	dst->num_events = src->num_events;
+	dst->t_start = src->t_start;
+	dst->total_events_time = src->total_events_time;
+	dst->total_events_eff_time =
+		src->total_events_time - src->stream_total_overlap;
+
+	/* Information is ready to be queried. */
+	dst->calc = TRUE;
+
+}
+
+/**
+ * @internal
+ * Determine aggregate event statistics.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof The profile object.
+ * */
+static void ccl_prof_calc_agg(CCLProf* prof) {
+
+	/* Make sure profile object is not NULL. */
+	g_return_if_fail(prof != NULL);
+
+	/* Hash table iterator. */
+	GHashTableIter iter;
+	/* Aggregate statistics and duration histograms indexed by event
+	 * name ID. */
+	CCLProfAgg** agg_array;
+	CCLProfHist* hists;
+	/* Event name and respective ID. */
+	gpointer event_name, event_name_id;
+	/* Number of event names. */
+	cl_uint num_event_names;
+	/* Event profiling information columns. */
+	CCLProfInfoCols* infos = &prof->infos;
+
+	/* Create array of aggregate statistics, and set aggregate values to
+	 * zero. */
+	num_event_names = g_hash_table_size(prof->event_names);
+	agg_array = g_new(CCLProfAgg*, num_event_names);
+	hists = g_new0(CCLProfHist, num_event_names);
+	g_hash_table_iter_init(&iter, prof->event_names);
+	while (g_hash_table_iter_next(&iter, &event_name, &event_name_id)) {
+		CCLProfAgg* evagg = ccl_prof_agg_new(event_name);
+		agg_array[GPOINTER_TO_UINT(event_name_id)] = evagg;
+	}
+
+	/* Iterate through all events with start and end instants and
+	 * determine durations. */
+	for (guint i = 0; i < prof->instants->len; ++i) {
+		guint idx = g_array_index(prof->instants, cl_uint, i);
+		cl_ulong duration = infos->t_end[idx] - infos->t_start[idx];
+		ccl_prof_hist_add(&hists[infos->event_name_id[idx]], duration);
+		prof->total_events_time += duration;
+	}
+
+	/* Determine duration statistics and relative times, and keep a list
+	 * of aggregates. */
+	for (cl_uint i = 0; i < num_event_names; ++i) {
+		ccl_prof_hist_fill_agg(&hists[i], agg_array[i]);
+		g_free(hists[i].buckets);
+		agg_array[i]->relative_time =
+			((double) agg_array[i]->absolute_time)
+			/
+			((double) prof->total_events_time);
+		prof->aggs = g_list_prepend(prof->aggs, (gpointer) agg_array[i]);
+	}
+
+	/* Release aux. arrays. */
+	g_free(agg_array);
+	g_free(hists);
+
+}
+
+/**
+ * @internal
+ * Sort an array of instants and associated values by instant, using a
+ * least significant digit radix sort. Byte positions which are the same
+ * for all instants (e.g. the most significant bytes of device
+ * timestamps) are skipped.
+ *
+ * @param[in,out] instants Instants to sort.
+ * @param[in,out] values Values associated with each instant.
+ * @param[in] n Number of instants.
+ * */
+static void ccl_prof_radix_sort(
+	cl_ulong* instants, cl_uint* values, gsize n) {
+
+	/* Source and destination arrays for each pass. */
+	cl_ulong* src_inst = instants;
+	cl_uint* src_val = values;
+	cl_ulong* dst_inst;
+	cl_uint* dst_val;
+	/* Auxiliary arrays. */
+	cl_ulong* aux_inst;
+	cl_uint* aux_val;
+	/* Histogram of digits, later converted to digit offsets. */
+	gsize count[256];
+
+	/* Nothing to sort. */
+	if (n < 2) return;
+
+	/* Allocate auxiliary arrays. */
+	aux_inst = g_new(cl_ulong, n);
+	aux_val = g_new(cl_uint, n);
+	dst_inst = aux_inst;
+	dst_val = aux_val;
+
+	/* One pass per byte. */
+	for (guint shift = 0; shift < 64; shift += 8) {
+
+		gsize offset = 0;
+
+		/* Determine histogram of current byte. */
+		memset(count, 0, sizeof(count));
+		for (gsize i = 0; i < n; ++i)
+			count[(src_inst[i] >> shift) & 0xFF]++;
+
+		/* Skip pass if all instants have the same byte value. */
+		if (count[(src_inst[0] >> shift) & 0xFF] == n) continue;
+
+		/* Convert histogram into offsets. */
+		for (guint d = 0; d < 256; ++d) {
+			gsize c = count[d];
+			count[d] = offset;
+			offset += c;
+		}
+
+		/* Scatter instants and values (stable). */
+		for (gsize i = 0; i < n; ++i) {
+			gsize pos = count[(src_inst[i] >> shift) & 0xFF]++;
+			dst_inst[pos] = src_inst[i];
+			dst_val[pos] = src_val[i];
+		}
+
+		/* Swap source and destination arrays. */
+		cl_ulong* tmp_inst = src_inst; src_inst = dst_inst; dst_inst = tmp_inst;
+		cl_uint* tmp_val = src_val; src_val = dst_val; dst_val = tmp_val;
+	}
+
+	/* Make sure sorted data ends up in the given arrays. */
+	if (src_inst != instants) {
+		memcpy(instants, src_inst, n * sizeof(cl_ulong));
+		memcpy(values, src_val, n * sizeof(cl_uint));
+	}
+
+	/* Release auxiliary arrays. */
+	g_free(aux_inst);
+	g_free(aux_val);
+
+}
+
+/**
+ * @internal
+ * Determine the order of a sequence of sort keys.
+ *
+ * @param[in,out] keys Sort keys, which will be sorted (complemented, if
+ * descending order is requested).
+ * @param[in] n Number of sort keys.
+ * @param[in] order Sort order.
+ * @return Array with the indexes of the sort keys in the requested
+ * order, to be freed with g_free().
+ * */
+static cl_uint* ccl_prof_sort_keys(
+	cl_ulong* keys, guint n, CCLProfSortOrder order) {
+
+	/* Indexes of sort keys. */
+	cl_uint* idxs = g_new(cl_uint, n);
+
+	/* Complement keys if descending order was requested, such that
+	 * equal keys keep their original relative order. */
+	if (order == CCL_PROF_SORT_DESC) {
+		for (guint i = 0; i < n; ++i) keys[i] = ~keys[i];
+	}
+
+	/* Sort indexes by key (stable). */
+	for (guint i = 0; i < n; ++i) idxs[i] = i;
+	ccl_prof_radix_sort(keys, idxs, n);
+
+	/* Return sorted indexes. */
+	return idxs;
+
+}
+
+/**
+ * @internal
+ * Compare two names given their IDs. It is an implementation of
+ * GCompareDataFunc from GLib.
+ *
+ * @param[in] a Pointer to first name ID.
+ * @param[in] b Pointer to second name ID.
+ * @param[in] userdata Array of names indexed by name ID.
+ * @return Negative value if a < b; zero if a = b; positive value if
+ * a > b.
+ * */
+static gint ccl_prof_name_id_comp(
+	gconstpointer a, gconstpointer b, gpointer userdata) {
+
+	const char** names = (const char**) userdata;
+	return g_strcmp0(names[*((cl_uint*) a)], names[*((cl_uint*) b)]);
+}
+
+/**
+ * @internal
+ * Determine the alphabetical rank of each name in a set of names, such
+ * that sorting by name can be performed with integer sort keys.
+ *
+ * @param[in] names Array of names indexed by name ID.
+ * @param[in] n Number of names.
+ * @return Array with the rank of each name, indexed by name ID, to be
+ * freed with g_free().
+ * */
+static cl_uint* ccl_prof_name_ranks(const char** names, guint n) {
+
+	/* Name IDs in alphabetical order, and rank of each name. */
+	cl_uint* ids = g_new(cl_uint, n);
+	cl_uint* ranks = g_new(cl_uint, n);
+
+	/* Sort name IDs by name. */
+	for (guint i = 0; i < n; ++i) ids[i] = i;
+	g_qsort_with_data(ids, n, sizeof(cl_uint), ccl_prof_name_id_comp,
+		(gpointer) names);
+
+	/* Determine ranks. Equal names get the same rank. */
+	for (guint i = 0; i < n; ++i) {
+		ranks[ids[i]] = ((i > 0) &&
+			(g_strcmp0(names[ids[i]], names[ids[i - 1]]) == 0))
+			? ranks[ids[i - 1]] : i;
+	}
+
+	/* Release aux. array and return ranks. */
+	g_free(ids);
+	return ranks;
+
+}
+
+/**
+ * @internal
+ * Get array of event names indexed by event name ID.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @return Array of event names, to be freed with g_free().
+ * */
+static const char** ccl_prof_event_name_array(CCLProf* prof) {
+
+	/* Hash table iterator. */
+	GHashTableIter iter;
+	/* Event name and respective ID. */
+	gpointer event_name, event_name_id;
+	/* Array of event names. */
+	const char** names = g_new(const char*,
+		g_hash_table_size(prof->event_names));
+
+	g_hash_table_iter_init(&iter, prof->event_names);
+	while (g_hash_table_iter_next(&iter, &event_name, &event_name_id)) {
+		names[GPOINTER_TO_UINT(event_name_id)] = (const char*) event_name;
+	}
+	return names;
 
 }
 
@@ -890,6 +1897,13 @@ static void ccl_prof_calc_agg(CCLProf* prof) {
  * @internal
  * Determine event overlaps for the given profile object.
  *
+ * Event instants are copied to contiguous arrays and sorted by instant.
+ * The sorted instants are then swept, keeping the number of currently
+ * occurring events for each event name. Within each interval between
+ * consecutive instants, the overlap between each pair of occurring
+ * events is accounted for in the overlap matrix, for all pairs of
+ * event names at once.
+ *
  * @private @memberof ccl_prof
  *
  * @param[in] prof Profile object.
@@ -905,150 +1919,102 @@ static void ccl_prof_calc_overlaps(CCLProf* prof) {
 	cl_ulong* overlap_matrix = NULL;
 	/* Number of event names. */
 	cl_uint num_event_names;
-	/* Helper table to account for all overlapping events. */
-	GHashTable* overlaps = NULL;
-	/* Occurring events table. */
-	GHashTable* occurring_events = NULL;
-	/* Type of sorting to perform. */
-	CCLProfInstSort sort_type;
-	/* Container for current event instants. */
-	GList* curr_evinst_container;
-
-	/* Determine number of event names. */
+	/* Number of event instants. */
+	gsize num_instants;
+	/* Event instants and respective event name ID (shifted left by one
+	 * bit) and type (least significant bit, set for START instants). */
+	cl_ulong* instants;
+	cl_uint* values;
+	/* Number of occurring events for each event name. */
+	cl_uint* occurring;
+	/* Event name IDs with occurring events, and respective position in
+	 * this list. */
+	cl_uint* active;
+	cl_uint* active_pos;
+	cl_uint num_active = 0;
+	/* Total number of occurring events. */
+	cl_ulong num_occurring = 0;
+
+	/* Determine number of event names and event instants. */
 	num_event_names = g_hash_table_size(prof->event_names);
+	num_instants = 2 * prof->instants->len;
+
+	/* Initialize overlap matrix and sweep data. */
+	overlap_matrix = g_new0(cl_ulong, num_event_names * num_event_names);
+	instants = g_new(cl_ulong, num_instants);
+	values = g_new(cl_uint, num_instants);
+	occurring = g_new0(cl_uint, num_event_names);
+	active = g_new(cl_uint, num_event_names);
+	active_pos = g_new(cl_uint, num_event_names);
+
+	/* Copy event instants to contiguous arrays. */
+	for (guint i = 0; i < prof->instants->len; ++i) {
+		guint idx = g_array_index(prof->instants, cl_uint, i);
+		instants[2 * i] = prof->infos.t_start[idx];
+		values[2 * i] = (prof->infos.event_name_id[idx] << 1) | 1;
+		instants[2 * i + 1] = prof->infos.t_end[idx];
+		values[2 * i + 1] = prof->infos.event_name_id[idx] << 1;
+	}
+
+	/* Sort event instants. */
+	ccl_prof_radix_sort(instants, values, num_instants);
+
+	/* Sweep through event instants. */
+	for (gsize i = 0; i < num_instants; ++i) {
 
-	/* Initialize overlap matrix. */
-	overlap_matrix = g_slice_alloc0(
-		sizeof(cl_ulong) * num_event_names * num_event_names);
-
-	/* Initialize helper table to account for all overlapping events. */
-	overlaps = g_hash_table_new_full(g_direct_hash, g_direct_equal,
-		NULL, (GDestroyNotify) g_hash_table_destroy);
-
-	/* Setup ocurring events table (key: eventID, value: eventNameID) */
-	occurring_events = g_hash_table_new(g_int_hash, g_int_equal);
-
-	/* Sort all event instants. */
-	sort_type = CCL_PROF_INST_SORT_INSTANT | CCL_PROF_SORT_ASC;
-	prof->instants = g_list_sort_with_data(prof->instants,
-		ccl_prof_inst_comp, (gpointer) &sort_type);
-
-	/* Iterate through all event instants */
-	curr_evinst_container = prof->instants;
-	while (curr_evinst_container) {
-
-		/* ** Loop aux. variables. ** */
-
-		/* Current event instant. */
-		CCLProfInst* curr_evinst = NULL;
-		/* Inner hash table (is value for overlap hash table). */
-		GHashTable* inner_table = NULL;
-		/* Hash table iterator. */
-		GHashTableIter iter;
-		/* Hashtable key, event name ID for current event, event
-		 * name ID for occurring event. */
-		gpointer key_eid, ueid_curr_ev, ueid_occu_ev;
-		/* Keys for start and end event instants. */
-		cl_uint eid_key1, eid_key2;
-		/* Event overlap in nanoseconds. */
-		cl_ulong eff_overlap;
-
-		/* Get current event instant. */
-		curr_evinst = (CCLProfInst*) curr_evinst_container->data;
-
-		/* Check if event time is START or END time */
-		if (curr_evinst->type == CCL_PROF_INST_TYPE_START) {
-			/* Event START instant. */
-
-			/* 1 - Check for overlaps with ocurring events */
-
-			g_hash_table_iter_init(&iter, occurring_events);
-			while (g_hash_table_iter_next (&iter, &key_eid, NULL)) {
-
-				/* The first hash table key will be the smaller event id. */
-				eid_key1 = curr_evinst->id <= *((cl_uint*) key_eid)
-					? curr_evinst->id
-					: *((cl_uint*) key_eid);
-				/* The second hash table key will be the larger event id. */
-				eid_key2 = curr_evinst->id > *((cl_uint*) key_eid)
-					? curr_evinst->id
-					: *((cl_uint*) key_eid);
-				/* Check if the first key (smaller id) is already in the
-				 * hash table... */
-				if (!g_hash_table_lookup_extended(overlaps,
-					GUINT_TO_POINTER(eid_key1), NULL,
-					(gpointer) &inner_table)) {
-					/* ...if not in table, add it to table, creating a new
-					 * inner table as value. Inner table will be initalized
-					 * with second key (larger id) as key and event start
-					 * instant as value. */
-					inner_table = g_hash_table_new(
-						g_direct_hash, g_direct_equal);
-					g_hash_table_insert(
-						overlaps, GUINT_TO_POINTER(eid_key1), inner_table);
+		/* Event name ID of current instant. */
+		cl_uint ueid = values[i] >> 1;
+
+		/* Account for overlaps in the interval since previous instant. */
+		if ((num_occurring > 1) && (instants[i] > instants[i - 1])) {
+
+			cl_ulong interval = instants[i] - instants[i - 1];
+
+			for (cl_uint a = 0; a < num_active; ++a) {
+
+				cl_uint ueid_a = active[a];
+				cl_ulong occ_a = occurring[ueid_a];
+
+				/* Overlaps between events with the same name. */
+				overlap_matrix[ueid_a * num_event_names + ueid_a] +=
+					occ_a * (occ_a - 1) / 2 * interval;
+
+				/* Overlaps between events with different names. */
+				for (cl_uint b = a + 1; b < num_active; ++b) {
+					cl_uint ueid_b = active[b];
+					overlap_matrix[MIN(ueid_a, ueid_b) * num_event_names
+						+ MAX(ueid_a, ueid_b)] +=
+						occ_a * occurring[ueid_b] * interval;
 				}
-				/* Add second key (larger id) to inner tabler, setting the
-				 * start instant as the value. */
-				g_hash_table_insert(
-					inner_table,
-					GUINT_TO_POINTER(eid_key2),
-					&(curr_evinst->instant));
 			}
 
-			/* 2 - Add event to occurring events. */
-			g_hash_table_insert(
-				occurring_events,
-				&(curr_evinst->id), /* eid */
-				g_hash_table_lookup(prof->event_names,
-					curr_evinst->event_name) /* ueid */
-			);
+			/* Overlaps between all pairs of occurring events. */
+			total_overlap +=
+				num_occurring * (num_occurring - 1) / 2 * interval;
+		}
+
+		/* Update number of occurring events. */
+		if (values[i] & 1) {
+
+			/* START instant. */
+			if (occurring[ueid] == 0) {
+				active_pos[ueid] = num_active;
+				active[num_active++] = ueid;
+			}
+			occurring[ueid]++;
+			num_occurring++;
 
 		} else {
-			/* Event END instant. */
-
-			/* 1 - Remove event from ocurring events */
-			g_hash_table_remove(occurring_events, &(curr_evinst->id));
-
-			/* 2 - Check for overlap termination with current events */
-			g_hash_table_iter_init(&iter, occurring_events);
-			while (g_hash_table_iter_next(&iter, &key_eid, &ueid_occu_ev)) {
-				/* The first hash table key will be the smaller event id. */
-				eid_key1 = curr_evinst->id <= *((cl_uint*) key_eid)
-					? curr_evinst->id
-					: *((cl_uint*) key_eid);
-				/* The second hash table key will be the larger event id. */
-				eid_key2 = curr_evinst->id > *((cl_uint*) key_eid)
-					? curr_evinst->id
-					: *((cl_uint*) key_eid);
-				/* Get effective overlap in nanoseconds. */
-				inner_table = g_hash_table_lookup(
-					overlaps, GUINT_TO_POINTER(eid_key1));
-				eff_overlap =
-					curr_evinst->instant
-					-
-					*((cl_ulong*) g_hash_table_lookup(
-						inner_table, GUINT_TO_POINTER(eid_key2)));
-				/* Add overlap to overlap matrix. */
-				ueid_curr_ev = g_hash_table_lookup(
-					prof->event_names, curr_evinst->event_name);
-				cl_uint ueid_min =
-					GPOINTER_TO_UINT(ueid_curr_ev)
-						<= GPOINTER_TO_UINT(ueid_occu_ev)
-					? GPOINTER_TO_UINT(ueid_curr_ev)
-					: GPOINTER_TO_UINT(ueid_occu_ev);
-				cl_uint ueid_max =
-					GPOINTER_TO_UINT(ueid_curr_ev)
-						> GPOINTER_TO_UINT(ueid_occu_ev)
-					? GPOINTER_TO_UINT(ueid_curr_ev)
-					: GPOINTER_TO_UINT(ueid_occu_ev);
-				overlap_matrix[ueid_min * num_event_names + ueid_max] +=
-					eff_overlap;
-				total_overlap += eff_overlap;
+
+			/* END instant. */
+			occurring[ueid]--;
+			num_occurring--;
+			if (occurring[ueid] == 0) {
+				cl_uint last = active[--num_active];
+				active[active_pos[ueid]] = last;
+				active_pos[last] = active_pos[ueid];
 			}
 		}
-
-		/* Get next event instant. */
-		curr_evinst_container = curr_evinst_container->next;
 	}
 
 	/* Populate list of overlaps. */
@@ -1072,15 +2038,13 @@ static void ccl_prof_calc_overlaps(CCLProf* prof) {
 	/* Determine and save effective events time. */
 	prof->total_events_eff_time = prof->total_events_time - total_overlap;
 
-	/* Free the overlaps matrix. */
-	g_slice_free1(sizeof(cl_ulong) * num_event_names * num_event_names,
-		overlap_matrix);
-
-	/* Free overlaps hash table. */
-	g_hash_table_destroy(overlaps);
-
-	/* Free occurring_events hash table. */
-	g_hash_table_destroy(occurring_events);
+	/* Free the overlaps matrix and sweep data. */
+	g_free(overlap_matrix);
+	g_free(instants);
+	g_free(values);
+	g_free(occurring);
+	g_free(active);
+	g_free(active_pos);
 
 }
 
@@ -1135,15 +2099,26 @@ void ccl_prof_destroy(CCLProf* prof) {
 	if (prof->queues != NULL)
 		g_hash_table_destroy(prof->queues);
 
-	/* Destroy list of all event instants. */
+	/* Destroy table of command queue names. */
+	if (prof->queue_names != NULL)
+		g_ptr_array_free(prof->queue_names, TRUE);
+
+	/* Destroy list of events with start and end instants. */
 	if (prof->instants != NULL)
-		g_list_free_full(
-			prof->instants, (GDestroyNotify) ccl_prof_inst_destroy);
+		g_array_free(prof->instants, TRUE);
 
-	/* Destroy list of event profiling information. */
-	if (prof->infos != NULL)
-		g_list_free_full(
-			prof->infos, (GDestroyNotify) ccl_prof_info_destroy);
+	/* Destroy event profiling information. */
+	g_free(prof->infos.event_name_id);
+	g_free(prof->infos.queue_name_id);
+	g_free(prof->infos.command_type);
+	g_free(prof->infos.t_queued);
+	g_free(prof->infos.t_submit);
+	g_free(prof->infos.t_start);
+	g_free(prof->infos.t_end);
+
+	/* Destroy iteration orders. */
+	g_free(prof->info_order);
+	g_free(prof->inst_order);
 
 	/* Destroy list of aggregate statistics. */
 	if (prof->aggs != NULL)
@@ -1163,6 +2138,26 @@ void ccl_prof_destroy(CCLProf* prof) {
 	if (prof->timer != NULL)
 		g_timer_destroy(prof->timer);
 
+	/* Destroy streaming mode data. */
+	if (prof->stream_hists != NULL)
+		g_hash_table_destroy(prof->stream_hists);
+	g_free(prof->stream_overlaps);
+	if (prof->stream_window != NULL)
+		g_array_free(prof->stream_window, TRUE);
+	if (prof->stream_t_last != NULL)
+		g_hash_table_destroy(prof->stream_t_last);
+
+	/* Destroy host API calls. */
+	if (prof->host_calls != NULL)
+		g_array_free(prof->host_calls, TRUE);
+	if (prof->host_objs != NULL)
+		g_hash_table_destroy(prof->host_objs);
+
+	/* Release mapped binary trace file. Names in the tables destroyed
+	 * above may point into it. */
+	if (prof->mapped != NULL)
+		g_mapped_file_unref(prof->mapped);
+
 	/* Destroy profile data structure. */
 	g_slice_free(CCLProf, prof);
 
@@ -1265,6 +2260,122 @@ void ccl_prof_add_queue(
 
 }
 
+/**
+ * Enable or disable host API call tracing. While enabled, calls to
+ * _cf4ocl_ functions which create objects or enqueue commands are
+ * timestamped with a monotonic host clock and recorded in per-thread
+ * buffers. Recorded calls are consumed by profile objects to which
+ * ccl_prof_add_host_trace() was applied.
+ *
+ * Host tracing is disabled by default. It is only available if the
+ * library was built with the `HOST_TRACING` option; otherwise, enabling
+ * it has no effect and a warning is logged. When disabled, the overhead
+ * of each traced call is an atomic read.
+ *
+ * @note While enabled, recorded calls are kept in memory until they are
+ * consumed by a profile object, up to 65536 calls per thread (and
+ * 65536 calls for all threads which have exited). Further calls are not
+ * recorded, and a warning is logged when the recorded calls are
+ * consumed.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] enable CL_TRUE to enable host tracing, CL_FALSE to disable
+ * it.
+ * */
+CCL_EXPORT
+void ccl_prof_set_host_tracing(cl_bool enable) {
+
+#ifdef CCL_HOST_TRACING
+	g_atomic_int_set(&host_trace_enabled, enable ? 1 : 0);
+#else
+	if (enable)
+		g_warning("Library was built without host tracing support.");
+#endif
+
+}
+
+/**
+ * Check if host API call tracing is enabled.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @return CL_TRUE if host tracing is enabled, CL_FALSE otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_prof_get_host_tracing() {
+
+	return g_atomic_int_get(&host_trace_enabled) ? CL_TRUE : CL_FALSE;
+
+}
+
+/**
+ * Have the profile object consume the host API calls recorded with
+ * host tracing (see ccl_prof_set_host_tracing()) when ccl_prof_calc()
+ * is invoked. All calls recorded until then, by any thread, are
+ * consumed, such that they are not available to other profile objects.
+ *
+ * Consumed calls are summarized per function in a "Host API calls"
+ * table of ccl_prof_get_summary(), and exported to a separate host
+ * process by ccl_prof_export_trace(). The offset between the host
+ * and device clocks is estimated from the events produced by traced
+ * calls: the device instant at which each event was queued must have
+ * occurred during the host call which enqueued it. If no such events
+ * are available (e.g. in streaming mode), a zero offset is assumed.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof A profile object.
+ * */
+CCL_EXPORT
+void ccl_prof_add_host_trace(CCLProf* prof) {
+
+	/* Make sure profile is not NULL. */
+	g_return_if_fail(prof != NULL);
+	/* Must be added before calculations. */
+	g_return_if_fail(prof->calc == FALSE);
+
+	prof->host_trace = TRUE;
+
+}
+
+/**
+ * @internal
+ * Determine aggregate statistics and event overlaps from the events
+ * added to the profile object, marking the profiling information as
+ * determined.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * */
+static void ccl_prof_calc_from_events(CCLProf* prof) {
+
+	/* Hash table iterator. */
+	GHashTableIter iter;
+
+	/* Auxiliary pointers for determining the table of event_ids. */
+	gpointer p_evt_name, p_id;
+
+	/* Obtain the event_ids table (by reversing the event_names table) */
+	prof->event_name_ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+	/* Populate table. */
+	g_hash_table_iter_init(&iter, prof->event_names);
+	while (g_hash_table_iter_next(&iter, &p_evt_name, &p_id)) {
+		g_hash_table_insert(prof->event_name_ids, p_id, p_evt_name);
+	}
+
+	/* Calculate aggregate statistics. */
+	ccl_prof_calc_agg(prof);
+
+	/* Determine event overlaps. */
+	ccl_prof_calc_overlaps(prof);
+
+	/* Profiling information is now determined. */
+	prof->calc = TRUE;
+
+}
+
 /**
  * Determine aggregate statistics for the given profile object.
  *
@@ -1272,6 +2383,11 @@ void ccl_prof_add_queue(
  * collected with ::ccl_queue_gc(). As such, they can be reused and
  * re-added for profiling to a new profile object.
  *
+ * If the profile object is in streaming mode (i.e. if ccl_prof_poll()
+ * was previously called), the remaining complete events are consumed
+ * with a final call to ccl_prof_poll(), and the incrementally determined
+ * information is made available.
+ *
  * @public @memberof ccl_prof
  *
  * @param[in] prof A profile object.
@@ -1301,34 +2417,56 @@ cl_bool ccl_prof_calc(CCLProf* prof, CCLErr** err) {
 	/* Hash table iterator. */
 	GHashTableIter iter;
 
-	/* Auxiliary pointers for determining the table of event_ids. */
-	gpointer p_evt_name, p_id;
+	/* Command queue wrapper. */
+	gpointer cq;
+
+	/* Consume recorded host API calls, if requested. */
+	if (prof->host_trace)
+		ccl_prof_host_trace_consume(prof);
 
-	/* Create table of event names. */
+	/* In streaming mode, consume remaining events and make the
+	 * incrementally determined information available. */
+	if (prof->stream) {
+
+		ccl_prof_poll(prof, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		g_hash_table_iter_init(&iter, prof->queues);
+		while (g_hash_table_iter_next(&iter, NULL, &cq)) {
+			ccl_queue_gc((CCLQueue*) cq);
+		}
+
+		ccl_prof_stream_fill(prof, prof);
+
+		/* Events were retired, so clocks cannot be aligned. */
+		if (prof->host_trace)
+			ccl_prof_host_trace_finish(prof);
+
+		g_assert(err == NULL || *err == NULL);
+		status = CL_TRUE;
+		goto finish;
+	}
+
+	/* Create table of event names, table of queue names and list of
+	 * events with start and end instants. */
 	prof->event_names = g_hash_table_new(g_str_hash, g_str_equal);
+	prof->queue_names = g_ptr_array_new();
+	prof->instants = g_array_new(FALSE, FALSE, sizeof(cl_uint));
 
 	/* Process queues and respective events. */
 	ccl_prof_process_queues(prof, &err_internal);
 	g_if_err_propagate_goto(err, err_internal, error_handler);
 
-	/* Obtain the event_ids table (by reversing the event_names table) */
-	prof->event_name_ids = g_hash_table_new(g_direct_hash, g_direct_equal);
-	/* Populate table. */
-	g_hash_table_iter_init(&iter, prof->event_names);
-	while (g_hash_table_iter_next(&iter, &p_evt_name, &p_id)) {
-		g_hash_table_insert(prof->event_name_ids, p_id, p_evt_name);
-	}
-
-	/* Calculate aggregate statistics. */
-	ccl_prof_calc_agg(prof);
+	/* Determine profiling information from the added events. */
+	ccl_prof_calc_from_events(prof);
 
-	/* Determine event overlaps. */
-	ccl_prof_calc_overlaps(prof);
+	/* Align host and device clocks. */
+	if (prof->host_trace)
+		ccl_prof_host_trace_finish(prof);
 
 	/* If we got here, everything is OK. */
 	g_assert(err == NULL || *err == NULL);
 	status = CL_TRUE;
-	prof->calc = TRUE;
 	goto finish;
 
 error_handler:
@@ -1344,16 +2482,186 @@ finish:
 }
 
 /**
- * Return aggregate statistics for events with the given name.
+ * Consume complete events of the profiled command queues, updating
+ * profiling information incrementally.
+ *
+ * The first call to this function places the profile object in
+ * streaming mode. In this mode, the complete events of the added
+ * queues are periodically retired with ccl_queue_retire_events() and
+ * their profiling records are immediately folded into aggregate
+ * statistics and event overlaps, without keeping per-event information.
+ * As such, memory usage and processing time remain bounded during
+ * long-running computations. A snapshot of the profiling information
+ * gathered so far can be obtained at any time with
+ * ccl_prof_snapshot(). Profiling is concluded with ccl_prof_calc().
+ *
+ * @note Event overlaps are determined against recently consumed events
+ * only, assuming that commands in each queue execute in order. Overlaps
+ * involving out-of-order queues may not be fully accounted for.
+ *
+ * @warning Event wrappers of complete events are retired by this
+ * function and are no longer valid after it returns, unless client code
+ * increased their reference count with ccl_event_ref(). This includes
+ * event wrappers returned by the `ccl_*_enqueue_*()` functions and by
+ * ccl_queue_get_last_event(), which must not be used (e.g. in event
+ * wait lists) after calling this function.
  *
  * @public @memberof ccl_prof
  *
- * @param[in] prof Profile object.
- * @param[in] event_name Event name.
- * @return Aggregate statistics for events with the given name.
- */
-CCL_EXPORT
-const CCLProfAgg* ccl_prof_get_agg(
+ * @param[in] prof A profile object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return CL_TRUE if function terminates successfully, or CL_FALSE
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_prof_poll(CCLProf* prof, CCLErr** err) {
+
+	/* Make sure prof is not NULL. */
+	g_return_val_if_fail(prof != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+	/* Calculations must not have been performed. */
+	g_return_val_if_fail(prof->calc == FALSE, CL_FALSE);
+	/* There must be some queues to process. */
+	g_return_val_if_fail(prof->queues != NULL, CL_FALSE);
+
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status flag. */
+	cl_bool status;
+	/* Hash table iterator. */
+	GHashTableIter iter;
+	/* Command queue name and wrapper. */
+	gpointer cq_name;
+	gpointer cq;
+	/* Profiling records of events retired by current queue. */
+	const CCLEventRecord* recs;
+	cl_uint num_recs;
+	/* Events which end before this instant can no longer overlap with
+	 * events not yet consumed. */
+	cl_ulong t_horizon = CL_ULONG_MAX;
+	/* Number of intervals kept for determining future overlaps. */
+	guint num_ivls = 0;
+
+	/* Enter streaming mode, if not already. */
+	if (!prof->stream) {
+		prof->event_names = g_hash_table_new(g_str_hash, g_str_equal);
+		prof->event_name_ids =
+			g_hash_table_new(g_direct_hash, g_direct_equal);
+		prof->stream_hists = g_hash_table_new_full(g_str_hash,
+			g_str_equal, NULL, (GDestroyNotify) ccl_prof_hist_destroy);
+		prof->stream_window =
+			g_array_new(FALSE, FALSE, sizeof(CCLProfInterval));
+		prof->stream_t_last = g_hash_table_new_full(
+			g_str_hash, g_str_equal, NULL, g_free);
+		prof->stream = TRUE;
+	}
+
+	/* Iterate over the command queues. */
+	g_hash_table_iter_init(&iter, prof->queues);
+	while (g_hash_table_iter_next(&iter, &cq_name, &cq)) {
+
+		/* Check that queue has profiling enabled. */
+		ccl_prof_check_queue(
+			(const char*) cq_name, (CCLQueue*) cq, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		/* Retire complete events, folding them into records. */
+		ccl_queue_retire_events((CCLQueue*) cq, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		/* Consume records. */
+		recs = ccl_queue_get_event_records((CCLQueue*) cq, &num_recs);
+		for (cl_uint i = 0; i < num_recs; ++i) {
+			ccl_prof_stream_record(prof, (const char*) cq_name, &recs[i]);
+		}
+		ccl_queue_clear_event_records((CCLQueue*) cq);
+
+		/* If the queue still has pending events, these may have started
+		 * before its latest consumed event ended. */
+		ccl_queue_iter_event_init((CCLQueue*) cq);
+		if (ccl_queue_iter_event_next((CCLQueue*) cq) != NULL) {
+			cl_ulong* t_last = (cl_ulong*)
+				g_hash_table_lookup(prof->stream_t_last, cq_name);
+			t_horizon = MIN(t_horizon, t_last != NULL ? *t_last : 0);
+		}
+	}
+
+	/* Discard intervals which can no longer overlap with events not yet
+	 * consumed. */
+	for (guint i = 0; i < prof->stream_window->len; ++i) {
+		CCLProfInterval ivl =
+			g_array_index(prof->stream_window, CCLProfInterval, i);
+		if (ivl.t_end > t_horizon) {
+			g_array_index(prof->stream_window, CCLProfInterval, num_ivls) =
+				ivl;
+			num_ivls++;
+		}
+	}
+	g_array_set_size(prof->stream_window, num_ivls);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	status = CL_FALSE;
+
+finish:
+
+	/* Return status. */
+	return status;
+
+}
+
+/**
+ * Get a snapshot of the profiling information incrementally determined
+ * with ccl_prof_poll().
+ *
+ * The returned profile object contains the aggregate statistics and
+ * event overlaps determined so far, and can be queried as a profile
+ * object on which ccl_prof_calc() was called. Non-aggregate event
+ * information and event instants are not available.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof A profile object in streaming mode.
+ * @return A new profile object, which should be destroyed with
+ * ccl_prof_destroy() when no longer needed, or `NULL` if `prof` is not
+ * in streaming mode.
+ * */
+CCL_EXPORT
+CCLProf* ccl_prof_snapshot(CCLProf* prof) {
+
+	/* Make sure prof is not NULL. */
+	g_return_val_if_fail(prof != NULL, NULL);
+	/* Profile object must be in streaming mode. */
+	g_return_val_if_fail(prof->stream == TRUE, NULL);
+
+	/* Create the snapshot and fill it with current information. */
+	CCLProf* snapshot = ccl_prof_new();
+	ccl_prof_stream_fill(snapshot, prof);
+
+	/* Return snapshot. */
+	return snapshot;
+
+}
+
+/**
+ * Return aggregate statistics for events with the given name.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] event_name Event name.
+ * @return Aggregate statistics for events with the given name.
+ */
+CCL_EXPORT
+const CCLProfAgg* ccl_prof_get_agg(
 	CCLProf* prof, const char* event_name) {
 
 	/* Make sure prof is not NULL. */
@@ -1441,6 +2749,84 @@ const CCLProfAgg* ccl_prof_iter_agg_next(CCLProf* prof) {
 	return (const CCLProfAgg*) agg;
 }
 
+/**
+ * @internal
+ * Determine the order of event profiling info instances for the given
+ * sort criteria and order.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] sort Bitfield of ::CCLProfInfoSort OR ::CCLProfSortOrder.
+ * @return Indexes of event profiling info instances in the requested
+ * order, to be freed with g_free().
+ * */
+static cl_uint* ccl_prof_info_order(CCLProf* prof, int sort) {
+
+	/* Sort criteria and order. */
+	CCLProfSort sort_data = ccl_prof_get_sort(&sort);
+	/* Event profiling information columns. */
+	CCLProfInfoCols* infos = &prof->infos;
+	/* Sort keys and name ranks. */
+	cl_ulong* keys = g_new(cl_ulong, infos->len);
+	cl_uint* ranks = NULL;
+	const char** names = NULL;
+	/* Order of instances. */
+	cl_uint* order;
+
+	/* Determine sort keys according to sort criteria. */
+	switch ((CCLProfInfoSort) sort_data.criteria) {
+		case CCL_PROF_INFO_SORT_NAME_EVENT:
+			names = ccl_prof_event_name_array(prof);
+			ranks = ccl_prof_name_ranks(
+				names, g_hash_table_size(prof->event_names));
+			for (guint i = 0; i < infos->len; ++i)
+				keys[i] = ranks[infos->event_name_id[i]];
+			break;
+		case CCL_PROF_INFO_SORT_NAME_QUEUE:
+			/* Queue names are not kept in streaming mode. */
+			if (prof->queue_names == NULL) break;
+			ranks = ccl_prof_name_ranks(
+				(const char**) prof->queue_names->pdata,
+				prof->queue_names->len);
+			for (guint i = 0; i < infos->len; ++i)
+				keys[i] = ranks[infos->queue_name_id[i]];
+			break;
+		case CCL_PROF_INFO_SORT_T_QUEUED:
+			memcpy(keys, infos->t_queued, infos->len * sizeof(cl_ulong));
+			break;
+		case CCL_PROF_INFO_SORT_T_SUBMIT:
+			memcpy(keys, infos->t_submit, infos->len * sizeof(cl_ulong));
+			break;
+		case CCL_PROF_INFO_SORT_T_START:
+			memcpy(keys, infos->t_start, infos->len * sizeof(cl_ulong));
+			break;
+		case CCL_PROF_INFO_SORT_T_END:
+			memcpy(keys, infos->t_end, infos->len * sizeof(cl_ulong));
+			break;
+		case CCL_PROF_INFO_SORT_DURATION:
+			for (guint i = 0; i < infos->len; ++i)
+				keys[i] = infos->t_end[i] > infos->t_start[i]
+					? infos->t_end[i] - infos->t_start[i] : 0;
+			break;
+		default:
+			g_warning("Unknown PROF_INFO sort criteria/order.");
+			for (guint i = 0; i < infos->len; ++i) keys[i] = i;
+	}
+
+	/* Determine order. */
+	order = ccl_prof_sort_keys(keys, infos->len, sort_data.order);
+
+	/* Release aux. arrays. */
+	g_free(keys);
+	g_free(ranks);
+	g_free(names);
+
+	/* Return order. */
+	return order;
+
+}
+
 /**
  * Initialize an iterator for event profiling info instances.
  *
@@ -1458,12 +2844,13 @@ void ccl_prof_iter_info_init(CCLProf* prof, int sort) {
 	/* This function can only be called after calculations are made. */
 	g_return_if_fail(prof->calc == TRUE);
 
-	/* Sort list of event prof. infos as requested by client. */
-	prof->infos = g_list_sort_with_data(
-		prof->infos, ccl_prof_info_comp, &sort);
+	/* Determine iteration order. */
+	g_free(prof->info_order);
+	prof->info_order = ccl_prof_info_order(prof, sort);
+
+	/* Set the iterator as the first element. */
+	prof->info_iter = 0;
 
-	/* Set the iterator as the first element in list. */
-	prof->info_iter = prof->infos;
 }
 
 /**
@@ -1474,6 +2861,10 @@ void ccl_prof_iter_info_init(CCLProf* prof, int sort) {
  * @param[in] prof Profile object.
  * @return The next event profiling info instance or `NULL` if no more instances
  * are left.
+ *
+ * @attention The returned object is owned by the profile object and is
+ * overwritten by the next call to this function. Its fields must be
+ * copied if they are required beyond that.
  * */
 CCL_EXPORT
 const CCLProfInfo* ccl_prof_iter_info_next(CCLProf* prof) {
@@ -1484,22 +2875,90 @@ const CCLProfInfo* ccl_prof_iter_info_next(CCLProf* prof) {
 	g_return_val_if_fail(prof->calc == TRUE, NULL);
 
 	/* The event profiling info instance to return. */
-	CCLProfInfo* info;
+	CCLProfInfo* info = NULL;
 
 	/* Check if there are any more left. */
-	if (prof->info_iter != NULL) {
-		/* Yes, send current one, pass to the next. */
-		info = (CCLProfInfo*) prof->info_iter->data;
-		prof->info_iter = prof->info_iter->next;
-	} else {
-		/* Nothing left. */
-		info = NULL;
+	if ((prof->info_order != NULL)
+		&& (prof->info_iter < prof->infos.len)) {
+
+		/* Yes, fill current one, pass to the next. */
+		guint idx = prof->info_order[prof->info_iter++];
+		info = &prof->info_curr;
+		info->event_name = (const char*) g_hash_table_lookup(
+			prof->event_name_ids,
+			GUINT_TO_POINTER(prof->infos.event_name_id[idx]));
+		info->command_type = prof->infos.command_type[idx];
+		info->queue_name = (const char*) g_ptr_array_index(
+			prof->queue_names, prof->infos.queue_name_id[idx]);
+		info->t_queued = prof->infos.t_queued[idx];
+		info->t_submit = prof->infos.t_submit[idx];
+		info->t_start = prof->infos.t_start[idx];
+		info->t_end = prof->infos.t_end[idx];
 	}
 
 	/* Return the profiling info instance. */
 	return (const CCLProfInfo*) info;
 }
 
+/**
+ * @internal
+ * Determine the order of event instant instances for the given sort
+ * criteria and order.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] sort Bitfield of ::CCLProfInstSort OR ::CCLProfSortOrder.
+ * @return Indexes of event instant instances in the requested order,
+ * to be freed with g_free().
+ * */
+static cl_uint* ccl_prof_inst_order(CCLProf* prof, int sort) {
+
+	/* Sort criteria and order. */
+	CCLProfSort sort_data = ccl_prof_get_sort(&sort);
+	/* Number of event instants. */
+	guint num_instants =
+		prof->instants != NULL ? 2 * prof->instants->len : 0;
+	/* Sort keys. */
+	cl_ulong* keys = g_new(cl_ulong, num_instants);
+	/* Order of instants. */
+	cl_uint* order;
+
+	/* Determine sort keys according to sort criteria. Instant 2 * i is
+	 * the start instant of the i-th event with device time, while
+	 * instant 2 * i + 1 is its end instant. */
+	for (guint i = 0; i < num_instants / 2; ++i) {
+		guint idx = g_array_index(prof->instants, cl_uint, i);
+		switch ((CCLProfInstSort) sort_data.criteria) {
+			case CCL_PROF_INST_SORT_INSTANT:
+				keys[2 * i] = prof->infos.t_start[idx];
+				keys[2 * i + 1] = prof->infos.t_end[idx];
+				break;
+			case CCL_PROF_INST_SORT_ID:
+				/* Event ID, start instant before end instant. */
+				keys[2 * i] = 2 * ((cl_ulong) idx + 1);
+				keys[2 * i + 1] = 2 * ((cl_ulong) idx + 1) + 1;
+				break;
+			default:
+				keys[2 * i] = 2 * i;
+				keys[2 * i + 1] = 2 * i + 1;
+		}
+	}
+	if ((sort_data.criteria != CCL_PROF_INST_SORT_INSTANT)
+		&& (sort_data.criteria != CCL_PROF_INST_SORT_ID))
+		g_warning("Unknown PROF_INST sort criteria/order.");
+
+	/* Determine order. */
+	order = ccl_prof_sort_keys(keys, num_instants, sort_data.order);
+
+	/* Release aux. array. */
+	g_free(keys);
+
+	/* Return order. */
+	return order;
+
+}
+
 /**
  * Initialize an iterator for event instant instances.
  *
@@ -1517,12 +2976,12 @@ void ccl_prof_iter_inst_init(CCLProf* prof, int sort) {
 	/* This function can only be called after calculations are made. */
 	g_return_if_fail(prof->calc == TRUE);
 
-	/* Sort list of event instants as requested by client. */
-	prof->instants = g_list_sort_with_data(
-		prof->instants, ccl_prof_inst_comp, &sort);
+	/* Determine iteration order. */
+	g_free(prof->inst_order);
+	prof->inst_order = ccl_prof_inst_order(prof, sort);
 
-	/* Set the iterator as the first element in list. */
-	prof->inst_iter = prof->instants;
+	/* Set the iterator as the first element. */
+	prof->inst_iter = 0;
 
 }
 
@@ -1534,6 +2993,10 @@ void ccl_prof_iter_inst_init(CCLProf* prof, int sort) {
  * @param[in] prof Profile object.
  * @return The next event instant instance or `NULL` if no more instances
  * are left.
+ *
+ * @attention The returned object is owned by the profile object and is
+ * overwritten by the next call to this function. Its fields must be
+ * copied if they are required beyond that.
  * */
 CCL_EXPORT
 const CCLProfInst* ccl_prof_iter_inst_next(CCLProf* prof) {
@@ -1543,20 +3006,33 @@ const CCLProfInst* ccl_prof_iter_inst_next(CCLProf* prof) {
 	/* This function can only be called after calculations are made. */
 	g_return_val_if_fail(prof->calc == TRUE, NULL);
 
-	/* The event profiling info instance to return. */
-	CCLProfInst* inst;
+	/* The event instant instance to return. */
+	CCLProfInst* inst = NULL;
 
 	/* Check if there are any more left. */
-	if (prof->inst_iter != NULL) {
-		/* Yes, send current one, pass to the next. */
-		inst = (CCLProfInst*) prof->inst_iter->data;
-		prof->inst_iter = prof->inst_iter->next;
-	} else {
-		/* Nothing left. */
-		inst = NULL;
+	if ((prof->inst_order != NULL)
+		&& (prof->inst_iter < 2 * prof->instants->len)) {
+
+		/* Yes, fill current one, pass to the next. */
+		guint j = prof->inst_order[prof->inst_iter++];
+		guint idx = g_array_index(prof->instants, cl_uint, j / 2);
+		inst = &prof->inst_curr;
+		inst->event_name = (const char*) g_hash_table_lookup(
+			prof->event_name_ids,
+			GUINT_TO_POINTER(prof->infos.event_name_id[idx]));
+		inst->queue_name = (const char*) g_ptr_array_index(
+			prof->queue_names, prof->infos.queue_name_id[idx]);
+		inst->id = idx + 1;
+		if (j % 2 == 0) {
+			inst->instant = prof->infos.t_start[idx];
+			inst->type = CCL_PROF_INST_TYPE_START;
+		} else {
+			inst->instant = prof->infos.t_end[idx];
+			inst->type = CCL_PROF_INST_TYPE_END;
+		}
 	}
 
-	/* Return the profiling info instance. */
+	/* Return the event instant instance. */
 	return (const CCLProfInst*) inst;
 }
 
@@ -1700,6 +3176,87 @@ void ccl_prof_print_summary(CCLProf* prof) {
 
 }
 
+/**
+ * @internal
+ * Statistics of host API calls to a function.
+ * */
+typedef struct ccl_prof_host_stat {
+
+	/** Name of called function. */
+	const char* func;
+
+	/** Number of calls. */
+	guint count;
+
+	/** Total duration of calls (ns). */
+	guint64 total;
+
+	/** Maximum duration of a call (ns). */
+	guint64 max;
+
+} CCLProfHostStat;
+
+/**
+ * @internal
+ * Compare host API call statistics by descending total duration.
+ *
+ * @param[in] a First statistics object.
+ * @param[in] b Second statistics object.
+ * @return Negative value if a should come before b, positive value if
+ * a should come after b, zero otherwise.
+ * */
+static gint ccl_prof_host_stat_comp(gconstpointer a, gconstpointer b) {
+
+	guint64 ta = ((const CCLProfHostStat*) a)->total;
+	guint64 tb = ((const CCLProfHostStat*) b)->total;
+
+	return (ta < tb) ? 1 : ((ta > tb) ? -1 : 0);
+
+}
+
+/**
+ * @internal
+ * Determine statistics of the host API calls consumed by the profile
+ * object, per called function.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @return List of ::CCLProfHostStat objects sorted by descending total
+ * duration, to be freed with `g_list_free_full()` and `g_free()`.
+ * */
+static GList* ccl_prof_host_stats(CCLProf* prof) {
+
+	/* Statistics indexed by function name. */
+	GHashTable* stats = g_hash_table_new(g_str_hash, g_str_equal);
+	/* List of statistics. */
+	GList* list;
+
+	for (guint i = 0; i < prof->host_calls->len; ++i) {
+
+		CCLProfHostCall* call =
+			&g_array_index(prof->host_calls, CCLProfHostCall, i);
+		CCLProfHostStat* stat = g_hash_table_lookup(stats, call->func);
+		guint64 dur = call->t_end - call->t_start;
+
+		if (stat == NULL) {
+			stat = g_new0(CCLProfHostStat, 1);
+			stat->func = call->func;
+			g_hash_table_insert(stats, (gpointer) call->func, stat);
+		}
+		stat->count++;
+		stat->total += dur;
+		stat->max = MAX(stat->max, dur);
+	}
+
+	list = g_list_sort(
+		g_hash_table_get_values(stats), ccl_prof_host_stat_comp);
+	g_hash_table_destroy(stats);
+
+	return list;
+
+}
+
 /**
  * Get a summary with the profiling info. More specifically,
  * this function returns a string containing a table of aggregate event
@@ -1760,6 +3317,26 @@ const char* ccl_prof_get_summary(
 			"                                    ---------------------------------\n");
 	}
 
+	/* Show event duration statistics */
+	g_string_append_printf(str_obj,
+		" Event durations (s)       :\n");
+	g_string_append_printf(str_obj,
+		"   --------------------------------------------------------------------------------------------------------------------------------\n");
+	g_string_append_printf(str_obj,
+		"   | Event name             |    Count |    Mean    |  Std. dev. |    Min     |    p50     |    p95     |    p99     |    Max     |\n");
+	g_string_append_printf(str_obj,
+		"   --------------------------------------------------------------------------------------------------------------------------------\n");
+	ccl_prof_iter_agg_init(prof, agg_sort);
+	while ((agg = ccl_prof_iter_agg_next(prof)) != NULL) {
+		g_string_append_printf(str_obj,
+			"   | %-22.22s | %8u | %10.4e | %10.4e | %10.4e | %10.4e | %10.4e | %10.4e | %10.4e |\n",
+			agg->event_name, agg->count, agg->mean * 1e-9,
+			agg->stddev * 1e-9, agg->min * 1e-9, agg->p50 * 1e-9,
+			agg->p95 * 1e-9, agg->p99 * 1e-9, agg->max * 1e-9);
+	}
+	g_string_append_printf(str_obj,
+		"   --------------------------------------------------------------------------------------------------------------------------------\n");
+
 	/* *** Show overlaps *** */
 
 	if (g_list_length(prof->overlaps) > 0) {
@@ -1794,6 +3371,29 @@ const char* ccl_prof_get_summary(
 			" Event overlaps            : None\n");
 	}
 
+	/* Show host API calls. */
+	if ((prof->host_calls != NULL) && (prof->host_calls->len > 0)) {
+		GList* host_stats = ccl_prof_host_stats(prof);
+		g_string_append_printf(str_obj,
+			" Host API calls            :\n");
+		g_string_append_printf(str_obj,
+			"   ------------------------------------------------------------------------------------\n");
+		g_string_append_printf(str_obj,
+			"   | Function                       |    Calls | Total (s)  |  Mean (s)  |  Max (s)   |\n");
+		g_string_append_printf(str_obj,
+			"   ------------------------------------------------------------------------------------\n");
+		for (GList* it = host_stats; it != NULL; it = it->next) {
+			CCLProfHostStat* stat = (CCLProfHostStat*) it->data;
+			g_string_append_printf(str_obj,
+				"   | %-30.30s | %8u | %10.4e | %10.4e | %10.4e |\n",
+				stat->func, stat->count, stat->total * 1e-9,
+				stat->total * 1e-9 / stat->count, stat->max * 1e-9);
+		}
+		g_string_append_printf(str_obj,
+			"   ------------------------------------------------------------------------------------\n");
+		g_list_free_full(host_stats, g_free);
+	}
+
 	/* Show total elapsed time */
 	if (prof->timer) {
 		double t_elapsed = g_timer_elapsed(prof->timer, NULL);
@@ -1984,6 +3584,756 @@ finish:
 
 }
 
+/**
+ * @internal
+ * Write a string to a stream as a quoted JSON string, escaping
+ * characters as necessary.
+ *
+ * @param[out] stream Stream where to write the string to.
+ * @param[in] str String to write.
+ * @return A negative value if an error occurs, zero otherwise.
+ * */
+static int ccl_prof_trace_write_str(FILE* stream, const char* str) {
+
+	int status = fputc('"', stream);
+
+	for (const char* c = str; (*c != '\0') && (status >= 0); ++c) {
+		if ((*c == '"') || (*c == '\\')) {
+			status = fprintf(stream, "\\%c", *c);
+		} else if ((unsigned char) *c < 0x20) {
+			status = fprintf(stream, "\\u%04x", (unsigned int) *c);
+		} else {
+			status = fputc(*c, stream);
+		}
+	}
+
+	if (status >= 0) status = fputc('"', stream);
+
+	return status < 0 ? status : 0;
+
+}
+
+/**
+ * @internal
+ * Check if the host-side phases (queued and submitted) of an event
+ * have consistent instants and can be exported.
+ *
+ * @param[in] infos Event profiling information columns.
+ * @param[in] idx Index of event.
+ * @return TRUE if the event host-side phases can be exported, FALSE
+ * otherwise.
+ * */
+static gboolean ccl_prof_trace_has_phases(
+	CCLProfInfoCols* infos, guint idx) {
+
+	return (infos->t_queued[idx] != 0)
+		&& (infos->t_queued[idx] <= infos->t_submit[idx])
+		&& (infos->t_submit[idx] <= infos->t_start[idx]);
+
+}
+
+/** Format of trace timestamps, in microseconds with nanosecond
+ * precision. */
+#define CCL_PROF_TRACE_TS "%" G_GUINT64_FORMAT ".%03u"
+
+/** Arguments for ::CCL_PROF_TRACE_TS, given instant `t` and time base
+ * `t0`, both in nanoseconds. If `t` is before `t0`, zero is used. */
+#define CCL_PROF_TRACE_TS_ARGS(t, t0) \
+	(guint64) (((t) > (t0) ? (t) - (t0) : 0) / 1000), \
+	(unsigned int) (((t) > (t0) ? (t) - (t0) : 0) % 1000)
+
+/**
+ * @internal
+ * Convert a host instant into device time.
+ *
+ * @private @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] t Host instant (ns).
+ * @return Device instant (ns), clamped to zero.
+ * */
+static cl_ulong ccl_prof_host_to_device(CCLProf* prof, guint64 t) {
+
+	gint64 t_dev = (gint64) t + prof->host_offset;
+	return t_dev < 0 ? 0 : (cl_ulong) t_dev;
+
+}
+
+/**
+ * Export event profiling information to a given stream in the Chrome
+ * Trace Event JSON format, which can be opened with the Perfetto UI
+ * (https://ui.perfetto.dev) or with Chrome's `about://tracing`.
+ *
+ * Each command queue is exported as a track, where events are shown as
+ * slices spanning their execution on the device. Events whose queued
+ * and submit instants are available are also exported as asynchronous
+ * slices spanning from the queued to the end instant, with nested
+ * "queued" and "submitted" slices. Event overlaps are made visible
+ * with a counter track holding the number of concurrently executing
+ * events. If the profile object consumed host API calls (see
+ * ccl_prof_add_host_trace()), these are exported as slices in a
+ * separate "host" process, with one track per host thread, converted
+ * into device time. Timestamps are relative to the oldest exported
+ * instant.
+ *
+ * The trace is written to the stream as it is generated, i.e. the
+ * complete document is never kept in memory. The iterators of the
+ * profile object are not affected.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[out] stream Stream where to export trace to.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return CL_TRUE if function terminates successfully, CL_FALSE
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_prof_export_trace(CCLProf* prof, FILE* stream, CCLErr** err) {
+
+	/* Make sure prof is not NULL. */
+	g_return_val_if_fail(prof != NULL, CL_FALSE);
+	/* Make sure stream is not NULL. */
+	g_return_val_if_fail(stream != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+	/* This function can only be called after calculations are made. */
+	g_return_val_if_fail(prof->calc == TRUE, CL_FALSE);
+
+	/* Stream write error flag. */
+	gboolean write_error = FALSE;
+	/* Return status. */
+	cl_bool ret_status;
+	/* Event profiling information columns. */
+	CCLProfInfoCols* infos = &prof->infos;
+	/* Number of queues. */
+	guint num_queues =
+		prof->queue_names != NULL ? prof->queue_names->len : 0;
+	/* Number of events with start and end instants. */
+	guint num_instants =
+		prof->instants != NULL ? 2 * prof->instants->len : 0;
+	/* Time base. */
+	cl_ulong t0 = prof->t_start;
+	/* Number of concurrently executing events. */
+	guint num_occurring = 0;
+	/* Number of host API calls and host threads. */
+	guint num_host_calls =
+		prof->host_calls != NULL ? prof->host_calls->len : 0;
+	guint num_host_threads = 0;
+	/* Order of events and of instants. Local orders are used, so that
+	 * the iterators of the profile object are not disturbed. */
+	cl_uint* info_order = NULL;
+	cl_uint* inst_order = NULL;
+
+	/* Determine time base, taking host-side phases and host API calls
+	 * into account. */
+	for (guint i = 0; i < infos->len; ++i) {
+		if (ccl_prof_trace_has_phases(infos, i))
+			t0 = MIN(t0, infos->t_queued[i]);
+	}
+	for (guint i = 0; i < num_host_calls; ++i) {
+		CCLProfHostCall* call =
+			&g_array_index(prof->host_calls, CCLProfHostCall, i);
+		t0 = MIN(t0, ccl_prof_host_to_device(prof, call->t_start));
+		num_host_threads = MAX(num_host_threads, call->thread);
+	}
+
+	/* Write header and track names. */
+	write_error |= fprintf(stream, "{\"displayTimeUnit\":\"ns\","
+		"\"traceEvents\":[\n{\"ph\":\"M\",\"pid\":1,\"name\":"
+		"\"process_name\",\"args\":{\"name\":\"cf4ocl\"}}") < 0;
+	for (guint q = 0; q < num_queues; ++q) {
+		write_error |= fprintf(stream, ",\n{\"ph\":\"M\",\"pid\":1,"
+			"\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":",
+			q + 1) < 0;
+		write_error |= ccl_prof_trace_write_str(
+			stream, g_ptr_array_index(prof->queue_names, q)) < 0;
+		write_error |= fprintf(stream, "}}") < 0;
+	}
+	if (num_host_calls > 0) {
+		write_error |= fprintf(stream, ",\n{\"ph\":\"M\",\"pid\":2,"
+			"\"name\":\"process_name\",\"args\":{\"name\":\"host\"}}") < 0;
+		for (guint t = 1; t <= num_host_threads; ++t) {
+			write_error |= fprintf(stream, ",\n{\"ph\":\"M\",\"pid\":2,"
+				"\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":"
+				"\"Thread %u\"}}", t, t) < 0;
+		}
+	}
+	g_if_err_create_goto(*err, CCL_ERROR, write_error,
+		CCL_ERROR_STREAM_WRITE, error_handler,
+		"Error while exporting trace (writing to stream).");
+
+	/* Export events sorted by start instant. */
+	info_order = ccl_prof_info_order(
+		prof, CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_ASC);
+	for (guint i = 0; i < infos->len; ++i) {
+
+		/* Index and names of current event. */
+		guint idx = info_order[i];
+		guint tid = infos->queue_name_id[idx] + 1;
+		const char* event_name = (const char*) g_hash_table_lookup(
+			prof->event_name_ids,
+			GUINT_TO_POINTER(infos->event_name_id[idx]));
+		const char* queue_name = (const char*) g_ptr_array_index(
+			prof->queue_names, infos->queue_name_id[idx]);
+
+		/* Slice for execution of event in the device. */
+		write_error |= fprintf(stream, ",\n{\"ph\":\"X\",\"pid\":1,"
+			"\"tid\":%u,\"ts\":" CCL_PROF_TRACE_TS ",\"dur\":"
+			CCL_PROF_TRACE_TS ",\"name\":", tid,
+			CCL_PROF_TRACE_TS_ARGS(infos->t_start[idx], t0),
+			CCL_PROF_TRACE_TS_ARGS(infos->t_end[idx], infos->t_start[idx]))
+			< 0;
+		write_error |= ccl_prof_trace_write_str(stream, event_name) < 0;
+		write_error |= fprintf(stream, ",\"args\":{\"id\":%u,"
+			"\"command_type\":\"0x%x\"}}", idx + 1,
+			(unsigned int) infos->command_type[idx]) < 0;
+
+		/* Asynchronous slices for queued and submitted phases. */
+		if (ccl_prof_trace_has_phases(infos, idx)) {
+
+			/* Instants and names of nested slices. */
+			cl_ulong t[] = { infos->t_queued[idx], infos->t_queued[idx],
+				infos->t_submit[idx], infos->t_submit[idx],
+				infos->t_start[idx], infos->t_end[idx] };
+			const char* ph[] = { "b", "b", "e", "b", "e", "e" };
+			const char* name[] = { event_name, "queued", "queued",
+				"submitted", "submitted", event_name };
+
+			for (guint j = 0; j < G_N_ELEMENTS(t); ++j) {
+				write_error |= fprintf(stream, ",\n{\"ph\":\"%s\","
+					"\"pid\":1,\"tid\":%u,\"id\":%u,\"ts\":"
+					CCL_PROF_TRACE_TS ",\"cat\":", ph[j], tid, idx + 1,
+					CCL_PROF_TRACE_TS_ARGS(t[j], t0)) < 0;
+				write_error |=
+					ccl_prof_trace_write_str(stream, queue_name) < 0;
+				write_error |= fprintf(stream, ",\"name\":") < 0;
+				write_error |=
+					ccl_prof_trace_write_str(stream, name[j]) < 0;
+				write_error |= fputc('}', stream) < 0;
+			}
+		}
+
+		g_if_err_create_goto(*err, CCL_ERROR, write_error,
+			CCL_ERROR_STREAM_WRITE, error_handler,
+			"Error while exporting trace (writing to stream).");
+	}
+
+	/* Export host API calls. */
+	for (guint i = 0; i < num_host_calls; ++i) {
+
+		CCLProfHostCall* call =
+			&g_array_index(prof->host_calls, CCLProfHostCall, i);
+		cl_ulong t_start = ccl_prof_host_to_device(prof, call->t_start);
+		cl_ulong t_end = ccl_prof_host_to_device(prof, call->t_end);
+
+		write_error |= fprintf(stream, ",\n{\"ph\":\"X\",\"pid\":2,"
+			"\"tid\":%u,\"ts\":" CCL_PROF_TRACE_TS ",\"dur\":"
+			CCL_PROF_TRACE_TS ",\"name\":", call->thread,
+			CCL_PROF_TRACE_TS_ARGS(t_start, t0),
+			CCL_PROF_TRACE_TS_ARGS(t_end, t_start)) < 0;
+		write_error |= ccl_prof_trace_write_str(stream, call->func) < 0;
+		write_error |= fputc('}', stream) < 0;
+
+		g_if_err_create_goto(*err, CCL_ERROR, write_error,
+			CCL_ERROR_STREAM_WRITE, error_handler,
+			"Error while exporting trace (writing to stream).");
+	}
+
+	/* Export number of concurrently executing events whenever it
+	 * changes. */
+	inst_order = ccl_prof_inst_order(
+		prof, CCL_PROF_INST_SORT_INSTANT | CCL_PROF_SORT_ASC);
+	for (guint i = 0; i < num_instants; ++i) {
+
+		/* Current instant. */
+		guint j = inst_order[i];
+		guint idx = g_array_index(prof->instants, cl_uint, j / 2);
+		cl_ulong instant = (j % 2 == 0)
+			? infos->t_start[idx] : infos->t_end[idx];
+
+		/* Update number of occurring events. */
+		if (j % 2 == 0) num_occurring++; else num_occurring--;
+
+		/* Only write counter after the last event at this instant. */
+		if (i + 1 < num_instants) {
+			guint k = inst_order[i + 1];
+			guint kdx = g_array_index(prof->instants, cl_uint, k / 2);
+			cl_ulong next = (k % 2 == 0)
+				? infos->t_start[kdx] : infos->t_end[kdx];
+			if (next == instant) continue;
+		}
+
+		write_error |= fprintf(stream, ",\n{\"ph\":\"C\",\"pid\":1,"
+			"\"name\":\"Concurrent events\",\"ts\":" CCL_PROF_TRACE_TS
+			",\"args\":{\"events\":%u}}",
+			CCL_PROF_TRACE_TS_ARGS(instant, t0), num_occurring) < 0;
+
+		g_if_err_create_goto(*err, CCL_ERROR, write_error,
+			CCL_ERROR_STREAM_WRITE, error_handler,
+			"Error while exporting trace (writing to stream).");
+	}
+
+	/* Close document. */
+	write_error |= fprintf(stream, "\n]}\n") < 0;
+	g_if_err_create_goto(*err, CCL_ERROR, write_error,
+		CCL_ERROR_STREAM_WRITE, error_handler,
+		"Error while exporting trace (writing to stream).");
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Release orders. */
+	g_free(info_order);
+	g_free(inst_order);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Helper function which exports a profiling trace to a given file,
+ * automatically opening and closing the file. See the
+ * ccl_prof_export_trace() for more information.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] filename Name of file where trace will be saved to.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return CL_TRUE if function terminates successfully, CL_FALSE
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_prof_export_trace_file(
+	CCLProf* prof, const char* filename, CCLErr** err) {
+
+	/* Make sure prof is not NULL. */
+	g_return_val_if_fail(prof != NULL, CL_FALSE);
+	/* Make sure filename is not NULL. */
+	g_return_val_if_fail(filename != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+	/* This function can only be called after calculations are made. */
+	g_return_val_if_fail(prof->calc == TRUE, CL_FALSE);
+
+	/* Aux. var. */
+	cl_bool status;
+
+	/* Internal CCLErr object. */
+	CCLErr* err_internal = NULL;
+
+	/* Open file. */
+	FILE* fp = fopen(filename, "w");
+	g_if_err_create_goto(*err, CCL_ERROR, fp == NULL,
+		CCL_ERROR_OPENFILE, error_handler,
+		"Unable to open file '%s' for exporting.", filename);
+
+	/* Export trace. */
+	ccl_prof_export_trace(prof, fp, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Close file, checking for errors when flushing buffered data. */
+	status = (fclose(fp) == 0);
+	fp = NULL;
+	g_if_err_create_goto(*err, CCL_ERROR, !status,
+		CCL_ERROR_STREAM_WRITE, error_handler,
+		"Error while exporting trace to file '%s'.", filename);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	status = CL_FALSE;
+
+finish:
+
+	/* Close file. */
+	if (fp) fclose(fp);
+
+	/* Return status. */
+	return status;
+
+}
+
+/**
+ * Export event profiling information to a given stream in a compact
+ * binary trace format, which can be loaded with
+ * ccl_prof_new_from_bin_file() for offline analysis.
+ *
+ * A binary trace consists of a header with a magic string, a format
+ * version and a byte order marker, followed by a string table with
+ * the event and queue names and by fixed-width records with the queued,
+ * submit, start and end instants, command type, queue name ID and
+ * event name ID of each event. Output is buffered, and records are
+ * written in blocks.
+ *
+ * Per-event information is not available in streaming mode, and the
+ * resulting trace will not contain any records.
+ *
+ * Host API calls consumed with ccl_prof_add_host_trace() are not
+ * stored in binary traces.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[out] stream Stream where to export trace to.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return CL_TRUE if function terminates successfully, CL_FALSE
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_prof_export_bin(CCLProf* prof, FILE* stream, CCLErr** err) {
+
+	/* Make sure prof is not NULL. */
+	g_return_val_if_fail(prof != NULL, CL_FALSE);
+	/* Make sure stream is not NULL. */
+	g_return_val_if_fail(stream != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+	/* This function can only be called after calculations are made. */
+	g_return_val_if_fail(prof->calc == TRUE, CL_FALSE);
+
+	/* Stream write error flag. */
+	gboolean write_error = FALSE;
+	/* Return status. */
+	cl_bool ret_status;
+	/* Event profiling information columns. */
+	CCLProfInfoCols* infos = &prof->infos;
+	/* Trace header. */
+	CCLProfBinHeader header = { .version = CCL_PROF_BIN_VERSION,
+		.byte_order = CCL_PROF_BIN_BYTE_ORDER };
+	/* Event names indexed by event name ID. */
+	const char** names = ccl_prof_event_name_array(prof);
+	/* Record buffer. */
+	CCLProfBinRecord* buf = g_new0(CCLProfBinRecord, CCL_PROF_BIN_BUFSIZE);
+	/* Padding of string table and unpadded string table size. */
+	static const char padding[8] = { 0 };
+	guint64 strings_len;
+
+	/* Determine header contents. */
+	memcpy(header.magic, CCL_PROF_BIN_MAGIC, sizeof(header.magic));
+	header.num_event_names = g_hash_table_size(prof->event_names);
+	header.num_queue_names =
+		prof->queue_names != NULL ? prof->queue_names->len : 0;
+	for (guint i = 0; i < header.num_event_names; ++i)
+		header.strings_size += strlen(names[i]) + 1;
+	for (guint i = 0; i < header.num_queue_names; ++i)
+		header.strings_size += strlen(
+			g_ptr_array_index(prof->queue_names, i)) + 1;
+	strings_len = header.strings_size;
+	header.strings_size = (strings_len + 7) & ~((guint64) 7);
+	header.num_records = infos->len;
+
+	/* Write header and string table. */
+	write_error |= fwrite(&header, sizeof(header), 1, stream) != 1;
+	for (guint i = 0; i < header.num_event_names; ++i)
+		write_error |= fwrite(names[i], strlen(names[i]) + 1, 1, stream)
+			!= 1;
+	for (guint i = 0; i < header.num_queue_names; ++i) {
+		const char* queue_name = g_ptr_array_index(prof->queue_names, i);
+		write_error |= fwrite(queue_name, strlen(queue_name) + 1, 1,
+			stream) != 1;
+	}
+	write_error |= fwrite(padding, 1,
+		(size_t) (header.strings_size - strings_len), stream)
+		!= (size_t) (header.strings_size - strings_len);
+	g_if_err_create_goto(*err, CCL_ERROR, write_error,
+		CCL_ERROR_STREAM_WRITE, error_handler,
+		"Error while exporting binary trace (writing to stream).");
+
+	/* Write records in blocks. */
+	for (guint i = 0; i < infos->len; i += CCL_PROF_BIN_BUFSIZE) {
+
+		/* Number of records in current block. */
+		guint n = MIN(CCL_PROF_BIN_BUFSIZE, infos->len - i);
+
+		/* Fill buffer. */
+		for (guint j = 0; j < n; ++j) {
+			buf[j].t_queued = infos->t_queued[i + j];
+			buf[j].t_submit = infos->t_submit[i + j];
+			buf[j].t_start = infos->t_start[i + j];
+			buf[j].t_end = infos->t_end[i + j];
+			buf[j].command_type = infos->command_type[i + j];
+			buf[j].queue_id = infos->queue_name_id[i + j];
+			buf[j].event_name_id = infos->event_name_id[i + j];
+		}
+
+		/* Write buffer to stream. */
+		write_error |= fwrite(buf, sizeof(CCLProfBinRecord), n, stream)
+			!= n;
+		g_if_err_create_goto(*err, CCL_ERROR, write_error,
+			CCL_ERROR_STREAM_WRITE, error_handler,
+			"Error while exporting binary trace (writing to stream).");
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Release buffers. */
+	g_free(buf);
+	g_free(names);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Helper function which exports a binary trace to a given file,
+ * automatically opening and closing the file. See the
+ * ccl_prof_export_bin() for more information.
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] prof Profile object.
+ * @param[in] filename Name of file where trace will be saved to.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return CL_TRUE if function terminates successfully, CL_FALSE
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_prof_export_bin_file(
+	CCLProf* prof, const char* filename, CCLErr** err) {
+
+	/* Make sure prof is not NULL. */
+	g_return_val_if_fail(prof != NULL, CL_FALSE);
+	/* Make sure filename is not NULL. */
+	g_return_val_if_fail(filename != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+	/* This function can only be called after calculations are made. */
+	g_return_val_if_fail(prof->calc == TRUE, CL_FALSE);
+
+	/* Aux. var. */
+	cl_bool status;
+
+	/* Internal CCLErr object. */
+	CCLErr* err_internal = NULL;
+
+	/* Open file. */
+	FILE* fp = fopen(filename, "wb");
+	g_if_err_create_goto(*err, CCL_ERROR, fp == NULL,
+		CCL_ERROR_OPENFILE, error_handler,
+		"Unable to open file '%s' for exporting.", filename);
+
+	/* Export trace. */
+	ccl_prof_export_bin(prof, fp, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Close file, checking for errors when flushing buffered data. */
+	status = (fclose(fp) == 0);
+	fp = NULL;
+	g_if_err_create_goto(*err, CCL_ERROR, !status,
+		CCL_ERROR_STREAM_WRITE, error_handler,
+		"Error while exporting binary trace to file '%s'.", filename);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	status = CL_FALSE;
+
+finish:
+
+	/* Close file. */
+	if (fp) fclose(fp);
+
+	/* Return status. */
+	return status;
+
+}
+
+/**
+ * Create a profile object from a binary trace file exported with
+ * ccl_prof_export_bin() or ccl_prof_export_bin_file().
+ *
+ * The file is memory-mapped, and event and queue names are referenced
+ * directly from the mapping, which is kept until the profile object is
+ * destroyed. The returned profile object has its profiling information
+ * already determined, i.e. it is not necessary (nor possible) to call
+ * ccl_prof_calc(), and can be examined with the same functions as
+ * profile objects created with ccl_prof_new(), e.g. with the iterator
+ * functions or with ccl_prof_get_summary().
+ *
+ * @public @memberof ccl_prof
+ *
+ * @param[in] filename Name of binary trace file.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new profile object, which should be destroyed with
+ * ccl_prof_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLProf* ccl_prof_new_from_bin_file(const char* filename, CCLErr** err) {
+
+	/* Make sure filename is not NULL. */
+	g_return_val_if_fail(filename != NULL, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal CCLErr object. */
+	CCLErr* err_internal = NULL;
+	/* Profile object to return. */
+	CCLProf* prof = NULL;
+	/* Mapped file, its contents and size. */
+	GMappedFile* mapped = NULL;
+	const char* contents;
+	gsize size;
+	/* Trace header, string table and records. */
+	const CCLProfBinHeader* header;
+	const char* strings;
+	const CCLProfBinRecord* recs;
+	/* Names in string table. */
+	const char** names = NULL;
+	guint64 num_names;
+
+	/* Map file. */
+	mapped = g_mapped_file_new(filename, FALSE, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	contents = g_mapped_file_get_contents(mapped);
+	size = g_mapped_file_get_length(mapped);
+	header = (const CCLProfBinHeader*) contents;
+
+	/* Validate header. */
+	g_if_err_create_goto(*err, CCL_ERROR,
+		(size < sizeof(CCLProfBinHeader))
+		|| (memcmp(header->magic, CCL_PROF_BIN_MAGIC,
+			sizeof(header->magic)) != 0),
+		CCL_ERROR_INVALID_DATA, error_handler,
+		"File '%s' is not a binary trace.", filename);
+	g_if_err_create_goto(*err, CCL_ERROR,
+		header->version != CCL_PROF_BIN_VERSION,
+		CCL_ERROR_INVALID_DATA, error_handler,
+		"Binary trace '%s' has unsupported format version %u.",
+		filename, (unsigned int) header->version);
+	g_if_err_create_goto(*err, CCL_ERROR,
+		header->byte_order != CCL_PROF_BIN_BYTE_ORDER,
+		CCL_ERROR_INVALID_DATA, error_handler,
+		"Binary trace '%s' was written with a different byte order.",
+		filename);
+	size -= sizeof(CCLProfBinHeader);
+	g_if_err_create_goto(*err, CCL_ERROR,
+		(header->strings_size % 8 != 0)
+		|| (header->strings_size > size)
+		|| (header->num_records >
+			(size - header->strings_size) / sizeof(CCLProfBinRecord)),
+		CCL_ERROR_INVALID_DATA, error_handler,
+		"Binary trace '%s' is truncated.", filename);
+
+	/* Locate names in string table. Each name takes at least one byte
+	 * (its terminating null character), so the number of names can't
+	 * be larger than the size of the string table. */
+	strings = contents + sizeof(CCLProfBinHeader);
+	num_names = (guint64) header->num_event_names + header->num_queue_names;
+	g_if_err_create_goto(*err, CCL_ERROR,
+		num_names > header->strings_size,
+		CCL_ERROR_INVALID_DATA, error_handler,
+		"Binary trace '%s' has an invalid string table.", filename);
+	names = g_new(const char*, num_names);
+	for (guint64 i = 0, offset = 0; i < num_names; ++i) {
+		const char* nul = (offset < header->strings_size)
+			? memchr(strings + offset, '\0', header->strings_size - offset)
+			: NULL;
+		g_if_err_create_goto(*err, CCL_ERROR, nul == NULL,
+			CCL_ERROR_INVALID_DATA, error_handler,
+			"Binary trace '%s' has an invalid string table.", filename);
+		names[i] = strings + offset;
+		offset = nul - strings + 1;
+	}
+	recs = (const CCLProfBinRecord*) (strings + header->strings_size);
+
+	/* Create profile object, which keeps the mapped file. */
+	prof = ccl_prof_new();
+	prof->mapped = mapped;
+	mapped = NULL;
+	prof->event_names = g_hash_table_new(g_str_hash, g_str_equal);
+	prof->queue_names = g_ptr_array_sized_new(header->num_queue_names);
+	prof->instants = g_array_new(FALSE, FALSE, sizeof(cl_uint));
+	for (guint i = 0; i < header->num_queue_names; ++i) {
+		g_ptr_array_add(prof->queue_names,
+			(gpointer) names[header->num_event_names + i]);
+	}
+
+	/* Add records. */
+	for (guint64 i = 0; i < header->num_records; ++i) {
+
+		CCLEventRecord rec;
+
+		g_if_err_create_goto(*err, CCL_ERROR,
+			(recs[i].event_name_id >= header->num_event_names)
+			|| (recs[i].queue_id >= header->num_queue_names),
+			CCL_ERROR_INVALID_DATA, error_handler,
+			"Binary trace '%s' has an invalid record.", filename);
+
+		rec.event_name = names[recs[i].event_name_id];
+		rec.command_type = recs[i].command_type;
+		rec.t_queued = recs[i].t_queued;
+		rec.t_submit = recs[i].t_submit;
+		rec.t_start = recs[i].t_start;
+		rec.t_end = recs[i].t_end;
+		ccl_prof_add_record(prof, recs[i].queue_id, &rec);
+	}
+
+	/* Determine profiling information. */
+	ccl_prof_calc_from_events(prof);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	if (prof != NULL) {
+		ccl_prof_destroy(prof);
+		prof = NULL;
+	}
+
+finish:
+
+	/* Release mapped file, if not kept by profile object, and aux.
+	 * array. */
+	if (mapped != NULL) g_mapped_file_unref(mapped);
+	g_free(names);
+
+	/* Return profile object. */
+	return prof;
+
+}
+
+
 /**
  * Set export options using a ::CCLProfExportOptions struct.
  *
@@ -68,7 +68,11 @@
  * all events with same name, represented by the ::CCLProfAgg* class. If
  * an event name is not set during the course of the computation, the
  * aggregation is performed by event type, i.e., by events which
- * represent the same command. A sequence of ::CCLProfAgg* objects can
+ * represent the same command. Besides total and relative times,
+ * aggregate event information includes the number of events and
+ * duration statistics (minimum, maximum, mean, standard deviation and
+ * percentiles), the latter estimated with a log-bucketed histogram with
+ * a relative error below 1%. A sequence of ::CCLProfAgg* objects can
  * be iterated over using the ::ccl_prof_iter_agg_init() and
  * ::ccl_prof_iter_agg_next() functions. A specific aggregate event
  * can be obtained by name using the ::ccl_prof_get_agg() function.
@@ -77,7 +81,9 @@
  * if no name is given), the queue the event is associated with, and
  * submit, queue, start and end instants. A sequence of ::CCLProfInfo*
  * objects can be iterated over using the ::ccl_prof_iter_info_init()
- * and ::ccl_prof_iter_info_next() functions.
+ * and ::ccl_prof_iter_info_next() functions. Event information is kept
+ * column-wise internally, so the returned objects are only valid until
+ * the next call to the iterator function.
  * 3. _Event instants_: specific start and end event instants, represented
  * by the ::CCLProfInst* class. A sequence of ::CCLProfInst* objects can
  * be iterated over using the ::ccl_prof_iter_inst_init() and
@@ -89,6 +95,27 @@
  * ::ccl_prof_iter_overlap_init() and ::ccl_prof_iter_overlap_next()
  * functions.
  *
+ * For long-running computations, the profiler can also operate in
+ * _streaming_ mode. In this mode, ::ccl_prof_poll() is called
+ * periodically, consuming the complete events of the added queues and
+ * updating aggregate event information and event overlaps
+ * incrementally, without keeping per-event information. A snapshot of
+ * the profiling information gathered so far can be obtained at any time
+ * with ::ccl_prof_snapshot(), and queried with the functions described
+ * above. A final call to ::ccl_prof_calc() consumes the remaining
+ * events. In streaming mode, non-aggregate event information and event
+ * instants are not available.
+ *
+ * The time spent by the host in _cf4ocl_ API calls can also be traced.
+ * If the library is built with the `HOST_TRACING` option (disabled by
+ * default), host tracing can be enabled at runtime with
+ * ::ccl_prof_set_host_tracing(), after which calls which create objects
+ * or enqueue commands are recorded with a monotonic host clock in
+ * bounded per-thread buffers. A profile object consumes the recorded calls if
+ * ::ccl_prof_add_host_trace() is invoked before ::ccl_prof_calc(). Host
+ * calls are then aligned with device events, summarized per function
+ * and included in exported traces.
+ *
  * While this information can be subject to different types of
  * examination by client code, the profiler module also offers some
  * functionality which allows for a more immediate interpretation of
@@ -104,6 +131,15 @@
  * exported with the ::ccl_prof_export_info() or
  * ::ccl_prof_export_info_file() functions, using the default export
  * options.
+ * 3. A timeline of the performed computation can be exported in the
+ * Chrome Trace Event JSON format with the ::ccl_prof_export_trace() or
+ * ::ccl_prof_export_trace_file() functions, and opened with the
+ * [Perfetto UI](https://ui.perfetto.dev) or Chrome's `about://tracing`.
+ * 4. Event profiling information can be saved in a compact binary trace
+ * format with ::ccl_prof_export_bin() or ::ccl_prof_export_bin_file(),
+ * and loaded for offline analysis with ::ccl_prof_new_from_bin_file(),
+ * which returns a profile object that can be examined as described
+ * above.
  *
  * _Example: Conway's game of life using double-buffered images_
  * (@ref ca.c "complete example")
@@ -162,6 +198,14 @@
       ------------------------------------------------------------------
                                        |         Total |    3.8518e-02 |
                                        ---------------------------------
+    Event durations (s)       :
+      --------------------------------------------------------------------------------------------------------------------------------
+      | Event name             |    Count |    Mean    |  Std. dev. |    Min     |    p50     |    p95     |    p99     |    Max     |
+      --------------------------------------------------------------------------------------------------------------------------------
+      | NDRANGE_KERNEL         |      256 | 1.4636e-04 | 2.1177e-05 | 1.2160e-04 | 1.4112e-04 | 1.8624e-04 | 2.1952e-04 | 2.5408e-04 |
+      | READ_IMAGE             |      256 | 4.0246e-06 | 3.1846e-07 | 3.6800e-06 | 3.9840e-06 | 4.4640e-06 | 5.0720e-06 | 6.4960e-06 |
+      | WRITE_IMAGE            |        1 | 1.9690e-05 | 0.0000e+00 | 1.9690e-05 | 1.9690e-05 | 1.9690e-05 | 1.9690e-05 | 1.9690e-05 |
+      --------------------------------------------------------------------------------------------------------------------------------
     Event overlaps            :
       ------------------------------------------------------------------
       | Event 1                | Event2                 | Overlap (s)  |
@@ -245,6 +289,55 @@ typedef struct ccl_prof_agg {
 	 * */
 	double relative_time;
 
+	/**
+	 * Number of events with name equal to ::CCLProfAgg::event_name
+	 * which used device time.
+	 * @public
+	 * */
+	cl_uint count;
+
+	/**
+	 * Duration of the shortest event.
+	 * @public
+	 * */
+	cl_ulong min;
+
+	/**
+	 * Duration of the longest event.
+	 * @public
+	 * */
+	cl_ulong max;
+
+	/**
+	 * Mean event duration.
+	 * @public
+	 * */
+	double mean;
+
+	/**
+	 * Standard deviation of event durations.
+	 * @public
+	 * */
+	double stddev;
+
+	/**
+	 * Median (50th percentile) of event durations.
+	 * @public
+	 * */
+	cl_ulong p50;
+
+	/**
+	 * 95th percentile of event durations.
+	 * @public
+	 * */
+	cl_ulong p95;
+
+	/**
+	 * 99th percentile of event durations.
+	 * @public
+	 * */
+	cl_ulong p99;
+
 } CCLProfAgg;
 
 
@@ -257,7 +350,34 @@ typedef enum {
 	CCL_PROF_AGG_SORT_NAME = 0x00,
 
 	/** Sort aggregate event data instances by time. */
-	CCL_PROF_AGG_SORT_TIME = 0x10
+	CCL_PROF_AGG_SORT_TIME = 0x10,
+
+	/** Sort aggregate event data instances by number of events. */
+	CCL_PROF_AGG_SORT_COUNT = 0x100,
+
+	/** Sort aggregate event data instances by mean duration. */
+	CCL_PROF_AGG_SORT_MEAN = 0x110,
+
+	/** Sort aggregate event data instances by standard deviation of
+	 * durations. */
+	CCL_PROF_AGG_SORT_STDDEV = 0x120,
+
+	/** Sort aggregate event data instances by minimum duration. */
+	CCL_PROF_AGG_SORT_MIN = 0x130,
+
+	/** Sort aggregate event data instances by maximum duration. */
+	CCL_PROF_AGG_SORT_MAX = 0x140,
+
+	/** Sort aggregate event data instances by median duration. */
+	CCL_PROF_AGG_SORT_P50 = 0x150,
+
+	/** Sort aggregate event data instances by 95th percentile of
+	 * durations. */
+	CCL_PROF_AGG_SORT_P95 = 0x160,
+
+	/** Sort aggregate event data instances by 99th percentile of
+	 * durations. */
+	CCL_PROF_AGG_SORT_P99 = 0x170
 
 } CCLProfAggSort;
 
@@ -336,7 +456,10 @@ typedef enum {
 	CCL_PROF_INFO_SORT_T_START    = 0x60,
 
 	 /** Sort event profiling info instances by end time. */
-	CCL_PROF_INFO_SORT_T_END      = 0x70
+	CCL_PROF_INFO_SORT_T_END      = 0x70,
+
+	 /** Sort event profiling info instances by duration. */
+	CCL_PROF_INFO_SORT_DURATION   = 0xc0
 
 } CCLProfInfoSort;
 
@@ -510,10 +633,33 @@ CCL_EXPORT
 void ccl_prof_add_queue(
 	CCLProf* prof, const char* cq_name, CCLQueue* cq);
 
+/* Enable or disable host API call tracing. */
+CCL_EXPORT
+void ccl_prof_set_host_tracing(cl_bool enable);
+
+/* Check if host API call tracing is enabled. */
+CCL_EXPORT
+cl_bool ccl_prof_get_host_tracing(void);
+
+/* Have the profile object consume the host API calls recorded with
+ * host tracing. */
+CCL_EXPORT
+void ccl_prof_add_host_trace(CCLProf* prof);
+
 /* Determine aggregate statistics for the given profile object. */
 CCL_EXPORT
 cl_bool ccl_prof_calc(CCLProf* prof, CCLErr** err);
 
+/* Consume complete events of the profiled command queues, updating
+ * profiling information incrementally. */
+CCL_EXPORT
+cl_bool ccl_prof_poll(CCLProf* prof, CCLErr** err);
+
+/* Get a snapshot of the profiling information incrementally determined
+ * with ccl_prof_poll(). */
+CCL_EXPORT
+CCLProf* ccl_prof_snapshot(CCLProf* prof);
+
 /* Return aggregate statistics for events with the given name. */
 CCL_EXPORT
 const CCLProfAgg* ccl_prof_get_agg(
@@ -587,6 +733,32 @@ CCL_EXPORT
 cl_bool ccl_prof_export_info_file(
 	CCLProf* profile, const char* filename, CCLErr** err);
 
+/* Export profiling trace to a given stream in the Chrome Trace Event
+ * JSON format. */
+CCL_EXPORT
+cl_bool ccl_prof_export_trace(CCLProf* prof, FILE* stream, CCLErr** err);
+
+/* Helper function which exports profiling trace to a given file,
+ * automatically opening and closing the file. */
+CCL_EXPORT
+cl_bool ccl_prof_export_trace_file(
+	CCLProf* prof, const char* filename, CCLErr** err);
+
+/* Export profiling information to a given stream in a compact binary
+ * trace format. */
+CCL_EXPORT
+cl_bool ccl_prof_export_bin(CCLProf* prof, FILE* stream, CCLErr** err);
+
+/* Helper function which exports a binary trace to a given file,
+ * automatically opening and closing the file. */
+CCL_EXPORT
+cl_bool ccl_prof_export_bin_file(
+	CCLProf* prof, const char* filename, CCLErr** err);
+
+/* Create a profile object from a binary trace file. */
+CCL_EXPORT
+CCLProf* ccl_prof_new_from_bin_file(const char* filename, CCLErr** err);
+
 /* Set export options using a ::CCLProfExportOptions struct. */
 CCL_EXPORT
 void ccl_prof_set_export_opts(CCLProfExportOptions export_opts);
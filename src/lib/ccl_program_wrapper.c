@@ -27,9 +27,21 @@
  * */
 
 #include "ccl_program_wrapper.h"
+#include "ccl_platform_wrapper.h"
 #include "_ccl_abstract_dev_container_wrapper.h"
+#include "_ccl_kernel_wrapper.h"
+#include "_ccl_program_wrapper.h"
 #include "_ccl_defs.h"
 
+/* Version of the program cache format, part of all cache keys. */
+#define CCL_PROGRAM_CACHE_VERSION "cf4ocl-program-cache-1"
+
+/* Number of locks which synchronize kernel creation with asynchronous
+ * builds (must be a power of two), and the respective number of
+ * bits. */
+#define CCL_PROGRAM_NUM_BUILD_LOCKS 16
+#define CCL_PROGRAM_BUILD_LOCK_BITS 4
+
 /* Valid file name characters. */
 #define CCL_VALIDFILECHARS "abcdefghijklmnopqrstuvwxyzABCDEFGH" \
 	"IJKLMNOPQRSTUVWXYZ0123456789_."
@@ -59,6 +71,34 @@ struct ccl_program {
 	 * */
 	GHashTable* krnls;
 
+	/**
+	 * Kernel table, with program kernels in the order given by
+	 * clCreateKernelsInProgram().
+	 * @private
+	 * */
+	CCLKernel** krnl_table;
+
+	/**
+	 * Names of kernels in kernel table (`NULL`-terminated), or `NULL`
+	 * if the kernel table was not created.
+	 * @private
+	 * */
+	gchar** krnl_names;
+
+	/**
+	 * Number of kernels in kernel table.
+	 * @private
+	 * */
+	cl_uint num_krnls;
+
+	/**
+	 * Work-group information of kernels in kernel table, for each
+	 * kernel and device, indexed by
+	 * `kernel_index * number_of_devices + device_index`.
+	 * @private
+	 * */
+	CCLKernelMeta* krnl_meta;
+
 	/**
 	 * Build logs of most recent build for each device.
 	 * @private
@@ -92,6 +132,141 @@ struct ccl_program_binary {
 	size_t size;
 };
 
+/**
+ * Class which represents an ongoing asynchronous build of a program
+ * for one or more devices.
+ * */
+struct ccl_program_build_future {
+
+	/**
+	 * Program being built.
+	 * @private
+	 * */
+	CCLProgram* prg;
+
+	/**
+	 * Devices for which the program is being built.
+	 * @private
+	 * */
+	CCLDevice** devs;
+
+	/**
+	 * Number of devices for which the program is being built.
+	 * @private
+	 * */
+	cl_uint num_devs;
+
+	/**
+	 * Build options.
+	 * @private
+	 * */
+	gchar* options;
+
+	/**
+	 * OpenCL status of the build for each device.
+	 * @private
+	 * */
+	cl_int* status;
+
+	/**
+	 * Whether the build is finished for each device.
+	 * @private
+	 * */
+	gboolean* done;
+
+	/**
+	 * Number of devices for which the build has started.
+	 * @private
+	 * */
+	cl_uint num_started;
+
+	/**
+	 * Number of devices for which the build is finished.
+	 * @private
+	 * */
+	cl_uint num_done;
+
+	/**
+	 * Worker threads, one per device.
+	 * @private
+	 * */
+	GThreadPool* pool;
+
+	/**
+	 * Protects the build state.
+	 * @private
+	 * */
+	GMutex mutex;
+
+	/**
+	 * Signals changes in the build state.
+	 * @private
+	 * */
+	GCond cond;
+
+};
+
+/* Locks which synchronize kernel creation with asynchronous builds.
+ * Programs share locks according to their OpenCL objects. Statically
+ * allocated locks don't need to be initialized. */
+static GRWLock build_locks[CCL_PROGRAM_NUM_BUILD_LOCKS];
+
+/* Compile-time check of the number of locks. */
+G_STATIC_ASSERT(
+	(1 << CCL_PROGRAM_BUILD_LOCK_BITS) == CCL_PROGRAM_NUM_BUILD_LOCKS);
+
+/**
+ * @internal
+ * Get the lock which synchronizes kernel creation with asynchronous
+ * builds of the given program. Asynchronous builds hold the lock for
+ * reading while they are running, and kernel creation holds the lock
+ * for writing.
+ *
+ * @private @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @return The lock for the given program.
+ * */
+static inline GRWLock* ccl_program_get_build_lock(CCLProgram* prg) {
+
+	guint64 h = (guint64) GPOINTER_TO_SIZE(ccl_program_unwrap(prg));
+	h *= G_GUINT64_CONSTANT(0x9E3779B97F4A7C15);
+	return &build_locks[h >> (64 - CCL_PROGRAM_BUILD_LOCK_BITS)];
+}
+
+/**
+ * @internal
+ * Wait for asynchronous builds of the given program which are in
+ * progress, and keep new ones from starting, such that kernels can be
+ * created. OpenCL does not allow building a program with attached
+ * kernels, so this function must be called before creating kernels,
+ * and ccl_program_kernels_unlock() afterwards.
+ *
+ * @private @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * */
+void ccl_program_kernels_lock(CCLProgram* prg) {
+
+	g_rw_lock_writer_lock(ccl_program_get_build_lock(prg));
+
+}
+
+/**
+ * @internal
+ * Allow asynchronous builds of the given program to start again after
+ * a call to ccl_program_kernels_lock().
+ *
+ * @private @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * */
+void ccl_program_kernels_unlock(CCLProgram* prg) {
+
+	g_rw_lock_writer_unlock(ccl_program_get_build_lock(prg));
+
+}
+
 /**
  * @internal
  * Destroy table of build logs.
@@ -117,6 +292,35 @@ static void ccl_program_clear_build_logs(CCLProgram* prg) {
 	}
 }
 
+/**
+ * @internal
+ * Destroy kernel table.
+ *
+ * @private @memberof ccl_program
+ *
+ * @param[in] prg A ::CCLProgram wrapper object.
+ * */
+static void ccl_program_clear_kernel_table(CCLProgram* prg) {
+
+	/* Reduce reference count of kernels in table. */
+	for (cl_uint i = 0; i < prg->num_krnls; ++i) {
+		if (prg->krnl_table[i] != NULL)
+			ccl_kernel_destroy(prg->krnl_table[i]);
+	}
+
+	/* Free table. */
+	g_free(prg->krnl_table);
+	g_free(prg->krnl_meta);
+	g_strfreev(prg->krnl_names);
+
+	/* Set to NULL to allow reuse. */
+	prg->krnl_table = NULL;
+	prg->krnl_meta = NULL;
+	prg->krnl_names = NULL;
+	prg->num_krnls = 0;
+
+}
+
 /**
  * @internal
  * Implementation of ccl_wrapper_release_fields() function for
@@ -145,6 +349,9 @@ static void ccl_program_release_fields(CCLProgram* prg) {
 
 	}
 
+	/* Destroy kernel table. */
+	ccl_program_clear_kernel_table(prg);
+
 	/* If the binaries table was created... */
 	if (prg->binaries != NULL) {
 
@@ -234,6 +441,99 @@ static void ccl_program_binary_destroy(CCLProgramBinary* pbin) {
  * */
 #define ccl_program_binary_new_empty() ccl_program_binary_new(NULL, 0)
 
+/**
+ * @internal
+ * Determine the program cache key of the given sources, build options
+ * and device, i.e. the SHA-256 of the sources, build options, device
+ * name, driver version and platform version.
+ *
+ * @private @memberof ccl_program
+ *
+ * @param[in] dev Device wrapper object.
+ * @param[in] count Number of source strings.
+ * @param[in] strings Source strings.
+ * @param[in] lengths Number of chars in each string, as in
+ * ccl_program_new_from_sources().
+ * @param[in] options Build options, or `NULL`.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The cache key as an hexadecimal string, which should be freed
+ * with g_free(), or `NULL` if an error occurs.
+ * */
+static gchar* ccl_program_cache_key(CCLDevice* dev, cl_uint count,
+	const char** strings, const size_t* lengths, const char* options,
+	CCLErr** err) {
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Platform of device. */
+	CCLPlatform* platf = NULL;
+	/* Device and platform information. */
+	const char* info;
+	/* Checksum object. */
+	GChecksum* sum = g_checksum_new(G_CHECKSUM_SHA256);
+	/* Cache key. */
+	gchar* key = NULL;
+
+	/* Fields are separated by null characters. */
+	g_checksum_update(sum, (const guchar*) CCL_PROGRAM_CACHE_VERSION, -1);
+	g_checksum_update(sum, (const guchar*) "", 1);
+
+	/* Sources. */
+	for (cl_uint i = 0; i < count; ++i) {
+		g_checksum_update(sum, (const guchar*) strings[i],
+			((lengths == NULL) || (lengths[i] == 0))
+				? (gssize) strlen(strings[i]) : (gssize) lengths[i]);
+	}
+	g_checksum_update(sum, (const guchar*) "", 1);
+
+	/* Build options. */
+	if (options != NULL)
+		g_checksum_update(sum, (const guchar*) options, -1);
+	g_checksum_update(sum, (const guchar*) "", 1);
+
+	/* Device name and driver version. */
+	info = ccl_device_get_info_array(
+		dev, CL_DEVICE_NAME, char*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	g_checksum_update(sum, (const guchar*) info, -1);
+	g_checksum_update(sum, (const guchar*) "", 1);
+
+	info = ccl_device_get_info_array(
+		dev, CL_DRIVER_VERSION, char*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	g_checksum_update(sum, (const guchar*) info, -1);
+	g_checksum_update(sum, (const guchar*) "", 1);
+
+	/* Platform version. */
+	platf = ccl_platform_new_from_device(dev, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	info = ccl_platform_get_info_string(
+		platf, CL_PLATFORM_VERSION, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	g_checksum_update(sum, (const guchar*) info, -1);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	key = g_strdup(g_checksum_get_string(sum));
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Release stuff. */
+	if (platf != NULL) ccl_platform_destroy(platf);
+	g_checksum_free(sum);
+
+	/* Return cache key. */
+	return key;
+
+}
+
 /**
  * @addtogroup CCL_PROGRAM_WRAPPER
  * @{
@@ -429,6 +729,9 @@ CCLProgram* ccl_program_new_from_sources(CCLContext* ctx,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	cl_program program = NULL;
 	CCLProgram* prg = NULL;
@@ -455,6 +758,191 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return prg. */
+	return prg;
+
+}
+
+/**
+ * Create and build a new program wrapper object from several source
+ * code strings, using a persistent cache of program binaries.
+ *
+ * A cache file is kept for each device in the context, named after
+ * the SHA-256 of the sources, build options, device name, driver
+ * version and platform version. If cache files exist for all devices,
+ * the program is created from them with clCreateProgramWithBinary() and
+ * built. Otherwise, or if creating or building the program from the
+ * cached binaries fails (e.g. because the files are corrupt), the
+ * program is created from the sources and built, and its binaries are
+ * written back to the cache. Cache files are written to temporary
+ * files which are atomically renamed, such that concurrent writers
+ * (e.g. several processes starting at the same time) never leave
+ * partially written files. Failures writing to the cache are ignored.
+ *
+ * @warning Only the given source strings and build options are part of
+ * the cache key. Headers included by the sources with `#include`
+ * (e.g. found in folders given with `-I` build options) are not, so
+ * changes to their contents are not detected, and a stale binary may
+ * be used. Client code which includes headers should either add their
+ * version or checksum to the build options (e.g. `-DHEADERS_SHA=...`),
+ * or remove the cache files when the headers change.
+ *
+ * @public @memberof ccl_program
+ *
+ * @attention If the build fails, the program is destroyed, and its build
+ * log is not available. Use ccl_program_new_from_sources() and
+ * ccl_program_build() to diagnose build errors.
+ *
+ * @param[in] ctx The context wrapper object.
+ * @param[in] count Number of source strings.
+ * @param[in] strings Source strings.
+ * @param[in] lengths An array with the number of chars in each string
+ * (the string length). If an element in lengths is zero, its
+ * accompanying string is null-terminated. If lengths is `NULL`, all
+ * strings in the strings argument are considered null-terminated.
+ * @param[in] options A null-terminated string of characters that
+ * describes the build options to be used for building the program
+ * executable, or `NULL`.
+ * @param[in] cache_dir Cache directory, created if it does not exist.
+ * If `NULL`, the `cf4ocl/programs` folder in the user's cache directory
+ * (e.g. `$XDG_CACHE_HOME/cf4ocl/programs`) is used.
+ * @param[out] from_cache Location where to place `CL_TRUE` if the
+ * program was created from cached binaries or `CL_FALSE` otherwise, or
+ * `NULL` if this information is not required.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new, built, program wrapper object, or `NULL` if an error
+ * occurs.
+ * */
+CCL_EXPORT
+CCLProgram* ccl_program_new_from_sources_cached(CCLContext* ctx,
+	cl_uint count, const char** strings, const size_t* lengths,
+	const char* options, const char* cache_dir, cl_bool* from_cache,
+	CCLErr** err) {
+
+	/* Make sure ctx is not NULL. */
+	g_return_val_if_fail(ctx != NULL, NULL);
+	/* Make sure there are sources. */
+	g_return_val_if_fail((count > 0) && (strings != NULL), NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Program wrapper object. */
+	CCLProgram* prg = NULL;
+	/* Devices in context. */
+	CCLDevice* const* devs;
+	cl_uint num_devs = 0;
+	/* Cache directory and files, one per device. */
+	gchar* dir = NULL;
+	gchar** files = NULL;
+	/* Cached binaries, one per device. */
+	CCLProgramBinary** bins = NULL;
+	/* Are all binaries cached? */
+	cl_bool hit = CL_TRUE;
+
+	/* Determine cache directory. */
+	dir = (cache_dir != NULL)
+		? g_strdup(cache_dir)
+		: g_build_filename(
+			g_get_user_cache_dir(), "cf4ocl", "programs", NULL);
+
+	/* Get devices in context. */
+	num_devs = ccl_context_get_num_devices(ctx, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	devs = ccl_context_get_all_devices(ctx, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Determine cache files and try to load them. */
+	files = g_new0(gchar*, num_devs + 1);
+	bins = g_new0(CCLProgramBinary*, num_devs);
+	for (cl_uint i = 0; i < num_devs; ++i) {
+
+		gchar* key = ccl_program_cache_key(
+			devs[i], count, strings, lengths, options, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		gchar* file = g_strconcat(key, ".bin", NULL);
+		files[i] = g_build_filename(dir, file, NULL);
+		g_free(file);
+		g_free(key);
+
+		bins[i] = ccl_program_binary_new_empty();
+		if (hit && !g_file_get_contents(files[i],
+			(char**) &bins[i]->data, &bins[i]->size, NULL)) {
+			hit = CL_FALSE;
+		} else if (hit && (bins[i]->size == 0)) {
+			g_free(bins[i]->data);
+			bins[i]->data = NULL;
+			hit = CL_FALSE;
+		}
+	}
+
+	/* Try to create and build program from cached binaries. Failures
+	 * are handled as cache misses. */
+	if (hit) {
+		prg = ccl_program_new_from_binaries(
+			ctx, num_devs, devs, bins, NULL, NULL);
+		if ((prg != NULL) && !ccl_program_build(prg, options, NULL)) {
+			ccl_program_destroy(prg);
+			prg = NULL;
+		}
+		hit = (prg != NULL);
+	}
+
+	if (!hit) {
+
+		/* Create and build program from sources. */
+		prg = ccl_program_new_from_sources(
+			ctx, count, strings, lengths, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		ccl_program_build(prg, options, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		/* Write binaries back to the cache. Binaries are saved with
+		 * g_file_set_contents(), which writes to a temporary file in the
+		 * same folder and renames it, so readers only see complete
+		 * files. */
+		if (g_mkdir_with_parents(dir, 0700) == 0) {
+			for (cl_uint i = 0; i < num_devs; ++i) {
+				ccl_program_save_binary(prg, devs[i], files[i], NULL);
+			}
+		}
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	if (from_cache != NULL) *from_cache = hit;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Destroy program, if it was created. */
+	if (prg != NULL) {
+		ccl_program_destroy(prg);
+		prg = NULL;
+	}
+
+finish:
+
+	/* Free stuff. */
+	if (bins != NULL) {
+		for (cl_uint i = 0; i < num_devs; ++i) {
+			if (bins[i] != NULL) {
+				ccl_program_binary_destroy(bins[i]);
+			}
+		}
+		g_free(bins);
+	}
+	g_strfreev(files);
+	g_free(dir);
+
 	/* Return prg. */
 	return prg;
 
@@ -625,6 +1113,9 @@ CCLProgram* ccl_program_new_from_binaries(CCLContext* ctx,
 	/* Make sure num_devices > 0. */
 	g_return_val_if_fail(num_devices > 0, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	cl_int ocl_status;
 	CCLProgram* prg = NULL;
 	cl_program program = NULL;
@@ -674,6 +1165,9 @@ finish:
 	if (bins_raw != NULL)
 		g_slice_free1(num_devices * sizeof(unsigned char*), bins_raw);
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return prg. */
 	return prg;
 
@@ -709,6 +1203,9 @@ CCLProgram* ccl_program_new_from_built_in_kernels(CCLContext* ctx,
 	/* Make sure num_devices > 0. */
 	g_return_val_if_fail(num_devices > 0, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* OpenCL function return status. */
 	cl_int ocl_status;
 	/* OpenCL program object. */
@@ -790,6 +1287,9 @@ finish:
 	if (device_list != NULL)
 		g_slice_free1(num_devices * sizeof(cl_device_id), device_list);
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return prg. */
 	return prg;
 
@@ -856,6 +1356,9 @@ cl_bool ccl_program_build_full(CCLProgram* prg,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Array of unwrapped devices. */
 	cl_device_id* cl_devices = NULL;
 	/* Status of OpenCL function call. */
@@ -904,25 +1407,381 @@ finish:
 		g_slice_free1(sizeof(cl_device_id) * num_devices, cl_devices);
 	}
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return result of function call. */
 	return result;
 
 }
 
 /**
- * Get a general build log of most recent build, compile or link, for all
- * devices.
+ * @internal
+ * Worker thread function which builds the program executable of an
+ * asynchronous build for a single device.
  *
- * Individual build logs for each device associated with the program are
- * returned in a concatenated fashion, with a header (identifying the device)
- * and footer separating them.
+ * @private @memberof ccl_program_build_future
  *
- * @param[in] prg Program wrapper object.
- * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
- * reporting is to be ignored.
- * @return The build log for most recent build, compile or link. May be `NULL`
- * or an empty string if no build, compile or link was performed, or if no build
- * log is available.
+ * @param[in] data Index of device in build future plus one.
+ * @param[in] user_data The ::CCLProgramBuildFuture object.
+ * */
+static void ccl_program_build_worker(gpointer data, gpointer user_data) {
+
+	/* Build future. */
+	CCLProgramBuildFuture* fut = (CCLProgramBuildFuture*) user_data;
+	/* Index of device to build for. */
+	cl_uint idx = GPOINTER_TO_UINT(data) - 1;
+	/* Device to build for. */
+	cl_device_id cl_dev = ccl_device_unwrap(fut->devs[idx]);
+	/* Lock which keeps kernels from being created during the build. */
+	GRWLock* build_lock = ccl_program_get_build_lock(fut->prg);
+	/* Status of OpenCL function call. */
+	cl_int ocl_status;
+
+	/* Signal that the build for this device has started. The build
+	 * lock is acquired before, such that kernels created after
+	 * ccl_program_build_future_wait() returns wait for the build to
+	 * finish. */
+	g_rw_lock_reader_lock(build_lock);
+	g_mutex_lock(&fut->mutex);
+	fut->num_started++;
+	g_cond_broadcast(&fut->cond);
+	g_mutex_unlock(&fut->mutex);
+
+	/* Build program for this device only. */
+	ocl_status = clBuildProgram(ccl_program_unwrap(fut->prg),
+		1, &cl_dev, fut->options, NULL, NULL);
+	g_rw_lock_reader_unlock(build_lock);
+
+	/* Signal that the build for this device is finished. */
+	g_mutex_lock(&fut->mutex);
+	fut->status[idx] = ocl_status;
+	fut->done[idx] = TRUE;
+	fut->num_done++;
+	g_cond_broadcast(&fut->cond);
+	g_mutex_unlock(&fut->mutex);
+
+}
+
+/**
+ * Start building (compiling and linking) a program executable for
+ * each of the given devices in parallel, returning immediately. Each
+ * device is built in a separate worker thread with the clBuildProgram()
+ * OpenCL function.
+ *
+ * The build for a specific device can be waited for with
+ * ccl_program_build_future_wait(), after which the build status and
+ * log for that device can be checked, even if the builds for other
+ * devices are not finished yet. Kernels can also be created after this
+ * function returns. However, since OpenCL forbids building a program
+ * with attached kernels, kernel creation blocks until the builds for
+ * the remaining devices are finished.
+ *
+ * @public @memberof ccl_program
+ *
+ * @attention The program must not be otherwise built, compiled or
+ * modified until the returned future is destroyed. Program kernels
+ * must only be created after a call to
+ * ccl_program_build_future_wait(), which guarantees that the builds
+ * for all devices have been started. Kernel creation waits for builds
+ * in progress to finish.
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[in] num_devices The number of devices listed in `devs`.
+ * @param[in] devs List of device wrappers associated with program.
+ * If `NULL`, the program executable is built for all devices
+ * associated with program.
+ * @param[in] options A null-terminated string of characters that
+ * describes the build options to be used for building the program
+ * executable.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new build future, which must be released with
+ * ccl_program_build_future_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLProgramBuildFuture* ccl_program_build_async(CCLProgram* prg,
+	cl_uint num_devices, CCLDevice* const* devs, const char* options,
+	CCLErr** err) {
+
+	/* Make sure prg is not NULL. */
+	g_return_val_if_fail(prg != NULL, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Build future to return. */
+	CCLProgramBuildFuture* fut = NULL;
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+
+	/* If no devices were specified, build for all program devices. */
+	if ((devs == NULL) || (num_devices == 0)) {
+		devs = ccl_program_get_all_devices(prg, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		num_devices = ccl_program_get_num_devices(prg, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+	}
+
+	/* Clear build logs cache. */
+	ccl_program_clear_build_logs(prg);
+
+	/* Initialize build future. */
+	fut = g_slice_new0(CCLProgramBuildFuture);
+	fut->prg = prg;
+	ccl_program_ref(prg);
+	fut->devs = g_memdup(devs, sizeof(CCLDevice*) * num_devices);
+	fut->num_devs = num_devices;
+	fut->options = g_strdup(options);
+	fut->status = g_new0(cl_int, num_devices);
+	fut->done = g_new0(gboolean, num_devices);
+	g_mutex_init(&fut->mutex);
+	g_cond_init(&fut->cond);
+
+	/* Create one worker thread per device. */
+	fut->pool = g_thread_pool_new(ccl_program_build_worker, fut,
+		(gint) num_devices, FALSE, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Start builds. */
+	for (cl_uint i = 0; i < num_devices; ++i) {
+		g_thread_pool_push(fut->pool, GUINT_TO_POINTER(i + 1),
+			&err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Destroy what was built for the build future. */
+	if (fut != NULL) {
+		ccl_program_build_future_destroy(fut);
+		fut = NULL;
+	}
+
+finish:
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return build future. */
+	return fut;
+
+}
+
+/**
+ * @internal
+ * Get the index of a device in a build future.
+ *
+ * @private @memberof ccl_program_build_future
+ *
+ * @param[in] fut The build future.
+ * @param[in] dev A device wrapper.
+ * @return The index of the device in the build future, or `G_MAXUINT`
+ * if the device is not part of the build.
+ * */
+static cl_uint ccl_program_build_future_index(
+	CCLProgramBuildFuture* fut, CCLDevice* dev) {
+
+	for (cl_uint i = 0; i < fut->num_devs; ++i) {
+		if (ccl_device_unwrap(fut->devs[i]) == ccl_device_unwrap(dev))
+			return i;
+	}
+	return G_MAXUINT;
+}
+
+/**
+ * Check if an asynchronous build has finished (successfully or
+ * unsuccessfully) for the given device or for all devices. This
+ * function does not block.
+ *
+ * @public @memberof ccl_program_build_future
+ *
+ * @param[in] fut The build future.
+ * @param[in] dev Device wrapper, or `NULL` to check all devices.
+ * @return `CL_TRUE` if the build is finished, `CL_FALSE` if it is
+ * still running or if the device is not part of the build.
+ * */
+CCL_EXPORT
+cl_bool ccl_program_build_future_is_ready(
+	CCLProgramBuildFuture* fut, CCLDevice* dev) {
+
+	/* Make sure fut is not NULL. */
+	g_return_val_if_fail(fut != NULL, CL_FALSE);
+
+	/* Index of device. */
+	cl_uint idx;
+	/* Result of function call. */
+	cl_bool ready;
+
+	g_mutex_lock(&fut->mutex);
+	if (dev == NULL) {
+		ready = (fut->num_done == fut->num_devs) ? CL_TRUE : CL_FALSE;
+	} else {
+		idx = ccl_program_build_future_index(fut, dev);
+		ready = ((idx != G_MAXUINT) && fut->done[idx])
+			? CL_TRUE : CL_FALSE;
+	}
+	g_mutex_unlock(&fut->mutex);
+
+	return ready;
+
+}
+
+/**
+ * Wait for an asynchronous build to finish for the given device or for
+ * all devices. This function also waits until the builds for all
+ * devices have started, such that kernels can be safely created once
+ * it returns successfully. Kernel creation waits for the builds for
+ * the remaining devices to finish, since OpenCL forbids building a
+ * program with attached kernels.
+ *
+ * @public @memberof ccl_program_build_future
+ *
+ * @param[in] fut The build future.
+ * @param[in] dev Device wrapper, or `NULL` to wait for all devices.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if the program was successfully built for the
+ * given device (or for all devices), or `CL_FALSE` otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_program_build_future_wait(
+	CCLProgramBuildFuture* fut, CCLDevice* dev, CCLErr** err) {
+
+	/* Make sure fut is not NULL. */
+	g_return_val_if_fail(fut != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Index of device. */
+	cl_uint idx = G_MAXUINT;
+	/* First device whose build failed. */
+	cl_uint failed = G_MAXUINT;
+	/* Result of function call. */
+	cl_bool result;
+
+	/* Find device in build future. */
+	if (dev != NULL) {
+		idx = ccl_program_build_future_index(fut, dev);
+		g_if_err_create_goto(*err, CCL_ERROR, idx == G_MAXUINT,
+			CCL_ERROR_DEVICE_NOT_FOUND, error_handler,
+			"%s: device is not part of the build.", CCL_STRD);
+	}
+
+	/* Wait until the builds have started for all devices and until the
+	 * build is finished for the given device or for all devices. */
+	g_mutex_lock(&fut->mutex);
+	while ((fut->num_started < fut->num_devs)
+		|| ((idx == G_MAXUINT) && (fut->num_done < fut->num_devs))
+		|| ((idx != G_MAXUINT) && !fut->done[idx])) {
+
+		g_cond_wait(&fut->cond, &fut->mutex);
+	}
+	g_mutex_unlock(&fut->mutex);
+
+	/* Check if build failed. */
+	if (idx != G_MAXUINT) {
+		if (fut->status[idx] != CL_SUCCESS) failed = idx;
+	} else {
+		for (cl_uint i = 0; i < fut->num_devs; ++i) {
+			if (fut->status[i] != CL_SUCCESS) {
+				failed = i;
+				break;
+			}
+		}
+	}
+	g_if_err_create_goto(*err, CCL_OCL_ERROR, failed != G_MAXUINT,
+		fut->status[failed], error_handler,
+		"%s: unable to build program for device %u (OpenCL error %d: %s).",
+		CCL_STRD, failed, fut->status[failed],
+		ccl_err(fut->status[failed]));
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	result = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Bad result. */
+	result = CL_FALSE;
+
+finish:
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return result of function call. */
+	return result;
+
+}
+
+/**
+ * Wait for an asynchronous build to finish for all devices and release
+ * the build future. Kernels created for already built devices remain
+ * valid.
+ *
+ * @public @memberof ccl_program_build_future
+ *
+ * @param[in] fut The build future to destroy.
+ * */
+CCL_EXPORT
+void ccl_program_build_future_destroy(CCLProgramBuildFuture* fut) {
+
+	/* Make sure fut is not NULL. */
+	g_return_if_fail(fut != NULL);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Wait for worker threads to finish. */
+	if (fut->pool != NULL)
+		g_thread_pool_free(fut->pool, FALSE, TRUE);
+
+	/* Release build state. */
+	g_mutex_clear(&fut->mutex);
+	g_cond_clear(&fut->cond);
+	g_free(fut->done);
+	g_free(fut->status);
+	g_free(fut->options);
+	g_free(fut->devs);
+	ccl_program_unref(fut->prg);
+	g_slice_free(CCLProgramBuildFuture, fut);
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+}
+
+/**
+ * Get a general build log of most recent build, compile or link, for all
+ * devices.
+ *
+ * Individual build logs for each device associated with the program are
+ * returned in a concatenated fashion, with a header (identifying the device)
+ * and footer separating them.
+ *
+ * @param[in] prg Program wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The build log for most recent build, compile or link. May be `NULL`
+ * or an empty string if no build, compile or link was performed, or if no build
+ * log is available.
  * */
 CCL_EXPORT
 const char* ccl_program_get_build_log(CCLProgram* prg, CCLErr** err) {
@@ -1575,62 +2434,29 @@ CCLEvent* ccl_program_enqueue_kernel(CCLProgram* prg,
 	const size_t* local_work_size, CCLEventWaitList* evt_wait_lst,
 	CCLErr** err, ...) {
 
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
+
 	/* Event wrapper. */
 	CCLEvent* evt;
+	/* Kernel wrapper. */
+	CCLKernel* krnl;
 	/* The va_list, which represents the variable argument list. */
 	va_list args_va;
-	/* Array of arguments, to be created from the va_list. */
-	void** args_array = NULL;
-	/* Number of arguments. */
-	guint num_args = 0;
-	/* Aux. arg. when cycling through the va_list. */
-	void* aux_arg;
-
-	/* Initialize the va_list. */
-	va_start(args_va, err);
 
-	/* Get first argument. */
-	aux_arg = va_arg(args_va, void*);
-
-	/* Check if any arguments are given, and if so, populate array
-	 * of arguments. */
-	if (aux_arg != NULL) {
-
-		/* 1. Determine number of arguments. */
-
-		while (aux_arg != NULL) {
-			num_args++;
-			aux_arg = va_arg(args_va, void*);
-		}
-		va_end(args_va);
-
-		/* 2. Populate array of arguments. */
-
-		args_array = g_slice_alloc((num_args + 1) * sizeof(void*));
-		va_start(args_va, err);
-
-		for (guint i = 0; i < num_args; ++i) {
-			aux_arg = va_arg(args_va, void*);
-			args_array[i] = aux_arg;
-		}
-		va_end(args_va);
-		args_array[num_args] = NULL;
+	/* Get kernel wrapper. */
+	krnl = ccl_program_get_kernel(prg, kernel_name, err);
+	if (krnl == NULL) return NULL;
 
-	}
+	/* Set kernel arguments directly from the va_list. */
+	va_start(args_va, err);
+	ccl_kernel_set_args_va(krnl, args_va);
+	va_end(args_va);
 
-	/* Enqueue kernel using the array of arguments version of this
-	 * function. */
-	evt = ccl_program_enqueue_kernel_v(prg, kernel_name, cq, work_dim,
+	/* Enqueue kernel. */
+	evt = ccl_kernel_enqueue_ndrange(krnl, cq, work_dim,
 		global_work_offset, global_work_size, local_work_size,
-		evt_wait_lst, args_array, err);
-
-	/* If any arguments are given... */
-	if (num_args > 0) {
-
-		/* Free the array of arguments. */
-		g_slice_free1((num_args + 1) * sizeof(void*), args_array);
-
-	}
+		evt_wait_lst, err);
 
 	/* Return the event. */
 	return evt;
@@ -1701,6 +2527,484 @@ CCLEvent* ccl_program_enqueue_kernel_v(CCLProgram* prg,
 	return evt;
 }
 
+/**
+ * Create kernels for all program kernel functions in one pass, with the
+ * clCreateKernelsInProgram() OpenCL function, and precompute their
+ * work-group information for each program device. The kernels are kept
+ * in a kernel table, and are the same instances returned by
+ * ccl_program_get_kernel(). Kernels in the table can be accessed by
+ * index, avoiding lookups by name.
+ *
+ * This function should be called after the program is successfully
+ * built. It does nothing if the kernel table was already created.
+ *
+ * @public @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_program_create_kernels(CCLProgram* prg, CCLErr** err) {
+
+	/* Make sure prg is not NULL. */
+	g_return_val_if_fail(prg != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Nothing to do if kernel table was already created. */
+	if (prg->krnl_names != NULL) return CL_TRUE;
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Status of OpenCL function calls. */
+	cl_int ocl_status;
+	/* OpenCL kernel objects. */
+	cl_kernel* kernels = NULL;
+	/* Number of kernels in program. */
+	cl_uint num_krnls = 0;
+	/* Program devices. */
+	CCLDevice* const* devs;
+	cl_uint num_devs;
+	/* OpenCL version of the underlying platform. */
+	cl_uint ocl_ver;
+	/* Result of function call. */
+	cl_bool result;
+
+	/* Get program devices and OpenCL version. */
+	devs = ccl_program_get_all_devices(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	num_devs = ccl_program_get_num_devices(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ocl_ver = ccl_program_get_opencl_version(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Get number of kernels in program. */
+	ccl_program_kernels_lock(prg);
+	ocl_status = clCreateKernelsInProgram(
+		ccl_program_unwrap(prg), 0, NULL, &num_krnls);
+	ccl_program_kernels_unlock(prg);
+	g_if_err_create_goto(*err, CCL_OCL_ERROR,
+		CL_SUCCESS != ocl_status, ocl_status, error_handler,
+		"%s: unable to get number of kernels (OpenCL error %d: %s).",
+		CCL_STRD, ocl_status, ccl_err(ocl_status));
+
+	/* Create all kernels in one pass. */
+	if (num_krnls > 0) {
+		kernels = g_new0(cl_kernel, num_krnls);
+		ccl_program_kernels_lock(prg);
+		ocl_status = clCreateKernelsInProgram(
+			ccl_program_unwrap(prg), num_krnls, kernels, NULL);
+		ccl_program_kernels_unlock(prg);
+		g_if_err_create_goto(*err, CCL_OCL_ERROR,
+			CL_SUCCESS != ocl_status, ocl_status, error_handler,
+			"%s: unable to create kernels (OpenCL error %d: %s).",
+			CCL_STRD, ocl_status, ccl_err(ocl_status));
+	}
+
+	/* Initialize kernel table, taking ownership of kernels. */
+	prg->num_krnls = num_krnls;
+	prg->krnl_table = g_new0(CCLKernel*, num_krnls);
+	prg->krnl_names = g_new0(gchar*, num_krnls + 1);
+	prg->krnl_meta = g_new0(CCLKernelMeta, num_krnls * num_devs);
+	for (cl_uint k = 0; k < num_krnls; ++k)
+		prg->krnl_table[k] = ccl_kernel_new_wrap(kernels[k]);
+
+	/* If kernels hash table is not yet initialized, then
+	 * initialize it. */
+	if (prg->krnls == NULL) {
+		prg->krnls = g_hash_table_new_full(g_str_hash, g_str_equal,
+			NULL, (GDestroyNotify) ccl_kernel_destroy);
+	}
+
+	for (cl_uint k = 0; k < num_krnls; ++k) {
+
+		/* Kernel wrapper. */
+		CCLKernel* krnl = prg->krnl_table[k];
+		/* Existing kernel wrapper with the same name. */
+		CCLKernel* krnl_existing;
+		/* Kernel name, owned by the kernel wrapper. */
+		char* name;
+
+		/* Get kernel name. */
+		name = ccl_kernel_get_info_array(
+			krnl, CL_KERNEL_FUNCTION_NAME, char*, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		prg->krnl_names[k] = g_strdup(name);
+
+		/* Keep the same kernel instance as ccl_program_get_kernel(). */
+		krnl_existing = g_hash_table_lookup(prg->krnls, name);
+		if (krnl_existing != NULL) {
+			ccl_kernel_destroy(krnl);
+			krnl = krnl_existing;
+			ccl_kernel_ref(krnl);
+			prg->krnl_table[k] = krnl;
+		} else {
+			ccl_kernel_ref(krnl);
+			g_hash_table_insert(prg->krnls, name, krnl);
+		}
+
+		/* Precompute work-group information for each device for which
+		 * the program was built. */
+		for (cl_uint d = 0; d < num_devs; ++d) {
+
+			/* Work-group information for current kernel and device. */
+			CCLKernelMeta* meta = &prg->krnl_meta[k * num_devs + d];
+			/* OpenCL kernel and device. */
+			cl_kernel cl_krnl = ccl_kernel_unwrap(krnl);
+			cl_device_id cl_dev = ccl_device_unwrap(devs[d]);
+			/* Build status for current device. */
+			cl_build_status build_status;
+
+			build_status = ccl_program_get_build_info_scalar(prg,
+				devs[d], CL_PROGRAM_BUILD_STATUS, cl_build_status,
+				&err_internal);
+			g_if_err_propagate_goto(err, err_internal, error_handler);
+			if (build_status != CL_BUILD_SUCCESS) continue;
+
+			ocl_status = clGetKernelWorkGroupInfo(cl_krnl, cl_dev,
+				CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t),
+				&meta->wg_size, NULL);
+			if (ocl_status == CL_SUCCESS)
+				ocl_status = clGetKernelWorkGroupInfo(cl_krnl, cl_dev,
+					CL_KERNEL_LOCAL_MEM_SIZE, sizeof(cl_ulong),
+					&meta->local_mem_size, NULL);
+			meta->wg_size_mult = meta->wg_size;
+#ifdef CL_VERSION_1_1
+			if ((ocl_status == CL_SUCCESS) && (ocl_ver >= 110)) {
+				ocl_status = clGetKernelWorkGroupInfo(cl_krnl, cl_dev,
+					CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+					sizeof(size_t), &meta->wg_size_mult, NULL);
+				if (ocl_status == CL_SUCCESS)
+					ocl_status = clGetKernelWorkGroupInfo(cl_krnl, cl_dev,
+						CL_KERNEL_PRIVATE_MEM_SIZE, sizeof(cl_ulong),
+						&meta->private_mem_size, NULL);
+			}
+#endif
+			g_if_err_create_goto(*err, CCL_OCL_ERROR,
+				CL_SUCCESS != ocl_status, ocl_status, error_handler,
+				"%s: unable to get work-group information of kernel '%s' "
+				"(OpenCL error %d: %s).",
+				CCL_STRD, prg->krnl_names[k], ocl_status,
+				ccl_err(ocl_status));
+			meta->available = CL_TRUE;
+
+		}
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	result = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Release kernels not yet in the kernel table. */
+	if ((kernels != NULL) && (prg->krnl_table == NULL)) {
+		for (cl_uint k = 0; k < num_krnls; ++k) {
+			if (kernels[k] != NULL) clReleaseKernel(kernels[k]);
+		}
+	}
+
+	/* Destroy partially created kernel table. */
+	ccl_program_clear_kernel_table(prg);
+
+	/* Bad result. */
+	result = CL_FALSE;
+
+finish:
+
+	/* Release array of OpenCL kernel objects. */
+	g_free(kernels);
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return result of function call. */
+	return result;
+
+}
+
+/**
+ * Get the index of a kernel function in the program kernel table. The
+ * index can be used as a handle for the kernel, avoiding lookups by
+ * name. The kernel table is created with ccl_program_create_kernels()
+ * if necessary.
+ *
+ * @public @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[in] kernel_name Name of kernel function.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The index of the kernel function in the kernel table, or
+ * `CL_UINT_MAX` if an error occurs.
+ * */
+CCL_EXPORT
+cl_uint ccl_program_get_kernel_index(
+	CCLProgram* prg, const char* kernel_name, CCLErr** err) {
+
+	/* Make sure prg is not NULL. */
+	g_return_val_if_fail(prg != NULL, CL_UINT_MAX);
+	/* Make sure kernel_name is not NULL. */
+	g_return_val_if_fail(kernel_name != NULL, CL_UINT_MAX);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_UINT_MAX);
+
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Kernel index. */
+	cl_uint index = CL_UINT_MAX;
+
+	/* Create kernel table if necessary. */
+	ccl_program_create_kernels(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Find kernel by name. */
+	for (cl_uint k = 0; k < prg->num_krnls; ++k) {
+		if (g_strcmp0(prg->krnl_names[k], kernel_name) == 0) {
+			index = k;
+			break;
+		}
+	}
+	g_if_err_create_goto(*err, CCL_ERROR, index == CL_UINT_MAX,
+		CCL_ERROR_ARGS, error_handler,
+		"%s: program has no kernel named '%s'.", CCL_STRD, kernel_name);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Return kernel index. */
+	return index;
+
+}
+
+/**
+ * Get the kernel wrapper object at the given index of the program
+ * kernel table. The kernel table is created with
+ * ccl_program_create_kernels() if necessary. As with
+ * ccl_program_get_kernel(), the returned kernel wrapper object is
+ * released when the program wrapper object is destroyed.
+ *
+ * @public @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[in] index Index of kernel in kernel table.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The kernel wrapper object at the given index, or `NULL` if an
+ * error occurs.
+ * */
+CCL_EXPORT
+CCLKernel* ccl_program_get_kernel_by_index(
+	CCLProgram* prg, cl_uint index, CCLErr** err) {
+
+	/* Make sure prg is not NULL. */
+	g_return_val_if_fail(prg != NULL, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Kernel wrapper object. */
+	CCLKernel* krnl = NULL;
+
+	/* Create kernel table if necessary. */
+	ccl_program_create_kernels(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Check index. */
+	g_if_err_create_goto(*err, CCL_ERROR, index >= prg->num_krnls,
+		CCL_ERROR_ARGS, error_handler,
+		"%s: invalid kernel index %u.", CCL_STRD, index);
+
+	/* Get kernel. */
+	krnl = prg->krnl_table[index];
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Return kernel wrapper. */
+	return krnl;
+
+}
+
+/**
+ * Get the precomputed work-group information of a kernel in the program
+ * kernel table for the given device. The kernel table is created with
+ * ccl_program_create_kernels() if necessary.
+ *
+ * @public @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[in] index Index of kernel in kernel table.
+ * @param[in] dev Device wrapper object associated with the program.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return The work-group information of the kernel for the given
+ * device, which belongs to the program and must not be freed, or `NULL`
+ * if an error occurs.
+ * */
+CCL_EXPORT
+const CCLKernelMeta* ccl_program_get_kernel_meta(
+	CCLProgram* prg, cl_uint index, CCLDevice* dev, CCLErr** err) {
+
+	/* Make sure prg is not NULL. */
+	g_return_val_if_fail(prg != NULL, NULL);
+	/* Make sure dev is not NULL. */
+	g_return_val_if_fail(dev != NULL, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+	/* Program devices. */
+	CCLDevice* const* devs;
+	cl_uint num_devs;
+	/* Index of device. */
+	cl_uint d;
+	/* Work-group information. */
+	const CCLKernelMeta* meta = NULL;
+
+	/* Create kernel table if necessary. */
+	ccl_program_create_kernels(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Check index. */
+	g_if_err_create_goto(*err, CCL_ERROR, index >= prg->num_krnls,
+		CCL_ERROR_ARGS, error_handler,
+		"%s: invalid kernel index %u.", CCL_STRD, index);
+
+	/* Find device. */
+	devs = ccl_program_get_all_devices(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	num_devs = ccl_program_get_num_devices(prg, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	for (d = 0; d < num_devs; ++d) {
+		if (ccl_device_unwrap(devs[d]) == ccl_device_unwrap(dev)) break;
+	}
+	g_if_err_create_goto(*err, CCL_ERROR, d == num_devs,
+		CCL_ERROR_DEVICE_NOT_FOUND, error_handler,
+		"%s: device is not associated with program.", CCL_STRD);
+
+	/* Get work-group information. */
+	meta = &prg->krnl_meta[index * num_devs + d];
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Return work-group information. */
+	return meta;
+
+}
+
+/**
+ * Enqueues a program kernel function, given by its index in the program
+ * kernel table, for execution on a device. This function is equivalent
+ * to ccl_program_enqueue_kernel(), but avoids the lookup of the kernel
+ * by name.
+ *
+ * @attention The variable argument list must end with `NULL`.
+ *
+ * @warning For multi-threaded execution of the same kernel
+ * function, create different kernel wrapper instances with the
+ * ccl_kernel_new() function and use the @ref CCL_KERNEL_WRAPPER
+ * "kernel module" API to enqueue kernel executions.
+ *
+ * @public @memberof ccl_program
+ *
+ * @param[in] prg The program wrapper object.
+ * @param[in] index Index of kernel in kernel table, as returned by
+ * ccl_program_get_kernel_index().
+ * @param[in] cq Command queue wrapper object where to enqueue kernel
+ * execution.
+ * @param[in] work_dim The number of dimensions used to specify the
+ * global work-items and work-items in the work-group.
+ * @param[in] global_work_offset Can be used to specify an array of
+ * `work_dim` unsigned values that describe the offset used to calculate
+ * the global ID of a work-item.
+ * @param[in] global_work_size An array of `work_dim` unsigned values
+ * that describe the number of global work-items in `work_dim`
+ * dimensions that will execute the kernel function.
+ * @param[in] local_work_size An array of `work_dim` unsigned values
+ * that describe the number of work-items that make up a work-group that
+ * will execute the specified kernel.
+ * @param[in,out] evt_wait_lst List of events that need to complete
+ * before this command can be executed. The list will be cleared and
+ * can be reused by client code.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @param[in] ... A `NULL`-terminated list of arguments to set.
+ * @return Event wrapper object that identifies this command.
+ * */
+CCL_EXPORT
+CCLEvent* ccl_program_enqueue_kernel_by_index(CCLProgram* prg,
+	cl_uint index, CCLQueue* cq, cl_uint work_dim,
+	const size_t* global_work_offset, const size_t* global_work_size,
+	const size_t* local_work_size, CCLEventWaitList* evt_wait_lst,
+	CCLErr** err, ...) {
+
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail((err) == NULL || *(err) == NULL, NULL);
+
+	/* Event wrapper. */
+	CCLEvent* evt;
+	/* Kernel wrapper. */
+	CCLKernel* krnl;
+	/* The va_list, which represents the variable argument list. */
+	va_list args_va;
+
+	/* Get kernel wrapper. */
+	krnl = ccl_program_get_kernel_by_index(prg, index, err);
+	if (krnl == NULL) return NULL;
+
+	/* Set kernel arguments directly from the va_list. */
+	va_start(args_va, err);
+	ccl_kernel_set_args_va(krnl, args_va);
+	va_end(args_va);
+
+	/* Enqueue kernel. */
+	evt = ccl_kernel_enqueue_ndrange(krnl, cq, work_dim,
+		global_work_offset, global_work_size, local_work_size,
+		evt_wait_lst, err);
+
+	/* Return the event. */
+	return evt;
+
+}
+
 /**
  * @internal
  * Load the program binaries into the binaries table of the program
@@ -78,6 +78,15 @@
  * object from a list of binary code strings executable on the given
  * device list, one binary string per device.
  *
+ * Building programs from source can take a long time with some OpenCL
+ * implementations. The ::ccl_program_new_from_sources_cached()
+ * constructor creates and builds a program from source code, keeping
+ * the resulting binaries in a persistent on-disk cache, keyed by the
+ * sources, build options, device and driver, such that later calls
+ * (e.g. in later runs of the application) create the program from the
+ * cached binaries instead. Headers included by the sources are not
+ * part of the cache key (see the function documentation for details).
+ *
  * The ::ccl_program_new_from_built_in_kernels() constructor directly
  * wraps the native OpenCL clCreateProgramWithBuiltInKernels()
  * function, allowing to create programs from built-in kernels. This
@@ -94,6 +103,18 @@
  * OpenCL function, the former provides a simpler interface which will
  * be useful in many situations.
  *
+ * When a program is associated with several devices, the
+ * ::ccl_program_build_async() function builds the program executable
+ * for each device in parallel, in a separate thread, and returns
+ * immediately with a ::CCLProgramBuildFuture object. The
+ * ::ccl_program_build_future_wait() function waits until the build is
+ * finished for a specific device, such that its build status and log
+ * can be checked while the program is still being built for the
+ * remaining ones. Since OpenCL forbids building a program with attached
+ * kernels, kernel creation waits for builds in progress to finish. The
+ * ::ccl_program_build_future_destroy() function waits for all builds to
+ * finish and releases the future.
+ *
  * Compilation and linking (which require OpenCL >= 1.2) are provided
  * by the ::ccl_program_compile() and ::ccl_program_link()
  * functions.
@@ -144,6 +165,26 @@
  * @ref CCL_KERNEL_WRAPPER "kernel wrapper module" API for handling kernel
  * wrapper objects.
  *
+ * Programs which enqueue kernels repeatedly can avoid the lookup of
+ * kernels by name with a kernel table. The
+ * ::ccl_program_create_kernels() function creates the kernels for all
+ * program kernel functions in one pass, and precomputes their
+ * work-group information for each device in a ::CCLKernelMeta record.
+ * The table is also created on first use by the following functions:
+ *
+ * * ::ccl_program_get_kernel_index() - Get the index of a kernel
+ * function in the kernel table, which serves as a handle for it.
+ * * ::ccl_program_get_kernel_by_index() - Get the kernel wrapper object
+ * for a kernel table index.
+ * * ::ccl_program_get_kernel_meta() - Get the work-group information
+ * of a kernel for a device.
+ * * ::ccl_program_enqueue_kernel_by_index() - Enqueues a program
+ * kernel function, given by its kernel table index, for execution on a
+ * device.
+ *
+ * Kernels in the table are the same instances returned by
+ * ::ccl_program_get_kernel().
+ *
  * The ::CCLProgram* class extends the ::CCLDevContainer* class; as
  * such, it provides methods for handling a list of devices associated
  * with the program:
@@ -194,6 +235,48 @@
  * and a device. */
 typedef struct ccl_program_binary CCLProgramBinary;
 
+/** Class which represents an ongoing asynchronous build of a program
+ * for one or more devices. */
+typedef struct ccl_program_build_future CCLProgramBuildFuture;
+
+/**
+ * Work-group information of a program kernel for a device, precomputed
+ * by ccl_program_create_kernels().
+ * */
+typedef struct ccl_kernel_meta {
+
+	/**
+	 * Maximum work-group size (`CL_KERNEL_WORK_GROUP_SIZE`).
+	 * */
+	size_t wg_size;
+
+	/**
+	 * Preferred work-group size multiple
+	 * (`CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE`), or the maximum
+	 * work-group size for OpenCL 1.0 platforms.
+	 * */
+	size_t wg_size_mult;
+
+	/**
+	 * Local memory used by the kernel (`CL_KERNEL_LOCAL_MEM_SIZE`).
+	 * */
+	cl_ulong local_mem_size;
+
+	/**
+	 * Minimum private memory used by each work-item
+	 * (`CL_KERNEL_PRIVATE_MEM_SIZE`), or 0 for OpenCL 1.0 platforms.
+	 * */
+	cl_ulong private_mem_size;
+
+	/**
+	 * `CL_TRUE` if the program was successfully built for the device,
+	 * in which case the remaining fields are set, or `CL_FALSE`
+	 * otherwise.
+	 * */
+	cl_bool available;
+
+} CCLKernelMeta;
+
 /**
  * Prototype of callback functions for program build, compile and
  * link.
@@ -246,6 +329,14 @@ CCLProgram* ccl_program_new_from_sources(CCLContext* ctx,
 	cl_uint count, const char** strings, const size_t* lengths,
 	CCLErr** err);
 
+/* Create and build a new program wrapper object from several source
+ * code strings, using a persistent cache of program binaries. */
+CCL_EXPORT
+CCLProgram* ccl_program_new_from_sources_cached(CCLContext* ctx,
+	cl_uint count, const char** strings, const size_t* lengths,
+	const char* options, const char* cache_dir, cl_bool* from_cache,
+	CCLErr** err);
+
 /* ************************ */
 /* CREATE FROM BINARIES API */
 /* ************************ */
@@ -306,6 +397,30 @@ cl_bool ccl_program_build_full(CCLProgram* prg,
 	cl_uint num_devices, CCLDevice* const* devs, const char* options,
 	ccl_program_callback pfn_notify, void* user_data, CCLErr** err);
 
+/* Start building a program executable for each device in parallel,
+ * returning immediately. */
+CCL_EXPORT
+CCLProgramBuildFuture* ccl_program_build_async(CCLProgram* prg,
+	cl_uint num_devices, CCLDevice* const* devs, const char* options,
+	CCLErr** err);
+
+/* Check if an asynchronous build has finished for the given device or
+ * for all devices. */
+CCL_EXPORT
+cl_bool ccl_program_build_future_is_ready(
+	CCLProgramBuildFuture* fut, CCLDevice* dev);
+
+/* Wait for an asynchronous build to finish for the given device or for
+ * all devices. */
+CCL_EXPORT
+cl_bool ccl_program_build_future_wait(
+	CCLProgramBuildFuture* fut, CCLDevice* dev, CCLErr** err);
+
+/* Wait for an asynchronous build to finish and release the build
+ * future. */
+CCL_EXPORT
+void ccl_program_build_future_destroy(CCLProgramBuildFuture* fut);
+
 /* Get a general build log of most recent build, compile or link, for
  * all devices. */
 CCL_EXPORT
@@ -366,6 +481,37 @@ CCLEvent* ccl_program_enqueue_kernel_v(CCLProgram* prg,
 	const size_t* local_work_size, CCLEventWaitList* evt_wait_lst,
 	void** args, CCLErr** err);
 
+/* Create kernels for all program kernel functions in one pass and
+ * precompute their work-group information. */
+CCL_EXPORT
+cl_bool ccl_program_create_kernels(CCLProgram* prg, CCLErr** err);
+
+/* Get the index of a kernel function in the program kernel table. */
+CCL_EXPORT
+cl_uint ccl_program_get_kernel_index(
+	CCLProgram* prg, const char* kernel_name, CCLErr** err);
+
+/* Get the kernel wrapper object at the given index of the program
+ * kernel table. */
+CCL_EXPORT
+CCLKernel* ccl_program_get_kernel_by_index(
+	CCLProgram* prg, cl_uint index, CCLErr** err);
+
+/* Get the precomputed work-group information of a kernel in the program
+ * kernel table for the given device. */
+CCL_EXPORT
+const CCLKernelMeta* ccl_program_get_kernel_meta(
+	CCLProgram* prg, cl_uint index, CCLDevice* dev, CCLErr** err);
+
+/* Enqueues a program kernel function, given by its index in the program
+ * kernel table, for execution on a device. */
+CCL_EXPORT
+CCLEvent* ccl_program_enqueue_kernel_by_index(CCLProgram* prg,
+	cl_uint index, CCLQueue* cq, cl_uint work_dim,
+	const size_t* global_work_offset, const size_t* global_work_size,
+	const size_t* local_work_size, CCLEventWaitList* evt_wait_lst,
+	CCLErr** err, ...) G_GNUC_NULL_TERMINATED;
+
 /* ************************* */
 /* BINARY HANDLING FUNCTIONS */
 /* ************************* */
@@ -450,7 +596,7 @@ CCLDevice* const* ccl_program_get_all_devices(CCLProgram* prg,
 #define ccl_program_get_info_scalar(prg, param_name, param_type, err) \
 	(param_name == CL_PROGRAM_BINARIES) \
 	? (param_type) 0 \
-	: *((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) prg, \
+	: *((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) prg, \
 		NULL, param_name, sizeof(param_type), \
 		CCL_INFO_PROGRAM, CL_FALSE, err))
 
@@ -516,7 +662,7 @@ CCLDevice* const* ccl_program_get_all_devices(CCLProgram* prg,
  * */
 #define ccl_program_get_build_info_scalar(prg, dev, param_name, \
 	param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) prg, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) prg, \
 		(CCLWrapper*) dev, param_name, sizeof(param_type), \
 		CCL_INFO_PROGRAM_BUILD, CL_FALSE, err))
 
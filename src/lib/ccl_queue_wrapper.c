@@ -30,6 +30,10 @@
 #include "_ccl_abstract_wrapper.h"
 #include "_ccl_defs.h"
 
+/** Maximum number of profiling records of retired events kept by each
+ * command queue until consumed. */
+#define CCL_QUEUE_MAX_EVENT_RECORDS 65536
+
 /**
  * Command queue wrapper class.
  *
@@ -67,8 +71,313 @@ struct ccl_queue {
 	 * */
 	GHashTableIter evt_iter;
 
+	/**
+	 * If `CL_TRUE`, events produced by this queue are not wrapped.
+	 * @private
+	 * */
+	cl_bool untracked;
+
+	/**
+	 * Most recent OpenCL event produced by this queue while in
+	 * untracked mode.
+	 * @private
+	 * */
+	cl_event last_event;
+
+	/**
+	 * Ring buffer with the event wrappers subject to retirement, or
+	 * `NULL` if the number of events kept by the queue is unbounded.
+	 * @private
+	 * */
+	CCLEvent** evt_ring;
+
+	/**
+	 * Maximum number of events kept by the queue, as set with
+	 * ccl_queue_set_max_events().
+	 * @private
+	 * */
+	cl_uint evt_ring_max;
+
+	/**
+	 * Capacity of the event ring buffer, which grows beyond the maximum
+	 * number of events when the oldest events are not yet complete.
+	 * @private
+	 * */
+	cl_uint evt_ring_cap;
+
+	/**
+	 * Position of the oldest event in the event ring buffer.
+	 * @private
+	 * */
+	cl_uint evt_ring_head;
+
+	/**
+	 * Number of events in the event ring buffer.
+	 * @private
+	 * */
+	cl_uint evt_ring_len;
+
+	/**
+	 * If `CL_TRUE`, the timing information of retired events is kept in
+	 * the `evt_records` array.
+	 * @private
+	 * */
+	cl_bool evt_fold;
+
+	/**
+	 * Profiling records of retired events.
+	 * @private
+	 * */
+	GArray* evt_records;
+
+	/**
+	 * Number of retired events whose profiling records were dropped
+	 * because ::CCL_QUEUE_MAX_EVENT_RECORDS records were already kept.
+	 * @private
+	 * */
+	guint evt_records_dropped;
+
 };
 
+/**
+ * @internal
+ * Initialize the table of events of the given command queue, if not
+ * yet initialized.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * */
+static void ccl_queue_init_evts(CCLQueue* cq) {
+
+	if (cq->evts == NULL) {
+		cq->evts = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+			(GDestroyNotify) ccl_event_destroy, NULL);
+	}
+}
+
+/**
+ * @internal
+ * Release the most recent OpenCL event kept by the command queue in
+ * untracked mode, if any.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * */
+static void ccl_queue_release_last_event(CCLQueue* cq) {
+
+	if (cq->last_event != NULL) {
+		clReleaseEvent(cq->last_event);
+		cq->last_event = NULL;
+	}
+}
+
+/**
+ * @internal
+ * Fold the timing information of the given event into a new profiling
+ * record of the command queue. The event is expected to be complete. If
+ * the queue already keeps ::CCL_QUEUE_MAX_EVENT_RECORDS records, the
+ * new record is dropped.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] evt The event wrapper object.
+ * @return `CL_TRUE` if the record was added, `CL_FALSE` if the event
+ * does not provide timing information.
+ * */
+static cl_bool ccl_queue_fold_event(CCLQueue* cq, CCLEvent* evt) {
+
+	/* The new record. */
+	CCLEventRecord rec;
+
+	/* The information is not cached in the event wrapper, which is
+	 * about to be destroyed. */
+	if (!ccl_event_get_timestamps(evt, &rec, NULL)) return CL_FALSE;
+
+	/* Keep record, if there is room for it. */
+	if (cq->evt_records == NULL) {
+		cq->evt_records = g_array_new(FALSE, FALSE, sizeof(CCLEventRecord));
+	}
+	if (cq->evt_records->len < CCL_QUEUE_MAX_EVENT_RECORDS)
+		g_array_append_val(cq->evt_records, rec);
+	else
+		cq->evt_records_dropped++;
+
+	return CL_TRUE;
+}
+
+/**
+ * @internal
+ * Check if the given event can be retired, i.e. if its command is no
+ * longer queued, submitted or running. If so, and if the queue has
+ * profiling enabled, the event timing information is folded into a new
+ * profiling record. This function never blocks.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] evt The event wrapper object.
+ * @return `CL_TRUE` if the event can be retired, `CL_FALSE` otherwise.
+ * */
+static cl_bool ccl_queue_settle_event(CCLQueue* cq, CCLEvent* evt) {
+
+	/* The OpenCL event object. */
+	cl_event event = ccl_event_unwrap(evt);
+	/* Event execution status. */
+	cl_int exec_status;
+	/* OpenCL status. */
+	cl_int ocl_status;
+
+	/* Check execution status directly, bypassing the info cache. */
+	ocl_status = clGetEventInfo(event, CL_EVENT_COMMAND_EXECUTION_STATUS,
+		sizeof(cl_int), &exec_status, NULL);
+
+	/* If the command is still queued, submitted or running, the event
+	 * can't be retired yet. */
+	if ((ocl_status == CL_SUCCESS) && (exec_status > CL_COMPLETE))
+		return CL_FALSE;
+
+	/* Fold the event timing information if profiling is enabled and
+	 * the command completed successfully. */
+	if ((cq->evt_fold) && (ocl_status == CL_SUCCESS)
+		&& (exec_status == CL_COMPLETE)) {
+
+		if (!ccl_queue_fold_event(cq, evt)) {
+			g_info("The '%s' event does not have profiling info",
+				ccl_event_get_final_name(evt));
+		}
+	}
+
+	/* Event can be retired. */
+	return CL_TRUE;
+}
+
+/**
+ * @internal
+ * Retire the oldest events in the event ring buffer of the command
+ * queue, oldest first, until the ring buffer holds at most `max_len`
+ * events. Retirement stops at the first event which is not yet
+ * complete, i.e. this function never blocks, and the ring buffer may
+ * keep more than `max_len` events.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] max_len Number of events to keep in the ring buffer.
+ * */
+static void ccl_queue_retire_oldest(CCLQueue* cq, cl_uint max_len) {
+
+	/* Oldest event in the ring buffer. */
+	CCLEvent* evt;
+
+	while (cq->evt_ring_len > max_len) {
+
+		/* Fold the timing information of the oldest event, if it is
+		 * complete. */
+		evt = cq->evt_ring[cq->evt_ring_head];
+		if (!ccl_queue_settle_event(cq, evt)) break;
+
+		/* Remove event from ring buffer. */
+		cq->evt_ring[cq->evt_ring_head] = NULL;
+		cq->evt_ring_head = (cq->evt_ring_head + 1) % cq->evt_ring_cap;
+		cq->evt_ring_len--;
+
+		/* Release the event wrapper. */
+		g_hash_table_remove(cq->evts, evt);
+	}
+}
+
+/**
+ * @internal
+ * Move the events in the event ring buffer of the command queue to a
+ * new ring buffer with the given capacity, oldest first.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] cap Capacity of the new ring buffer, which must be able to
+ * hold the events currently in the ring buffer.
+ * */
+static void ccl_queue_resize_ring(CCLQueue* cq, cl_uint cap) {
+
+	/* New ring buffer. */
+	CCLEvent** evt_ring = g_new0(CCLEvent*, cap);
+
+	g_assert(cap >= cq->evt_ring_len);
+
+	for (cl_uint i = 0; i < cq->evt_ring_len; ++i) {
+		evt_ring[i] = cq->evt_ring[
+			(cq->evt_ring_head + i) % cq->evt_ring_cap];
+	}
+	g_free(cq->evt_ring);
+	cq->evt_ring = evt_ring;
+	cq->evt_ring_cap = cap;
+	cq->evt_ring_head = 0;
+}
+
+/**
+ * @internal
+ * Determine if the timing information of events retired by the command
+ * queue should be kept, i.e. if the queue has profiling enabled.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * */
+static void ccl_queue_init_fold(CCLQueue* cq, CCLErr** err) {
+
+	/* Queue properties. */
+	cl_command_queue_properties qprop;
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+
+	/* Check if queue has profiling enabled. */
+	qprop = ccl_queue_get_info_scalar(cq, CL_QUEUE_PROPERTIES,
+		cl_command_queue_properties, &err_internal);
+	if (err_internal != NULL) {
+		g_propagate_error(err, err_internal);
+	} else {
+		cq->evt_fold =
+			(qprop & CL_QUEUE_PROFILING_ENABLE) ? CL_TRUE : CL_FALSE;
+	}
+}
+
+/**
+ * @internal
+ * Associate the given event wrapper with the command queue. If the
+ * number of events kept by the queue is bounded and the event ring
+ * buffer is full, the oldest complete events are retired. If the oldest
+ * event is not yet complete, the ring buffer grows instead.
+ *
+ * @private @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] evt The event wrapper object.
+ * */
+static void ccl_queue_track_event(CCLQueue* cq, CCLEvent* evt) {
+
+	/* Initialize the list of events of this command queue. */
+	ccl_queue_init_evts(cq);
+
+	/* Add the wrapped event to the list of events of this command
+	 * queue. */
+	g_hash_table_add(cq->evts, (gpointer) evt);
+
+	/* Place the event in the ring buffer, if any. */
+	if (cq->evt_ring != NULL) {
+		ccl_queue_retire_oldest(cq, cq->evt_ring_max - 1);
+		if (cq->evt_ring_len == cq->evt_ring_cap)
+			ccl_queue_resize_ring(cq, 2 * cq->evt_ring_cap);
+		cq->evt_ring[(cq->evt_ring_head + cq->evt_ring_len)
+			% cq->evt_ring_cap] = evt;
+		cq->evt_ring_len++;
+	}
+}
+
 /**
  * @internal
  * Implementation of ccl_wrapper_release_fields() function for
@@ -94,6 +403,15 @@ static void ccl_queue_release_fields(CCLQueue* cq) {
 	if (cq->evts != NULL) {
 		g_hash_table_destroy(cq->evts);
 	}
+
+	/* Release most recent untracked event. */
+	ccl_queue_release_last_event(cq);
+
+	/* Release the event ring buffer and the retired event records. */
+	g_free(cq->evt_ring);
+	if (cq->evt_records != NULL) {
+		g_array_free(cq->evt_records, TRUE);
+	}
 }
 
 /**
@@ -160,6 +478,9 @@ CCLQueue* ccl_queue_new_full(CCLContext* ctx, CCLDevice* dev,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* The OpenCL status flag. */
 	cl_int ocl_status;
 	/* The OpenCL command queue object. */
@@ -301,6 +622,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return the new command queue wrapper object. */
 	return cq;
 
@@ -473,12 +797,18 @@ finish:
  * This function is used by the `ccl_*_enqueue_*()` functions and will
  * rarely be called from client code.
  *
+ * If the command queue is in untracked mode (see
+ * ccl_queue_set_untracked()), the OpenCL event is not wrapped. Instead,
+ * it is kept by the queue as the most recent event (releasing the
+ * previous one), and `NULL` is returned.
+ *
  * @public @memberof ccl_queue
  *
  * @param[in] cq The command queue wrapper object.
  * @param[in] event The OpenCL event to wrap and associate with the
  * given command queue.
- * @return The event wrapper object for the given OpenCL event object.
+ * @return The event wrapper object for the given OpenCL event object,
+ * or `NULL` if the queue is in untracked mode.
  * */
 CCL_EXPORT
 CCLEvent* ccl_queue_produce_event(CCLQueue* cq, cl_event event) {
@@ -488,24 +818,432 @@ CCLEvent* ccl_queue_produce_event(CCLQueue* cq, cl_event event) {
 	/* Make sure event is not NULL. */
 	g_return_val_if_fail(event != NULL, NULL);
 
-	/* Wrap the OpenCL event. */
-	CCLEvent* evt = ccl_event_new_wrap(event);
+	/* Event wrapper. */
+	CCLEvent* evt = NULL;
 
-	/* Initialize the list of events of this command queue. */
-	if (cq->evts == NULL) {
-		cq->evts = g_hash_table_new_full(g_direct_hash, g_direct_equal,
-			(GDestroyNotify) ccl_event_destroy, NULL);
-	}
+	if (cq->untracked) {
 
-	/* Add the wrapped event to the list of events of this command
-	 * queue. */
-	g_hash_table_add(cq->evts, (gpointer) evt);
+		/* In untracked mode, just keep the OpenCL event, so that a
+		 * wrapper can be created on demand with
+		 * ccl_queue_get_last_event(). */
+		ccl_queue_release_last_event(cq);
+		cq->last_event = event;
+
+	} else {
+
+		/* Wrap the OpenCL event. */
+		evt = ccl_event_new_wrap(event);
+
+		/* Associate the wrapped event with this command queue. */
+		ccl_queue_track_event(cq, evt);
+
+	}
 
 	/* Return the wrapped event. */
 	return evt;
 
 }
 
+/**
+ * Enable or disable untracked mode in the given command queue.
+ *
+ * By default, every command enqueued with the `ccl_*_enqueue_*()`
+ * functions produces an event wrapper, which is kept by the queue
+ * until ccl_queue_gc() is called or the queue is destroyed. In
+ * untracked mode, the OpenCL events produced by enqueued commands are
+ * not wrapped, and the `ccl_*_enqueue_*()` functions return `NULL`
+ * instead of an event wrapper. This considerably reduces host overhead
+ * for pipelines which enqueue many small commands, most of which are
+ * never waited on or profiled. Only the OpenCL event produced by the
+ * most recent command is kept, and it can be wrapped on demand with
+ * ccl_queue_get_last_event().
+ *
+ * @attention In untracked mode, `NULL` returned by the
+ * `ccl_*_enqueue_*()` functions does not signal an error; the `err`
+ * parameter must be checked instead.
+ *
+ * @warning Commands enqueued in untracked mode can't be analyzed by
+ * the @ref CCL_PROFILER "profiler module".
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] untracked `CL_TRUE` to enable untracked mode, `CL_FALSE`
+ * to disable it.
+ * */
+CCL_EXPORT
+void ccl_queue_set_untracked(CCLQueue* cq, cl_bool untracked) {
+
+	/* Make sure cq is not NULL. */
+	g_return_if_fail(cq != NULL);
+
+	/* Release most recent untracked event when leaving untracked
+	 * mode. */
+	if (!untracked)
+		ccl_queue_release_last_event(cq);
+
+	/* Set mode. */
+	cq->untracked = untracked;
+}
+
+/**
+ * Check if the given command queue is in untracked mode.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @return `CL_TRUE` if the command queue is in untracked mode,
+ * `CL_FALSE` otherwise.
+ * @see ccl_queue_set_untracked()
+ * */
+CCL_EXPORT
+cl_bool ccl_queue_is_untracked(CCLQueue* cq) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, CL_FALSE);
+
+	/* Return mode. */
+	return cq->untracked;
+}
+
+/**
+ * Get an event wrapper for the most recent command enqueued in a
+ * command queue in untracked mode.
+ *
+ * The event wrapper is only created when this function is called, and
+ * is then associated with the command queue as any other event wrapper
+ * produced in tracked mode. Calling this function more than once for
+ * the same command returns the same event wrapper.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @return Event wrapper for the most recent command enqueued in
+ * untracked mode, or `NULL` if no such command exists (e.g. if
+ * ccl_queue_gc() was called in the meantime).
+ * @see ccl_queue_set_untracked()
+ * */
+CCL_EXPORT
+CCLEvent* ccl_queue_get_last_event(CCLQueue* cq) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, NULL);
+
+	/* Event wrapper. */
+	CCLEvent* evt = NULL;
+
+	/* Is there an untracked event? */
+	if (cq->last_event != NULL) {
+
+		/* Get event wrapper, creating it if necessary. */
+		evt = ccl_event_new_wrap(cq->last_event);
+
+		/* Initialize the list of events of this command queue. */
+		ccl_queue_init_evts(cq);
+
+		if (g_hash_table_contains(cq->evts, evt)) {
+
+			/* Event wrapper was already produced by a previous call,
+			 * undo the reference increment of the wrap constructor. */
+			ccl_event_destroy(evt);
+
+		} else {
+
+			/* New event wrapper, which will release the OpenCL event
+			 * when destroyed. As such, the queue must retain the OpenCL
+			 * event for itself. */
+			clRetainEvent(cq->last_event);
+			ccl_queue_track_event(cq, evt);
+
+		}
+	}
+
+	/* Return the event wrapper. */
+	return evt;
+}
+
+/**
+ * Set the maximum number of event wrappers kept by the command queue.
+ *
+ * By default, command queues keep all the event wrappers they produce
+ * until ccl_queue_gc() is called or the queue is destroyed. In
+ * long-running applications this leads to unbounded memory growth,
+ * both in the host and in the OpenCL implementation. When a maximum
+ * number of events is set, the queue keeps the event wrappers it
+ * produces in a ring buffer. Once the ring buffer is full, producing a
+ * new event retires the oldest events, as long as their commands are
+ * complete. Enqueue functions never block waiting for events to
+ * complete: if the oldest event is not yet complete (e.g. because its
+ * command waits on a user event), the ring buffer grows, and is
+ * brought back to `max_events` events once the oldest events complete.
+ * If the queue has profiling enabled, the timing
+ * information of retired events is first folded into compact
+ * ::CCLEventRecord objects, which are released by ccl_queue_gc() and
+ * are taken into account by the @ref CCL_PROFILER "profiler module".
+ *
+ * @warning Event records keep accumulating until drained by
+ * ccl_prof_poll(), ccl_queue_clear_event_records() or ccl_queue_gc()
+ * (also called by ccl_prof_calc()). At most
+ * ::CCL_QUEUE_MAX_EVENT_RECORDS records are kept. Once this limit is
+ * reached, the timing information of further retired events is
+ * discarded, and a warning with the number of discarded records is
+ * issued when the records are drained. Long-running applications with
+ * profiling enabled should call ccl_prof_poll() periodically.
+ *
+ * @attention Event wrappers returned by the `ccl_*_enqueue_*()`
+ * functions are only valid until retired, i.e. until they are complete
+ * and at least `max_events` other events are produced by the queue,
+ * unless client code increases their reference count with
+ * ccl_event_ref().
+ *
+ * @note Event wrappers produced before calling this function are not
+ * subject to retirement. If the queue already keeps more events than
+ * `max_events` in its ring buffer, only complete events are retired by
+ * this function.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[in] max_events Maximum number of event wrappers kept by the
+ * queue, or 0 for no limit (default).
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_queue_set_max_events(
+	CCLQueue* cq, cl_uint max_events, CCLErr** err) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Function return status. */
+	cl_bool status;
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+
+	/* Check if queue has profiling enabled. */
+	ccl_queue_init_fold(cq, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	if (max_events > 0) {
+
+		/* Retire the oldest complete events which don't fit in the new
+		 * capacity, and move the remaining events to a new ring
+		 * buffer, oldest first. */
+		ccl_queue_retire_oldest(cq, max_events);
+		ccl_queue_resize_ring(cq, MAX(max_events, cq->evt_ring_len));
+
+	} else {
+
+		/* Remove ring buffer, events are kept until ccl_queue_gc() is
+		 * called. */
+		g_free(cq->evt_ring);
+		cq->evt_ring = NULL;
+		cq->evt_ring_cap = 0;
+		cq->evt_ring_head = 0;
+		cq->evt_ring_len = 0;
+	}
+	cq->evt_ring_max = max_events;
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	status = CL_FALSE;
+
+finish:
+
+	/* Return status. */
+	return status;
+
+}
+
+/**
+ * Get the maximum number of event wrappers kept by the command queue.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @return The maximum number of event wrappers kept by the command
+ * queue, or 0 if there is no limit.
+ * @see ccl_queue_set_max_events()
+ * */
+CCL_EXPORT
+cl_uint ccl_queue_get_max_events(CCLQueue* cq) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, 0);
+
+	/* Return maximum number of events. */
+	return cq->evt_ring_max;
+}
+
+/**
+ * @internal
+ * Get the profiling records of events retired by the command queue.
+ *
+ * This function is used by @ref CCL_PROFILER "profile module" functions and
+ * will rarely be called from client code.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] num_records Location where to place the number of
+ * records.
+ * @return Array of profiling records of retired events, or `NULL` if
+ * there are no such records. The array is owned by the queue and is
+ * valid until ccl_queue_gc() is called or an event is retired.
+ * Records accumulate, up to ::CCL_QUEUE_MAX_EVENT_RECORDS records, until
+ * drained with ccl_queue_clear_event_records() or ccl_queue_gc().
+ * @see ccl_queue_set_max_events()
+ * */
+CCL_EXPORT
+const CCLEventRecord* ccl_queue_get_event_records(
+	CCLQueue* cq, cl_uint* num_records) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, NULL);
+	/* Make sure num_records is not NULL. */
+	g_return_val_if_fail(num_records != NULL, NULL);
+
+	/* Are there any records? */
+	if ((cq->evt_records == NULL) || (cq->evt_records->len == 0)) {
+		*num_records = 0;
+		return NULL;
+	}
+
+	/* Return records. */
+	*num_records = cq->evt_records->len;
+	return (const CCLEventRecord*) cq->evt_records->data;
+}
+
+/**
+ * Retire all complete events associated with the command queue.
+ *
+ * Contrary to ccl_queue_gc(), which releases all events associated with
+ * the command queue, this function only releases the event wrappers of
+ * commands which are no longer queued, submitted or running. If the
+ * queue has profiling enabled, the timing information of retired events
+ * is first folded into compact ::CCLEventRecord objects, as described
+ * in ccl_queue_set_max_events().
+ *
+ * This function is used by ccl_prof_poll() and will rarely be called
+ * from client code.
+ *
+ * @attention Event wrappers of retired events are no longer valid,
+ * unless client code increased their reference count with
+ * ccl_event_ref().
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_queue_retire_events(CCLQueue* cq, CCLErr** err) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Hash table iterator. */
+	GHashTableIter iter;
+	/* Current event wrapper. */
+	gpointer evt;
+	/* Number of events remaining in the ring buffer. */
+	cl_uint ring_len = 0;
+	/* Function return status. */
+	cl_bool status;
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+
+	/* Check if queue has profiling enabled. */
+	ccl_queue_init_fold(cq, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Retire complete events. */
+	ccl_queue_init_evts(cq);
+	g_hash_table_iter_init(&iter, cq->evts);
+	while (g_hash_table_iter_next(&iter, &evt, NULL)) {
+		if (ccl_queue_settle_event(cq, (CCLEvent*) evt))
+			g_hash_table_iter_remove(&iter);
+	}
+
+	/* Remove retired events from the ring buffer, if any, keeping the
+	 * remaining events in order. */
+	for (cl_uint i = 0; i < cq->evt_ring_len; ++i) {
+		evt = cq->evt_ring[(cq->evt_ring_head + i) % cq->evt_ring_cap];
+		cq->evt_ring[(cq->evt_ring_head + i) % cq->evt_ring_cap] = NULL;
+		if (g_hash_table_contains(cq->evts, evt)) {
+			cq->evt_ring[(cq->evt_ring_head + ring_len)
+				% cq->evt_ring_cap] = (CCLEvent*) evt;
+			ring_len++;
+		}
+	}
+	cq->evt_ring_len = ring_len;
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	status = CL_TRUE;
+	goto finish;
+
+error_handler:
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	status = CL_FALSE;
+
+finish:
+
+	/* Return status. */
+	return status;
+
+}
+
+/**
+ * @internal
+ * Release the profiling records of events retired by the command
+ * queue, keeping the associated events.
+ *
+ * This function is used by @ref CCL_PROFILER "profile module" functions and
+ * will rarely be called from client code.
+ *
+ * @public @memberof ccl_queue
+ *
+ * @param[in] cq The command queue wrapper object.
+ * @see ccl_queue_get_event_records()
+ * */
+CCL_EXPORT
+void ccl_queue_clear_event_records(CCLQueue* cq) {
+
+	/* Make sure cq is not NULL. */
+	g_return_if_fail(cq != NULL);
+
+	/* Release profiling records of retired events. */
+	if (cq->evt_records != NULL) {
+		g_array_set_size(cq->evt_records, 0);
+	}
+
+	/* Warn about records which could not be kept. */
+	if (cq->evt_records_dropped > 0) {
+		g_warning("%u retired events were not profiled because the "
+			"command queue already kept %u unconsumed profiling records.",
+			cq->evt_records_dropped, (guint) CCL_QUEUE_MAX_EVENT_RECORDS);
+		cq->evt_records_dropped = 0;
+	}
+}
+
 /**
  * @internal
  * Initialize an iterator for this command queue's list of event
@@ -525,6 +1263,10 @@ void ccl_queue_iter_event_init(CCLQueue* cq) {
 	/* Make sure cq is not NULL. */
 	g_return_if_fail(cq != NULL);
 
+	/* Initialize the list of events of this command queue, which may
+	 * be uninitialized if no events were produced yet. */
+	ccl_queue_init_evts(cq);
+
 	/* Initialize iterator. */
 	g_hash_table_iter_init(&cq->evt_iter, cq->evts);
 
@@ -642,7 +1384,9 @@ cl_bool ccl_queue_finish(CCLQueue* cq, CCLErr** err) {
  *
  * This function is also called by the ::ccl_prof_calc() function,
  * i.e., the queue events are released after the profiling analysis is
- * performed.
+ * performed. Profiling records of events retired by queues with a
+ * bounded number of events (see ccl_queue_set_max_events()) are also
+ * released.
  *
  * @public @memberof ccl_queue
  *
@@ -659,6 +1403,16 @@ void ccl_queue_gc(CCLQueue* cq) {
 		g_hash_table_remove_all(cq->evts);
 	}
 
+	/* Empty the event ring buffer. */
+	cq->evt_ring_head = 0;
+	cq->evt_ring_len = 0;
+
+	/* Release profiling records of retired events. */
+	ccl_queue_clear_event_records(cq);
+
+	/* Release most recent untracked event. */
+	ccl_queue_release_last_event(cq);
+
 }
 
 /**
@@ -776,6 +1530,9 @@ CCLEvent* ccl_enqueue_barrier(CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Event wrapper to return. */
 	CCLEvent* evt;
 	/* OpenCL event object. */
@@ -855,6 +1612,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
@@ -956,6 +1716,9 @@ CCLEvent* ccl_enqueue_marker(CCLQueue* cq,
 	/* Make sure err is NULL or it is not set. */
 	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* Event wrapper to return. */
 	CCLEvent* evt;
 	/* OpenCL event object. */
@@ -1034,6 +1797,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(evt);
+
 	/* Return event. */
 	return evt;
 
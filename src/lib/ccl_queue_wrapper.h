@@ -56,6 +56,26 @@
  * Queue wrappers created with the `CL_QUEUE_PROFILING_ENABLE` property can be
  * automatically profiled with the @ref CCL_PROFILER "profiler module".
  *
+ * Command queues which enqueue many commands whose events are rarely
+ * needed can be placed in untracked mode with ::ccl_queue_set_untracked().
+ * In this mode, enqueued commands do not produce event wrappers, and an
+ * event wrapper for the most recent command can be obtained on demand with
+ * ::ccl_queue_get_last_event().
+ *
+ * Long-running applications which keep enqueuing commands in tracked
+ * mode can bound the number of event wrappers kept by a queue with
+ * ::ccl_queue_set_max_events(). Once this limit is reached, the oldest
+ * complete events are retired (enqueue functions never block waiting
+ * for incomplete events, the limit is exceeded instead). If
+ * the queue has profiling enabled, the timing information of retired
+ * events is first folded into compact ::CCLEventRecord objects, which
+ * are still taken into account by the @ref CCL_PROFILER "profiler
+ * module". Event records keep accumulating until drained, up to a
+ * fixed limit, beyond which the timing information of retired events
+ * is discarded with a warning. Long-running applications should thus
+ * periodically call ::ccl_prof_poll() (which consumes and releases
+ * them) or ::ccl_queue_gc().
+ *
  * Information about queue objects can be fetched using the
  * @ref ug_getinfo "info macros":
  *
@@ -116,6 +136,45 @@ CCLDevice* ccl_queue_get_device(CCLQueue* cq, CCLErr** err);
 CCL_EXPORT
 CCLEvent* ccl_queue_produce_event(CCLQueue* cq, cl_event event);
 
+/* Enable or disable untracked mode in the given command queue. */
+CCL_EXPORT
+void ccl_queue_set_untracked(CCLQueue* cq, cl_bool untracked);
+
+/* Check if the given command queue is in untracked mode. */
+CCL_EXPORT
+cl_bool ccl_queue_is_untracked(CCLQueue* cq);
+
+/* Get an event wrapper for the most recent command enqueued in a
+ * command queue in untracked mode. */
+CCL_EXPORT
+CCLEvent* ccl_queue_get_last_event(CCLQueue* cq);
+
+/* Set the maximum number of event wrappers kept by the command
+ * queue. */
+CCL_EXPORT
+cl_bool ccl_queue_set_max_events(
+	CCLQueue* cq, cl_uint max_events, CCLErr** err);
+
+/* Get the maximum number of event wrappers kept by the command
+ * queue. */
+CCL_EXPORT
+cl_uint ccl_queue_get_max_events(CCLQueue* cq);
+
+/* Get the profiling records of events retired by the command
+ * queue. */
+CCL_EXPORT
+const CCLEventRecord* ccl_queue_get_event_records(
+	CCLQueue* cq, cl_uint* num_records);
+
+/* Retire all complete events associated with the command queue. */
+CCL_EXPORT
+cl_bool ccl_queue_retire_events(CCLQueue* cq, CCLErr** err);
+
+/* Release the profiling records of events retired by the command
+ * queue, keeping the associated events. */
+CCL_EXPORT
+void ccl_queue_clear_event_records(CCLQueue* cq);
+
 /* Initialize an iterator for this command queue's list of event
  * wrappers. */
 CCL_EXPORT
@@ -181,7 +240,7 @@ CCLEvent* ccl_enqueue_marker(CCLQueue* cq,
  * destroyed. If an error occurs, zero is returned.
  * */
 #define ccl_queue_get_info_scalar(cq, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) cq, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) cq, \
 		NULL, param_name, sizeof(param_type), CCL_INFO_QUEUE, CL_FALSE, err))
 
 /**
@@ -234,6 +234,9 @@ CCLSampler* ccl_sampler_new_full(CCLContext* ctx,
 	/* Make sure ctx is not NULL. */
 	g_return_val_if_fail(ctx != NULL, NULL);
 
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
 	/* New sampler wrapper object to create. */
 	CCLSampler* smplr = NULL;
 	/* OpenCL sampler object to create and wrap. */
@@ -299,6 +302,9 @@ error_handler:
 
 finish:
 
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
 	/* Return sampler wrapper. */
 	return smplr;
 
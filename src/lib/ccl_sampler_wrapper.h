@@ -136,7 +136,7 @@ CCLSampler* ccl_sampler_new_full(CCLContext* ctx,
  * If an error occurs, zero is returned.
  * */
 #define ccl_sampler_get_info_scalar(smplr, param_name, param_type, err) \
-	*((param_type*) ccl_wrapper_get_info_value((CCLWrapper*) smplr, \
+	*((param_type*) ccl_wrapper_get_info_scalar((CCLWrapper*) smplr, \
 		NULL, param_name, sizeof(param_type), CCL_INFO_SAMPLER, CL_FALSE, err))
 
 /**
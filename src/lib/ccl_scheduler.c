@@ -0,0 +1,945 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of classes and methods for scheduling tasks across
+ * command queues according to the memory objects they access.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_scheduler.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ * Maximum number of command queues used by a scheduler.
+ * */
+#define CCL_SCHEDULER_MAX_QUEUES 2
+
+/**
+ * @internal
+ * Accesses to a memory object by the tasks added to a scheduler.
+ * */
+typedef struct ccl_scheduler_memobj_state {
+
+	/**
+	 * Index of the last task which wrote the memory object, or -1 if
+	 * no task wrote it.
+	 * @private
+	 * */
+	cl_int last_write;
+
+	/**
+	 * Indexes of the tasks which read the memory object since it was
+	 * last written.
+	 * @private
+	 * */
+	GArray* reads;
+
+} CCLSchedulerMemObjState;
+
+/**
+ * Task scheduler class.
+ * */
+struct ccl_scheduler {
+
+	/**
+	 * Command queues.
+	 * @private
+	 * */
+	CCLQueue* queues[CCL_SCHEDULER_MAX_QUEUES];
+
+	/**
+	 * Number of distinct command queues (1 in out-of-order mode, 2
+	 * otherwise).
+	 * @private
+	 * */
+	cl_uint num_queues;
+
+	/**
+	 * Command graph where tasks are recorded.
+	 * @private
+	 * */
+	CCLCommandGraph* cg;
+
+	/**
+	 * Queue index of each task.
+	 * @private
+	 * */
+	GArray* task_queues;
+
+	/**
+	 * Accesses to memory objects, indexed by memory object wrapper.
+	 * @private
+	 * */
+	GHashTable* memobjs;
+
+	/**
+	 * Scratch space for determining the dependencies of a new task.
+	 * @private
+	 * */
+	GArray* deps;
+
+	/**
+	 * Most recent task of each queue on which a new task depends, or
+	 * -1 if none.
+	 * @private
+	 * */
+	cl_int latest[CCL_SCHEDULER_MAX_QUEUES];
+
+	/**
+	 * Most recent task of each queue (second index) which tasks in
+	 * each queue (first index) have already waited for, or -1 if none.
+	 * @private
+	 * */
+	cl_int synced[CCL_SCHEDULER_MAX_QUEUES][CCL_SCHEDULER_MAX_QUEUES];
+
+	/**
+	 * Number of dependencies converted into events.
+	 * @private
+	 * */
+	cl_uint num_deps;
+
+	/**
+	 * Were tasks enqueued since the last time the scheduler was
+	 * finished?
+	 * @private
+	 * */
+	cl_bool pending;
+
+	/**
+	 * Event wait list used for synchronizing consecutive runs.
+	 * @private
+	 * */
+	CCLEventWaitList ewl;
+
+	/**
+	 * Storage for the event wait list used for synchronizing
+	 * consecutive runs.
+	 * @private
+	 * */
+	CCLEventWaitListStorage ewl_storage;
+
+};
+
+/**
+ * @internal
+ * Destroy the accesses to a memory object.
+ *
+ * @param[in] state Accesses to a memory object.
+ * */
+static void ccl_scheduler_memobj_state_destroy(
+	CCLSchedulerMemObjState* state) {
+
+	g_array_free(state->reads, TRUE);
+	g_slice_free(CCLSchedulerMemObjState, state);
+
+}
+
+/**
+ * @internal
+ * Get the accesses to a memory object, creating them if necessary.
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] mo Memory object wrapper.
+ * @return Accesses to the given memory object.
+ * */
+static CCLSchedulerMemObjState* ccl_scheduler_memobj_state_get(
+	CCLScheduler* sched, CCLMemObj* mo) {
+
+	/* Accesses to memory object. */
+	CCLSchedulerMemObjState* state = g_hash_table_lookup(sched->memobjs, mo);
+
+	/* Create them if they don't exist yet. */
+	if (state == NULL) {
+		state = g_slice_new(CCLSchedulerMemObjState);
+		state->last_write = -1;
+		state->reads = g_array_new(FALSE, FALSE, sizeof(cl_int));
+		g_hash_table_insert(sched->memobjs, mo, state);
+	}
+
+	/* Return accesses to memory object. */
+	return state;
+
+}
+
+/**
+ * @internal
+ * Consider a dependency of a new task.
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] dep Index of task on which the new task depends.
+ * */
+static void ccl_scheduler_dep(CCLScheduler* sched, cl_int dep) {
+
+	/* Queue of the task on which the new task depends. */
+	cl_uint dep_queue = g_array_index(sched->task_queues, cl_uint, dep);
+
+	if (sched->num_queues > 1) {
+
+		/* In-order queues: only the most recent task of each queue
+		 * matters. */
+		if (dep > sched->latest[dep_queue])
+			sched->latest[dep_queue] = dep;
+
+	} else {
+
+		/* Out-of-order queue: keep each distinct dependency. */
+		for (guint i = 0; i < sched->deps->len; ++i)
+			if (g_array_index(sched->deps, cl_int, i) == dep)
+				return;
+		g_array_append_val(sched->deps, dep);
+
+	}
+}
+
+/**
+ * @internal
+ * Determine the minimum set of dependencies of a new task from the
+ * memory objects it reads and writes. Dependencies are placed in the
+ * scheduler's `deps` array.
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] queue_idx Queue index of the new task.
+ * @param[in] reads `NULL`-terminated array of memory objects read by
+ * the new task, or `NULL`.
+ * @param[in] writes `NULL`-terminated array of memory objects written
+ * by the new task, or `NULL`.
+ * */
+static void ccl_scheduler_deps(CCLScheduler* sched, cl_uint queue_idx,
+	CCLMemObj* const* reads, CCLMemObj* const* writes) {
+
+	/* Reset dependencies. */
+	g_array_set_size(sched->deps, 0);
+	for (cl_uint q = 0; q < CCL_SCHEDULER_MAX_QUEUES; ++q)
+		sched->latest[q] = -1;
+
+	/* Read after write. */
+	for (cl_uint i = 0; (reads != NULL) && (reads[i] != NULL); ++i) {
+		CCLSchedulerMemObjState* state =
+			g_hash_table_lookup(sched->memobjs, reads[i]);
+		if ((state != NULL) && (state->last_write >= 0))
+			ccl_scheduler_dep(sched, state->last_write);
+	}
+
+	/* Write after write and write after read. */
+	for (cl_uint i = 0; (writes != NULL) && (writes[i] != NULL); ++i) {
+		CCLSchedulerMemObjState* state =
+			g_hash_table_lookup(sched->memobjs, writes[i]);
+		if (state == NULL) continue;
+		if (state->last_write >= 0)
+			ccl_scheduler_dep(sched, state->last_write);
+		for (guint j = 0; j < state->reads->len; ++j)
+			ccl_scheduler_dep(sched, g_array_index(state->reads, cl_int, j));
+	}
+
+	/* In-order queues: tasks in the same queue are implicitly
+	 * ordered, and tasks of other queues which this queue already
+	 * waited for don't need to be waited for again. */
+	if (sched->num_queues > 1) {
+		for (cl_uint q = 0; q < sched->num_queues; ++q) {
+			if ((q != queue_idx)
+				&& (sched->latest[q] > sched->synced[queue_idx][q])) {
+
+				g_array_append_val(sched->deps, sched->latest[q]);
+			}
+		}
+	}
+}
+
+/**
+ * @internal
+ * Update the scheduler state after a new task was recorded.
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] task Index of the new task.
+ * @param[in] queue_idx Queue index of the new task.
+ * @param[in] reads `NULL`-terminated array of memory objects read by
+ * the new task, or `NULL`.
+ * @param[in] writes `NULL`-terminated array of memory objects written
+ * by the new task, or `NULL`.
+ * */
+static void ccl_scheduler_commit(CCLScheduler* sched, cl_int task,
+	cl_uint queue_idx, CCLMemObj* const* reads, CCLMemObj* const* writes) {
+
+	/* Keep queue of new task. */
+	g_array_append_val(sched->task_queues, queue_idx);
+
+	/* Keep track of synchronization between queues. */
+	for (guint i = 0; i < sched->deps->len; ++i) {
+		cl_int dep = g_array_index(sched->deps, cl_int, i);
+		cl_uint dep_queue = g_array_index(sched->task_queues, cl_uint, dep);
+		if (dep > sched->synced[queue_idx][dep_queue])
+			sched->synced[queue_idx][dep_queue] = dep;
+	}
+	sched->num_deps += sched->deps->len;
+
+	/* Update accesses to memory objects. */
+	for (cl_uint i = 0; (reads != NULL) && (reads[i] != NULL); ++i) {
+		CCLSchedulerMemObjState* state =
+			ccl_scheduler_memobj_state_get(sched, reads[i]);
+		g_array_append_val(state->reads, task);
+	}
+	for (cl_uint i = 0; (writes != NULL) && (writes[i] != NULL); ++i) {
+		CCLSchedulerMemObjState* state =
+			ccl_scheduler_memobj_state_get(sched, writes[i]);
+		state->last_write = task;
+		g_array_set_size(state->reads, 0);
+	}
+}
+
+/**
+ * @internal
+ * Get the queue index for tasks of the given kind.
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] which Kind of task.
+ * @return Queue index for tasks of the given kind.
+ * */
+static cl_uint ccl_scheduler_queue_idx(
+	CCLScheduler* sched, CCLSchedulerQueue which) {
+
+	return (sched->num_queues > 1) ? (cl_uint) which : 0;
+
+}
+
+/**
+ * @addtogroup CCL_SCHEDULER
+ * @{
+ */
+
+/**
+ * Create a new task scheduler object, together with its command
+ * queues.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] ctx Context wrapper object.
+ * @param[in] dev Device wrapper object, must be associated with `ctx`.
+ * @param[in] properties Properties of the command queues created by
+ * the scheduler. If `CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE` is given,
+ * a single out-of-order queue is used for all tasks; otherwise, two
+ * in-order queues are used, one for kernel executions and another for
+ * memory transfers. `CL_QUEUE_PROFILING_ENABLE` is required if the
+ * scheduler's queues are to be profiled.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new task scheduler object, which should be destroyed with
+ * ccl_scheduler_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLScheduler* ccl_scheduler_new(CCLContext* ctx, CCLDevice* dev,
+	cl_command_queue_properties properties, CCLErr** err) {
+
+	/* Make sure ctx is not NULL. */
+	g_return_val_if_fail(ctx != NULL, NULL);
+	/* Make sure dev is not NULL. */
+	g_return_val_if_fail(dev != NULL, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Task scheduler. */
+	CCLScheduler* sched = g_slice_new0(CCLScheduler);
+
+	/* Initialize task scheduler. */
+	sched->num_queues =
+		(properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) ? 1 : 2;
+	sched->cg = ccl_command_graph_new();
+	sched->task_queues = g_array_new(FALSE, FALSE, sizeof(cl_uint));
+	sched->memobjs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+		NULL, (GDestroyNotify) ccl_scheduler_memobj_state_destroy);
+	sched->deps = g_array_new(FALSE, FALSE, sizeof(cl_int));
+	sched->ewl = ccl_event_wait_list_init(&sched->ewl_storage);
+	for (cl_uint i = 0; i < CCL_SCHEDULER_MAX_QUEUES; ++i)
+		for (cl_uint j = 0; j < CCL_SCHEDULER_MAX_QUEUES; ++j)
+			sched->synced[i][j] = -1;
+
+	/* Create command queues. */
+	for (cl_uint i = 0; i < sched->num_queues; ++i) {
+		sched->queues[i] = ccl_queue_new(ctx, dev, properties, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Destroy what was built for the task scheduler. */
+	ccl_scheduler_destroy(sched);
+	sched = NULL;
+
+finish:
+
+	/* Return new task scheduler. */
+	return sched;
+
+}
+
+/**
+ * Destroy a task scheduler object, releasing its command queues.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler object to destroy.
+ * */
+CCL_EXPORT
+void ccl_scheduler_destroy(CCLScheduler* sched) {
+
+	/* Task scheduler to destroy cannot be NULL. */
+	g_return_if_fail(sched != NULL);
+
+	/* Release command queues. */
+	for (cl_uint i = 0; i < sched->num_queues; ++i)
+		if (sched->queues[i] != NULL)
+			ccl_queue_destroy(sched->queues[i]);
+
+	/* Release command graph and scheduler state. */
+	ccl_command_graph_destroy(sched->cg);
+	g_array_free(sched->task_queues, TRUE);
+	g_hash_table_destroy(sched->memobjs);
+	g_array_free(sched->deps, TRUE);
+	ccl_event_wait_list_dispose(&sched->ewl);
+
+	/* Release task scheduler. */
+	g_slice_free(CCLScheduler, sched);
+
+}
+
+/**
+ * Add a kernel execution task, which is enqueued in the compute queue.
+ * Kernel executions must declare the memory objects they read and
+ * write, since these can't be inferred from the kernel arguments.
+ * Memory objects which are both read and written must be given in
+ * both arrays.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] krnl Kernel wrapper object.
+ * @param[in] work_dim The number of dimensions used to specify the
+ * global work-items and work-items in the work-group (between 1 and
+ * 3).
+ * @param[in] global_work_offset Global work offset, or `NULL`.
+ * @param[in] global_work_size Global work size.
+ * @param[in] local_work_size Local work size, or `NULL`.
+ * @param[in] args A `NULL`-terminated array of kernel arguments, or
+ * `NULL`, captured as in ccl_command_graph_add_kernel().
+ * @param[in] reads `NULL`-terminated array of memory objects read by
+ * the kernel, or `NULL`.
+ * @param[in] writes `NULL`-terminated array of memory objects written
+ * by the kernel, or `NULL`.
+ * @return Index of the new task, or a negative value if the given
+ * parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_scheduler_add_kernel(CCLScheduler* sched, CCLKernel* krnl,
+	cl_uint work_dim, const size_t* global_work_offset,
+	const size_t* global_work_size, const size_t* local_work_size,
+	void** args, CCLMemObj* const* reads, CCLMemObj* const* writes) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, -1);
+
+	/* Queue index and index of new task. */
+	cl_uint queue_idx =
+		ccl_scheduler_queue_idx(sched, CCL_SCHEDULER_QUEUE_COMPUTE);
+	cl_int task;
+
+	/* Determine dependencies and record task. */
+	ccl_scheduler_deps(sched, queue_idx, reads, writes);
+	task = ccl_command_graph_add_kernel(sched->cg, queue_idx, krnl,
+		work_dim, global_work_offset, global_work_size, local_work_size,
+		args, sched->deps->len, (const cl_int*) sched->deps->data);
+	if (task >= 0)
+		ccl_scheduler_commit(sched, task, queue_idx, reads, writes);
+
+	/* Return index of new task. */
+	return task;
+
+}
+
+/**
+ * Add a non-blocking buffer read task, which is enqueued in the
+ * transfer queue. The data in `ptr` is only available after
+ * ccl_scheduler_finish() is called.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] buf Buffer wrapper object where to read from.
+ * @param[in] offset The offset in bytes in the buffer object to read
+ * from.
+ * @param[in] size The size in bytes of data being read.
+ * @param[out] ptr The pointer to buffer in host memory where data is
+ * to be read into.
+ * @return Index of the new task, or a negative value if the given
+ * parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_scheduler_add_buffer_read(CCLScheduler* sched,
+	CCLBuffer* buf, size_t offset, size_t size, void* ptr) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, -1);
+
+	/* Memory objects read by task. */
+	CCLMemObj* reads[] = { (CCLMemObj*) buf, NULL };
+	/* Queue index and index of new task. */
+	cl_uint queue_idx =
+		ccl_scheduler_queue_idx(sched, CCL_SCHEDULER_QUEUE_TRANSFER);
+	cl_int task;
+
+	/* Determine dependencies and record task. */
+	ccl_scheduler_deps(sched, queue_idx, reads, NULL);
+	task = ccl_command_graph_add_buffer_read(sched->cg, queue_idx, buf,
+		CL_FALSE, offset, size, ptr,
+		sched->deps->len, (const cl_int*) sched->deps->data);
+	if (task >= 0)
+		ccl_scheduler_commit(sched, task, queue_idx, reads, NULL);
+
+	/* Return index of new task. */
+	return task;
+
+}
+
+/**
+ * Add a non-blocking buffer write task, which is enqueued in the
+ * transfer queue. The data in `ptr` must not be modified until
+ * ccl_scheduler_finish() is called.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[out] buf Buffer wrapper object where to write to.
+ * @param[in] offset The offset in bytes in the buffer object to write
+ * to.
+ * @param[in] size The size in bytes of data being written.
+ * @param[in] ptr The pointer to buffer in host memory where data is to
+ * be written from.
+ * @return Index of the new task, or a negative value if the given
+ * parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_scheduler_add_buffer_write(CCLScheduler* sched,
+	CCLBuffer* buf, size_t offset, size_t size, void* ptr) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, -1);
+
+	/* Memory objects written by task. */
+	CCLMemObj* writes[] = { (CCLMemObj*) buf, NULL };
+	/* Queue index and index of new task. */
+	cl_uint queue_idx =
+		ccl_scheduler_queue_idx(sched, CCL_SCHEDULER_QUEUE_TRANSFER);
+	cl_int task;
+
+	/* Determine dependencies and record task. */
+	ccl_scheduler_deps(sched, queue_idx, NULL, writes);
+	task = ccl_command_graph_add_buffer_write(sched->cg, queue_idx, buf,
+		CL_FALSE, offset, size, ptr,
+		sched->deps->len, (const cl_int*) sched->deps->data);
+	if (task >= 0)
+		ccl_scheduler_commit(sched, task, queue_idx, NULL, writes);
+
+	/* Return index of new task. */
+	return task;
+
+}
+
+/**
+ * Add a buffer copy task, which is enqueued in the transfer queue.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] src_buf Source buffer wrapper object.
+ * @param[out] dst_buf Destination buffer wrapper object.
+ * @param[in] src_offset The offset where to begin copying data from
+ * `src_buf`.
+ * @param[in] dst_offset The offset where to begin copying data into
+ * `dst_buf`.
+ * @param[in] size The size in bytes to copy.
+ * @return Index of the new task, or a negative value if the given
+ * parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_scheduler_add_buffer_copy(CCLScheduler* sched,
+	CCLBuffer* src_buf, CCLBuffer* dst_buf, size_t src_offset,
+	size_t dst_offset, size_t size) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, -1);
+
+	/* Memory objects read and written by task. */
+	CCLMemObj* reads[] = { (CCLMemObj*) src_buf, NULL };
+	CCLMemObj* writes[] = { (CCLMemObj*) dst_buf, NULL };
+	/* Queue index and index of new task. */
+	cl_uint queue_idx =
+		ccl_scheduler_queue_idx(sched, CCL_SCHEDULER_QUEUE_TRANSFER);
+	cl_int task;
+
+	/* Determine dependencies and record task. */
+	ccl_scheduler_deps(sched, queue_idx, reads, writes);
+	task = ccl_command_graph_add_buffer_copy(sched->cg, queue_idx,
+		src_buf, dst_buf, src_offset, dst_offset, size,
+		sched->deps->len, (const cl_int*) sched->deps->data);
+	if (task >= 0)
+		ccl_scheduler_commit(sched, task, queue_idx, reads, writes);
+
+	/* Return index of new task. */
+	return task;
+
+}
+
+/**
+ * Add a non-blocking image read task, which is enqueued in the
+ * transfer queue. The data in `ptr` is only available after
+ * ccl_scheduler_finish() is called.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] img Image wrapper object where to read from.
+ * @param[in] origin Defines the @f$(x, y, z)@f$ offset in pixels in
+ * the 1D, 2D or 3D image.
+ * @param[in] region Defines the @f$(width, height, depth)@f$ in pixels
+ * of the 1D, 2D or 3D rectangle being read.
+ * @param[in] row_pitch The length of each row in bytes.
+ * @param[in] slice_pitch Size in bytes of the 2D slice of the 3D region
+ * of a 3D image or each image of a 1D or 2D image array being read.
+ * @param[out] ptr The pointer to a buffer in host memory where image
+ * data is to be read into.
+ * @return Index of the new task, or a negative value if the given
+ * parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_scheduler_add_image_read(CCLScheduler* sched, CCLImage* img,
+	const size_t* origin, const size_t* region, size_t row_pitch,
+	size_t slice_pitch, void* ptr) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, -1);
+
+	/* Memory objects read by task. */
+	CCLMemObj* reads[] = { (CCLMemObj*) img, NULL };
+	/* Queue index and index of new task. */
+	cl_uint queue_idx =
+		ccl_scheduler_queue_idx(sched, CCL_SCHEDULER_QUEUE_TRANSFER);
+	cl_int task;
+
+	/* Determine dependencies and record task. */
+	ccl_scheduler_deps(sched, queue_idx, reads, NULL);
+	task = ccl_command_graph_add_image_read(sched->cg, queue_idx, img,
+		CL_FALSE, origin, region, row_pitch, slice_pitch, ptr,
+		sched->deps->len, (const cl_int*) sched->deps->data);
+	if (task >= 0)
+		ccl_scheduler_commit(sched, task, queue_idx, reads, NULL);
+
+	/* Return index of new task. */
+	return task;
+
+}
+
+/**
+ * Add a non-blocking image write task, which is enqueued in the
+ * transfer queue. The data in `ptr` must not be modified until
+ * ccl_scheduler_finish() is called.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[out] img Image wrapper object where to write to.
+ * @param[in] origin Defines the @f$(x, y, z)@f$ offset in pixels in
+ * the 1D, 2D or 3D image.
+ * @param[in] region Defines the @f$(width, height, depth)@f$ in pixels
+ * of the 1D, 2D or 3D rectangle being written.
+ * @param[in] input_row_pitch The length of each row in bytes.
+ * @param[in] input_slice_pitch Size in bytes of the 2D slice of the 3D
+ * region of a 3D image or each image of a 1D or 2D image array being
+ * written.
+ * @param[in] ptr The pointer to a buffer in host memory where image
+ * data is to be written from.
+ * @return Index of the new task, or a negative value if the given
+ * parameters are invalid.
+ * */
+CCL_EXPORT
+cl_int ccl_scheduler_add_image_write(CCLScheduler* sched, CCLImage* img,
+	const size_t* origin, const size_t* region, size_t input_row_pitch,
+	size_t input_slice_pitch, void* ptr) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, -1);
+
+	/* Memory objects written by task. */
+	CCLMemObj* writes[] = { (CCLMemObj*) img, NULL };
+	/* Queue index and index of new task. */
+	cl_uint queue_idx =
+		ccl_scheduler_queue_idx(sched, CCL_SCHEDULER_QUEUE_TRANSFER);
+	cl_int task;
+
+	/* Determine dependencies and record task. */
+	ccl_scheduler_deps(sched, queue_idx, NULL, writes);
+	task = ccl_command_graph_add_image_write(sched->cg, queue_idx, img,
+		CL_FALSE, origin, region, input_row_pitch, input_slice_pitch,
+		ptr, sched->deps->len, (const cl_int*) sched->deps->data);
+	if (task >= 0)
+		ccl_scheduler_commit(sched, task, queue_idx, NULL, writes);
+
+	/* Return index of new task. */
+	return task;
+
+}
+
+/**
+ * Enqueue all tasks in the scheduler's command queues. This function
+ * does not block. If tasks enqueued by a previous run may still be
+ * executing, a marker (in-order mode) or a barrier (out-of-order mode)
+ * is enqueued in each queue, so that tasks of this run don't overtake
+ * tasks of the previous run.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in,out] evt_wait_lst List of events that need to complete
+ * before tasks can be executed. The list will be cleared and can be
+ * reused by client code.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_scheduler_run(CCLScheduler* sched,
+	CCLEventWaitList* evt_wait_lst, CCLErr** err) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+	/* Queues for each queue index of the command graph. */
+	CCLQueue* queues[CCL_SCHEDULER_MAX_QUEUES];
+
+	/* Use internal event wait list if none was given. */
+	if (evt_wait_lst == NULL)
+		evt_wait_lst = &sched->ewl;
+
+	/* Synchronize with tasks of the previous run. */
+	if (sched->pending) {
+		for (cl_uint i = 0; i < sched->num_queues; ++i) {
+			CCLEvent* evt;
+			if (sched->num_queues > 1) {
+				evt = ccl_enqueue_marker(
+					sched->queues[i], NULL, &err_internal);
+				g_if_err_propagate_goto(err, err_internal, error_handler);
+				ccl_event_wait_list_add(evt_wait_lst, evt, NULL);
+			} else {
+				ccl_enqueue_barrier(sched->queues[i], NULL, &err_internal);
+				g_if_err_propagate_goto(err, err_internal, error_handler);
+			}
+		}
+	}
+
+	/* Replay recorded tasks. */
+	for (cl_uint i = 0; i < CCL_SCHEDULER_MAX_QUEUES; ++i)
+		queues[i] = sched->queues[ccl_scheduler_queue_idx(sched, i)];
+	sched->pending = CL_TRUE;
+	ccl_command_graph_replay(sched->cg, queues, CCL_SCHEDULER_MAX_QUEUES,
+		evt_wait_lst, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+	/* Don't keep synchronization events. */
+	ccl_event_wait_list_clear(evt_wait_lst);
+
+finish:
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Block until all tasks enqueued by the scheduler are complete. The
+ * event wrappers produced by the completed tasks are then retired with
+ * ccl_queue_retire_events(), so that they don't accumulate over runs.
+ * If the scheduler's queues have profiling enabled, the timing
+ * information of these events is kept as profiling records, which are
+ * taken into account and released by ccl_prof_calc().
+ *
+ * @attention Event wrappers produced by the scheduler's tasks are no
+ * longer valid after this function returns, unless client code
+ * increased their reference count with ccl_event_ref().
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_scheduler_finish(CCLScheduler* sched, CCLErr** err) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Wait for all command queues, and retire the events of completed
+	 * tasks. */
+	for (cl_uint i = 0; i < sched->num_queues; ++i) {
+		if (!ccl_queue_finish(sched->queues[i], err))
+			return CL_FALSE;
+		if (!ccl_queue_retire_events(sched->queues[i], err))
+			return CL_FALSE;
+	}
+
+	/* No more pending tasks. */
+	sched->pending = CL_FALSE;
+	return CL_TRUE;
+
+}
+
+/**
+ * Get one of the command queues used by the scheduler. In
+ * out-of-order mode, the same queue is returned for both kinds of
+ * tasks.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] which Which queue to get.
+ * @return The requested command queue wrapper, which belongs to the
+ * scheduler and should not be destroyed by client code.
+ * */
+CCL_EXPORT
+CCLQueue* ccl_scheduler_get_queue(
+	CCLScheduler* sched, CCLSchedulerQueue which) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, NULL);
+	/* Make sure which is valid. */
+	g_return_val_if_fail(which < CCL_SCHEDULER_MAX_QUEUES, NULL);
+
+	return sched->queues[ccl_scheduler_queue_idx(sched, which)];
+
+}
+
+/**
+ * Get the command graph where tasks are recorded. Task indexes are
+ * command indexes in this graph, which can be used, for example, to
+ * update kernel arguments with ccl_command_graph_set_kernel_arg() or
+ * to name the events produced by tasks with
+ * ccl_command_graph_set_name(). Memory objects can be exchanged with
+ * ccl_command_graph_swap_memobjs(), which preserves the dependencies
+ * determined by the scheduler. Commands should not be added directly
+ * to the graph.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @return The command graph, which belongs to the scheduler and should
+ * not be destroyed by client code.
+ * */
+CCL_EXPORT
+CCLCommandGraph* ccl_scheduler_get_graph(CCLScheduler* sched) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, NULL);
+
+	return sched->cg;
+
+}
+
+/**
+ * Get the number of dependencies between tasks which are converted
+ * into events when the scheduler is run.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @return Number of dependencies converted into events.
+ * */
+CCL_EXPORT
+cl_uint ccl_scheduler_get_num_deps(CCLScheduler* sched) {
+
+	/* Make sure sched is not NULL. */
+	g_return_val_if_fail(sched != NULL, 0);
+
+	return sched->num_deps;
+
+}
+
+/**
+ * Add the scheduler's command queues to a profile object. The compute
+ * and transfer queues are named "Compute" and "Transfer",
+ * respectively, and overlaps between their events are reported in the
+ * profile object's overlap table. In out-of-order mode, only the
+ * "Compute" queue is added.
+ *
+ * @public @memberof ccl_scheduler
+ *
+ * @param[in] sched Task scheduler.
+ * @param[in] prof Profile object.
+ * */
+CCL_EXPORT
+void ccl_scheduler_add_to_prof(CCLScheduler* sched, CCLProf* prof) {
+
+	/* Make sure sched is not NULL. */
+	g_return_if_fail(sched != NULL);
+	/* Make sure prof is not NULL. */
+	g_return_if_fail(prof != NULL);
+
+	/* Queue names. */
+	static const char* names[CCL_SCHEDULER_MAX_QUEUES] =
+		{ "Compute", "Transfer" };
+
+	for (cl_uint i = 0; i < sched->num_queues; ++i)
+		ccl_prof_add_queue(prof, names[i], sched->queues[i]);
+
+}
+
+/** @} */
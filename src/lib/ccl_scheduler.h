@@ -0,0 +1,206 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Definition of classes and methods for scheduling tasks across
+ * command queues according to the memory objects they access.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_SCHEDULER_H_
+#define _CCL_SCHEDULER_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_command_graph.h"
+#include "ccl_profiler.h"
+
+/**
+ * @defgroup CCL_SCHEDULER Task scheduler
+ *
+ * The task scheduler module provides a class which dispatches tasks
+ * (kernel executions and memory transfers) across command queues,
+ * automatically determining the dependencies between them from the
+ * memory objects they read and write.
+ *
+ * @warning The functions in this module are not thread-safe.
+ *
+ * A scheduler owns its command queues. By default, it creates two
+ * in-order queues for the given device, one for kernel executions
+ * (::CCL_SCHEDULER_QUEUE_COMPUTE) and another for memory transfers
+ * (::CCL_SCHEDULER_QUEUE_TRANSFER), so that transfers can overlap
+ * with computations. If the out-of-order execution mode is requested,
+ * a single out-of-order queue is used for all tasks.
+ *
+ * Tasks are added with the `ccl_scheduler_add_*()` functions. The
+ * memory objects accessed by transfers are implicit, while kernel
+ * executions declare the memory objects they read and write. A task
+ * depends on the last task which wrote any memory object it accesses
+ * and, if it writes a memory object, on the tasks which read that
+ * memory object since it was last written. Only the minimum set of
+ * dependencies is converted into events: dependencies between tasks in
+ * the same in-order queue are implicit, and a task only waits for the
+ * most recent task of the other queue, and only if its queue has not
+ * already waited for that task or a later one.
+ *
+ * Tasks are recorded in a @ref CCL_COMMAND_GRAPH "command graph",
+ * which is replayed each time ::ccl_scheduler_run() is called. Task
+ * indexes are the command indexes of the underlying graph, obtained
+ * with ::ccl_scheduler_get_graph(), which can be used for updating
+ * kernel arguments, exchanging memory objects between runs or naming
+ * the events produced by tasks.
+ *
+ * The overlap achieved by the scheduler can be analyzed by adding its
+ * queues to a @ref CCL_PROFILER "profile object" with
+ * ::ccl_scheduler_add_to_prof(), in which case overlaps between
+ * transfers and kernel executions are reported in the overlap table
+ * of the profile object. In this case, queues must be created with
+ * the `CL_QUEUE_PROFILING_ENABLE` property.
+ *
+ * _Example:_
+ *
+ * @code{.c}
+ * CCLScheduler* sched;
+ * CCLProf* prof;
+ * @endcode
+ * @code{.c}
+ * sched = ccl_scheduler_new(ctx, dev, CL_QUEUE_PROFILING_ENABLE, NULL);
+ * ccl_scheduler_add_buffer_write(sched, buf_in, 0, size, host_in);
+ * ccl_scheduler_add_kernel(sched, krnl, 1, NULL, &gws, &lws,
+ *     (void*[]) { buf_in, buf_out, NULL },
+ *     (CCLMemObj*[]) { (CCLMemObj*) buf_in, NULL },
+ *     (CCLMemObj*[]) { (CCLMemObj*) buf_out, NULL });
+ * ccl_scheduler_add_buffer_read(sched, buf_out, 0, size, host_out);
+ * @endcode
+ * @code{.c}
+ * for (i = 0; i < n; ++i)
+ *     ccl_scheduler_run(sched, NULL, NULL);
+ * ccl_scheduler_finish(sched, NULL);
+ * @endcode
+ * @code{.c}
+ * prof = ccl_prof_new();
+ * ccl_scheduler_add_to_prof(sched, prof);
+ * ccl_prof_calc(prof, NULL);
+ * ccl_prof_print_summary(prof);
+ * @endcode
+ * @code{.c}
+ * ccl_prof_destroy(prof);
+ * ccl_scheduler_destroy(sched);
+ * @endcode
+ *
+ * @{
+ */
+
+/**
+ * Command queues used by a scheduler.
+ * */
+typedef enum ccl_scheduler_queue {
+
+	/** Queue for kernel executions, or for all tasks in out-of-order
+	 * mode. */
+	CCL_SCHEDULER_QUEUE_COMPUTE = 0,
+
+	/** Queue for memory transfers, which is the same as the compute
+	 * queue in out-of-order mode. */
+	CCL_SCHEDULER_QUEUE_TRANSFER = 1
+
+} CCLSchedulerQueue;
+
+/**
+ * Task scheduler class.
+ * */
+typedef struct ccl_scheduler CCLScheduler;
+
+/* Create a new task scheduler object. */
+CCL_EXPORT
+CCLScheduler* ccl_scheduler_new(CCLContext* ctx, CCLDevice* dev,
+	cl_command_queue_properties properties, CCLErr** err);
+
+/* Destroy a task scheduler object. */
+CCL_EXPORT
+void ccl_scheduler_destroy(CCLScheduler* sched);
+
+/* Add a kernel execution task. */
+CCL_EXPORT
+cl_int ccl_scheduler_add_kernel(CCLScheduler* sched, CCLKernel* krnl,
+	cl_uint work_dim, const size_t* global_work_offset,
+	const size_t* global_work_size, const size_t* local_work_size,
+	void** args, CCLMemObj* const* reads, CCLMemObj* const* writes);
+
+/* Add a buffer read task. */
+CCL_EXPORT
+cl_int ccl_scheduler_add_buffer_read(CCLScheduler* sched,
+	CCLBuffer* buf, size_t offset, size_t size, void* ptr);
+
+/* Add a buffer write task. */
+CCL_EXPORT
+cl_int ccl_scheduler_add_buffer_write(CCLScheduler* sched,
+	CCLBuffer* buf, size_t offset, size_t size, void* ptr);
+
+/* Add a buffer copy task. */
+CCL_EXPORT
+cl_int ccl_scheduler_add_buffer_copy(CCLScheduler* sched,
+	CCLBuffer* src_buf, CCLBuffer* dst_buf, size_t src_offset,
+	size_t dst_offset, size_t size);
+
+/* Add an image read task. */
+CCL_EXPORT
+cl_int ccl_scheduler_add_image_read(CCLScheduler* sched, CCLImage* img,
+	const size_t* origin, const size_t* region, size_t row_pitch,
+	size_t slice_pitch, void* ptr);
+
+/* Add an image write task. */
+CCL_EXPORT
+cl_int ccl_scheduler_add_image_write(CCLScheduler* sched, CCLImage* img,
+	const size_t* origin, const size_t* region, size_t input_row_pitch,
+	size_t input_slice_pitch, void* ptr);
+
+/* Enqueue all tasks in the scheduler's command queues. */
+CCL_EXPORT
+cl_bool ccl_scheduler_run(CCLScheduler* sched,
+	CCLEventWaitList* evt_wait_lst, CCLErr** err);
+
+/* Block until all tasks enqueued by the scheduler are complete. */
+CCL_EXPORT
+cl_bool ccl_scheduler_finish(CCLScheduler* sched, CCLErr** err);
+
+/* Get one of the command queues used by the scheduler. */
+CCL_EXPORT
+CCLQueue* ccl_scheduler_get_queue(
+	CCLScheduler* sched, CCLSchedulerQueue which);
+
+/* Get the command graph where tasks are recorded. */
+CCL_EXPORT
+CCLCommandGraph* ccl_scheduler_get_graph(CCLScheduler* sched);
+
+/* Get the number of dependencies converted into events. */
+CCL_EXPORT
+cl_uint ccl_scheduler_get_num_deps(CCLScheduler* sched);
+
+/* Add the scheduler's command queues to a profile object. */
+CCL_EXPORT
+void ccl_scheduler_add_to_prof(CCLScheduler* sched, CCLProf* prof);
+
+/** @} */
+
+#endif
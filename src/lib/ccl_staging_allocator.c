@@ -0,0 +1,437 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of an allocator of pinned host memory for staging
+ * transfers between host and device.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_staging_allocator.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ * A persistently mapped block of pinned host memory.
+ * */
+typedef struct ccl_staging_block {
+
+	/**
+	 * Buffer allocated with `CL_MEM_ALLOC_HOST_PTR`.
+	 * @private
+	 * */
+	CCLBuffer* buf;
+
+	/**
+	 * Mapped pointer of buffer.
+	 * @private
+	 * */
+	cl_uchar* host;
+
+	/**
+	 * Size of block in bytes.
+	 * @private
+	 * */
+	size_t size;
+
+	/**
+	 * Number of bytes handed out since the block was last empty.
+	 * @private
+	 * */
+	size_t used;
+
+	/**
+	 * Number of slices which were not returned yet.
+	 * @private
+	 * */
+	cl_uint num_live;
+
+	/**
+	 * Queue where the block was mapped, and where it is unmapped.
+	 * @private
+	 * */
+	CCLQueue* cq;
+
+} CCLStagingBlock;
+
+/**
+ * Staging allocator class.
+ * */
+struct ccl_staging_allocator {
+
+	/**
+	 * Queue where blocks are mapped and unmapped.
+	 * @private
+	 * */
+	CCLQueue* cq;
+
+	/**
+	 * Size of regular blocks.
+	 * @private
+	 * */
+	size_t block_size;
+
+	/**
+	 * Slice alignment in bytes.
+	 * @private
+	 * */
+	size_t align;
+
+	/**
+	 * Regular and dedicated blocks.
+	 * @private
+	 * */
+	GPtrArray* blocks;
+
+	/**
+	 * Blocks of slices which were not returned yet, indexed by slice
+	 * pointer.
+	 * @private
+	 * */
+	GHashTable* slices;
+
+};
+
+/**
+ * @internal
+ * Destroy a block, unmapping and releasing its buffer.
+ *
+ * @param[in] block Block to destroy.
+ * */
+static void ccl_staging_block_destroy(CCLStagingBlock* block) {
+
+	if (block->host != NULL)
+		ccl_buffer_enqueue_unmap(
+			block->buf, block->cq, block->host, NULL, NULL);
+	ccl_buffer_destroy(block->buf);
+	g_slice_free(CCLStagingBlock, block);
+
+}
+
+/**
+ * @internal
+ * Create and map a new block.
+ *
+ * @param[in] sa Staging allocator.
+ * @param[in] size Size of block in bytes.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new block, or `NULL` if an error occurs.
+ * */
+static CCLStagingBlock* ccl_staging_block_new(CCLStagingAllocator* sa,
+	size_t size, CCLErr** err) {
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Context of allocator queue. */
+	CCLContext* ctx;
+	/* New block. */
+	CCLStagingBlock* block = g_slice_new0(CCLStagingBlock);
+
+	block->size = size;
+	block->cq = sa->cq;
+
+	/* Create buffer in host memory allocated by the OpenCL
+	 * implementation. */
+	ctx = ccl_queue_get_context(sa->cq, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	block->buf = ccl_buffer_new(ctx,
+		CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size, NULL,
+		&err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Map it for the lifetime of the block. */
+	block->host = ccl_buffer_enqueue_map(block->buf, sa->cq, CL_TRUE,
+		CL_MAP_READ | CL_MAP_WRITE, 0, size, NULL, NULL, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Release what was created for the block. */
+	if (block->buf != NULL) ccl_buffer_destroy(block->buf);
+	g_slice_free(CCLStagingBlock, block);
+	block = NULL;
+
+finish:
+
+	/* Return new block. */
+	return block;
+
+}
+
+/**
+ * @addtogroup CCL_STAGING_ALLOCATOR
+ * @{
+ */
+
+/**
+ * Create a new staging allocator. Blocks are only created when
+ * required.
+ *
+ * @public @memberof ccl_staging_allocator
+ *
+ * @param[in] cq Command queue wrapper object where blocks are mapped
+ * and unmapped. Slice alignment is determined by its device.
+ * @param[in] block_size Size of blocks in bytes, which is also the
+ * largest slice served by shared blocks. It is rounded up to a multiple
+ * of the slice alignment.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new staging allocator, which should be destroyed with
+ * ccl_staging_allocator_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLStagingAllocator* ccl_staging_allocator_new(CCLQueue* cq,
+	size_t block_size, CCLErr** err) {
+
+	/* Make sure cq is not NULL. */
+	g_return_val_if_fail(cq != NULL, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Staging allocator. */
+	CCLStagingAllocator* sa = NULL;
+	/* Device of command queue. */
+	CCLDevice* dev;
+	/* Slice alignment in bits. */
+	cl_uint align_bits;
+	/* Slice alignment in bytes. */
+	size_t align;
+
+	/* Determine slice alignment. */
+	dev = ccl_queue_get_device(cq, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	align_bits = ccl_device_get_info_scalar(dev,
+		CL_DEVICE_MEM_BASE_ADDR_ALIGN, cl_uint, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	align = MAX(align_bits / 8, 1);
+
+	/* Create and initialize allocator. */
+	sa = g_slice_new0(CCLStagingAllocator);
+	ccl_queue_ref(cq);
+	sa->cq = cq;
+	sa->block_size = MAX(((block_size + align - 1) / align) * align, align);
+	sa->align = align;
+	sa->blocks = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) ccl_staging_block_destroy);
+	sa->slices = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Return new staging allocator. */
+	return sa;
+
+}
+
+/**
+ * Destroy a staging allocator, unmapping and releasing all its blocks.
+ * Slices must not be used after the allocator is destroyed.
+ *
+ * @public @memberof ccl_staging_allocator
+ *
+ * @param[in] sa Staging allocator to destroy.
+ * */
+CCL_EXPORT
+void ccl_staging_allocator_destroy(CCLStagingAllocator* sa) {
+
+	/* Staging allocator to destroy cannot be NULL. */
+	g_return_if_fail(sa != NULL);
+
+	/* Warn about slices which were not returned. */
+	if (g_hash_table_size(sa->slices) > 0)
+		g_warning("Staging allocator destroyed with %u slices in use.",
+			g_hash_table_size(sa->slices));
+
+	/* Unmap and release blocks, waiting for the unmaps to complete. */
+	g_hash_table_destroy(sa->slices);
+	g_ptr_array_free(sa->blocks, TRUE);
+	ccl_queue_finish(sa->cq, NULL);
+
+	/* Release queue and allocator. */
+	ccl_queue_unref(sa->cq);
+	g_slice_free(CCLStagingAllocator, sa);
+
+}
+
+/**
+ * Allocate a slice of pinned host memory. The slice is taken from the
+ * first block with enough room left; a new block is created if no
+ * such block exists. Slices larger than the block size get a dedicated
+ * block.
+ *
+ * @public @memberof ccl_staging_allocator
+ *
+ * @param[in] sa Staging allocator.
+ * @param[in] size Size of slice in bytes.
+ * @param[out] block Return location for the buffer wrapper of the
+ * block containing the slice, or `NULL`. The buffer belongs to the
+ * allocator and remains mapped until the allocator is destroyed or, for
+ * dedicated blocks, until the slice is returned.
+ * @param[out] offset Return location for the offset of the slice in
+ * its block, or `NULL`.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return Host pointer to the slice, which should be returned with
+ * ccl_staging_allocator_free(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+void* ccl_staging_allocator_alloc(CCLStagingAllocator* sa, size_t size,
+	CCLBuffer** block, size_t* offset, CCLErr** err) {
+
+	/* Make sure sa is not NULL. */
+	g_return_val_if_fail(sa != NULL, NULL);
+	/* Make sure size is not zero. */
+	g_return_val_if_fail(size > 0, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Slice size, rounded up to the alignment. */
+	size_t slice_size = ((size + sa->align - 1) / sa->align) * sa->align;
+	/* Block which serves the slice. */
+	CCLStagingBlock* blk = NULL;
+	/* Slice pointer. */
+	void* ptr = NULL;
+
+	if (slice_size > sa->block_size) {
+
+		/* Too large for regular blocks, create dedicated block. */
+		blk = ccl_staging_block_new(sa, slice_size, err);
+		if (blk != NULL) g_ptr_array_add(sa->blocks, blk);
+
+	} else {
+
+		/* Find first regular block with enough room left. */
+		for (guint i = 0; i < sa->blocks->len; ++i) {
+			CCLStagingBlock* b = g_ptr_array_index(sa->blocks, i);
+			if ((b->size == sa->block_size)
+				&& (b->used + slice_size <= b->size)) {
+				blk = b;
+				break;
+			}
+		}
+
+		/* Create new regular block if none was found. */
+		if (blk == NULL) {
+			blk = ccl_staging_block_new(sa, sa->block_size, err);
+			if (blk != NULL) g_ptr_array_add(sa->blocks, blk);
+		}
+	}
+
+	/* Hand out slice. */
+	if (blk != NULL) {
+		ptr = blk->host + blk->used;
+		if (block != NULL) *block = blk->buf;
+		if (offset != NULL) *offset = blk->used;
+		blk->used += slice_size;
+		blk->num_live++;
+		g_hash_table_insert(sa->slices, ptr, blk);
+	}
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(blk != NULL ? blk->buf : NULL);
+
+	/* Return slice. */
+	return ptr;
+
+}
+
+/**
+ * Return a slice of pinned host memory to the allocator. When all
+ * slices of a block are returned, the block is reused from its start
+ * or, if dedicated, released.
+ *
+ * @public @memberof ccl_staging_allocator
+ *
+ * @param[in] sa Staging allocator.
+ * @param[in] ptr Slice allocated with ccl_staging_allocator_alloc(),
+ * which must not be in use by pending commands.
+ * */
+CCL_EXPORT
+void ccl_staging_allocator_free(CCLStagingAllocator* sa, void* ptr) {
+
+	/* Make sure sa is not NULL. */
+	g_return_if_fail(sa != NULL);
+	/* Make sure ptr is not NULL. */
+	g_return_if_fail(ptr != NULL);
+
+	/* Block of slice. */
+	CCLStagingBlock* blk = g_hash_table_lookup(sa->slices, ptr);
+
+	/* Make sure slice belongs to allocator. */
+	g_return_if_fail(blk != NULL);
+
+	g_hash_table_remove(sa->slices, ptr);
+	blk->num_live--;
+
+	/* Reuse or release empty blocks. */
+	if (blk->num_live == 0) {
+		if (blk->size > sa->block_size)
+			g_ptr_array_remove_fast(sa->blocks, blk);
+		else
+			blk->used = 0;
+	}
+
+}
+
+/**
+ * Get the alignment of slices handed out by the allocator, i.e. the
+ * `CL_DEVICE_MEM_BASE_ADDR_ALIGN` of its device, in bytes. Slice
+ * offsets in their blocks are multiples of this value.
+ *
+ * @public @memberof ccl_staging_allocator
+ *
+ * @param[in] sa Staging allocator.
+ * @return Alignment of slices in bytes.
+ * */
+CCL_EXPORT
+size_t ccl_staging_allocator_get_alignment(CCLStagingAllocator* sa) {
+
+	/* Make sure sa is not NULL. */
+	g_return_val_if_fail(sa != NULL, 0);
+
+	return sa->align;
+
+}
+
+/** @} */
@@ -0,0 +1,120 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Definition of an allocator of pinned host memory for staging
+ * transfers between host and device.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_STAGING_ALLOCATOR_H_
+#define _CCL_STAGING_ALLOCATOR_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_queue_wrapper.h"
+#include "ccl_buffer_wrapper.h"
+
+/**
+ * @defgroup CCL_STAGING_ALLOCATOR Staging allocators
+ *
+ * The staging allocator module provides a class which allocates
+ * pinned host memory for staging transfers between host and device.
+ *
+ * @warning The functions in this module are not thread-safe.
+ *
+ * Transfers with ccl_buffer_enqueue_read() and
+ * ccl_buffer_enqueue_write() from ordinary (pageable) host memory are
+ * usually performed by the OpenCL implementation through an internal
+ * pinned buffer, with an additional host copy. Most implementations
+ * allocate pinned memory for buffers created with
+ * `CL_MEM_ALLOC_HOST_PTR`, such that transfers from their mapped
+ * pointers are performed directly by DMA.
+ *
+ * The staging allocator creates such buffers (blocks), keeps them
+ * mapped during its lifetime, and hands out slices of the mapped
+ * memory with ccl_staging_allocator_alloc(). Slices are aligned to
+ * the `CL_DEVICE_MEM_BASE_ADDR_ALIGN` of the allocator's device and can
+ * be passed as host pointers to read and write commands. The block and
+ * offset of each slice are also made available. A block is reused once
+ * all of its slices are returned with ccl_staging_allocator_free().
+ * Slices larger than the block size get dedicated blocks, which are
+ * released when the slice is returned.
+ *
+ * A slice must not be returned while non-blocking transfers which use
+ * it are pending.
+ *
+ * _Example:_
+ *
+ * @code{.c}
+ * CCLStagingAllocator* sa;
+ * cl_float* hdata;
+ * @endcode
+ * @code{.c}
+ * sa = ccl_staging_allocator_new(queue, 16 * 1024 * 1024, NULL);
+ * @endcode
+ * @code{.c}
+ * hdata = ccl_staging_allocator_alloc(sa, n * sizeof(cl_float),
+ *     NULL, NULL, NULL);
+ * for (cl_uint i = 0; i < n; ++i) hdata[i] = i;
+ * ccl_buffer_enqueue_write(buf, queue, CL_TRUE, 0, n * sizeof(cl_float),
+ *     hdata, NULL, NULL);
+ * ccl_staging_allocator_free(sa, hdata);
+ * @endcode
+ * @code{.c}
+ * ccl_staging_allocator_destroy(sa);
+ * @endcode
+ *
+ * @{
+ */
+
+/**
+ * Staging allocator class.
+ * */
+typedef struct ccl_staging_allocator CCLStagingAllocator;
+
+/* Create a new staging allocator. */
+CCL_EXPORT
+CCLStagingAllocator* ccl_staging_allocator_new(CCLQueue* cq,
+	size_t block_size, CCLErr** err);
+
+/* Destroy a staging allocator. */
+CCL_EXPORT
+void ccl_staging_allocator_destroy(CCLStagingAllocator* sa);
+
+/* Allocate a slice of pinned host memory. */
+CCL_EXPORT
+void* ccl_staging_allocator_alloc(CCLStagingAllocator* sa, size_t size,
+	CCLBuffer** block, size_t* offset, CCLErr** err);
+
+/* Return a slice of pinned host memory to the allocator. */
+CCL_EXPORT
+void ccl_staging_allocator_free(CCLStagingAllocator* sa, void* ptr);
+
+/* Get the alignment of slices handed out by the allocator. */
+CCL_EXPORT
+size_t ccl_staging_allocator_get_alignment(CCLStagingAllocator* sa);
+
+/** @} */
+
+#endif
@@ -0,0 +1,665 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Implementation of classes and methods for streaming data through a
+ * kernel in fixed-size chunks.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#include "ccl_stream.h"
+#include "_ccl_kernel_wrapper.h"
+#include "_ccl_defs.h"
+
+/**
+ * @internal
+ * Maximum number of event wrappers kept by each of the stream's
+ * command queues, per slot.
+ * */
+#define CCL_STREAM_MAX_EVENTS_PER_SLOT 4
+
+/**
+ * @internal
+ * A slot in the ring of buffers managed by a stream.
+ * */
+typedef struct ccl_stream_slot {
+
+	/**
+	 * Input device buffer.
+	 * @private
+	 * */
+	CCLBuffer* dev_in;
+
+	/**
+	 * Output device buffer.
+	 * @private
+	 * */
+	CCLBuffer* dev_out;
+
+	/**
+	 * Input host staging slice.
+	 * @private
+	 * */
+	void* host_in;
+
+	/**
+	 * Output host staging slice.
+	 * @private
+	 * */
+	void* host_out;
+
+	/**
+	 * Kernel execution event, kept until the output is read.
+	 * @private
+	 * */
+	CCLEvent* evt_exec;
+
+	/**
+	 * Output read event, kept until the chunk is pulled.
+	 * @private
+	 * */
+	CCLEvent* evt_read;
+
+} CCLStreamSlot;
+
+/**
+ * Stream class.
+ * */
+struct ccl_stream {
+
+	/**
+	 * Command queue for transfers.
+	 * @private
+	 * */
+	CCLQueue* cq_transfer;
+
+	/**
+	 * Command queue for kernel executions.
+	 * @private
+	 * */
+	CCLQueue* cq_compute;
+
+	/**
+	 * Allocator of host staging slices.
+	 * @private
+	 * */
+	CCLStagingAllocator* staging;
+
+	/**
+	 * Kernel which processes each chunk, referenced by the stream.
+	 * @private
+	 * */
+	CCLKernel* krnl;
+
+	/**
+	 * Number of work dimensions.
+	 * @private
+	 * */
+	cl_uint work_dim;
+
+	/**
+	 * Global and local work sizes.
+	 * @private
+	 * */
+	size_t gws[3], lws[3];
+
+	/**
+	 * Was a local work size specified?
+	 * @private
+	 * */
+	cl_bool has_lws;
+
+	/**
+	 * Size of input chunks in bytes.
+	 * @private
+	 * */
+	size_t size_in;
+
+	/**
+	 * Size of output chunks in bytes.
+	 * @private
+	 * */
+	size_t size_out;
+
+	/**
+	 * Ring of slots.
+	 * @private
+	 * */
+	CCLStreamSlot* slots;
+
+	/**
+	 * Number of slots.
+	 * @private
+	 * */
+	cl_uint depth;
+
+	/**
+	 * Slot where the next chunk will be pushed.
+	 * @private
+	 * */
+	cl_uint head;
+
+	/**
+	 * Number of chunks pushed but not yet pulled.
+	 * @private
+	 * */
+	cl_uint num_pending;
+
+	/**
+	 * Reusable event wait list.
+	 * @private
+	 * */
+	CCLEventWaitList ewl;
+
+	/**
+	 * Storage for the reusable event wait list.
+	 * @private
+	 * */
+	CCLEventWaitListStorage ewl_storage;
+
+};
+
+/**
+ * @internal
+ * Enqueue the read of a slot's output, after the kernel execution which
+ * produces it.
+ *
+ * @param[in] stream Stream object.
+ * @param[in] slot Slot whose output is to be read.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+static cl_bool ccl_stream_enqueue_read(CCLStream* stream,
+	CCLStreamSlot* slot, CCLErr** err) {
+
+	/* Event wrapper. */
+	CCLEvent* evt;
+
+	/* Read output into staging buffer once it is produced. */
+	evt = ccl_buffer_enqueue_read(slot->dev_out, stream->cq_transfer,
+		CL_FALSE, 0, stream->size_out, slot->host_out,
+		ccl_ewl(&stream->ewl, slot->evt_exec, NULL), err);
+	if (evt == NULL) return CL_FALSE;
+
+	/* Keep read event until the chunk is pulled. */
+	ccl_event_set_name(evt, "STREAM_READ");
+	ccl_event_ref(evt);
+	slot->evt_read = evt;
+
+	/* The kernel execution event is no longer required. */
+	ccl_event_unref(slot->evt_exec);
+	slot->evt_exec = NULL;
+
+	return CL_TRUE;
+
+}
+
+/**
+ * @addtogroup CCL_STREAM
+ * @{
+ */
+
+/**
+ * Create a new stream object, together with its command queues and
+ * buffers.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] ctx Context wrapper object.
+ * @param[in] dev Device wrapper object, must be associated with `ctx`.
+ * @param[in] krnl Kernel which processes each chunk, taking the input
+ * and output buffers as its first two arguments. The stream keeps a
+ * reference to the kernel until it is destroyed.
+ * @param[in] work_dim The number of dimensions used to specify the
+ * global work-items and work-items in the work-group (between 1 and
+ * 3).
+ * @param[in] global_work_size Global work size used for each chunk.
+ * @param[in] local_work_size Local work size used for each chunk, or
+ * `NULL`.
+ * @param[in] chunk_size_in Size in bytes of input chunks.
+ * @param[in] chunk_size_out Size in bytes of output chunks.
+ * @param[in] depth Number of chunks which can be in flight, at least 2.
+ * @param[in] properties Properties of the stream's command queues.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return A new stream object, which should be destroyed with
+ * ccl_stream_destroy(), or `NULL` if an error occurs.
+ * */
+CCL_EXPORT
+CCLStream* ccl_stream_new(CCLContext* ctx, CCLDevice* dev,
+	CCLKernel* krnl, cl_uint work_dim, const size_t* global_work_size,
+	const size_t* local_work_size, size_t chunk_size_in,
+	size_t chunk_size_out, cl_uint depth,
+	cl_command_queue_properties properties, CCLErr** err) {
+
+	/* Make sure ctx is not NULL. */
+	g_return_val_if_fail(ctx != NULL, NULL);
+	/* Make sure dev is not NULL. */
+	g_return_val_if_fail(dev != NULL, NULL);
+	/* Make sure krnl is not NULL. */
+	g_return_val_if_fail(krnl != NULL, NULL);
+	/* Make sure work dimensions are valid. */
+	g_return_val_if_fail((work_dim >= 1) && (work_dim <= 3), NULL);
+	/* Make sure global_work_size is not NULL. */
+	g_return_val_if_fail(global_work_size != NULL, NULL);
+	/* Make sure chunk sizes are valid. */
+	g_return_val_if_fail((chunk_size_in > 0) && (chunk_size_out > 0), NULL);
+	/* Make sure there are at least two slots. */
+	g_return_val_if_fail(depth >= 2, NULL);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, NULL);
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Stream object. */
+	CCLStream* stream = g_slice_new0(CCLStream);
+
+	/* Keep kernel, work sizes and chunk sizes. */
+	stream->krnl = krnl;
+	ccl_kernel_ref(krnl);
+	stream->work_dim = work_dim;
+	stream->has_lws = (local_work_size != NULL);
+	for (cl_uint i = 0; i < work_dim; ++i) {
+		stream->gws[i] = global_work_size[i];
+		stream->lws[i] = stream->has_lws ? local_work_size[i] : 0;
+	}
+	stream->size_in = chunk_size_in;
+	stream->size_out = chunk_size_out;
+	stream->depth = depth;
+	stream->slots = g_new0(CCLStreamSlot, depth);
+	stream->ewl = ccl_event_wait_list_init(&stream->ewl_storage);
+
+	/* Create command queues, keeping a bounded number of events. */
+	stream->cq_transfer = ccl_queue_new(ctx, dev, properties, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_queue_set_max_events(stream->cq_transfer,
+		CCL_STREAM_MAX_EVENTS_PER_SLOT * depth, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	stream->cq_compute = ccl_queue_new(ctx, dev, properties, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_queue_set_max_events(stream->cq_compute,
+		CCL_STREAM_MAX_EVENTS_PER_SLOT * depth, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Create allocator of host staging slices, with a single block
+	 * for all slots if alignment allows it. */
+	stream->staging = ccl_staging_allocator_new(stream->cq_transfer,
+		depth * (chunk_size_in + chunk_size_out), &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* Create buffers of each slot. */
+	for (cl_uint i = 0; i < depth; ++i) {
+
+		CCLStreamSlot* slot = &stream->slots[i];
+
+		slot->dev_in = ccl_buffer_new(ctx, CL_MEM_READ_ONLY,
+			chunk_size_in, NULL, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		slot->dev_out = ccl_buffer_new(ctx, CL_MEM_WRITE_ONLY,
+			chunk_size_out, NULL, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		/* Host staging slices are taken from pinned host memory. */
+		slot->host_in = ccl_staging_allocator_alloc(stream->staging,
+			chunk_size_in, NULL, NULL, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		slot->host_out = ccl_staging_allocator_alloc(stream->staging,
+			chunk_size_out, NULL, NULL, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+	/* Destroy what was built for the stream. */
+	ccl_stream_destroy(stream);
+	stream = NULL;
+
+finish:
+
+	/* Return new stream. */
+	return stream;
+
+}
+
+/**
+ * Destroy a stream object, waiting for chunks in flight and releasing
+ * its command queues and buffers. Results of chunks which were not
+ * pulled are discarded.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] stream Stream object to destroy.
+ * */
+CCL_EXPORT
+void ccl_stream_destroy(CCLStream* stream) {
+
+	/* Stream object to destroy cannot be NULL. */
+	g_return_if_fail(stream != NULL);
+
+	/* Release events of slots. */
+	for (cl_uint i = 0; i < stream->depth; ++i) {
+
+		CCLStreamSlot* slot = &stream->slots[i];
+
+		if (slot->evt_exec != NULL) ccl_event_unref(slot->evt_exec);
+		if (slot->evt_read != NULL) ccl_event_unref(slot->evt_read);
+	}
+
+	/* Wait for all commands to complete. */
+	if (stream->cq_compute != NULL)
+		ccl_queue_finish(stream->cq_compute, NULL);
+	if (stream->cq_transfer != NULL)
+		ccl_queue_finish(stream->cq_transfer, NULL);
+
+	/* Release buffers and staging slices. */
+	for (cl_uint i = 0; i < stream->depth; ++i) {
+
+		CCLStreamSlot* slot = &stream->slots[i];
+
+		if (slot->dev_in != NULL) ccl_buffer_destroy(slot->dev_in);
+		if (slot->dev_out != NULL) ccl_buffer_destroy(slot->dev_out);
+		if (slot->host_in != NULL)
+			ccl_staging_allocator_free(stream->staging, slot->host_in);
+		if (slot->host_out != NULL)
+			ccl_staging_allocator_free(stream->staging, slot->host_out);
+	}
+	if (stream->staging != NULL)
+		ccl_staging_allocator_destroy(stream->staging);
+
+	/* Release command queues and kernel. */
+	if (stream->cq_compute != NULL) ccl_queue_destroy(stream->cq_compute);
+	if (stream->cq_transfer != NULL) ccl_queue_destroy(stream->cq_transfer);
+	if (stream->krnl != NULL) ccl_kernel_unref(stream->krnl);
+
+	/* Release remaining stream resources. */
+	ccl_event_wait_list_dispose(&stream->ewl);
+	g_free(stream->slots);
+	g_slice_free(CCLStream, stream);
+
+}
+
+/**
+ * Check if a chunk can be pushed into the stream, i.e. if less than
+ * `depth` chunks are in flight. If not, a chunk must be pulled with
+ * ccl_stream_pull() before another one is pushed.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] stream Stream object.
+ * @return `CL_TRUE` if a chunk can be pushed, `CL_FALSE` otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_stream_can_push(CCLStream* stream) {
+
+	/* Make sure stream is not NULL. */
+	g_return_val_if_fail(stream != NULL, CL_FALSE);
+
+	return stream->num_pending < stream->depth;
+
+}
+
+/**
+ * Push a chunk into the stream. The chunk is copied into a host
+ * staging buffer, and its write, processing and read are enqueued
+ * without blocking. The read of the previous chunk is only enqueued
+ * at this point, after the write of this chunk, so that the write of a
+ * chunk overlaps with the processing of the previous one.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] stream Stream object, where a chunk can be pushed (see
+ * ccl_stream_can_push()).
+ * @param[in] data Chunk data.
+ * @param[in] size Size of chunk data in bytes, at most the input chunk
+ * size. The kernel is executed with the same work size regardless of
+ * this value.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_stream_push(CCLStream* stream, const void* data,
+	size_t size, CCLErr** err) {
+
+	/* Make sure stream is not NULL. */
+	g_return_val_if_fail(stream != NULL, CL_FALSE);
+	/* Make sure there is space for another chunk. */
+	g_return_val_if_fail(ccl_stream_can_push(stream), CL_FALSE);
+	/* Make sure data is valid. */
+	g_return_val_if_fail((data != NULL) && (size > 0)
+		&& (size <= stream->size_in), CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+	/* Current and previous slots. */
+	CCLStreamSlot* slot = &stream->slots[stream->head];
+	CCLStreamSlot* prev =
+		&stream->slots[(stream->head + stream->depth - 1) % stream->depth];
+	/* Event wrappers. */
+	CCLEvent* evt_write;
+	CCLEvent* evt_exec;
+	/* OpenCL memory objects of current slot. */
+	cl_mem mem_in = ccl_memobj_unwrap(slot->dev_in);
+	cl_mem mem_out = ccl_memobj_unwrap(slot->dev_out);
+
+	/* Write chunk to device from staging buffer. */
+	memcpy(slot->host_in, data, size);
+	evt_write = ccl_buffer_enqueue_write(slot->dev_in, stream->cq_transfer,
+		CL_FALSE, 0, size, slot->host_in, NULL, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_event_set_name(evt_write, "STREAM_WRITE");
+
+	/* Process chunk once it is written. */
+	ccl_kernel_set_arg_value_full(
+		stream->krnl, 0, sizeof(cl_mem), &mem_in, CL_TRUE);
+	ccl_kernel_set_arg_value_full(
+		stream->krnl, 1, sizeof(cl_mem), &mem_out, CL_TRUE);
+	evt_exec = ccl_kernel_enqueue_ndrange(stream->krnl, stream->cq_compute,
+		stream->work_dim, NULL, stream->gws,
+		stream->has_lws ? stream->lws : NULL,
+		ccl_ewl(&stream->ewl, evt_write, NULL), &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_event_set_name(evt_exec, "STREAM_EXEC");
+	ccl_event_ref(evt_exec);
+	slot->evt_exec = evt_exec;
+
+	/* Read output of the previous chunk, if it is still in flight. */
+	if (prev->evt_exec != NULL) {
+		ccl_stream_enqueue_read(stream, prev, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+	}
+
+	/* Advance ring. */
+	stream->head = (stream->head + 1) % stream->depth;
+	stream->num_pending++;
+
+	/* Submit commands to the device. */
+	ccl_queue_flush(stream->cq_transfer, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_queue_flush(stream->cq_compute, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Pull the result of the oldest chunk pushed into the stream, blocking
+ * until it is available.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] stream Stream object, with at least one chunk in flight
+ * (see ccl_stream_get_num_pending()).
+ * @param[out] data Location where to copy the output chunk, with space
+ * for the output chunk size, or `NULL` if the result is to be
+ * discarded.
+ * @param[out] err Return location for a ::CCLErr object, or `NULL` if error
+ * reporting is to be ignored.
+ * @return `CL_TRUE` if operation is successful, or `CL_FALSE`
+ * otherwise.
+ * */
+CCL_EXPORT
+cl_bool ccl_stream_pull(CCLStream* stream, void* data, CCLErr** err) {
+
+	/* Make sure stream is not NULL. */
+	g_return_val_if_fail(stream != NULL, CL_FALSE);
+	/* Make sure there are chunks in flight. */
+	g_return_val_if_fail(stream->num_pending > 0, CL_FALSE);
+	/* Make sure err is NULL or it is not set. */
+	g_return_val_if_fail(err == NULL || *err == NULL, CL_FALSE);
+
+	/* Trace host call. */
+	CCL_HOST_TRACE_BEGIN();
+
+	/* Internal error object. */
+	CCLErr* err_internal = NULL;
+	/* Function return status. */
+	cl_bool ret_status;
+	/* Slot of oldest chunk. */
+	CCLStreamSlot* slot = &stream->slots[
+		(stream->head + stream->depth - stream->num_pending)
+		% stream->depth];
+
+	/* Enqueue read if it was not enqueued yet, i.e. if no chunk was
+	 * pushed after this one. */
+	if (slot->evt_read == NULL) {
+		ccl_stream_enqueue_read(stream, slot, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+	}
+
+	/* Wait for read to complete. */
+	ccl_event_wait(ccl_ewl(&stream->ewl, slot->evt_read, NULL),
+		&err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	ccl_event_unref(slot->evt_read);
+	slot->evt_read = NULL;
+	stream->num_pending--;
+
+	/* Copy output from staging buffer. */
+	if (data != NULL)
+		memcpy(data, slot->host_out, stream->size_out);
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	ret_status = CL_TRUE;
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+	ret_status = CL_FALSE;
+
+finish:
+
+	/* Record host call. */
+	CCL_HOST_TRACE_END(NULL);
+
+	/* Return status. */
+	return ret_status;
+
+}
+
+/**
+ * Get the number of chunks pushed into the stream but not yet pulled.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] stream Stream object.
+ * @return Number of chunks in flight.
+ * */
+CCL_EXPORT
+cl_uint ccl_stream_get_num_pending(CCLStream* stream) {
+
+	/* Make sure stream is not NULL. */
+	g_return_val_if_fail(stream != NULL, 0);
+
+	return stream->num_pending;
+
+}
+
+/**
+ * Add the stream's command queues to a profile object, named "Stream
+ * transfer" and "Stream compute". The time spent in each stage is
+ * reported in the aggregate table of the profile object under the
+ * "STREAM_WRITE", "STREAM_EXEC" and "STREAM_READ" event names, and the
+ * overlap between stages is reported in its overlap table.
+ *
+ * @public @memberof ccl_stream
+ *
+ * @param[in] stream Stream object.
+ * @param[in] prof Profile object.
+ * */
+CCL_EXPORT
+void ccl_stream_add_to_prof(CCLStream* stream, CCLProf* prof) {
+
+	/* Make sure stream is not NULL. */
+	g_return_if_fail(stream != NULL);
+	/* Make sure prof is not NULL. */
+	g_return_if_fail(prof != NULL);
+
+	ccl_prof_add_queue(prof, "Stream transfer", stream->cq_transfer);
+	ccl_prof_add_queue(prof, "Stream compute", stream->cq_compute);
+
+}
+
+/** @} */
@@ -0,0 +1,146 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with cf4ocl. If not, see
+ * <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ *
+ * Definition of classes and methods for streaming data through a
+ * kernel in fixed-size chunks.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU Lesser General Public License version 3 (LGPLv3)](http://www.gnu.org/licenses/lgpl.html)
+ * */
+
+#ifndef _CCL_STREAM_H_
+#define _CCL_STREAM_H_
+
+#include "ccl_common.h"
+#include "ccl_errors.h"
+#include "ccl_context_wrapper.h"
+#include "ccl_kernel_wrapper.h"
+#include "ccl_buffer_wrapper.h"
+#include "ccl_profiler.h"
+#include "ccl_staging_allocator.h"
+
+/**
+ * @defgroup CCL_STREAM Streams
+ *
+ * The stream module provides a class for streaming large datasets
+ * through a kernel in fixed-size chunks, overlapping host-device
+ * transfers with kernel execution.
+ *
+ * @warning The functions in this module are not thread-safe.
+ *
+ * A stream manages a ring of `depth` slots (2 for double buffering, 3
+ * for triple buffering, and so on). Each slot has an input and an
+ * output device buffer, and an input and an output host staging
+ * slice, taken from a @ref CCL_STAGING_ALLOCATOR "staging allocator",
+ * so that transfers are performed from pinned host memory whenever the
+ * OpenCL implementation supports it. Transfers are enqueued in a
+ * transfer queue and kernel executions in a separate compute queue, so
+ * that, in steady state, chunk _N+1_ is written while chunk _N_ is
+ * processed and chunk _N-1_ is read.
+ *
+ * Chunks are pushed with ::ccl_stream_push(), and the respective
+ * results are pulled, in the same order, with ::ccl_stream_pull(). At
+ * most `depth` chunks can be in flight, i.e. pushed but not yet
+ * pulled: when ::ccl_stream_can_push() returns `CL_FALSE`, a chunk
+ * must be pulled before another one is pushed.
+ *
+ * The kernel must take the input and output buffers as its first two
+ * arguments. These are set by the stream for each chunk, while the
+ * remaining arguments must be set by client code with
+ * ::ccl_kernel_set_arg() before chunks are pushed.
+ *
+ * Events produced by the stream are named "STREAM_WRITE",
+ * "STREAM_EXEC" and "STREAM_READ". If the stream's queues are created
+ * with the `CL_QUEUE_PROFILING_ENABLE` property, they can be added to
+ * a @ref CCL_PROFILER "profile object" with ::ccl_stream_add_to_prof(),
+ * so that the time spent in each stage and the overlap between stages
+ * can be analyzed. The queues keep a bounded number of events, such
+ * that memory usage does not grow with the number of chunks.
+ *
+ * _Example:_
+ *
+ * @code{.c}
+ * CCLStream* stream;
+ * size_t gws = CHUNK_SIZE / sizeof(cl_float);
+ * @endcode
+ * @code{.c}
+ * stream = ccl_stream_new(ctx, dev, krnl, 1, &gws, NULL,
+ *     CHUNK_SIZE, CHUNK_SIZE, 3, CL_QUEUE_PROFILING_ENABLE, NULL);
+ * @endcode
+ * @code{.c}
+ * for (i = 0; i < num_chunks; ++i) {
+ *     if (!ccl_stream_can_push(stream))
+ *         ccl_stream_pull(stream, out + j++ * CHUNK_SIZE, NULL);
+ *     ccl_stream_push(stream, in + i * CHUNK_SIZE, CHUNK_SIZE, NULL);
+ * }
+ * while (ccl_stream_get_num_pending(stream) > 0)
+ *     ccl_stream_pull(stream, out + j++ * CHUNK_SIZE, NULL);
+ * @endcode
+ * @code{.c}
+ * ccl_stream_destroy(stream);
+ * @endcode
+ *
+ * @{
+ */
+
+/**
+ * Stream class.
+ * */
+typedef struct ccl_stream CCLStream;
+
+/* Create a new stream object. */
+CCL_EXPORT
+CCLStream* ccl_stream_new(CCLContext* ctx, CCLDevice* dev,
+	CCLKernel* krnl, cl_uint work_dim, const size_t* global_work_size,
+	const size_t* local_work_size, size_t chunk_size_in,
+	size_t chunk_size_out, cl_uint depth,
+	cl_command_queue_properties properties, CCLErr** err);
+
+/* Destroy a stream object. */
+CCL_EXPORT
+void ccl_stream_destroy(CCLStream* stream);
+
+/* Check if a chunk can be pushed into the stream. */
+CCL_EXPORT
+cl_bool ccl_stream_can_push(CCLStream* stream);
+
+/* Push a chunk into the stream. */
+CCL_EXPORT
+cl_bool ccl_stream_push(CCLStream* stream, const void* data,
+	size_t size, CCLErr** err);
+
+/* Pull the result of the oldest chunk pushed into the stream. */
+CCL_EXPORT
+cl_bool ccl_stream_pull(CCLStream* stream, void* data, CCLErr** err);
+
+/* Get the number of chunks pushed into the stream but not yet
+ * pulled. */
+CCL_EXPORT
+cl_uint ccl_stream_get_num_pending(CCLStream* stream);
+
+/* Add the stream's command queues to a profile object. */
+CCL_EXPORT
+void ccl_stream_add_to_prof(CCLStream* stream, CCLProf* prof);
+
+/** @} */
+
+#endif
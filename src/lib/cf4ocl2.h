@@ -33,7 +33,9 @@ extern "C" {
 #endif
 
 #include <cf4ocl2/ccl_abstract_wrapper.h>
+#include <cf4ocl2/ccl_buffer_pool.h>
 #include <cf4ocl2/ccl_buffer_wrapper.h>
+#include <cf4ocl2/ccl_command_graph.h>
 #include <cf4ocl2/ccl_common.h>
 #include <cf4ocl2/ccl_context_wrapper.h>
 #include <cf4ocl2/ccl_device_query.h>
@@ -52,6 +54,9 @@ extern "C" {
 #include <cf4ocl2/ccl_program_wrapper.h>
 #include <cf4ocl2/ccl_queue_wrapper.h>
 #include <cf4ocl2/ccl_sampler_wrapper.h>
+#include <cf4ocl2/ccl_scheduler.h>
+#include <cf4ocl2/ccl_staging_allocator.h>
+#include <cf4ocl2/ccl_stream.h>
 
 #ifdef __cplusplus
 }
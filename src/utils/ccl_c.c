@@ -45,6 +45,11 @@
  * <dd>List available devices and exit.</dd>
  * <dt>-d, --device=DEV</dt>
  * <dd>Specify a device on which to perform the task.</dd>
+ * <dt>-p, --parallel</dt>
+ * <dd>Build for all devices in the platform of the specified device, in
+ * parallel (build task only). Binary output and build log files are saved
+ * with the index of the device in the platform appended to the file
+ * name.</dd>
  * <dt>-t, --task=TASK</dt>
  * <dd>0 (Build, default), 1 (Compile) or 2 (Link). Tasks 1 and 2 are only
  * available for platforms with support for OpenCL 1.2 or higher.</dd>
@@ -129,6 +134,7 @@ typedef enum ccl_c_tasks {
 /* Command line arguments and respective default values. */
 static gboolean opt_list = FALSE;
 static guint dev_idx = CCL_UTILS_NODEVICE;
+static gboolean parallel = FALSE;
 static guint task = CCL_C_BUILD;
 static gchar* options = NULL;
 static gchar** src_files = NULL;
@@ -146,6 +152,9 @@ static GOptionEntry entries[] = {
 	 "List available devices and exit.",                          NULL},
 	{"device",               'd', 0, G_OPTION_ARG_INT,            &dev_idx,
 	 "Specify a device on which to perform the task.",            "DEV"},
+	{"parallel",             'p', 0, G_OPTION_ARG_NONE,           &parallel,
+	 "Build for all devices in the platform of the specified device, in "
+	 "parallel (build task only).",                               NULL},
 	{"task",                 't', 0, G_OPTION_ARG_INT,            &task,
 	 "0 (Build, default), 1 (Compile) or 2 (Link). Tasks 1 and 2 are only "
 	 "available for platforms with support for OpenCL 1.2 or higher.",
@@ -345,6 +354,160 @@ finish:
 
 }
 
+/**
+ * Show the result of a task for a device, namely build status and log,
+ * and optionally save the binary and show kernel information.
+ *
+ * @param[in] prg Program object, or `NULL` if it is not available.
+ * @param[in] dev Device for which the task was performed.
+ * @param[in] err_build Build/compile/link error, if any.
+ * @param[in] bin_out Binary output file, or `NULL`.
+ * @param[in] log_out Build log output file, or `NULL` to print the build
+ * log to stderr.
+ * @param[out] err Return location for a CCLErr object.
+ * */
+void ccl_c_task_report(CCLProgram* prg, CCLDevice* dev, CCLErr* err_build,
+	const char* bin_out, const char* log_out, CCLErr** err) {
+
+	/* Device name. */
+	char* dname;
+
+	/* Build status. */
+	cl_build_status build_status;
+
+	/* Build status string. */
+	const char* build_status_str;
+
+	/* Build log. */
+	const char* build_log;
+
+	/* Number of kernel names. */
+	guint n_kernel_names;
+
+	/* Internal error handling object. */
+	CCLErr* err_internal = NULL;
+
+	/* Get and show device name. */
+	dname = ccl_device_get_info_array(
+		dev, CL_DEVICE_NAME, char*, &err_internal);
+	g_if_err_propagate_goto(err, err_internal, error_handler);
+	g_printf("* Device                 : %s\n", dname);
+
+	/* Ir program object exists... */
+	if (prg) {
+
+		/* ...get build status and build status string. */
+		build_status = ccl_program_get_build_info_scalar(prg, dev,
+			CL_PROGRAM_BUILD_STATUS, cl_build_status, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		build_status_str = ccl_c_get_build_status_str(build_status);
+
+	} else {
+
+		/* If program object does not exist, set build status string to
+		 * unavailable. */
+		build_status = CL_BUILD_NONE;
+		build_status_str = "Unavailable";
+
+	}
+
+	/* Show build status. */
+	g_printf("* Build status           : %s\n", build_status_str);
+
+	/* If build successful, save binary? */
+	if (bin_out && prg && (build_status == CL_BUILD_SUCCESS)) {
+
+		ccl_program_save_binary(prg, dev, bin_out, &err_internal);
+		g_if_err_propagate_goto(err, err_internal, error_handler);
+		g_printf("* Binary output file     : %s\n", bin_out);
+
+	}
+
+	/* Show build error message, if any. */
+	if (err_build) {
+		g_printf("* Additional information : %s\n", err_build->message);
+	}
+
+	/* Show kernel information? */
+	if (kernel_names && !err_build) {
+
+		/* Cycle through kernel names. */
+		n_kernel_names = g_strv_length(kernel_names);
+		for (guint i = 0; i < n_kernel_names; i++) {
+
+			/* Show information for current kernel name. */
+			g_printf("* Kernel information     : %s\n", kernel_names[i]);
+			ccl_c_kernel_info_show(prg, dev, kernel_names[i], &err_internal);
+			g_if_err_propagate_goto(err, err_internal, error_handler);
+
+		}
+	}
+
+	/* Show build log, if any. */
+	g_printf("* Build log              :");
+	if (!prg) {
+
+		/* No build log if program object does not exist. */
+		g_printf(" Unavailable.\n");
+
+	} else {
+
+		/* Get build log. */
+		build_log = ccl_program_get_device_build_log(
+			prg, dev, &err_internal);
+		if (err_internal) {
+
+			/* Not possible to retrieve build log due to error. */
+			g_info("Unable to retrieve build log. %s",
+				err_internal->message);
+			g_clear_error(&err_internal);
+
+		}
+
+		/* If build log was retrieved successfully and has length greater
+		 * than zero, output it. */
+		if ((build_log) && (strlen(build_log) > 0)) {
+
+			/* Should we output print log to file or to stderr? */
+			if (log_out) {
+
+				/* Output to file. */
+				g_printf(" Saved to %s.\n", log_out);
+				g_file_set_contents(log_out, build_log, -1, &err_internal);
+				g_if_err_propagate_goto(err, err_internal, error_handler);
+
+			} else {
+
+				/* Output to stderr. */
+				g_printf(" Printed to error output stream.\n");
+				g_fprintf(stderr, "\n%s\n", build_log);
+
+			}
+
+		} else {
+
+			/* No build log or build log is empty. */
+			g_printf(" Empty.\n");
+
+		}
+	}
+
+	/* If we got here, everything is OK. */
+	g_assert(err == NULL || *err == NULL);
+	goto finish;
+
+error_handler:
+
+	/* If we got here there was an error, verify that it is so. */
+	g_assert(err == NULL || *err != NULL);
+
+finish:
+
+	/* Return. */
+	return;
+
+}
+
 /**
  * Kernel analyzer main program function.
  *
@@ -365,8 +528,7 @@ int main(int argc, char* argv[]) {
 	guint i = 0;
 
 	/* Number of types of files, file names and kernel names. */
-	guint n_src_files, n_bin_files, n_src_h_files,
-		n_src_h_names, n_kernel_names;
+	guint n_src_files, n_bin_files, n_src_h_files, n_src_h_names;
 
 	/* Context wrapper. */
 	CCLContext* ctx = NULL;
@@ -374,8 +536,8 @@ int main(int argc, char* argv[]) {
 	/* Device wrapper. */
 	CCLDevice* dev = NULL;
 
-	/* Device name. */
-	char* dname;
+	/* Number of devices in context. */
+	cl_uint n_devs = 1;
 
 	/* Main program wrapper. */
 	CCLProgram* prg = NULL;
@@ -386,14 +548,21 @@ int main(int argc, char* argv[]) {
 	/* Array containing multiple program wrappers. */
 	GPtrArray* prgs = NULL;
 
-	/* Build status. */
-	cl_build_status build_status;
+	/* Build future for parallel builds. */
+	CCLProgramBuildFuture* fut = NULL;
 
-	/* Build status string. */
-	const char* build_status_str;
+	/* Build error for individual devices in parallel builds. */
+	CCLErr* err_dev = NULL;
 
-	/* Build log. */
-	const char* build_log;
+	/* Output files for individual devices in parallel builds. */
+	gchar* bin_out;
+	gchar* log_out;
+
+	/* Platform wrapper, used for parallel builds. */
+	CCLPlatform* platf = NULL;
+
+	/* Devices in platform, used for parallel builds. */
+	CCLDevice* const* devs;
 
 	/* Parse command line options. */
 	ccl_c_args_parse(argc, argv, &err);
@@ -429,7 +598,6 @@ int main(int argc, char* argv[]) {
 		n_bin_files = bin_files != NULL ? g_strv_length(bin_files) : 0;
 		n_src_h_files = src_h_files != NULL ? g_strv_length(src_h_files) : 0;
 		n_src_h_names = src_h_names != NULL ? g_strv_length(src_h_names) : 0;
-		n_kernel_names = kernel_names != NULL ? g_strv_length(kernel_names) : 0;
 
 		/* Select a context/device. */
 		if (dev_idx == CCL_UTILS_NODEVICE) {
@@ -443,6 +611,33 @@ int main(int argc, char* argv[]) {
 		dev = ccl_context_get_device(ctx, 0, &err);
 		g_if_err_goto(err, error_handler);
 
+		/* In parallel mode, replace context with one containing all
+		 * devices in the platform of the selected device. */
+		if (parallel) {
+
+			/* Parallel mode is only available for the build task. */
+			g_if_err_create_goto(err, CCL_ERROR, task != CCL_C_BUILD,
+				CCL_ERROR_ARGS, error_handler,
+				"Parallel mode is only available for the 'build' task.");
+
+			/* Get platform of selected device and create a context
+			 * with all its devices. */
+			platf = ccl_platform_new_from_device(dev, &err);
+			g_if_err_goto(err, error_handler);
+			n_devs = ccl_platform_get_num_devices(platf, &err);
+			g_if_err_goto(err, error_handler);
+			devs = ccl_platform_get_all_devices(platf, &err);
+			g_if_err_goto(err, error_handler);
+			ccl_context_destroy(ctx);
+			ctx = ccl_context_new_from_devices(n_devs, devs, &err);
+			g_if_err_goto(err, error_handler);
+
+			/* Get first device. */
+			dev = ccl_context_get_device(ctx, 0, &err);
+			g_if_err_goto(err, error_handler);
+
+		}
+
 		 /* Perform task. */
 		switch (task) {
 			case CCL_C_BUILD:
@@ -458,6 +653,13 @@ int main(int argc, char* argv[]) {
 					CCL_ERROR_ARGS, error_handler,
 					"The 'build' task accepts at most one binary file.");
 
+				/* A binary is specific to a device, so it can't be built
+				 * for all devices. */
+				g_if_err_create_goto(err, CCL_ERROR,
+					parallel && (n_bin_files > 0),
+					CCL_ERROR_ARGS, error_handler,
+					"Parallel mode requires source files.");
+
 				/* Input headers are not accepted by the compile task. */
 				g_if_err_create_goto(err, CCL_ERROR,
 					(n_src_h_files > 0) || (n_src_h_names > 0),
@@ -482,12 +684,24 @@ int main(int argc, char* argv[]) {
 				g_if_err_goto(err, error_handler);
 
 				/* Build program. */
-				ccl_program_build(prg, options, &err_build);
+				if (parallel) {
 
-				/* Only check for errors that are not build/compile/link
-				 * failures. */
-				if (!ccl_c_is_build_error(err_build)) {
-					g_if_err_propagate_goto(&err, err_build, error_handler);
+					/* In parallel mode, start building for all devices
+					 * and check results as each device finishes. */
+					fut = ccl_program_build_async(
+						prg, 0, NULL, options, &err);
+					g_if_err_goto(err, error_handler);
+
+				} else {
+
+					ccl_program_build(prg, options, &err_build);
+
+					/* Only check for errors that are not
+					 * build/compile/link failures. */
+					if (!ccl_c_is_build_error(err_build)) {
+						g_if_err_propagate_goto(
+							&err, err_build, error_handler);
+					}
 				}
 
 				break;
@@ -600,105 +814,54 @@ int main(int argc, char* argv[]) {
 					task);
 		}
 
-		/* Get and show device name. */
-		dname = ccl_device_get_info_array(dev, CL_DEVICE_NAME, char*, &err);
-		g_if_err_goto(err, error_handler);
-		g_printf("* Device                 : %s\n", dname);
+		/* Show results. */
+		if (fut) {
 
-		/* Ir program object exists... */
-		if (prg) {
+			/* In parallel mode, show results for each device as soon
+			 * as its build is finished. */
+			for (i = 0; i < n_devs; i++) {
 
-			/* ...get build status and build status string. */
-			build_status = ccl_program_get_build_info_scalar(prg, dev,
-				CL_PROGRAM_BUILD_STATUS, cl_build_status, &err);
-			g_if_err_goto(err, error_handler);
-			build_status_str = ccl_c_get_build_status_str(build_status);
-
-		} else {
-
-			/* If program object does not exist, set build status string to
-			 * unavailable. */
-			build_status = CL_BUILD_NONE;
-			build_status_str = "Unavailable";
-
-		}
-
-		/* Show build status. */
-		g_printf("* Build status           : %s\n", build_status_str);
-
-		/* If build successful, save binary? */
-		if (output && prg && (build_status == CL_BUILD_SUCCESS)) {
-
-			ccl_program_save_binary(prg, dev, output, &err);
-			g_if_err_goto(err, error_handler);
-			g_printf("* Binary output file     : %s\n", output);
-
-		}
-
-		/* Show build error message, if any. */
-		if (err_build) {
-			g_printf("* Additional information : %s\n", err_build->message);
-		}
-
-		/* Show kernel information? */
-		if (kernel_names && !err_build) {
-
-			/* Cycle through kernel names. */
-			for (i = 0; i < n_kernel_names; i++) {
-
-				/* Show information for current kernel name. */
-				g_printf("* Kernel information     : %s\n", kernel_names[i]);
-				ccl_c_kernel_info_show(prg, dev, kernel_names[i], &err);
+				/* Get device. */
+				dev = ccl_context_get_device(ctx, i, &err);
 				g_if_err_goto(err, error_handler);
 
-			}
-		}
-
-		/* Show build log, if any. */
-		g_printf("* Build log              :");
-		if (!prg) {
+				/* Wait for build of current device. */
+				ccl_program_build_future_wait(fut, dev, &err_dev);
 
-			/* No build log if program object does not exist. */
-			g_printf(" Unavailable.\n");
-
-		} else {
-
-			/* Get build log. */
-			build_log = ccl_program_get_device_build_log(prg, dev, &err);
-			if (err) {
-
-				/* Not possible to retrieve build log due to error. */
-				g_info("Unable to retrieve build log. %s", err->message);
-				g_clear_error(&err);
-
-			}
-
-			/* If build log was retrieved successfully and has length greater
-			 * than zero, output it. */
-			if ((build_log) && (strlen(build_log) > 0)) {
-
-				/* Should we output print log to file or to stderr? */
-				if (bld_log_out) {
+				/* Only check for errors that are not build failures. */
+				if (!ccl_c_is_build_error(err_dev)) {
+					g_if_err_propagate_goto(&err, err_dev, error_handler);
+				}
 
-					/* Output to file. */
-					g_printf(" Saved to %s.\n", bld_log_out);
-					g_file_set_contents(bld_log_out, build_log, -1, &err);
-					g_if_err_goto(err, error_handler);
+				/* Output files for current device. */
+				bin_out = output
+					? g_strdup_printf("%s.%u", output, i) : NULL;
+				log_out = bld_log_out
+					? g_strdup_printf("%s.%u", bld_log_out, i) : NULL;
+
+				/* Show results for current device. */
+				g_printf("\n");
+				ccl_c_task_report(prg, dev, err_dev, bin_out, log_out, &err);
+				g_free(bin_out);
+				g_free(log_out);
+				g_if_err_goto(err, error_handler);
 
+				/* Keep first build error to determine exit status. */
+				if (err_build == NULL) {
+					err_build = err_dev;
 				} else {
-
-					/* Output to stderr. */
-					g_printf(" Printed to error output stream.\n");
-					g_fprintf(stderr, "\n%s\n", build_log);
-
+					g_clear_error(&err_dev);
 				}
+				err_dev = NULL;
 
-			} else {
+			}
 
-				/* No build log or build log is empty. */
-				g_printf(" Empty.\n");
+		} else {
+
+			ccl_c_task_report(
+				prg, dev, err_build, output, bld_log_out, &err);
+			g_if_err_goto(err, error_handler);
 
-			}
 		}
 
 	}
@@ -726,6 +889,9 @@ cleanup:
 
 	/* Free stuff! */
 	g_clear_error(&err_build);
+	g_clear_error(&err_dev);
+	if (fut) ccl_program_build_future_destroy(fut);
+	if (platf) ccl_platform_destroy(platf);
 	if (src_files) g_strfreev(src_files);
 	if (src_h_files) g_strfreev(src_h_files);
 	if (src_h_names) g_strfreev(src_h_names);
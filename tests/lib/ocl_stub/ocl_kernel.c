@@ -45,6 +45,54 @@ clCreateKernel(cl_program program, const char* kernel_name,
 
 }
 
+CL_API_ENTRY cl_int CL_API_CALL
+clCreateKernelsInProgram(cl_program program, cl_uint num_kernels,
+	cl_kernel* kernels, cl_uint* num_kernels_ret) {
+
+	cl_int status = CL_SUCCESS;
+	GRegex* regex;
+	GMatchInfo* match_info = NULL;
+	GPtrArray* names = g_ptr_array_new_with_free_func(g_free);
+
+	if (program == NULL) {
+		status = CL_INVALID_PROGRAM;
+		goto finish;
+	}
+
+	/* Find kernel functions in source code. */
+	if (program->source != NULL) {
+		regex = g_regex_new("kernel\\s+void\\s+(\\w+)", 0, 0, NULL);
+		g_regex_match(regex, program->source, 0, &match_info);
+		while (g_match_info_matches(match_info)) {
+			g_ptr_array_add(names, g_match_info_fetch(match_info, 1));
+			g_match_info_next(match_info, NULL);
+		}
+		g_match_info_free(match_info);
+		g_regex_unref(regex);
+	}
+
+	if ((kernels != NULL) && (num_kernels < names->len)) {
+		status = CL_INVALID_VALUE;
+		goto finish;
+	}
+
+	/* Create kernels. */
+	if (kernels != NULL) {
+		for (guint i = 0; i < names->len; ++i) {
+			kernels[i] = clCreateKernel(program,
+				g_intern_string(g_ptr_array_index(names, i)), NULL);
+		}
+	}
+	if (num_kernels_ret != NULL)
+		*num_kernels_ret = names->len;
+
+finish:
+
+	g_ptr_array_free(names, TRUE);
+	return status;
+
+}
+
 CL_API_ENTRY cl_int CL_API_CALL
 clSetKernelArg(cl_kernel kernel, cl_uint arg_index, size_t arg_size,
 	const void* arg_value) {
@@ -0,0 +1,185 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Test the buffer pool class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+/**
+ * Tests allocating, releasing and recycling buffers, as well as pool
+ * statistics.
+ * */
+static void alloc_release_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBufferPool* pool = NULL;
+	CCLBuffer *a, *b, *c, *d, *e, *f, *g;
+	CCLEvent* uevt = NULL;
+	CCLBufferPoolStats stats;
+	CCLErr* err = NULL;
+	size_t align;
+	cl_uchar* hbuf_in;
+	cl_uchar* hbuf_out;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+
+	/* Backing buffers must hold at least one sub-buffer. */
+	pool = ccl_buffer_pool_new(ctx, CL_MEM_READ_WRITE, 0, &err);
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+	g_assert(pool == NULL);
+	g_clear_error(&err);
+
+	align = ccl_device_get_info_scalar(
+		dev, CL_DEVICE_MEM_BASE_ADDR_ALIGN, cl_uint, &err) / 8;
+	g_assert_no_error(err);
+
+	/* Create a pool with very small backing buffers, with room for
+	 * eight sub-buffers of the smallest size class. */
+	pool = ccl_buffer_pool_new(ctx, CL_MEM_READ_WRITE, 8 * align, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(ccl_buffer_pool_get_alignment(pool), >=, align);
+	align = ccl_buffer_pool_get_alignment(pool);
+
+	/* Allocate buffers in the two smallest size classes. */
+	a = ccl_buffer_pool_alloc(pool, 1, &err);
+	g_assert_no_error(err);
+	b = ccl_buffer_pool_alloc(pool, align + 1, &err);
+	g_assert_no_error(err);
+	g_assert(a != b);
+
+	/* A buffer released without events is immediately recycled. */
+	ccl_buffer_pool_release(pool, a, NULL);
+	c = ccl_buffer_pool_alloc(pool, 1, &err);
+	g_assert_no_error(err);
+	g_assert(c == a);
+
+	/* Check that recycled sub-buffers hold data. */
+	hbuf_in = g_new(cl_uchar, align);
+	hbuf_out = g_new0(cl_uchar, align);
+	for (size_t i = 0; i < align; ++i)
+		hbuf_in[i] = (cl_uchar) g_test_rand_int();
+	ccl_buffer_enqueue_write(c, cq, CL_TRUE, 0, align, hbuf_in, NULL, &err);
+	g_assert_no_error(err);
+	ccl_buffer_enqueue_read(c, cq, CL_TRUE, 0, align, hbuf_out, NULL, &err);
+	g_assert_no_error(err);
+	for (size_t i = 0; i < align; ++i)
+		g_assert_cmpuint(hbuf_out[i], ==, hbuf_in[i]);
+	g_free(hbuf_in);
+	g_free(hbuf_out);
+
+	/* A buffer released with an event is only recycled after the event
+	 * completes. */
+	uevt = ccl_user_event_new(ctx, &err);
+	g_assert_no_error(err);
+	ccl_buffer_pool_release(pool, b, uevt);
+
+	d = ccl_buffer_pool_alloc(pool, align + 1, &err);
+	g_assert_no_error(err);
+	g_assert(d != b);
+
+	ccl_user_event_set_status(uevt, CL_COMPLETE, &err);
+	g_assert_no_error(err);
+	ccl_buffer_pool_release(pool, d, NULL);
+
+	e = ccl_buffer_pool_alloc(pool, align + 1, &err);
+	g_assert_no_error(err);
+	g_assert(e == b);
+
+	/* Allocations larger than backing buffers get dedicated buffers. */
+	f = ccl_buffer_pool_alloc(pool, 8 * align + 1, &err);
+	g_assert_no_error(err);
+	ccl_buffer_pool_release(pool, f, NULL);
+
+	/* Allocating four times the alignment doesn't fit in the first
+	 * backing buffer, where five times the alignment was already
+	 * used. */
+	g = ccl_buffer_pool_alloc(pool, 4 * align, &err);
+	g_assert_no_error(err);
+
+	/* Check statistics. */
+	ccl_buffer_pool_get_stats(pool, &stats);
+	g_assert_cmpuint(stats.num_allocs, ==, 7);
+	g_assert_cmpuint(stats.num_hits, ==, 2);
+	g_assert_cmpfloat(stats.hit_rate, ==, 2.0 / 7.0);
+	g_assert_cmpuint(stats.num_blocks, ==, 2);
+	g_assert_cmpuint(stats.bytes_reserved, ==, 16 * align);
+	g_assert_cmpuint(stats.bytes_in_use, ==, 7 * align);
+	g_assert_cmpuint(stats.bytes_requested, ==, 5 * align + 2);
+	g_assert_cmpuint(stats.bytes_cached, ==, 2 * align);
+	g_assert_cmpuint(stats.bytes_wasted, ==, 3 * align);
+	g_assert_cmpfloat(stats.external_frag, ==, 3.0 / 16.0);
+	g_assert_cmpfloat(stats.internal_frag, >, 0.0);
+
+	/* Return all buffers to the pool. */
+	ccl_buffer_pool_release(pool, c, NULL);
+	ccl_buffer_pool_release(pool, e, NULL);
+	ccl_buffer_pool_release(pool, g, NULL);
+
+	ccl_buffer_pool_get_stats(pool, &stats);
+	g_assert_cmpuint(stats.bytes_in_use, ==, 0);
+	g_assert_cmpuint(stats.bytes_requested, ==, 0);
+	g_assert_cmpuint(stats.bytes_cached, ==, 9 * align);
+
+	/* Release pool and wrappers. */
+	ccl_buffer_pool_destroy(pool);
+	ccl_event_destroy(uevt);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char** argv) {
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func(
+		"/buffer-pool/alloc-release",
+		alloc_release_test);
+
+	return g_test_run();
+}
@@ -0,0 +1,332 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Test the command graph class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+#define CCL_TEST_COMMAND_GRAPH_BUF_SIZE 64
+
+#define CCL_TEST_COMMAND_GRAPH_KERNEL_NAME "cg_inc"
+
+#define CCL_TEST_COMMAND_GRAPH_KERNEL_CONTENT \
+	"__kernel void " CCL_TEST_COMMAND_GRAPH_KERNEL_NAME "(" \
+	"		__global uint *buf, uint x)" \
+	"{" \
+	"	buf[get_global_id(0)] += x;" \
+	"}"
+
+/**
+ * Tests recording and replaying transfers in two queues, swapping
+ * memory objects between replays.
+ * */
+static void transfers_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* queues[2] = { NULL, NULL };
+	CCLBuffer* bufs[3] = { NULL, NULL, NULL };
+	CCLCommandGraph* cg = NULL;
+	CCLErr* err = NULL;
+	cl_uint hbuf_in[CCL_TEST_COMMAND_GRAPH_BUF_SIZE];
+	cl_uint hbuf_out[CCL_TEST_COMMAND_GRAPH_BUF_SIZE];
+	cl_uint hbuf_aux[CCL_TEST_COMMAND_GRAPH_BUF_SIZE];
+	size_t buf_size = CCL_TEST_COMMAND_GRAPH_BUF_SIZE * sizeof(cl_uint);
+	cl_int cmd_write, cmd_copy, cmd_read, cmd_wait;
+	cl_bool status;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create two command queues, one of them in untracked mode. */
+	for (cl_uint i = 0; i < 2; ++i) {
+		queues[i] = ccl_queue_new(ctx, dev, 0, &err);
+		g_assert_no_error(err);
+	}
+	ccl_queue_set_untracked(queues[1], CL_TRUE);
+
+	/* Create device buffers. */
+	for (cl_uint i = 0; i < 3; ++i) {
+		bufs[i] = ccl_buffer_new(
+			ctx, CL_MEM_READ_WRITE, buf_size, NULL, &err);
+		g_assert_no_error(err);
+	}
+
+	/* Record commands: write to the first buffer, copy it to the second
+	 * buffer in the other queue, read the second buffer and wait for
+	 * the read. */
+	cg = ccl_command_graph_new();
+	g_assert(cg != NULL);
+
+	cmd_write = ccl_command_graph_add_buffer_write(cg, 0, bufs[0],
+		CL_FALSE, 0, buf_size, hbuf_in, 0, NULL);
+	g_assert_cmpint(cmd_write, ==, 0);
+
+	cmd_copy = ccl_command_graph_add_buffer_copy(cg, 1, bufs[0], bufs[1],
+		0, 0, buf_size, 1, &cmd_write);
+	g_assert_cmpint(cmd_copy, ==, 1);
+
+	cmd_read = ccl_command_graph_add_buffer_read(cg, 0, bufs[1],
+		CL_FALSE, 0, buf_size, hbuf_out, 1, &cmd_copy);
+	g_assert_cmpint(cmd_read, ==, 2);
+
+	cmd_wait = ccl_command_graph_add_wait(cg, 1, &cmd_read);
+	g_assert_cmpint(cmd_wait, ==, 3);
+
+	g_assert_cmpuint(ccl_command_graph_get_num_commands(cg), ==, 4);
+
+	/* Replay graph a few times, checking results. */
+	for (cl_uint r = 0; r < 3; ++r) {
+
+		for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i) {
+			hbuf_in[i] = (cl_uint) g_test_rand_int();
+			hbuf_out[i] = 0;
+		}
+
+		status = ccl_command_graph_replay(cg, queues, 2, NULL, &err);
+		g_assert_no_error(err);
+		g_assert(status);
+
+		for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i)
+			g_assert_cmpuint(hbuf_out[i], ==, hbuf_in[i]);
+
+	}
+
+	/* Copy from the first to the third buffer from now on. */
+	ccl_command_graph_swap_memobjs(
+		cg, (CCLMemObj*) bufs[1], (CCLMemObj*) bufs[2]);
+
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i) {
+		hbuf_aux[i] = hbuf_in[i];
+		hbuf_in[i] = ~hbuf_in[i];
+	}
+
+	status = ccl_command_graph_replay(cg, queues, 2, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(status);
+
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i)
+		g_assert_cmpuint(hbuf_out[i], ==, hbuf_in[i]);
+
+	/* The second buffer should keep the data of the previous replay. */
+	ccl_buffer_enqueue_read(bufs[1], queues[0], CL_TRUE, 0, buf_size,
+		hbuf_out, NULL, &err);
+	g_assert_no_error(err);
+
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i)
+		g_assert_cmpuint(hbuf_out[i], ==, hbuf_aux[i]);
+
+	/* The untracked queue should have kept the last copy event. */
+	g_assert(ccl_queue_get_last_event(queues[1]) != NULL);
+
+	/* Release client references to the buffers used by the graph, and
+	 * swap them, i.e. write to the third buffer and copy it to the
+	 * first one. The graph keeps two references to each buffer. */
+	ccl_buffer_destroy(bufs[0]);
+	ccl_buffer_destroy(bufs[2]);
+	ccl_command_graph_swap_memobjs(
+		cg, (CCLMemObj*) bufs[0], (CCLMemObj*) bufs[2]);
+	g_assert_cmpint(ccl_wrapper_ref_count((CCLWrapper*) bufs[0]), ==, 2);
+	g_assert_cmpint(ccl_wrapper_ref_count((CCLWrapper*) bufs[2]), ==, 2);
+
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i) {
+		hbuf_in[i] = (cl_uint) g_test_rand_int();
+		hbuf_out[i] = 0;
+	}
+
+	status = ccl_command_graph_replay(cg, queues, 2, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(status);
+
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i)
+		g_assert_cmpuint(hbuf_out[i], ==, hbuf_in[i]);
+
+	/* Replaying with less queues than required should fail. */
+	status = ccl_command_graph_replay(cg, queues, 1, NULL, &err);
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+	g_assert(!status);
+	g_clear_error(&err);
+
+	/* Wait for any pending commands. */
+	for (cl_uint i = 0; i < 2; ++i) {
+		ccl_queue_finish(queues[i], &err);
+		g_assert_no_error(err);
+	}
+
+	/* Release graph and wrappers. The first and third buffers are
+	 * released with the graph. */
+	ccl_command_graph_destroy(cg);
+	ccl_buffer_destroy(bufs[1]);
+	for (cl_uint i = 0; i < 2; ++i)
+		ccl_queue_destroy(queues[i]);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Tests recording and replaying kernel executions, updating kernel
+ * arguments between replays.
+ * */
+static void kernel_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBuffer* buf = NULL;
+	CCLProgram* prg = NULL;
+	CCLKernel* krnl = NULL;
+	CCLCommandGraph* cg = NULL;
+	CCLErr* err = NULL;
+	cl_uint hbuf[CCL_TEST_COMMAND_GRAPH_BUF_SIZE];
+	size_t buf_size = CCL_TEST_COMMAND_GRAPH_BUF_SIZE * sizeof(cl_uint);
+	size_t gws = CCL_TEST_COMMAND_GRAPH_BUF_SIZE;
+	cl_uint x = 3, y = 5;
+	cl_int cmd_krnl, cmd_read;
+	void* args[3];
+	cl_bool status;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create and initialize device buffer. */
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i)
+		hbuf[i] = i;
+	buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+		buf_size, hbuf, &err);
+	g_assert_no_error(err);
+
+	/* Create and build program, get kernel. */
+	prg = ccl_program_new_from_source(
+		ctx, CCL_TEST_COMMAND_GRAPH_KERNEL_CONTENT, &err);
+	g_assert_no_error(err);
+
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+
+	krnl = ccl_program_get_kernel(
+		prg, CCL_TEST_COMMAND_GRAPH_KERNEL_NAME, &err);
+	g_assert_no_error(err);
+
+	/* Record commands: execute kernel, then read results. */
+	cg = ccl_command_graph_new();
+
+	args[0] = buf;
+	args[1] = ccl_arg_priv(x, cl_uint);
+	args[2] = NULL;
+	cmd_krnl = ccl_command_graph_add_kernel(
+		cg, 0, krnl, 1, NULL, &gws, NULL, args, 0, NULL);
+	g_assert_cmpint(cmd_krnl, >=, 0);
+
+	cmd_read = ccl_command_graph_add_buffer_read(
+		cg, 0, buf, CL_TRUE, 0, buf_size, hbuf, 1, &cmd_krnl);
+	g_assert_cmpint(cmd_read, >=, 0);
+
+	/* The graph keeps one reference to the buffer for each command
+	 * which uses it, also when the argument is set again. */
+	g_assert_cmpint(ccl_wrapper_ref_count((CCLWrapper*) buf), ==, 3);
+	ccl_command_graph_set_kernel_arg(cg, cmd_krnl, 0, buf);
+	g_assert_cmpint(ccl_wrapper_ref_count((CCLWrapper*) buf), ==, 3);
+
+	/* Replay graph a few times. */
+	for (cl_uint r = 0; r < 3; ++r) {
+		status = ccl_command_graph_replay(cg, &cq, 1, NULL, &err);
+		g_assert_no_error(err);
+		g_assert(status);
+	}
+
+	/* Update private kernel argument and replay again. */
+	ccl_command_graph_set_kernel_arg(
+		cg, cmd_krnl, 1, ccl_arg_priv(y, cl_uint));
+	status = ccl_command_graph_replay(cg, &cq, 1, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(status);
+
+#ifndef OPENCL_STUB
+
+	/* Check results. */
+	for (cl_uint i = 0; i < CCL_TEST_COMMAND_GRAPH_BUF_SIZE; ++i)
+		g_assert_cmpuint(hbuf[i], ==, i + 3 * x + y);
+
+#endif
+
+	/* The graph can still be replayed once client code releases its
+	 * reference to the buffer. */
+	ccl_buffer_destroy(buf);
+	status = ccl_command_graph_replay(cg, &cq, 1, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(status);
+
+	/* Release graph and wrappers. */
+	ccl_command_graph_destroy(cg);
+	ccl_program_destroy(prg);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char** argv) {
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func(
+		"/command-graph/transfers",
+		transfers_test);
+
+	g_test_add_func(
+		"/command-graph/kernel",
+		kernel_test);
+
+	return g_test_run();
+}
@@ -222,6 +222,199 @@ static void sub_devices_test() {
 
 }
 
+/**
+ * Tests caching of device information, which does not change during
+ * the lifetime of the device.
+ * */
+static void info_cache_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLErr* err = NULL;
+	CCLWrapperInfo* info1 = NULL;
+	CCLWrapperInfo* info2 = NULL;
+	cl_uint cu1, cu2;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Repeated queries should return the same cached information. */
+	info1 = ccl_device_get_info(dev, CL_DEVICE_NAME, &err);
+	g_assert_no_error(err);
+	info2 = ccl_device_get_info(dev, CL_DEVICE_NAME, &err);
+	g_assert_no_error(err);
+	g_assert(info1 == info2);
+	g_assert_cmpstr((char*) info1->value, ==, (char*) info2->value);
+
+	/* The same applies to scalar queries, which should agree with
+	 * the generic query. */
+	cu1 = ccl_device_get_info_scalar(
+		dev, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err);
+	g_assert_no_error(err);
+	cu2 = ccl_device_get_info_scalar(
+		dev, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(cu1, ==, cu2);
+	info1 = ccl_device_get_info(dev, CL_DEVICE_MAX_COMPUTE_UNITS, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(*((cl_uint*) info1->value), ==, cu1);
+
+	/* Information which may change should be queried again. */
+	info1 = ccl_device_get_info(dev, CL_DEVICE_AVAILABLE, &err);
+	g_assert_no_error(err);
+	info2 = ccl_device_get_info(dev, CL_DEVICE_AVAILABLE, &err);
+	g_assert_no_error(err);
+	g_assert(info1 != info2);
+
+	/* Invalid queries should fail every time, returning zero. */
+	cu1 = ccl_device_get_info_scalar(dev, 0, cl_uint, &err);
+	g_assert_error(err, CCL_OCL_ERROR, CL_INVALID_VALUE);
+	g_assert_cmpuint(cu1, ==, 0);
+	g_clear_error(&err);
+	cu1 = ccl_device_get_info_scalar(dev, 0, cl_uint, &err);
+	g_assert_error(err, CCL_OCL_ERROR, CL_INVALID_VALUE);
+	g_clear_error(&err);
+
+	/* Destroy stuff. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/* Number of information queries performed by each thread in the
+ * multi-threaded information cache test. */
+#define CCL_TEST_DEVICE_MT_NUMQUERIES 16384
+
+/* Number of information queries performed by each thread in the
+ * multi-threaded information cache test, when performance tests are
+ * enabled. */
+#define CCL_TEST_DEVICE_MT_NUMQUERIES_PERF 4194304
+
+/* Maximum number of threads in the multi-threaded information cache
+ * test. */
+#define CCL_TEST_DEVICE_MT_MAXTHREADS 16
+
+/**
+ * Data for each thread in the multi-threaded information cache test.
+ * */
+typedef struct ccl_test_device_mt_data {
+
+	/* Device shared by all threads. */
+	CCLDevice* dev;
+
+	/* Number of queries to perform. */
+	guint num_queries;
+
+	/* Expected number of compute units. */
+	cl_uint compute_units;
+
+	/* Expected maximum work-group size. */
+	size_t max_wgsize;
+
+} CCLTestDeviceMTData;
+
+/**
+ * Thread function for multi-threaded information cache test. Queries
+ * cached scalar information about a device shared by all threads.
+ * */
+static gpointer info_cache_mt_thread(gpointer data) {
+
+	CCLTestDeviceMTData* td = (CCLTestDeviceMTData*) data;
+	CCLErr* err = NULL;
+
+	for (guint i = 0; i < td->num_queries; i += 2) {
+
+		cl_uint cu = ccl_device_get_info_scalar(
+			td->dev, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err);
+		size_t wgs = ccl_device_get_info_scalar(
+			td->dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err);
+		g_assert_no_error(err);
+		g_assert_cmpuint(cu, ==, td->compute_units);
+		g_assert_cmpuint(wgs, ==, td->max_wgsize);
+	}
+
+	return NULL;
+}
+
+/**
+ * Tests concurrent queries of cached device information by several
+ * threads. When performance tests are enabled (`-m perf`), the number
+ * of queries per second is reported for an increasing number of
+ * threads.
+ * */
+static void info_cache_mt_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLErr* err = NULL;
+	GThread* threads[CCL_TEST_DEVICE_MT_MAXTHREADS];
+	CCLTestDeviceMTData tdata;
+	GTimer* timer;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context, and the expected values. */
+	tdata.dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+	tdata.num_queries = g_test_perf()
+		? CCL_TEST_DEVICE_MT_NUMQUERIES_PERF
+		: CCL_TEST_DEVICE_MT_NUMQUERIES;
+	tdata.compute_units = ccl_device_get_info_scalar(
+		tdata.dev, CL_DEVICE_MAX_COMPUTE_UNITS, cl_uint, &err);
+	g_assert_no_error(err);
+	tdata.max_wgsize = ccl_device_get_info_scalar(
+		tdata.dev, CL_DEVICE_MAX_WORK_GROUP_SIZE, size_t, &err);
+	g_assert_no_error(err);
+
+	timer = g_timer_new();
+
+	/* Test with 1, 2, 4, ..., CCL_TEST_DEVICE_MT_MAXTHREADS threads. */
+	for (guint nt = 1; nt <= CCL_TEST_DEVICE_MT_MAXTHREADS; nt *= 2) {
+
+		/* Start threads. */
+		g_timer_start(timer);
+		for (guint i = 0; i < nt; ++i) {
+			threads[i] = g_thread_new(
+				"info_cache_mt", info_cache_mt_thread, &tdata);
+		}
+
+		/* Wait for threads to finish. */
+		for (guint i = 0; i < nt; ++i) {
+			g_thread_join(threads[i]);
+		}
+		g_timer_stop(timer);
+
+		/* Report throughput. */
+		if (g_test_perf()) {
+			g_test_maximized_result(
+				nt * tdata.num_queries / g_timer_elapsed(timer, NULL),
+				"%2u thread(s): %.0f queries/s", nt,
+				nt * tdata.num_queries / g_timer_elapsed(timer, NULL));
+		}
+	}
+
+	g_timer_destroy(timer);
+
+	/* Destroy stuff. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
 /**
  * Main function.
  * @param[in] argc Number of command line arguments.
@@ -236,6 +429,14 @@ int main(int argc, char** argv) {
 		"/wrappers/device/sub-devices",
 		sub_devices_test);
 
+	g_test_add_func(
+		"/wrappers/device/info-cache",
+		info_cache_test);
+
+	g_test_add_func(
+		"/wrappers/device/info-cache-mt",
+		info_cache_mt_test);
+
 	return g_test_run();
 }
 
@@ -135,6 +135,18 @@ static void create_info_destroy_test() {
 	/* Check that start time occurs before end time. */
 	g_assert_cmpuint(*((cl_ulong*) info->value), <=, time_end);
 
+	/* Check that all information obtained in a single pass matches
+	 * the information obtained separately. */
+	CCLEventRecord rec;
+	ccl_event_get_timestamps(evt, &rec, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(rec.command_type, ==, CL_COMMAND_WRITE_BUFFER);
+	g_assert_cmpuint(rec.t_start, ==, *((cl_ulong*) info->value));
+	g_assert_cmpuint(rec.t_end, ==, time_end);
+	g_assert_cmpuint(rec.t_queued, <=, rec.t_submit);
+	g_assert_cmpuint(rec.t_submit, <=, rec.t_start);
+	g_assert_cmpstr(rec.event_name, ==, ccl_event_get_final_name(evt));
+
 	/* Release wrappers. */
 	ccl_event_destroy(evt);
 	ccl_buffer_destroy(buf);
@@ -515,6 +527,128 @@ static void event_wait_lists_test() {
 
 }
 
+/**
+ * Reusable event wait lists test.
+ * */
+static void event_wait_lists_reuse_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBuffer* buf = NULL;
+	CCLEvent* evts[20];
+	CCLErr* err = NULL;
+	cl_uint host_buf[20];
+	CCLEventWaitListStorage ewl_storage;
+	CCLEventWaitList ewl = NULL;
+	CCLEventWaitList ewl_dyn = NULL;
+	const cl_event* clevent_ptr;
+	cl_uint num_evts;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a device buffer. */
+	buf = ccl_buffer_new(
+		ctx, CL_MEM_READ_WRITE, 20 * sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+
+	/* Initialize reusable event wait list. */
+	ewl = ccl_event_wait_list_init(&ewl_storage);
+	g_assert(ewl == &ewl_storage);
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+	g_assert_cmpuint(num_evts, ==, 0);
+	clevent_ptr = ccl_event_wait_list_get_clevents(ewl_test_aux(&ewl));
+	g_assert(clevent_ptr == NULL);
+
+	/* Add more events than fit in the list's inline storage. */
+	for (cl_uint i = 0; i < 20; ++i) {
+		host_buf[i] = i;
+		evts[i] = ccl_buffer_enqueue_write(buf, cq, CL_FALSE,
+			i * sizeof(cl_uint), sizeof(cl_uint), &host_buf[i], NULL, &err);
+		g_assert_no_error(err);
+		ccl_event_wait_list_add(&ewl, evts[i], NULL);
+	}
+
+	/* Check that the events are in the list, in order. */
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+	g_assert_cmpuint(num_evts, ==, 20);
+	clevent_ptr = ccl_event_wait_list_get_clevents(ewl_test_aux(&ewl));
+	for (cl_uint i = 0; i < 20; ++i)
+		g_assert(clevent_ptr[i] == ccl_event_unwrap(evts[i]));
+
+	/* Wait on events, list should be emptied but not released. */
+	ccl_event_wait(&ewl, &err);
+	g_assert_no_error(err);
+	g_assert(ewl == &ewl_storage);
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+	g_assert_cmpuint(num_evts, ==, 0);
+
+	/* Reuse list in an enqueue function. */
+	ccl_buffer_enqueue_read(buf, cq, CL_TRUE, 0, 20 * sizeof(cl_uint),
+		host_buf, ccl_ewl(&ewl, evts[19], NULL), &err);
+	g_assert_no_error(err);
+	g_assert(ewl == &ewl_storage);
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+	g_assert_cmpuint(num_evts, ==, 0);
+
+	/* In keep mode, the list should be left intact until reset. */
+	ccl_event_wait_list_set_keep(&ewl, CL_TRUE);
+	ccl_event_wait_list_add(&ewl, evts[0], evts[1], NULL);
+	ccl_event_wait(&ewl, &err);
+	g_assert_no_error(err);
+	ccl_event_wait(&ewl, &err);
+	g_assert_no_error(err);
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+	g_assert_cmpuint(num_evts, ==, 2);
+	ccl_event_wait_list_reset(&ewl);
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl));
+	g_assert_cmpuint(num_evts, ==, 0);
+
+	/* Release the list. */
+	ccl_event_wait_list_dispose(&ewl);
+	g_assert(ewl == NULL);
+
+	/* Dynamically allocated lists can also be placed in keep mode. */
+	ccl_event_wait_list_set_keep(&ewl_dyn, CL_TRUE);
+	g_assert(ewl_dyn != NULL);
+	ccl_event_wait_list_add(&ewl_dyn, evts[2], NULL);
+	ccl_event_wait(&ewl_dyn, &err);
+	g_assert_no_error(err);
+	num_evts = ccl_event_wait_list_get_num_events(ewl_test_aux(&ewl_dyn));
+	g_assert_cmpuint(num_evts, ==, 1);
+	ccl_event_wait_list_dispose(&ewl_dyn);
+	g_assert(ewl_dyn == NULL);
+
+#ifndef OPENCL_STUB
+
+	/* Check that buffer was properly written. */
+	for (cl_uint i = 0; i < 20; ++i)
+		g_assert_cmpuint(host_buf[i], ==, i);
+
+#endif
+
+	/* Release wrappers. */
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
 /**
  * Main function.
  * @param[in] argc Number of command line arguments.
@@ -548,6 +682,10 @@ int main(int argc, char** argv) {
 		"/wrappers/event/wait-lists",
 		event_wait_lists_test);
 
+	g_test_add_func(
+		"/wrappers/event/wait-lists-reuse",
+		event_wait_lists_reuse_test);
+
 	return g_test_run();
 }
 
@@ -25,6 +25,7 @@
  * */
 
 #include <cf4ocl2.h>
+#include <glib/gstdio.h>
 #include "test.h"
 
 #define CCL_TEST_KERNEL_NAME "test_krnl"
@@ -41,6 +42,10 @@
 #define CCL_TEST_KERNEL_LWS 8 /* Must be a divisor of CCL_TEST_KERNEL_BUF_SIZE */
 G_STATIC_ASSERT(CCL_TEST_KERNEL_BUF_SIZE % CCL_TEST_KERNEL_LWS == 0);
 
+/* Temporary tuning database used by the tests, so that they neither
+ * depend on nor change the user's tuning database. */
+static gchar* test_tuning_db_file = NULL;
+
 /**
  * Tests creation, getting info from and destruction of
  * kernel wrapper objects.
@@ -413,6 +418,7 @@ static void suggest_worksizes_aux(CCLDevice* dev, CCLKernel* krnl) {
 	/* Test variables. */
 	CCLErr* err = NULL;
 	size_t rws[3], gws[3], lws[3], lws_max[3];
+	size_t gws_prev[3], lws_prev[3];
 
 	/* Perform test 20 times with different values. */
 	for (cl_uint i = 0; i < 200; ++i) {
@@ -464,6 +470,37 @@ static void suggest_worksizes_aux(CCLDevice* dev, CCLKernel* krnl) {
 		g_assert_cmpuint(lws[0], <=, lws_max[0]);
 		check_dev_limits(dev, 1, lws);
 
+		/* 5. Request for global work size and local work sizes given a
+		 * real work size, using the occupancy cost model. Repeated
+		 * requests give the same result. */
+		WS_INIT(lws, 0, 0, 0);
+		WS_INIT(rws, RAND_RWS, 0, 0);
+		ccl_kernel_suggest_worksizes_full(krnl, dev, 1, rws, gws, lws,
+			CCL_WORKSIZE_OCCUPANCY, &err);
+		g_assert_no_error(err);
+		g_assert_cmpuint(gws[0], >=, rws[0]);
+		g_assert_cmpuint(gws[0] % lws[0], ==, 0);
+		check_dev_limits(dev, 1, lws);
+		WS_INIT(gws_prev, gws[0], 0, 0);
+		WS_INIT(lws_prev, lws[0], 0, 0);
+		WS_INIT(lws, 0, 0, 0);
+		ccl_kernel_suggest_worksizes_full(krnl, dev, 1, rws, gws, lws,
+			CCL_WORKSIZE_OCCUPANCY, &err);
+		g_assert_no_error(err);
+		g_assert_cmpuint(gws[0], ==, gws_prev[0]);
+		g_assert_cmpuint(lws[0], ==, lws_prev[0]);
+
+		/* 6. Request a local work size, forcing the global work size to
+		 * be equal to the real work size, using the occupancy cost
+		 * model. */
+		WS_INIT(lws, 0, 0, 0);
+		WS_INIT(rws, RAND_RWS, 0, 0);
+		ccl_kernel_suggest_worksizes_full(krnl, dev, 1, rws, NULL, lws,
+			CCL_WORKSIZE_OCCUPANCY, &err);
+		g_assert_no_error(err);
+		g_assert_cmpuint(rws[0] % lws[0], ==, 0);
+		check_dev_limits(dev, 1, lws);
+
 		/* ************************* */
 		/* ******* 2-D tests ******* */
 		/* ************************* */
@@ -582,10 +619,77 @@ static void suggest_worksizes_aux(CCLDevice* dev, CCLKernel* krnl) {
 		g_assert_cmpuint(lws[2], <=, lws_max[2]);
 		check_dev_limits(dev, 3, lws);
 
+		/* 5. Request for global work size and local work sizes given a
+		 * real work size and a maximum local work size, using the
+		 * occupancy cost model. */
+		WS_INIT(lws_max, RAND_LWS, RAND_LWS, RAND_LWS);
+		memcpy(lws, lws_max, 3 * sizeof(size_t));
+		WS_INIT(rws, RAND_RWS, RAND_RWS, RAND_RWS);
+		ccl_kernel_suggest_worksizes_full(krnl, dev, 3, rws, gws, lws,
+			CCL_WORKSIZE_OCCUPANCY, &err);
+		g_assert_no_error(err);
+		g_assert_cmpuint(gws[0], >=, rws[0]);
+		g_assert_cmpuint(gws[1], >=, rws[1]);
+		g_assert_cmpuint(gws[2], >=, rws[2]);
+		g_assert_cmpuint(gws[0] % lws[0], ==, 0);
+		g_assert_cmpuint(gws[1] % lws[1], ==, 0);
+		g_assert_cmpuint(gws[2] % lws[2], ==, 0);
+		g_assert_cmpuint(lws[0], <=, lws_max[0]);
+		g_assert_cmpuint(lws[1], <=, lws_max[1]);
+		g_assert_cmpuint(lws[2], <=, lws_max[2]);
+		check_dev_limits(dev, 3, lws);
+
 	}
 
 }
 
+#ifndef OPENCL_STUB
+
+/** Number of real work sizes for which suggestions are requested
+ * concurrently, more than the suggestions cached by a kernel. */
+#define CCL_TEST_KERNEL_WS_NUM 200
+
+/** Number of threads requesting suggestions concurrently. */
+#define CCL_TEST_KERNEL_WS_THREADS 4
+
+/**
+ * Data for threads of suggest_worksizes_test().
+ * */
+typedef struct {
+	CCLDevice* dev;
+	CCLKernel* krnl;
+	const size_t* gws;
+	const size_t* lws;
+} CCLTestKernelWs;
+
+/**
+ * Thread function for suggest_worksizes_test(), which checks that
+ * suggestions for the same kernel obtained concurrently are the
+ * expected ones.
+ * */
+static gpointer suggest_worksizes_thread(gpointer data) {
+
+	CCLTestKernelWs* td = (CCLTestKernelWs*) data;
+	CCLErr* err = NULL;
+	size_t rws, gws, lws;
+
+	for (cl_uint r = 0; r < 10; ++r) {
+		for (cl_uint i = 0; i < CCL_TEST_KERNEL_WS_NUM; ++i) {
+			rws = i + 1;
+			lws = 0;
+			ccl_kernel_suggest_worksizes(
+				td->krnl, td->dev, 1, &rws, &gws, &lws, &err);
+			g_assert_no_error(err);
+			g_assert_cmpuint(gws, ==, td->gws[i]);
+			g_assert_cmpuint(lws, ==, td->lws[i]);
+		}
+	}
+
+	return NULL;
+}
+
+#endif
+
 /**
  * Tests the ::ccl_kernel_suggest_worksizes() function.
  *
@@ -631,6 +735,25 @@ static void suggest_worksizes_test() {
 	/* Test with non-NULL kernel. */
 	suggest_worksizes_aux(dev, krnl);
 
+	/* Test concurrent suggestions for the same kernel, comparing them
+	 * with suggestions obtained sequentially. */
+	size_t exp_gws[CCL_TEST_KERNEL_WS_NUM];
+	size_t exp_lws[CCL_TEST_KERNEL_WS_NUM];
+	GThread* threads[CCL_TEST_KERNEL_WS_THREADS];
+	CCLTestKernelWs td = { dev, krnl, exp_gws, exp_lws };
+
+	for (cl_uint i = 0; i < CCL_TEST_KERNEL_WS_NUM; ++i) {
+		size_t rws = i + 1;
+		exp_lws[i] = 0;
+		ccl_kernel_suggest_worksizes(
+			krnl, dev, 1, &rws, &exp_gws[i], &exp_lws[i], &err);
+		g_assert_no_error(err);
+	}
+	for (cl_uint t = 0; t < CCL_TEST_KERNEL_WS_THREADS; ++t)
+		threads[t] = g_thread_new(NULL, suggest_worksizes_thread, &td);
+	for (cl_uint t = 0; t < CCL_TEST_KERNEL_WS_THREADS; ++t)
+		g_thread_join(threads[t]);
+
 	/* Destroy program. */
 	ccl_program_destroy(prg);
 
@@ -644,6 +767,152 @@ static void suggest_worksizes_test() {
 	g_assert(ccl_wrapper_memcheck());
 }
 
+/**
+ * Tests the ::ccl_kernel_autotune() function and the use of the tuning
+ * database by ::ccl_kernel_suggest_worksizes().
+ * */
+static void autotune_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLProgram* prg = NULL;
+	CCLKernel* krnl = NULL;
+	CCLBuffer* buf = NULL;
+	CCLErr* err = NULL;
+	gchar* db_dir;
+	gchar* db_file;
+	size_t rws = CCL_TEST_KERNEL_BUF_SIZE;
+	size_t lws;
+
+	/* Use a tuning database in a temp. dir. */
+	db_dir = g_dir_make_tmp("test_kernel_tuning_XXXXXX", &err);
+	g_assert_no_error(err);
+	db_file = g_build_filename(db_dir, "tuning.ini", NULL);
+	ccl_kernel_set_tuning_db(db_file);
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create and build program. */
+	prg = ccl_program_new_from_source(ctx, CCL_TEST_KERNEL_CONTENT, &err);
+	g_assert_no_error(err);
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+
+	/* Get kernel wrapper object and set its argument. */
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_KERNEL_NAME, &err);
+	g_assert_no_error(err);
+	buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE,
+		CCL_TEST_KERNEL_BUF_SIZE * sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+	ccl_kernel_set_args(krnl, buf, NULL);
+
+	/* Autotuning requires a command queue with profiling enabled. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+	lws = 0;
+	g_assert(!ccl_kernel_autotune(krnl, cq, 1, &rws, NULL, &lws, 2, &err));
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+	g_clear_error(&err);
+	g_assert(!g_file_test(db_file, G_FILE_TEST_EXISTS));
+	ccl_queue_destroy(cq);
+
+#ifndef OPENCL_STUB
+
+	/* Kernel info is not functional with the OCL stub, so this
+	 * part of the test will only take place with a real OCL
+	 * implementation. */
+
+	size_t lws_sugg, lws_heur;
+	gchar* empty_db_file;
+
+	cq = ccl_queue_new(ctx, dev, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+
+	/* Get (and cache) heuristic suggestion before autotuning. */
+	lws_heur = 0;
+	ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, NULL, &lws_heur, &err);
+	g_assert_no_error(err);
+
+	/* The test kernel does not check if its global ID is within
+	 * bounds, so the global work size must be the real work size. */
+	lws = 0;
+	ccl_kernel_autotune(krnl, cq, 1, &rws, NULL, &lws, 3, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(lws, >, 0);
+	g_assert_cmpuint(rws % lws, ==, 0);
+	check_dev_limits(dev, 1, &lws);
+	g_assert(g_file_test(db_file, G_FILE_TEST_EXISTS));
+
+	/* Suggestions use the tuned local work size... */
+	lws_sugg = 0;
+	ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, NULL, &lws_sugg, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(lws_sugg, ==, lws);
+
+	/* ...also when the tuning database is reloaded from its file... */
+	ccl_kernel_set_tuning_db(db_file);
+	lws_sugg = 0;
+	ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, NULL, &lws_sugg, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(lws_sugg, ==, lws);
+
+	/* ...but not when another tuning database is used... */
+	empty_db_file = g_build_filename(db_dir, "empty.ini", NULL);
+	ccl_kernel_set_tuning_db(empty_db_file);
+	lws_sugg = 0;
+	ccl_kernel_suggest_worksizes(krnl, dev, 1, &rws, NULL, &lws_sugg, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(lws_sugg, ==, lws_heur);
+	ccl_kernel_set_tuning_db(db_file);
+	g_free(empty_db_file);
+
+	/* ...unless it exceeds the requested maximum local work size. */
+	if (lws > 1) {
+		lws_sugg = lws / 2;
+		ccl_kernel_suggest_worksizes(
+			krnl, dev, 1, &rws, NULL, &lws_sugg, &err);
+		g_assert_no_error(err);
+		g_assert_cmpuint(lws_sugg, <=, lws / 2);
+		g_assert_cmpuint(rws % lws_sugg, ==, 0);
+	}
+
+	/* Autotuning also works with a command queue in untracked mode. */
+	ccl_queue_set_untracked(cq, CL_TRUE);
+	lws = 0;
+	ccl_kernel_autotune(krnl, cq, 1, &rws, NULL, &lws, 2, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(lws, >, 0);
+	g_assert_cmpuint(rws % lws, ==, 0);
+
+	ccl_queue_destroy(cq);
+
+#endif
+
+	/* Go back to the tuning database of the tests, and remove the
+	 * temporary one. */
+	ccl_kernel_set_tuning_db(test_tuning_db_file);
+	g_unlink(db_file);
+	g_rmdir(db_dir);
+	g_free(db_file);
+	g_free(db_dir);
+
+	/* Destroy stuff. */
+	ccl_buffer_destroy(buf);
+	ccl_program_destroy(prg);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+}
 
 /* ******************************************** */
 /* ********* Test kernel arguments ************ */
@@ -1024,6 +1293,81 @@ static void args_test() {
 			//~ himg[i].c[0] + himg[i].c[1] + himg[i].c[2] + himg[i].c[3] + to_sum,
 			//~ himg[i].c[0], himg[i].c[1], himg[i].c[2], himg[i].c[3], to_sum);
 
+#endif
+
+	/* Update only the private argument, keeping the remaining ones, and
+	 * execute kernel again. */
+	to_sum = 7;
+	args[0] = (void*) ccl_arg_skip;
+	args[1] = (void*) ccl_arg_skip;
+	args[2] = (void*) ccl_arg_skip;
+	args[3] = (void*) ccl_arg_skip;
+	args[4] = ccl_arg_priv(to_sum, cl_uint);
+	args[5] = NULL;
+
+	ccl_kernel_set_args_and_enqueue_ndrange_v(krnl, cq, 1, NULL,
+		&gws, &lws, NULL, args, &err);
+	g_assert_no_error(err);
+
+	/* Set the same arguments again (the private argument should not be
+	 * passed again to the OpenCL kernel object, while memory objects
+	 * and samplers always are), this time setting the private argument
+	 * directly from its value, and execute kernel again. */
+	ccl_kernel_set_arg_value(krnl, 4, sizeof(cl_uint), &to_sum);
+	ccl_kernel_set_args_and_enqueue_ndrange(krnl, cq, 1, NULL,
+		&gws, &lws, NULL, &err, buf, img, smplr,
+		ccl_arg_local(lws, cl_uint), ccl_arg_skip, NULL);
+	g_assert_no_error(err);
+
+	/* Get results. */
+	evt = ccl_buffer_enqueue_read(buf, cq, CL_FALSE, 0,
+		sizeof(cl_uint) * CCL_TEST_KERNEL_ARGS_BUF_SIZE,
+		hbuf, NULL, &err);
+	g_assert_no_error(err);
+
+	/* Wait for transfer. */
+	ccl_event_wait(ccl_ewl(&ewl, evt, NULL), &err);
+	g_assert_no_error(err);
+
+#ifndef OPENCL_STUB
+
+	/* Check that results reflect the updated argument. */
+	for (cl_uint i = 0; i < CCL_TEST_KERNEL_ARGS_BUF_SIZE; ++i)
+		g_assert_cmpuint(hbuf[i], ==, himg[i].c[0] + himg[i].c[1] +
+			himg[i].c[2] + himg[i].c[3] + to_sum);
+
+#endif
+
+	/* Replace the buffer with a new one, which may get the handle of the
+	 * released buffer, and execute kernel again. The new buffer must
+	 * still be set in the OpenCL kernel object. */
+	ccl_buffer_destroy(buf);
+	buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE,
+		CCL_TEST_KERNEL_ARGS_BUF_SIZE * sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+	ccl_kernel_set_args_and_enqueue_ndrange(krnl, cq, 1, NULL,
+		&gws, &lws, NULL, &err, buf, ccl_arg_skip, ccl_arg_skip,
+		ccl_arg_skip, ccl_arg_skip, NULL);
+	g_assert_no_error(err);
+
+	/* Get results. */
+	memset(hbuf, 0, sizeof(cl_uint) * CCL_TEST_KERNEL_ARGS_BUF_SIZE);
+	evt = ccl_buffer_enqueue_read(buf, cq, CL_FALSE, 0,
+		sizeof(cl_uint) * CCL_TEST_KERNEL_ARGS_BUF_SIZE,
+		hbuf, NULL, &err);
+	g_assert_no_error(err);
+
+	/* Wait for transfer. */
+	ccl_event_wait(ccl_ewl(&ewl, evt, NULL), &err);
+	g_assert_no_error(err);
+
+#ifndef OPENCL_STUB
+
+	/* Check that the kernel wrote to the new buffer. */
+	for (cl_uint i = 0; i < CCL_TEST_KERNEL_ARGS_BUF_SIZE; ++i)
+		g_assert_cmpuint(hbuf[i], ==, himg[i].c[0] + himg[i].c[1] +
+			himg[i].c[2] + himg[i].c[3] + to_sum);
+
 #endif
 
 	/* Destroy stuff. */
@@ -1184,8 +1528,17 @@ static void native_test() {
  * */
 int main(int argc, char** argv) {
 
+	gchar* db_dir;
+	int result;
+
 	g_test_init(&argc, &argv, NULL);
 
+	/* Use a temporary tuning database. */
+	db_dir = g_dir_make_tmp("test_kernel_XXXXXX", NULL);
+	g_assert(db_dir != NULL);
+	test_tuning_db_file = g_build_filename(db_dir, "tuning.ini", NULL);
+	ccl_kernel_set_tuning_db(test_tuning_db_file);
+
 	g_test_add_func(
 		"/wrappers/kernel/create-info-destroy",
 		create_info_destroy_test);
@@ -1198,6 +1551,10 @@ int main(int argc, char** argv) {
 		"/wrappers/kernel/suggest-worksizes",
 		suggest_worksizes_test);
 
+	g_test_add_func(
+		"/wrappers/kernel/autotune",
+		autotune_test);
+
 	g_test_add_func(
 		"/wrappers/kernel/args",
 		args_test);
@@ -1206,7 +1563,17 @@ int main(int argc, char** argv) {
 		"/wrappers/kernel/native",
 		native_test);
 
-	return g_test_run();
+	result = g_test_run();
+
+	/* Go back to the default tuning database, and remove the temporary
+	 * one. */
+	ccl_kernel_set_tuning_db(NULL);
+	g_unlink(test_tuning_db_file);
+	g_rmdir(db_dir);
+	g_free(test_tuning_db_file);
+	g_free(db_dir);
+
+	return result;
 }
 
 
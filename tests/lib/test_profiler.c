@@ -134,6 +134,436 @@ static void create_add_destroy_test() {
 
 }
 
+/**
+ * Tests profiling of command queues with a bounded number of events,
+ * i.e. that events retired by the queue are still profiled.
+ * */
+static void max_events_test() {
+
+	/* Test variables. */
+	CCLErr* err = NULL;
+	CCLBuffer* buf = NULL;
+	CCLProf* prof = NULL;
+	CCLContext* ctx = NULL;
+	CCLDevice* d = NULL;
+	CCLQueue* cq = NULL;
+	CCLEvent* evt = NULL;
+	cl_uint hbuf = 0;
+	cl_uint num_evts = 0;
+	cl_uint num_recs = 0;
+	cl_uint num_infos = 0;
+	const cl_uint max_events = 4;
+	const cl_uint num_cmds = 10;
+
+	/* Get a context and a device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	d = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue with a bounded number of events. */
+	cq = ccl_queue_new(ctx, d, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(ccl_queue_get_max_events(cq), ==, 0);
+	ccl_queue_set_max_events(cq, max_events, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(ccl_queue_get_max_events(cq), ==, max_events);
+
+	/* Create device buffer. */
+	buf = ccl_buffer_new(
+		ctx, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+
+	/* Enqueue more commands than the maximum number of events. */
+	for (cl_uint i = 0; i < num_cmds; ++i) {
+		evt = ccl_buffer_enqueue_write(buf, cq, CL_TRUE, 0,
+			sizeof(cl_uint), &hbuf, NULL, &err);
+		g_assert_no_error(err);
+		ccl_event_set_name(evt, "WriteBuf");
+	}
+
+	/* Only the most recent events should be kept by the queue. */
+	ccl_queue_iter_event_init(cq);
+	while (ccl_queue_iter_event_next(cq) != NULL) num_evts++;
+	g_assert_cmpuint(num_evts, ==, max_events);
+
+	/* The remaining events should have been folded into records. */
+	ccl_queue_get_event_records(cq, &num_recs);
+	g_assert_cmpuint(num_recs, ==, num_cmds - max_events);
+
+	/* Profile queue. */
+	prof = ccl_prof_new();
+	ccl_prof_add_queue(prof, "Bounded queue", cq);
+	ccl_prof_calc(prof, &err);
+	g_assert_no_error(err);
+
+	/* All commands should have been profiled. */
+	ccl_prof_iter_info_init(prof,
+		CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_ASC);
+	while (ccl_prof_iter_info_next(prof) != NULL) num_infos++;
+	g_assert_cmpuint(num_infos, ==, num_cmds);
+
+	/* Queue events and records should have been released. */
+	ccl_queue_get_event_records(cq, &num_recs);
+	g_assert_cmpuint(num_recs, ==, 0);
+
+	/* Release wrappers and profiler. */
+	ccl_prof_destroy(prof);
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+#ifdef CL_VERSION_1_1
+
+/**
+ * Tests that command queues with a bounded number of events don't block
+ * when the oldest events are not yet complete.
+ * */
+static void max_events_pending_test() {
+
+	/* Test variables. */
+	CCLErr* err = NULL;
+	CCLBuffer* buf = NULL;
+	CCLContext* ctx = NULL;
+	CCLDevice* d = NULL;
+	CCLQueue* cq = NULL;
+	CCLEvent* uevt = NULL;
+	CCLEventWaitList ewl = NULL;
+	cl_uint hbuf[4] = { 0, 0, 0, 0 };
+	cl_uint num_evts = 0;
+	const cl_uint max_events = 2;
+	const cl_uint num_cmds = 4;
+
+	/* Get a context and a device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	d = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue with a bounded number of events. */
+	cq = ccl_queue_new(ctx, d, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+	ccl_queue_set_max_events(cq, max_events, &err);
+	g_assert_no_error(err);
+
+	/* Create device buffer and user event. */
+	buf = ccl_buffer_new(
+		ctx, CL_MEM_READ_WRITE, num_cmds * sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+	uevt = ccl_user_event_new(ctx, &err);
+	g_assert_no_error(err);
+
+	/* Enqueue more commands than the maximum number of events, all of
+	 * them waiting on the user event. This should not block. */
+	for (cl_uint i = 0; i < num_cmds; ++i) {
+		ccl_buffer_enqueue_write(buf, cq, CL_FALSE, i * sizeof(cl_uint),
+			sizeof(cl_uint), &hbuf[i], ccl_ewl(&ewl, uevt, NULL), &err);
+		g_assert_no_error(err);
+	}
+
+	/* The maximum number of events is unchanged. */
+	g_assert_cmpuint(ccl_queue_get_max_events(cq), ==, max_events);
+
+#ifndef OPENCL_STUB
+
+	/* Since no command is complete, all events are kept. */
+	ccl_queue_iter_event_init(cq);
+	while (ccl_queue_iter_event_next(cq) != NULL) num_evts++;
+	g_assert_cmpuint(num_evts, ==, num_cmds);
+
+#endif
+
+	/* Release commands and wait for them. */
+	ccl_user_event_set_status(uevt, CL_COMPLETE, &err);
+	g_assert_no_error(err);
+	ccl_queue_finish(cq, &err);
+	g_assert_no_error(err);
+
+	/* Once complete, producing a new event retires the oldest events. */
+	ccl_buffer_enqueue_write(buf, cq, CL_TRUE, 0,
+		sizeof(cl_uint), &hbuf[0], NULL, &err);
+	g_assert_no_error(err);
+
+	num_evts = 0;
+	ccl_queue_iter_event_init(cq);
+	while (ccl_queue_iter_event_next(cq) != NULL) num_evts++;
+	g_assert_cmpuint(num_evts, ==, max_events);
+
+	/* Release wrappers. */
+	ccl_event_destroy(uevt);
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+#endif
+
+/**
+ * Tests the profiler streaming mode, i.e. incremental consumption of
+ * complete events and snapshots of profiling information.
+ * */
+static void stream_test() {
+
+	/* Test variables. */
+	CCLErr* err = NULL;
+	CCLBuffer* buf = NULL;
+	CCLProf* prof = NULL;
+	CCLProf* snap1 = NULL;
+	CCLProf* snap2 = NULL;
+	cl_bool export_status;
+	CCLContext* ctx = NULL;
+	CCLDevice* d = NULL;
+	CCLQueue* cq1 = NULL;
+	CCLQueue* cq2 = NULL;
+	CCLEvent* evt = NULL;
+	const CCLProfAgg* agg = NULL;
+	cl_uint hbuf = 0;
+	const cl_uint num_cmds = 16;
+
+	/* Get a context and a device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	d = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create two command queues. */
+	cq1 = ccl_queue_new(ctx, d, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+	cq2 = ccl_queue_new(ctx, d, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+
+	/* Create device buffer. */
+	buf = ccl_buffer_new(
+		ctx, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+
+	/* Create profile object and add queues. */
+	prof = ccl_prof_new();
+	ccl_prof_add_queue(prof, "Q1", cq1);
+	ccl_prof_add_queue(prof, "Q2", cq2);
+
+	/* Perform two rounds of commands, consuming events in between. */
+	for (cl_uint r = 0; r < 2; ++r) {
+
+		for (cl_uint i = 0; i < num_cmds; ++i) {
+			evt = ccl_buffer_enqueue_write(buf, (i % 2) ? cq1 : cq2,
+				CL_TRUE, 0, sizeof(cl_uint), &hbuf, NULL, &err);
+			g_assert_no_error(err);
+			ccl_event_set_name(evt, (i % 2) ? "Write1" : "Write2");
+		}
+
+		ccl_prof_poll(prof, &err);
+		g_assert_no_error(err);
+
+		/* All events are complete, so all of them should have been
+		 * consumed. */
+		ccl_queue_iter_event_init(cq1);
+		g_assert(ccl_queue_iter_event_next(cq1) == NULL);
+		ccl_queue_iter_event_init(cq2);
+		g_assert(ccl_queue_iter_event_next(cq2) == NULL);
+
+		/* Get a snapshot of the profiling information. */
+		if (r == 0) snap1 = ccl_prof_snapshot(prof);
+		else snap2 = ccl_prof_snapshot(prof);
+	}
+
+	/* Snapshots should contain aggregate statistics for both event
+	 * names, and durations should not decrease over time. */
+	agg = ccl_prof_get_agg(snap1, "Write1");
+	g_assert(agg != NULL);
+	agg = ccl_prof_get_agg(snap2, "Write2");
+	g_assert(agg != NULL);
+	g_assert_cmpuint(agg->count, <=, num_cmds);
+	g_assert_cmpuint(agg->min, <=, agg->p50);
+	g_assert_cmpuint(agg->p99, <=, agg->max);
+	g_assert_cmpuint(ccl_prof_get_duration(snap1), <=,
+		ccl_prof_get_duration(snap2));
+	g_assert_cmpuint(ccl_prof_get_eff_duration(snap2), <=,
+		ccl_prof_get_duration(snap2));
+	g_assert(ccl_prof_get_summary(snap2,
+		CCL_PROF_AGG_SORT_TIME | CCL_PROF_SORT_DESC,
+		CCL_PROF_OVERLAP_SORT_DURATION | CCL_PROF_SORT_DESC) != NULL);
+
+	/* Snapshots can be exported, and their (empty) list of event infos
+	 * can be sorted by name. */
+	FILE* bin_stream = tmpfile();
+	g_assert(bin_stream != NULL);
+	export_status = ccl_prof_export_bin(snap2, bin_stream, &err);
+	g_assert_no_error(err);
+	g_assert(export_status);
+	g_assert_cmpint(ftell(bin_stream), >, 0);
+	fclose(bin_stream);
+	ccl_prof_iter_info_init(snap2,
+		CCL_PROF_INFO_SORT_NAME_EVENT | CCL_PROF_SORT_ASC);
+	g_assert(ccl_prof_iter_info_next(snap2) == NULL);
+	ccl_prof_iter_info_init(snap2,
+		CCL_PROF_INFO_SORT_NAME_QUEUE | CCL_PROF_SORT_DESC);
+	g_assert(ccl_prof_iter_info_next(snap2) == NULL);
+
+	/* Conclude profiling. */
+	ccl_prof_calc(prof, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(ccl_prof_get_duration(snap2), <=,
+		ccl_prof_get_duration(prof));
+	agg = ccl_prof_get_agg(prof, "Write1");
+	g_assert(agg != NULL);
+
+	/* Per-event information is not kept in streaming mode. */
+	ccl_prof_iter_info_init(prof,
+		CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_ASC);
+	g_assert(ccl_prof_iter_info_next(prof) == NULL);
+
+	/* Release wrappers and profile objects. */
+	ccl_prof_destroy(snap1);
+	ccl_prof_destroy(snap2);
+	ccl_prof_destroy(prof);
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq1);
+	ccl_queue_destroy(cq2);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Performs a traced call in a thread which exits before the recorded
+ * calls are consumed.
+ * */
+static gpointer host_trace_thread(gpointer data) {
+
+	/* Test variables. */
+	CCLErr* err = NULL;
+	CCLBuffer* buf = ((CCLBuffer**) data)[0];
+	CCLQueue* cq = ((CCLQueue**) data)[1];
+	cl_uint hbuf;
+
+	ccl_buffer_enqueue_read(buf, cq, CL_TRUE, 0,
+		sizeof(cl_uint), &hbuf, NULL, &err);
+	g_assert_no_error(err);
+
+	return NULL;
+}
+
+/**
+ * Tests tracing of host API calls and their consumption by profile
+ * objects.
+ * */
+static void host_trace_test() {
+
+	/* Test variables. */
+	CCLErr* err = NULL;
+	CCLBuffer* buf = NULL;
+	CCLProf* prof = NULL;
+	CCLContext* ctx = NULL;
+	CCLDevice* d = NULL;
+	CCLQueue* cq = NULL;
+	FILE* fp = NULL;
+	const char* summary = NULL;
+	char trace[4096];
+	size_t trace_len;
+	cl_uint hbuf = 0;
+	GThread* thread = NULL;
+	gpointer thread_data[2];
+
+	/* Host tracing is disabled by default. */
+	g_assert(!ccl_prof_get_host_tracing());
+
+	/* Enable host tracing. If the library was built without it, there
+	 * is nothing else to test. */
+	ccl_prof_set_host_tracing(CL_TRUE);
+	if (!ccl_prof_get_host_tracing()) {
+		g_test_message("Library built without host tracing support.");
+		return;
+	}
+
+	/* Get a context and a device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	d = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create command queue and device buffer. */
+	cq = ccl_queue_new(ctx, d, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+	buf = ccl_buffer_new(
+		ctx, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+
+	/* Perform some traced calls. */
+	for (cl_uint i = 0; i < 4; ++i) {
+		ccl_buffer_enqueue_write(buf, cq, CL_TRUE, 0,
+			sizeof(cl_uint), &hbuf, NULL, &err);
+		g_assert_no_error(err);
+	}
+
+	/* Calls of threads which have exited should not be lost. */
+	thread_data[0] = buf;
+	thread_data[1] = cq;
+	thread = g_thread_new("host-trace", host_trace_thread, thread_data);
+	g_thread_join(thread);
+
+	/* Disable host tracing. */
+	ccl_prof_set_host_tracing(CL_FALSE);
+	g_assert(!ccl_prof_get_host_tracing());
+
+	/* Profile queue, consuming the recorded host calls. */
+	prof = ccl_prof_new();
+	ccl_prof_add_queue(prof, "Q", cq);
+	ccl_prof_add_host_trace(prof);
+	ccl_prof_calc(prof, &err);
+	g_assert_no_error(err);
+
+	/* Traced calls should show up in the summary. */
+	summary = ccl_prof_get_summary(prof,
+		CCL_PROF_AGG_SORT_TIME | CCL_PROF_SORT_DESC,
+		CCL_PROF_OVERLAP_SORT_DURATION | CCL_PROF_SORT_DESC);
+	g_assert(g_strrstr(summary, "Host API calls") != NULL);
+	g_assert(g_strrstr(summary, "ccl_buffer_enqueue_write") != NULL);
+	g_assert(g_strrstr(summary, "ccl_buffer_new") != NULL);
+	g_assert(g_strrstr(summary, "ccl_buffer_enqueue_read") != NULL);
+
+	/* Traced calls should be exported as a separate host process. */
+	fp = tmpfile();
+	g_assert(fp != NULL);
+	ccl_prof_export_trace(prof, fp, &err);
+	g_assert_no_error(err);
+	rewind(fp);
+	trace_len = fread(trace, 1, sizeof(trace) - 1, fp);
+	trace[trace_len] = '\0';
+	fclose(fp);
+	g_assert(g_strrstr(trace, "\"pid\":2") != NULL);
+	g_assert(g_strrstr(trace, "\"name\":\"host\"") != NULL);
+
+	/* Release wrappers and profile object. */
+	ccl_prof_destroy(prof);
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
 /**
  * Main function.
  * @param[in] argc Number of command line arguments.
@@ -147,6 +577,20 @@ int main(int argc, char** argv) {
 	g_test_add_func(
 		"/profiler/create-add-destroy", create_add_destroy_test);
 
+	g_test_add_func(
+		"/profiler/max-events", max_events_test);
+
+#ifdef CL_VERSION_1_1
+	g_test_add_func(
+		"/profiler/max-events-pending", max_events_pending_test);
+#endif
+
+	g_test_add_func(
+		"/profiler/stream", stream_test);
+
+	g_test_add_func(
+		"/profiler/host-trace", host_trace_test);
+
 	return g_test_run();
 
 }
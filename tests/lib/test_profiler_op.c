@@ -47,6 +47,14 @@
 #endif
 
 #define CCL_TEST_MAXBUF 512
+
+/**
+ * Release a GString, including its character data.
+ * */
+static void ccl_test_prof_string_free(GString* str) {
+	g_string_free(str, TRUE);
+}
+
 /**
  * Tests the profiling module.
  * */
@@ -184,6 +192,14 @@ static void operation_test() {
 	g_assert(agg != NULL);
 	g_assert_cmpuint(agg->absolute_time, ==, 36);
 	g_assert_cmpfloat(agg->relative_time - 0.51728, <, 0.0001);
+	g_assert_cmpuint(agg->count, ==, 4);
+	g_assert_cmpuint(agg->min, ==, 1);
+	g_assert_cmpuint(agg->max, ==, 20);
+	g_assert_cmpfloat(ABS(agg->mean - 9.0), <, 0.0001);
+	g_assert_cmpfloat(ABS(agg->stddev - 8.20569), <, 0.0001);
+	g_assert_cmpuint(agg->p50, ==, 5);
+	g_assert_cmpuint(agg->p95, ==, 20);
+	g_assert_cmpuint(agg->p99, ==, 20);
 
 	agg = ccl_prof_get_agg(prof, "Event2");
 	g_assert(agg != NULL);
@@ -205,7 +221,22 @@ static void operation_test() {
 	g_assert_cmpuint(agg->absolute_time, ==, 11);
 	g_assert_cmpfloat(agg->relative_time - 0.15714, <, 0.0001);
 
-	/* 2) By cycling all agg. stats. */
+	/* 2) By cycling all agg. stats, sorted by maximum duration. */
+	cl_ulong prev_max = CL_ULONG_MAX;
+
+	ccl_prof_iter_agg_init(
+		prof, CCL_PROF_AGG_SORT_MAX | CCL_PROF_SORT_DESC);
+
+	while ((agg = ccl_prof_iter_agg_next(prof)) != NULL) {
+		g_assert_cmpuint(agg->max, <=, prev_max);
+		g_assert_cmpuint(agg->min, <=, agg->p50);
+		g_assert_cmpuint(agg->p50, <=, agg->p95);
+		g_assert_cmpuint(agg->p95, <=, agg->p99);
+		g_assert_cmpuint(agg->p99, <=, agg->max);
+		prev_max = agg->max;
+	}
+
+	/* 3) By cycling all agg. stats, sorted by name. */
 	const char* prev_name = "zzzz";
 
 	ccl_prof_iter_agg_init(
@@ -237,6 +268,52 @@ static void operation_test() {
 
 	}
 
+	/* Test ordering by event duration. */
+	cl_ulong prev_duration = CL_ULONG_MAX;
+	ccl_prof_iter_info_init(
+		prof, CCL_PROF_INFO_SORT_DURATION | CCL_PROF_SORT_DESC);
+
+	while ((info = ccl_prof_iter_info_next(prof)) != NULL) {
+
+		/* Check that the event durations are ordered properly. */
+		g_assert_cmpuint(info->t_end - info->t_start, <=, prev_duration);
+		prev_duration = info->t_end - info->t_start;
+
+	}
+
+	/* Test that events with the same queue name keep the same relative
+	 * order in ascending and descending order. */
+	GHashTable* ties[2];
+	for (guint o = 0; o < 2; ++o) {
+		ties[o] = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+			(GDestroyNotify) ccl_test_prof_string_free);
+		ccl_prof_iter_info_init(prof, CCL_PROF_INFO_SORT_NAME_QUEUE
+			| (o == 0 ? CCL_PROF_SORT_ASC : CCL_PROF_SORT_DESC));
+		while ((info = ccl_prof_iter_info_next(prof)) != NULL) {
+			GString* seq = (GString*) g_hash_table_lookup(
+				ties[o], info->queue_name);
+			if (seq == NULL) {
+				seq = g_string_new("");
+				g_hash_table_insert(
+					ties[o], (gpointer) info->queue_name, seq);
+			}
+			g_string_append_printf(seq, "%s@%" G_GUINT64_FORMAT ";",
+				info->event_name, (guint64) info->t_start);
+		}
+	}
+	g_assert_cmpuint(g_hash_table_size(ties[0]), ==,
+		g_hash_table_size(ties[1]));
+	GHashTableIter ties_iter;
+	gpointer ties_q, ties_seq;
+	g_hash_table_iter_init(&ties_iter, ties[0]);
+	while (g_hash_table_iter_next(&ties_iter, &ties_q, &ties_seq)) {
+		GString* seq_desc = (GString*) g_hash_table_lookup(ties[1], ties_q);
+		g_assert(seq_desc != NULL);
+		g_assert_cmpstr(((GString*) ties_seq)->str, ==, seq_desc->str);
+	}
+	g_hash_table_destroy(ties[0]);
+	g_hash_table_destroy(ties[1]);
+
 	/* ******************* */
 	/* Test event instants */
 	/* ******************* */
@@ -318,6 +395,120 @@ static void operation_test() {
 	g_assert(read_flag);
 	g_assert_cmpstr(file_contents, ==, expected_contents);
 	g_free(file_contents);
+	g_free(tmp_file_name);
+
+	/* Export trace. */
+	tmp_file_name = g_strconcat(
+		tmp_dir_name, G_DIR_SEPARATOR_S, "trace.json", NULL);
+
+	/* Exporting the trace should not disturb the iterators of the
+	 * profile object. */
+	ccl_prof_iter_info_init(
+		prof, CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_DESC);
+	info = ccl_prof_iter_info_next(prof);
+	g_assert(info != NULL);
+	cl_ulong t_start_last = info->t_start;
+
+	export_status = ccl_prof_export_trace_file(prof, tmp_file_name, &err);
+	g_assert_no_error(err);
+	g_assert(export_status);
+
+	guint num_remaining = 0, num_infos = 0;
+	while ((info = ccl_prof_iter_info_next(prof)) != NULL) {
+		g_assert_cmpuint(info->t_start, <=, t_start_last);
+		t_start_last = info->t_start;
+		num_remaining++;
+	}
+	ccl_prof_iter_info_init(
+		prof, CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_DESC);
+	while (ccl_prof_iter_info_next(prof) != NULL) num_infos++;
+	g_assert_cmpuint(num_remaining + 1, ==, num_infos);
+
+	/* Test if trace was correctly written: one execution slice per
+	 * event, and a concurrency counter. */
+	read_flag = g_file_get_contents(
+		tmp_file_name, &file_contents, NULL, NULL);
+	g_assert(read_flag);
+	g_assert(g_str_has_prefix(file_contents, "{"));
+	g_assert(g_str_has_suffix(file_contents, "]}\n"));
+	gchar** slices = g_strsplit(file_contents, "\"ph\":\"X\"", -1);
+	g_assert_cmpuint(g_strv_length(slices), ==, 8 + 1);
+	g_strfreev(slices);
+	g_assert(g_strstr_len(file_contents, -1,
+		"\"ts\":0.000,\"dur\":0.005,\"name\":\"Event1\"") != NULL);
+	g_assert(g_strstr_len(file_contents, -1,
+		"\"name\":\"Concurrent events\",\"ts\":0.009,"
+		"\"args\":{\"events\":3}") != NULL);
+	g_free(file_contents);
+	g_free(tmp_file_name);
+
+	/* Export binary trace and load it back. */
+	tmp_file_name = g_strconcat(
+		tmp_dir_name, G_DIR_SEPARATOR_S, "trace.bin", NULL);
+
+	export_status = ccl_prof_export_bin_file(prof, tmp_file_name, &err);
+	g_assert_no_error(err);
+	g_assert(export_status);
+
+	CCLProf* prof_bin = ccl_prof_new_from_bin_file(tmp_file_name, &err);
+	g_assert_no_error(err);
+	g_assert(prof_bin != NULL);
+
+	/* Loaded profile should yield the same information. */
+	g_assert_cmpuint(ccl_prof_get_duration(prof_bin), ==,
+		ccl_prof_get_duration(prof));
+	g_assert_cmpuint(ccl_prof_get_eff_duration(prof_bin), ==,
+		ccl_prof_get_eff_duration(prof));
+	g_assert_cmpstr(ccl_prof_get_summary(prof_bin,
+		CCL_PROF_AGG_SORT_TIME | CCL_PROF_SORT_DESC,
+		CCL_PROF_OVERLAP_SORT_DURATION | CCL_PROF_SORT_DESC), ==,
+		ccl_prof_get_summary(prof,
+		CCL_PROF_AGG_SORT_TIME | CCL_PROF_SORT_DESC,
+		CCL_PROF_OVERLAP_SORT_DURATION | CCL_PROF_SORT_DESC));
+
+	ccl_prof_iter_info_init(
+		prof, CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_ASC);
+	ccl_prof_iter_info_init(
+		prof_bin, CCL_PROF_INFO_SORT_T_START | CCL_PROF_SORT_ASC);
+	while ((info = ccl_prof_iter_info_next(prof)) != NULL) {
+		const CCLProfInfo* info_bin = ccl_prof_iter_info_next(prof_bin);
+		g_assert(info_bin != NULL);
+		g_assert_cmpstr(info_bin->event_name, ==, info->event_name);
+		g_assert_cmpstr(info_bin->queue_name, ==, info->queue_name);
+		g_assert_cmpuint(info_bin->command_type, ==, info->command_type);
+		g_assert_cmpuint(info_bin->t_start, ==, info->t_start);
+		g_assert_cmpuint(info_bin->t_end, ==, info->t_end);
+	}
+	g_assert(ccl_prof_iter_info_next(prof_bin) == NULL);
+	ccl_prof_destroy(prof_bin);
+
+	/* Loading a binary trace with more names than its string table can
+	 * hold should fail. The number of event names follows the 8-byte
+	 * magic string, the format version and the byte order mark. */
+	gsize bin_size;
+	read_flag = g_file_get_contents(
+		tmp_file_name, &file_contents, &bin_size, NULL);
+	g_assert(read_flag);
+	g_assert_cmpuint(bin_size, >=, 20);
+	memset(file_contents + 16, 0xFF, 4);
+	read_flag = g_file_set_contents(
+		tmp_file_name, file_contents, bin_size, NULL);
+	g_assert(read_flag);
+	g_free(file_contents);
+	prof_bin = ccl_prof_new_from_bin_file(tmp_file_name, &err);
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_INVALID_DATA);
+	g_assert(prof_bin == NULL);
+	g_clear_error(&err);
+
+	/* Loading a file which is not a binary trace should fail. */
+	g_free(tmp_file_name);
+	tmp_file_name = g_strconcat(
+		tmp_dir_name, G_DIR_SEPARATOR_S, "trace.json", NULL);
+	prof_bin = ccl_prof_new_from_bin_file(tmp_file_name, &err);
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_INVALID_DATA);
+	g_assert(prof_bin == NULL);
+	g_clear_error(&err);
+
 	g_free(tmp_dir_name);
 	g_free(tmp_file_name);
 
@@ -351,6 +542,152 @@ static void operation_test() {
 
 }
 
+/* Number of queues in the overlaps benchmark. */
+#define CCL_TEST_PROF_BENCH_NUMQUEUES 8
+
+/* Number of event names in the overlaps benchmark. */
+#define CCL_TEST_PROF_BENCH_NUMNAMES 8
+
+/* Maximum number of events kept by each queue in the overlaps
+ * benchmark. */
+#define CCL_TEST_PROF_BENCH_MAXEVTS 64
+
+/**
+ * Profile a synthetic trace with the given number of events spread over
+ * several queues, and return the time taken by ccl_prof_calc().
+ *
+ * @param[in] num_events Number of events in synthetic trace.
+ * @return Time taken by ccl_prof_calc(), in seconds.
+ * */
+static double overlaps_bench_run(cl_uint num_events) {
+
+	/* Aux vars. */
+	CCLContext* ctx;
+	CCLDevice* dev;
+	CCLQueue* qs[CCL_TEST_PROF_BENCH_NUMQUEUES];
+	cl_ulong t_cursor[CCL_TEST_PROF_BENCH_NUMQUEUES];
+	CCLBuffer* buf;
+	CCLProf* prof;
+	CCLErr* err = NULL;
+	CCLEvent* evt;
+	cl_event ev_unwrapped;
+	cl_int host_val = 0;
+	cl_uint devidx = 0;
+	GTimer* timer;
+	double t_calc;
+	const char* names[CCL_TEST_PROF_BENCH_NUMNAMES] = { "Event0",
+		"Event1", "Event2", "Event3", "Event4", "Event5", "Event6",
+		"Event7" };
+	gchar* qnames[CCL_TEST_PROF_BENCH_NUMQUEUES];
+
+	/* Create OpenCL wrappers. */
+	ctx = ccl_context_new_from_device_index(&devidx, &err);
+	g_assert_no_error(err);
+
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE, sizeof(cl_int), NULL,
+		&err);
+	g_assert_no_error(err);
+
+	prof = ccl_prof_new();
+
+	/* Create queues with a bounded number of events, so that memory is
+	 * dominated by the profiler itself. */
+	for (cl_uint q = 0; q < CCL_TEST_PROF_BENCH_NUMQUEUES; ++q) {
+		qs[q] = ccl_queue_new(ctx, dev, CL_QUEUE_PROFILING_ENABLE, &err);
+		g_assert_no_error(err);
+		ccl_queue_set_max_events(qs[q], CCL_TEST_PROF_BENCH_MAXEVTS, &err);
+		g_assert_no_error(err);
+		qnames[q] = g_strdup_printf("Q%u", q);
+		t_cursor[q] = 1000;
+	}
+
+	/* Generate synthetic trace: commands in each queue execute in
+	 * sequence, with random durations and gaps, overlapping with
+	 * commands in other queues. */
+	for (cl_uint i = 0; i < num_events; ++i) {
+
+		cl_uint q = g_test_rand_int_range(0, CCL_TEST_PROF_BENCH_NUMQUEUES);
+
+		evt = ccl_buffer_enqueue_write(buf, qs[q], CL_FALSE, 0,
+			sizeof(cl_int), &host_val, NULL, &err);
+		g_assert_no_error(err);
+		ccl_event_set_name(evt,
+			names[g_test_rand_int_range(0, CCL_TEST_PROF_BENCH_NUMNAMES)]);
+
+		ev_unwrapped = ccl_event_unwrap(evt);
+		t_cursor[q] += g_test_rand_int_range(0, 50);
+		ev_unwrapped->t_start = t_cursor[q];
+		t_cursor[q] += g_test_rand_int_range(1, 400);
+		ev_unwrapped->t_end = t_cursor[q];
+	}
+
+	/* Add queues. */
+	for (cl_uint q = 0; q < CCL_TEST_PROF_BENCH_NUMQUEUES; ++q)
+		ccl_prof_add_queue(prof, qnames[q], qs[q]);
+
+	/* Perform and time profiling calculations. */
+	timer = g_timer_new();
+	ccl_prof_calc(prof, &err);
+	g_assert_no_error(err);
+	t_calc = g_timer_elapsed(timer, NULL);
+	g_timer_destroy(timer);
+
+	/* Effective duration can't be larger than total duration. */
+	g_assert_cmpuint(
+		ccl_prof_get_eff_duration(prof), <=, ccl_prof_get_duration(prof));
+
+	/* Release profile object and wrappers. */
+	ccl_prof_destroy(prof);
+	for (cl_uint q = 0; q < CCL_TEST_PROF_BENCH_NUMQUEUES; ++q) {
+		ccl_queue_destroy(qs[q]);
+		g_free(qnames[q]);
+	}
+	ccl_buffer_destroy(buf);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+	/* Return time taken by profiling calculations. */
+	return t_calc;
+}
+
+/**
+ * Benchmarks profiling calculations (in particular, determination of
+ * event overlaps) with synthetic traces. If performance tests are
+ * enabled, traces with 10^5, 10^6 and 10^7 events are profiled;
+ * otherwise, a single small trace is profiled.
+ * */
+static void overlaps_bench_test() {
+
+	/* Number of events in the synthetic traces. */
+	const cl_uint num_events_perf[] = { 100000, 1000000, 10000000 };
+	const cl_uint num_events_quick[] = { 10000 };
+	const cl_uint* num_events;
+	cl_uint num_runs;
+
+	/* Select synthetic traces. */
+	if (g_test_perf()) {
+		num_events = num_events_perf;
+		num_runs = G_N_ELEMENTS(num_events_perf);
+	} else {
+		num_events = num_events_quick;
+		num_runs = G_N_ELEMENTS(num_events_quick);
+	}
+
+	/* Profile synthetic traces. */
+	for (cl_uint r = 0; r < num_runs; ++r) {
+		double t_calc = overlaps_bench_run(num_events[r]);
+		g_test_minimized_result(t_calc,
+			"Profiling of %u events: %fs", num_events[r], t_calc);
+	}
+
+}
+
 /**
  * Main function.
  * @param[in] argc Number of command line arguments.
@@ -363,6 +700,8 @@ int main(int argc, char** argv) {
 
 	g_test_add_func("/profiler/operation", operation_test);
 
+	g_test_add_func("/profiler/overlaps-bench", overlaps_bench_test);
+
 	return g_test_run();
 
 }
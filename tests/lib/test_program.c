@@ -767,6 +767,423 @@ static void compile_link_test() {
 
 #endif
 
+/**
+ * @internal
+ *
+ * @brief Count and optionally overwrite the files in a folder.
+ *
+ * @param[in] dir_name Folder name.
+ * @param[in] contents Contents to write to each file, or `NULL` if
+ * files are not to be overwritten.
+ * @param[in] remove Remove files?
+ * @return Number of files in folder.
+ * */
+static guint cache_files(const char* dir_name, const char* contents,
+	gboolean remove) {
+
+	CCLErr* err = NULL;
+	GDir* dir;
+	const gchar* name;
+	guint count = 0;
+
+	dir = g_dir_open(dir_name, 0, &err);
+	g_assert_no_error(err);
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		gchar* path = g_build_filename(dir_name, name, NULL);
+		if (contents != NULL) {
+			g_file_set_contents(path, contents, -1, &err);
+			g_assert_no_error(err);
+		}
+		if (remove) g_unlink(path);
+		g_free(path);
+		count++;
+	}
+	g_dir_close(dir);
+
+	return count;
+}
+
+/**
+ * Tests the persistent cache of program binaries.
+ * */
+static void cache_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLProgram* prg = NULL;
+	CCLKernel* krnl = NULL;
+	CCLErr* err = NULL;
+	gchar* cache_dir;
+	cl_uint num_devs;
+	cl_bool from_cache;
+	const char* src = CCL_TEST_PROGRAM_SUM_CONTENT;
+
+	/* Get a temp. dir. for the cache, which is initially empty. */
+	cache_dir = g_dir_make_tmp("test_program_cache_XXXXXX", &err);
+	g_assert_no_error(err);
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+	num_devs = ccl_context_get_num_devices(ctx, &err);
+	g_assert_no_error(err);
+
+	/* First build is a miss, and writes one binary per device to the
+	 * cache. */
+	prg = ccl_program_new_from_sources_cached(ctx, 1, &src, NULL,
+		"-DTEST_CACHE", cache_dir, &from_cache, &err);
+	g_assert_no_error(err);
+	g_assert(!from_cache);
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+	g_assert(krnl != NULL);
+	ccl_program_destroy(prg);
+	g_assert_cmpuint(cache_files(cache_dir, NULL, FALSE), ==, num_devs);
+
+	/* Second build is a hit. */
+	prg = ccl_program_new_from_sources_cached(ctx, 1, &src, NULL,
+		"-DTEST_CACHE", cache_dir, &from_cache, &err);
+	g_assert_no_error(err);
+	g_assert(from_cache);
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+	g_assert(krnl != NULL);
+	ccl_program_destroy(prg);
+
+	/* Different build options lead to a miss and new cache files. */
+	prg = ccl_program_new_from_sources_cached(ctx, 1, &src, NULL,
+		NULL, cache_dir, &from_cache, &err);
+	g_assert_no_error(err);
+	g_assert(!from_cache);
+	ccl_program_destroy(prg);
+	g_assert_cmpuint(
+		cache_files(cache_dir, NULL, FALSE), ==, 2 * num_devs);
+
+#ifndef OPENCL_STUB
+
+	/* Corrupt cache files are handled as misses, and rewritten. */
+	cache_files(cache_dir, "not a binary", FALSE);
+	prg = ccl_program_new_from_sources_cached(ctx, 1, &src, NULL,
+		NULL, cache_dir, &from_cache, &err);
+	g_assert_no_error(err);
+	g_assert(!from_cache);
+	ccl_program_destroy(prg);
+
+	prg = ccl_program_new_from_sources_cached(ctx, 1, &src, NULL,
+		NULL, cache_dir, &from_cache, &err);
+	g_assert_no_error(err);
+	g_assert(from_cache);
+	ccl_program_destroy(prg);
+
+#endif
+
+	/* Remove cache. */
+	cache_files(cache_dir, NULL, TRUE);
+	g_rmdir(cache_dir);
+	g_free(cache_dir);
+
+	/* Destroy context. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Tests building a program asynchronously for all devices in parallel.
+ * */
+static void build_async_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLProgram* prg = NULL;
+	CCLProgramBuildFuture* fut = NULL;
+	CCLKernel* krnl = NULL;
+	CCLDevice* dev = NULL;
+	CCLErr* err = NULL;
+	cl_uint num_devs;
+	cl_build_status build_status;
+	const char* src = CCL_TEST_PROGRAM_SUM_CONTENT;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+	num_devs = ccl_context_get_num_devices(ctx, &err);
+	g_assert_no_error(err);
+
+	/* Create program. */
+	prg = ccl_program_new_from_source(ctx, src, &err);
+	g_assert_no_error(err);
+
+	/* Start building for all devices. */
+	fut = ccl_program_build_async(prg, 0, NULL, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(fut != NULL);
+
+	/* Wait for the first device and get a kernel, which waits for the
+	 * builds for the remaining devices to finish. */
+	dev = ccl_program_get_device(prg, 0, &err);
+	g_assert_no_error(err);
+	ccl_program_build_future_wait(fut, dev, &err);
+	g_assert_no_error(err);
+	g_assert(ccl_program_build_future_is_ready(fut, dev));
+	build_status = ccl_program_get_build_info_scalar(
+		prg, dev, CL_PROGRAM_BUILD_STATUS, cl_build_status, &err);
+	g_assert_no_error(err);
+	g_assert_cmpint(build_status, ==, CL_BUILD_SUCCESS);
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+	g_assert(krnl != NULL);
+
+	/* Wait for all devices. */
+	ccl_program_build_future_wait(fut, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(ccl_program_build_future_is_ready(fut, NULL));
+	for (cl_uint i = 0; i < num_devs; ++i) {
+		dev = ccl_program_get_device(prg, i, &err);
+		g_assert_no_error(err);
+		g_assert(ccl_program_build_future_is_ready(fut, dev));
+	}
+
+	/* The program can be destroyed before the future. */
+	ccl_program_destroy(prg);
+	ccl_program_build_future_destroy(fut);
+
+	/* Building again after kernels were created is not allowed, and
+	 * the error is reported when waiting. */
+	prg = ccl_program_new_from_source(ctx, src, &err);
+	g_assert_no_error(err);
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+	fut = ccl_program_build_async(prg, 0, NULL, NULL, &err);
+	g_assert_no_error(err);
+	ccl_program_build_future_wait(fut, NULL, &err);
+	g_assert_error(err, CCL_OCL_ERROR, CL_INVALID_OPERATION);
+	g_clear_error(&err);
+	ccl_program_build_future_destroy(fut);
+	ccl_program_destroy(prg);
+
+	/* Destroy context. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Tests asynchronous builds in a context with several devices, creating
+ * a kernel after waiting for the build for a single device.
+ * */
+static void build_async_multi_test() {
+
+	/* Test variables. */
+	CCLPlatforms* ps;
+	CCLPlatform* p;
+	CCLContext* ctx = NULL;
+	CCLProgram* prg = NULL;
+	CCLProgramBuildFuture* fut = NULL;
+	CCLKernel* krnl = NULL;
+	CCLDevice* dev = NULL;
+	CCLErr* err = NULL;
+	cl_uint num_devs = 0;
+	const char* src = CCL_TEST_PROGRAM_SUM_CONTENT;
+
+	/* Get a context with at least two devices, if possible. */
+	ps = ccl_platforms_new(&err);
+	g_assert_no_error(err);
+	for (guint i = 0; i < ccl_platforms_count(ps); ++i) {
+		p = ccl_platforms_get(ps, i);
+		num_devs = ccl_platform_get_num_devices(p, &err);
+		g_assert_no_error(err);
+		if (num_devs >= 2) {
+			ctx = ccl_context_new_from_devices(num_devs,
+				ccl_platform_get_all_devices(p, NULL), &err);
+			g_assert_no_error(err);
+			break;
+		}
+	}
+
+	/* If not possible to find a context with several devices, finish
+	 * this test. */
+	if (ctx == NULL) {
+		g_test_message("'%s' test not performed because no platform " \
+			"with two or more devices was found", G_STRFUNC);
+		ccl_platforms_destroy(ps);
+		return;
+	}
+
+	/* Repeat, since the order of the builds is not deterministic. */
+	for (guint r = 0; r < 8; ++r) {
+
+		/* Create program and start building it for all devices. */
+		prg = ccl_program_new_from_source(ctx, src, &err);
+		g_assert_no_error(err);
+		fut = ccl_program_build_async(prg, 0, NULL, NULL, &err);
+		g_assert_no_error(err);
+
+		/* Wait for the last device and get a kernel. Kernel creation
+		 * must not make the builds for the other devices fail. */
+		dev = ccl_program_get_device(prg, num_devs - 1, &err);
+		g_assert_no_error(err);
+		ccl_program_build_future_wait(fut, dev, &err);
+		g_assert_no_error(err);
+		krnl = ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err);
+		g_assert_no_error(err);
+		g_assert(krnl != NULL);
+
+		/* The builds for all devices are finished and successful. */
+		g_assert(ccl_program_build_future_is_ready(fut, NULL));
+		ccl_program_build_future_wait(fut, NULL, &err);
+		g_assert_no_error(err);
+
+		ccl_program_build_future_destroy(fut);
+		ccl_program_destroy(prg);
+	}
+
+	/* Destroy context and platforms. */
+	ccl_context_destroy(ctx);
+	ccl_platforms_destroy(ps);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Tests the program kernel table.
+ * */
+static void kernel_table_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLProgram* prg = NULL;
+	CCLKernel* krnl = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBuffer *a, *b, *c;
+	CCLEvent* evt = NULL;
+	const CCLKernelMeta* meta;
+	CCLErr* err = NULL;
+	cl_uint idx;
+	cl_uint a_h[CCL_TEST_PROGRAM_BUF_SIZE];
+	cl_uint b_h[CCL_TEST_PROGRAM_BUF_SIZE];
+	cl_uint c_h[CCL_TEST_PROGRAM_BUF_SIZE];
+	cl_uint d_h = CCL_TEST_PROGRAM_CONST;
+	size_t gws = CCL_TEST_PROGRAM_BUF_SIZE;
+	size_t lws = CCL_TEST_PROGRAM_LWS;
+	size_t wg_size;
+	const char* src = CCL_TEST_PROGRAM_SUM_CONTENT;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create and build program. */
+	prg = ccl_program_new_from_source(ctx, src, &err);
+	g_assert_no_error(err);
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+
+	/* Get a kernel by name before the kernel table is created. */
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+
+	/* Create kernel table. */
+	ccl_program_create_kernels(prg, &err);
+	g_assert_no_error(err);
+
+	/* Kernels in table are the same instances kept by name. */
+	idx = ccl_program_get_kernel_index(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+	g_assert(ccl_program_get_kernel_by_index(prg, idx, &err) == krnl);
+	g_assert_no_error(err);
+
+	/* Unknown kernels and invalid indexes are reported. */
+	ccl_program_get_kernel_index(prg, "no_such_kernel", &err);
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+	g_clear_error(&err);
+	krnl = ccl_program_get_kernel_by_index(prg, idx + 100, &err);
+	g_assert_error(err, CCL_ERROR, CCL_ERROR_ARGS);
+	g_assert(krnl == NULL);
+	g_clear_error(&err);
+
+	/* Check precomputed work-group information. */
+	meta = ccl_program_get_kernel_meta(prg, idx, dev, &err);
+	g_assert_no_error(err);
+	g_assert(meta->available);
+	krnl = ccl_program_get_kernel_by_index(prg, idx, &err);
+	g_assert_no_error(err);
+	wg_size = ccl_kernel_get_workgroup_info_scalar(
+		krnl, dev, CL_KERNEL_WORK_GROUP_SIZE, size_t, &err);
+	g_assert_no_error(err);
+	g_assert_cmpuint(meta->wg_size, ==, wg_size);
+	g_assert_cmpuint(meta->wg_size_mult, >, 0);
+
+	/* Enqueue kernel by index. */
+	for (cl_uint i = 0; i < CCL_TEST_PROGRAM_BUF_SIZE; ++i) {
+		a_h[i] = i + 1;
+		b_h[i] = i + 1;
+	}
+	a = ccl_buffer_new(ctx, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+		sizeof(a_h), a_h, &err);
+	g_assert_no_error(err);
+	b = ccl_buffer_new(ctx, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+		sizeof(b_h), b_h, &err);
+	g_assert_no_error(err);
+	c = ccl_buffer_new(ctx, CL_MEM_WRITE_ONLY, sizeof(c_h), NULL, &err);
+	g_assert_no_error(err);
+	evt = ccl_program_enqueue_kernel_by_index(prg, idx, cq, 1, NULL,
+		&gws, &lws, NULL, &err, a, b, c, ccl_arg_priv(d_h, cl_uint), NULL);
+	g_assert_no_error(err);
+	g_assert(evt != NULL);
+	ccl_buffer_enqueue_read(c, cq, CL_TRUE, 0, sizeof(c_h), c_h, NULL, &err);
+	g_assert_no_error(err);
+
+#ifndef OPENCL_STUB
+	for (cl_uint i = 0; i < CCL_TEST_PROGRAM_BUF_SIZE; ++i)
+		g_assert_cmpuint(c_h[i], ==, a_h[i] + b_h[i] + d_h);
+#endif
+
+	/* Release wrappers. */
+	ccl_buffer_destroy(a);
+	ccl_buffer_destroy(b);
+	ccl_buffer_destroy(c);
+	ccl_program_destroy(prg);
+	ccl_queue_destroy(cq);
+
+	/* The kernel table is also created on first use. */
+	prg = ccl_program_new_from_source(ctx, src, &err);
+	g_assert_no_error(err);
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+	idx = ccl_program_get_kernel_index(prg, CCL_TEST_PROGRAM_SUM, &err);
+	g_assert_no_error(err);
+	krnl = ccl_program_get_kernel_by_index(prg, idx, &err);
+	g_assert_no_error(err);
+	g_assert(ccl_program_get_kernel(prg, CCL_TEST_PROGRAM_SUM, &err) == krnl);
+	g_assert_no_error(err);
+	ccl_program_destroy(prg);
+
+	/* Destroy context. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
 /**
  * Main function.
  * @param[in] argc Number of command line arguments.
@@ -785,6 +1202,22 @@ int main(int argc, char** argv) {
 		"/wrappers/program/ref-unref",
 		ref_unref_test);
 
+	g_test_add_func(
+		"/wrappers/program/cache",
+		cache_test);
+
+	g_test_add_func(
+		"/wrappers/program/build-async",
+		build_async_test);
+
+	g_test_add_func(
+		"/wrappers/program/build-async-multi",
+		build_async_multi_test);
+
+	g_test_add_func(
+		"/wrappers/program/kernel-table",
+		kernel_table_test);
+
 #ifdef CL_VERSION_1_2
 	g_test_add_func(
 		"/wrappers/program/compile-link",
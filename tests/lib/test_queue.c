@@ -313,6 +313,243 @@ static void barrier_marker_test() {
 
 }
 
+/**
+ * Tests the untracked mode of command queues.
+ * */
+static void untracked_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBuffer* buf = NULL;
+	CCLEvent* evt = NULL;
+	CCLEvent* evt_last = NULL;
+	CCLErr* err = NULL;
+	cl_uint value = 0;
+	cl_command_type ct = 0;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue and put it in untracked mode. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+	g_assert(!ccl_queue_is_untracked(cq));
+	ccl_queue_set_untracked(cq, CL_TRUE);
+	g_assert(ccl_queue_is_untracked(cq));
+
+	/* Create a device buffer. */
+	buf = ccl_buffer_new(
+		ctx, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+	g_assert_no_error(err);
+
+	/* No last event should be available yet. */
+	g_assert(ccl_queue_get_last_event(cq) == NULL);
+
+	/* Enqueue some commands, no event wrappers should be produced. */
+	for (cl_uint i = 0; i < 8; ++i) {
+		evt = ccl_buffer_enqueue_write(buf, cq, CL_FALSE, 0,
+			sizeof(cl_uint), &value, NULL, &err);
+		g_assert_no_error(err);
+		g_assert(evt == NULL);
+	}
+	ccl_queue_iter_event_init(cq);
+	g_assert(ccl_queue_iter_event_next(cq) == NULL);
+
+	/* Get wrapper for last event on demand, and check that it is
+	 * produced only once. */
+	evt_last = ccl_queue_get_last_event(cq);
+	g_assert(evt_last != NULL);
+	g_assert(ccl_queue_get_last_event(cq) == evt_last);
+	ct = ccl_event_get_command_type(evt_last, &err);
+	g_assert_no_error(err);
+	g_assert_cmphex(ct, ==, CL_COMMAND_WRITE_BUFFER);
+
+	/* Last event wrapper should now be associated with the queue. */
+	ccl_queue_iter_event_init(cq);
+	g_assert(ccl_queue_iter_event_next(cq) == evt_last);
+	g_assert(ccl_queue_iter_event_next(cq) == NULL);
+
+	/* After garbage collection, no last event should be available. */
+	ccl_queue_finish(cq, &err);
+	g_assert_no_error(err);
+	ccl_queue_gc(cq);
+	g_assert(ccl_queue_get_last_event(cq) == NULL);
+
+	/* Back to tracked mode, event wrappers should be produced again. */
+	ccl_queue_set_untracked(cq, CL_FALSE);
+	evt = ccl_buffer_enqueue_write(buf, cq, CL_TRUE, 0,
+		sizeof(cl_uint), &value, NULL, &err);
+	g_assert_no_error(err);
+	g_assert(evt != NULL);
+
+	/* Release wrappers. */
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/* Number of enqueued commands per thread in multi-threaded enqueue
+ * test. */
+#define CCL_TEST_QUEUE_MT_NUMCMDS 4096
+
+/* Number of enqueued commands per thread in multi-threaded enqueue
+ * test, when running performance tests. */
+#define CCL_TEST_QUEUE_MT_NUMCMDS_PERF 262144
+
+/* Number of commands after which queue events are released in the
+ * multi-threaded enqueue test. */
+#define CCL_TEST_QUEUE_MT_GC 1024
+
+/* Maximum number of threads in multi-threaded enqueue test. */
+#define CCL_TEST_QUEUE_MT_MAXTHREADS 16
+
+/**
+ * Data for each thread in the multi-threaded enqueue test.
+ * */
+typedef struct ccl_test_queue_mt_data {
+
+	/* Queue used by thread. */
+	CCLQueue* cq;
+
+	/* Buffer written by thread. */
+	CCLBuffer* buf;
+
+	/* Number of commands to enqueue. */
+	guint num_cmds;
+
+	/* Number of produced events. */
+	guint num_evts;
+
+} CCLTestQueueMTData;
+
+/**
+ * Thread function for multi-threaded enqueue test. Enqueues commands
+ * in the thread's own queue, periodically releasing produced events.
+ * */
+static gpointer enqueue_mt_thread(gpointer data) {
+
+	CCLTestQueueMTData* td = (CCLTestQueueMTData*) data;
+	CCLEvent* evt = NULL;
+	CCLErr* err = NULL;
+	cl_uint value = 0;
+
+	for (guint i = 0; i < td->num_cmds; ++i) {
+
+		/* Enqueue a small write, which produces a new event wrapper. */
+		evt = ccl_buffer_enqueue_write(td->buf, td->cq, CL_FALSE, 0,
+			sizeof(cl_uint), &value, NULL, &err);
+		g_assert_no_error(err);
+		if (evt != NULL) td->num_evts++;
+
+		/* Release events every once in a while. */
+		if ((i + 1) % CCL_TEST_QUEUE_MT_GC == 0) {
+			ccl_queue_finish(td->cq, &err);
+			g_assert_no_error(err);
+			ccl_queue_gc(td->cq);
+		}
+	}
+
+	/* Release remaining events. */
+	ccl_queue_finish(td->cq, &err);
+	g_assert_no_error(err);
+	ccl_queue_gc(td->cq);
+
+	return NULL;
+}
+
+/**
+ * Tests concurrent enqueueing of commands in several queues, one per
+ * thread. Each enqueue wraps a new event, stressing the registry of
+ * existing wrappers. When performance tests are enabled (`-m perf`),
+ * the number of produced events per second is reported for an
+ * increasing number of threads.
+ * */
+static void enqueue_mt_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLErr* err = NULL;
+	GThread* threads[CCL_TEST_QUEUE_MT_MAXTHREADS];
+	CCLTestQueueMTData tdata[CCL_TEST_QUEUE_MT_MAXTHREADS];
+	guint num_cmds = g_test_perf()
+		? CCL_TEST_QUEUE_MT_NUMCMDS_PERF : CCL_TEST_QUEUE_MT_NUMCMDS;
+	GTimer* timer;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create one queue and one buffer per thread. */
+	for (guint i = 0; i < CCL_TEST_QUEUE_MT_MAXTHREADS; ++i) {
+		tdata[i].cq = ccl_queue_new(ctx, dev, 0, &err);
+		g_assert_no_error(err);
+		tdata[i].buf = ccl_buffer_new(
+			ctx, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL, &err);
+		g_assert_no_error(err);
+		tdata[i].num_cmds = num_cmds;
+	}
+
+	timer = g_timer_new();
+
+	/* Test with 1, 2, 4, ..., CCL_TEST_QUEUE_MT_MAXTHREADS threads. */
+	for (guint nt = 1; nt <= CCL_TEST_QUEUE_MT_MAXTHREADS; nt *= 2) {
+
+		/* Start threads. */
+		g_timer_start(timer);
+		for (guint i = 0; i < nt; ++i) {
+			tdata[i].num_evts = 0;
+			threads[i] = g_thread_new(
+				"enqueue_mt", enqueue_mt_thread, &tdata[i]);
+		}
+
+		/* Wait for threads to finish and check results. */
+		for (guint i = 0; i < nt; ++i) {
+			g_thread_join(threads[i]);
+			g_assert_cmpuint(tdata[i].num_evts, ==, num_cmds);
+		}
+		g_timer_stop(timer);
+
+		/* Report throughput. */
+		if (g_test_perf()) {
+			g_test_maximized_result(
+				nt * num_cmds / g_timer_elapsed(timer, NULL),
+				"%2u thread(s): %.0f events/s", nt,
+				nt * num_cmds / g_timer_elapsed(timer, NULL));
+		}
+	}
+
+	g_timer_destroy(timer);
+
+	/* Release wrappers. */
+	for (guint i = 0; i < CCL_TEST_QUEUE_MT_MAXTHREADS; ++i) {
+		ccl_buffer_destroy(tdata[i].buf);
+		ccl_queue_destroy(tdata[i].cq);
+	}
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
 /**
  * Main function.
  * @param[in] argc Number of command line arguments.
@@ -335,6 +572,14 @@ int main(int argc, char** argv) {
 		"/wrappers/queue/barrier-marker",
 		barrier_marker_test);
 
+	g_test_add_func(
+		"/wrappers/queue/untracked",
+		untracked_test);
+
+	g_test_add_func(
+		"/wrappers/queue/enqueue-mt",
+		enqueue_mt_test);
+
 	return g_test_run();
 }
 
@@ -0,0 +1,264 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Test the task scheduler class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+#include "_ccl_defs.h"
+
+#define CCL_TEST_SCHEDULER_BUF_SIZE 64
+
+#define CCL_TEST_SCHEDULER_KERNEL_NAME "sched_inc"
+
+#define CCL_TEST_SCHEDULER_KERNEL_CONTENT \
+	"__kernel void " CCL_TEST_SCHEDULER_KERNEL_NAME "(" \
+	"		__global const uint *a, __global uint *b)" \
+	"{" \
+	"	uint i = get_global_id(0);" \
+	"	b[i] = a[i] + 1;" \
+	"}"
+
+/**
+ * Schedule a set of tasks with the given queue properties, check the
+ * number of dependencies converted into events and run the tasks a few
+ * times, checking the results.
+ *
+ * @param[in] ctx Context wrapper object.
+ * @param[in] prop Properties of the scheduler's command queues.
+ * @param[in] num_deps Expected number of dependencies.
+ * */
+static void scheduler_test_aux(CCLContext* ctx,
+	cl_command_queue_properties prop, cl_uint num_deps) {
+
+	/* Test variables. */
+	CCLDevice* dev = NULL;
+	CCLScheduler* sched = NULL;
+	CCLBuffer* bufs[3] = { NULL, NULL, NULL };
+	CCLProgram* prg = NULL;
+	CCLKernel* krnl = NULL;
+	CCLProf* prof = NULL;
+	CCLErr* err = NULL;
+	cl_uint hbuf_in[CCL_TEST_SCHEDULER_BUF_SIZE];
+	cl_uint hbuf_out[CCL_TEST_SCHEDULER_BUF_SIZE];
+	cl_uint hbuf_krnl[CCL_TEST_SCHEDULER_BUF_SIZE];
+	size_t buf_size = CCL_TEST_SCHEDULER_BUF_SIZE * sizeof(cl_uint);
+	size_t gws = CCL_TEST_SCHEDULER_BUF_SIZE;
+	cl_int task_krnl;
+	cl_bool status;
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create device buffers. */
+	for (cl_uint i = 0; i < 3; ++i) {
+		bufs[i] = ccl_buffer_new(
+			ctx, CL_MEM_READ_WRITE, buf_size, NULL, &err);
+		g_assert_no_error(err);
+	}
+
+	/* Create and build program, get kernel. */
+	prg = ccl_program_new_from_source(
+		ctx, CCL_TEST_SCHEDULER_KERNEL_CONTENT, &err);
+	g_assert_no_error(err);
+
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_SCHEDULER_KERNEL_NAME, &err);
+	g_assert_no_error(err);
+
+	/* Create scheduler. */
+	sched = ccl_scheduler_new(
+		ctx, dev, prop | CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+
+	/* Add tasks: write to the first buffer, have the kernel read it
+	 * into the second buffer while the first buffer is copied to the
+	 * third one, read the second and third buffers, and write again to
+	 * the first buffer. */
+	g_assert_cmpint(ccl_scheduler_add_buffer_write(
+		sched, bufs[0], 0, buf_size, hbuf_in), ==, 0);
+
+	task_krnl = ccl_scheduler_add_kernel(sched, krnl, 1, NULL, &gws, NULL,
+		(void*[]) { bufs[0], bufs[1], NULL },
+		(CCLMemObj*[]) { (CCLMemObj*) bufs[0], NULL },
+		(CCLMemObj*[]) { (CCLMemObj*) bufs[1], NULL });
+	g_assert_cmpint(task_krnl, ==, 1);
+	ccl_command_graph_set_name(
+		ccl_scheduler_get_graph(sched), task_krnl, "SCHED_KERNEL");
+
+	g_assert_cmpint(ccl_scheduler_add_buffer_copy(
+		sched, bufs[0], bufs[2], 0, 0, buf_size), ==, 2);
+
+	g_assert_cmpint(ccl_scheduler_add_buffer_read(
+		sched, bufs[2], 0, buf_size, hbuf_out), ==, 3);
+
+	g_assert_cmpint(ccl_scheduler_add_buffer_read(
+		sched, bufs[1], 0, buf_size, hbuf_krnl), ==, 4);
+
+	g_assert_cmpint(ccl_scheduler_add_buffer_write(
+		sched, bufs[0], 0, buf_size, hbuf_in), ==, 5);
+
+	/* Check number of dependencies converted into events. */
+	g_assert_cmpuint(ccl_scheduler_get_num_deps(sched), ==, num_deps);
+
+	/* Run tasks a few times, checking results. */
+	for (cl_uint r = 0; r < 3; ++r) {
+
+		for (cl_uint i = 0; i < CCL_TEST_SCHEDULER_BUF_SIZE; ++i) {
+			hbuf_in[i] = (cl_uint) g_test_rand_int();
+			hbuf_out[i] = 0;
+		}
+
+		/* Run twice without waiting in between. */
+		status = ccl_scheduler_run(sched, NULL, &err);
+		g_assert_no_error(err);
+		g_assert(status);
+
+		status = ccl_scheduler_run(sched, NULL, &err);
+		g_assert_no_error(err);
+		g_assert(status);
+
+		status = ccl_scheduler_finish(sched, &err);
+		g_assert_no_error(err);
+		g_assert(status);
+
+		for (cl_uint i = 0; i < CCL_TEST_SCHEDULER_BUF_SIZE; ++i) {
+			g_assert_cmpuint(hbuf_out[i], ==, hbuf_in[i]);
+#ifndef OPENCL_STUB
+			g_assert_cmpuint(hbuf_krnl[i], ==, hbuf_in[i] + 1);
+#endif
+		}
+	}
+
+	/* Profile the scheduler's queues. */
+	prof = ccl_prof_new();
+	ccl_scheduler_add_to_prof(sched, prof);
+	status = ccl_prof_calc(prof, &err);
+	g_assert_no_error(err);
+	g_assert(status);
+	g_assert(ccl_prof_get_agg(prof, "SCHED_KERNEL") != NULL);
+	ccl_prof_destroy(prof);
+
+	/* Release scheduler and wrappers. */
+	ccl_scheduler_destroy(sched);
+	for (cl_uint i = 0; i < 3; ++i)
+		ccl_buffer_destroy(bufs[i]);
+	ccl_program_destroy(prg);
+
+}
+
+/**
+ * Tests scheduling tasks in two in-order queues.
+ * */
+static void in_order_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLErr* err = NULL;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* The kernel waits for the first write, and the read of the
+	 * kernel's output waits for the kernel. The second write does not
+	 * need to wait for the kernel, because the transfer queue already
+	 * waited for it. */
+	scheduler_test_aux(ctx, 0, 2);
+
+	/* Release context. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Tests scheduling tasks in an out-of-order queue.
+ * */
+static void out_of_order_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLErr* err = NULL;
+	cl_command_queue_properties qprop;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Check if device supports out-of-order queues. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+	qprop = ccl_device_get_info_scalar(dev, CL_DEVICE_QUEUE_PROPERTIES,
+		cl_command_queue_properties, &err);
+	g_assert_no_error(err);
+
+	if (qprop & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) {
+
+		/* All dependencies are explicit in an out-of-order queue. */
+		scheduler_test_aux(ctx, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, 7);
+
+	} else {
+
+		g_test_message("'%s' test not performed because device does " \
+			"not support out-of-order queues", CCL_STRD);
+
+	}
+
+	/* Release context. */
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char** argv) {
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func(
+		"/scheduler/in-order",
+		in_order_test);
+
+	g_test_add_func(
+		"/scheduler/out-of-order",
+		out_of_order_test);
+
+	return g_test_run();
+}
@@ -0,0 +1,298 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Test the staging allocator class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+/* Number of round trips per transfer size in the bandwidth test. */
+#define CCL_TEST_STAGING_REPS 4
+#define CCL_TEST_STAGING_REPS_PERF 32
+
+/**
+ * Tests allocating and freeing slices, and transfers from slices.
+ * */
+static void alloc_free_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBuffer* buf = NULL;
+	CCLStagingAllocator* sa = NULL;
+	CCLBuffer *blk_a, *blk_b, *blk_c, *blk_d, *blk_e, *blk_f;
+	size_t off_a, off_b, off_c, off_d, off_e, off_f;
+	cl_uchar *a, *b, *c, *d, *e, *f;
+	CCLErr* err = NULL;
+	size_t align;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create an allocator with room for four slices of the alignment
+	 * size in each block. */
+	sa = ccl_staging_allocator_new(cq, 1, &err);
+	g_assert_no_error(err);
+	align = ccl_staging_allocator_get_alignment(sa);
+	g_assert_cmpuint(align, >, 0);
+	ccl_staging_allocator_destroy(sa);
+
+	sa = ccl_staging_allocator_new(cq, 4 * align, &err);
+	g_assert_no_error(err);
+
+	/* Slices are rounded up to the alignment and taken in order from
+	 * the same block. */
+	a = ccl_staging_allocator_alloc(sa, 1, &blk_a, &off_a, &err);
+	g_assert_no_error(err);
+	b = ccl_staging_allocator_alloc(sa, align + 1, &blk_b, &off_b, &err);
+	g_assert_no_error(err);
+	c = ccl_staging_allocator_alloc(sa, align, &blk_c, &off_c, &err);
+	g_assert_no_error(err);
+	g_assert(blk_a == blk_b);
+	g_assert(blk_a == blk_c);
+	g_assert_cmpuint(off_a, ==, 0);
+	g_assert_cmpuint(off_b, ==, align);
+	g_assert_cmpuint(off_c, ==, 3 * align);
+	g_assert(b - a == (ptrdiff_t) align);
+	g_assert(c - a == (ptrdiff_t) (3 * align));
+
+	/* A full block leads to a new block. */
+	d = ccl_staging_allocator_alloc(sa, 1, &blk_d, &off_d, &err);
+	g_assert_no_error(err);
+	g_assert(blk_d != blk_a);
+	g_assert_cmpuint(off_d, ==, 0);
+
+	/* Transfer data to the device from one slice and back to another. */
+	buf = ccl_buffer_new(ctx, CL_MEM_READ_WRITE, align, NULL, &err);
+	g_assert_no_error(err);
+	for (size_t i = 0; i < align; ++i)
+		c[i] = (cl_uchar) g_test_rand_int();
+	ccl_buffer_enqueue_write(buf, cq, CL_TRUE, 0, align, c, NULL, &err);
+	g_assert_no_error(err);
+	ccl_buffer_enqueue_read(buf, cq, CL_TRUE, 0, align, d, NULL, &err);
+	g_assert_no_error(err);
+	for (size_t i = 0; i < align; ++i)
+		g_assert_cmpuint(d[i], ==, c[i]);
+
+	/* A block is reused once all its slices are returned. */
+	ccl_staging_allocator_free(sa, a);
+	ccl_staging_allocator_free(sa, b);
+	ccl_staging_allocator_free(sa, c);
+	e = ccl_staging_allocator_alloc(sa, 2 * align, &blk_e, &off_e, &err);
+	g_assert_no_error(err);
+	g_assert(e == a);
+	g_assert(blk_e == blk_a);
+	g_assert_cmpuint(off_e, ==, 0);
+
+	/* Slices larger than blocks get dedicated blocks. */
+	f = ccl_staging_allocator_alloc(sa, 4 * align + 1, &blk_f, &off_f, &err);
+	g_assert_no_error(err);
+	g_assert(blk_f != blk_a);
+	g_assert(blk_f != blk_d);
+	g_assert_cmpuint(off_f, ==, 0);
+	g_assert_cmpuint(ccl_memobj_get_info_scalar(
+		blk_f, CL_MEM_SIZE, size_t, &err), ==, 5 * align);
+	g_assert_no_error(err);
+	ccl_staging_allocator_free(sa, f);
+
+	/* Return remaining slices. */
+	ccl_staging_allocator_free(sa, d);
+	ccl_staging_allocator_free(sa, e);
+
+	/* Release allocator and wrappers. */
+	ccl_staging_allocator_destroy(sa);
+	ccl_buffer_destroy(buf);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * @internal
+ *
+ * @brief Measure host-device bandwidth of blocking round trips.
+ *
+ * @param[in] cq Command queue.
+ * @param[in] buf Device buffer.
+ * @param[in] host Host memory, pageable or pinned.
+ * @param[in] size Size of transfers in bytes.
+ * @param[in] reps Number of round trips.
+ * @return Bandwidth in MiB/s.
+ * */
+static double bandwidth_run(CCLQueue* cq, CCLBuffer* buf, void* host,
+	size_t size, guint reps) {
+
+	/* Test variables. */
+	CCLErr* err = NULL;
+	GTimer* timer = g_timer_new();
+	double secs;
+
+	/* Perform round trips. */
+	for (guint r = 0; r < reps; ++r) {
+		ccl_buffer_enqueue_write(
+			buf, cq, CL_TRUE, 0, size, host, NULL, &err);
+		g_assert_no_error(err);
+		ccl_buffer_enqueue_read(
+			buf, cq, CL_TRUE, 0, size, host, NULL, &err);
+		g_assert_no_error(err);
+	}
+	g_timer_stop(timer);
+	secs = g_timer_elapsed(timer, NULL);
+	g_timer_destroy(timer);
+
+	/* Each round trip transfers twice the size. */
+	return (2.0 * reps * size) / (1024.0 * 1024.0) / MAX(secs, 1e-9);
+
+}
+
+/**
+ * Benchmarks host-device transfers from pageable memory and from
+ * pinned slices of a staging allocator. If performance tests are
+ * enabled (`-m perf`), transfers of 1, 16 and 64 MiB are measured and
+ * reported; otherwise, a single small size is checked.
+ * */
+static void bandwidth_test() {
+
+	/* Transfer sizes. */
+	const size_t sizes_perf[] = { 1 << 20, 16 << 20, 64 << 20 };
+	const size_t sizes_quick[] = { 1 << 16 };
+	const size_t* sizes;
+	guint num_sizes, reps;
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLQueue* cq = NULL;
+	CCLBuffer* buf = NULL;
+	CCLStagingAllocator* sa = NULL;
+	CCLErr* err = NULL;
+	void* pageable;
+	void* pinned;
+	double bw_pageable, bw_pinned;
+
+	/* Select transfer sizes. */
+	if (g_test_perf()) {
+		sizes = sizes_perf;
+		num_sizes = G_N_ELEMENTS(sizes_perf);
+		reps = CCL_TEST_STAGING_REPS_PERF;
+	} else {
+		sizes = sizes_quick;
+		num_sizes = G_N_ELEMENTS(sizes_quick);
+		reps = CCL_TEST_STAGING_REPS;
+	}
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create a command queue and a staging allocator. */
+	cq = ccl_queue_new(ctx, dev, 0, &err);
+	g_assert_no_error(err);
+	sa = ccl_staging_allocator_new(cq, sizes[num_sizes - 1], &err);
+	g_assert_no_error(err);
+
+	for (guint s = 0; s < num_sizes; ++s) {
+
+		/* Create device buffer, pageable memory and pinned slice. */
+		buf = ccl_buffer_new(
+			ctx, CL_MEM_READ_WRITE, sizes[s], NULL, &err);
+		g_assert_no_error(err);
+		pageable = g_malloc0(sizes[s]);
+		pinned = ccl_staging_allocator_alloc(
+			sa, sizes[s], NULL, NULL, &err);
+		g_assert_no_error(err);
+		memset(pinned, 0, sizes[s]);
+
+		/* Measure bandwidth of both paths. */
+		bw_pageable = bandwidth_run(cq, buf, pageable, sizes[s], reps);
+		bw_pinned = bandwidth_run(cq, buf, pinned, sizes[s], reps);
+
+		/* Report results. */
+		if (g_test_perf()) {
+			g_test_maximized_result(bw_pageable,
+				"%3lu MiB, pageable: %.1f MiB/s",
+				(unsigned long) (sizes[s] >> 20), bw_pageable);
+			g_test_maximized_result(bw_pinned,
+				"%3lu MiB, pinned:   %.1f MiB/s",
+				(unsigned long) (sizes[s] >> 20), bw_pinned);
+		}
+		g_assert_cmpfloat(bw_pageable, >, 0.0);
+		g_assert_cmpfloat(bw_pinned, >, 0.0);
+
+		/* Release memory of current size. */
+		ccl_staging_allocator_free(sa, pinned);
+		g_free(pageable);
+		ccl_buffer_destroy(buf);
+
+	}
+
+	/* Release allocator and wrappers. */
+	ccl_staging_allocator_destroy(sa);
+	ccl_queue_destroy(cq);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char** argv) {
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func(
+		"/staging-allocator/alloc-free",
+		alloc_free_test);
+
+	g_test_add_func(
+		"/staging-allocator/bandwidth",
+		bandwidth_test);
+
+	return g_test_run();
+}
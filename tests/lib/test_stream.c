@@ -0,0 +1,180 @@
+/*
+ * This file is part of cf4ocl (C Framework for OpenCL).
+ *
+ * cf4ocl is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * cf4ocl is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with cf4ocl. If not, see <http://www.gnu.org/licenses/>.
+ * */
+
+/**
+ * @file
+ * Test the stream class and its methods.
+ *
+ * @author Nuno Fachada
+ * @date 2017
+ * @copyright [GNU General Public License version 3 (GPLv3)](http://www.gnu.org/licenses/gpl.html)
+ * */
+
+#include <cf4ocl2.h>
+#include "test.h"
+
+#define CCL_TEST_STREAM_CHUNK_SIZE 64
+
+#define CCL_TEST_STREAM_NUM_CHUNKS 10
+
+#define CCL_TEST_STREAM_DEPTH 3
+
+#define CCL_TEST_STREAM_KERNEL_NAME "stream_inc"
+
+#define CCL_TEST_STREAM_KERNEL_CONTENT \
+	"__kernel void " CCL_TEST_STREAM_KERNEL_NAME "(" \
+	"		__global const uint *in, __global uint *out, uint x)" \
+	"{" \
+	"	uint i = get_global_id(0);" \
+	"	out[i] = in[i] + x;" \
+	"}"
+
+/**
+ * Tests streaming chunks through a kernel, with backpressure and
+ * profiling.
+ * */
+static void push_pull_test() {
+
+	/* Test variables. */
+	CCLContext* ctx = NULL;
+	CCLDevice* dev = NULL;
+	CCLProgram* prg = NULL;
+	CCLKernel* krnl = NULL;
+	CCLStream* stream = NULL;
+	CCLProf* prof = NULL;
+	CCLErr* err = NULL;
+	cl_uint hin[CCL_TEST_STREAM_NUM_CHUNKS][CCL_TEST_STREAM_CHUNK_SIZE];
+	cl_uint hout[CCL_TEST_STREAM_NUM_CHUNKS][CCL_TEST_STREAM_CHUNK_SIZE];
+	size_t chunk_size = CCL_TEST_STREAM_CHUNK_SIZE * sizeof(cl_uint);
+	size_t gws = CCL_TEST_STREAM_CHUNK_SIZE;
+	cl_uint x = 7;
+	cl_uint pulled = 0;
+	cl_bool status;
+
+	/* Get the test context with the pre-defined device. */
+	ctx = ccl_test_context_new(&err);
+	g_assert_no_error(err);
+
+	/* Get first device in context. */
+	dev = ccl_context_get_device(ctx, 0, &err);
+	g_assert_no_error(err);
+
+	/* Create and build program, get kernel and set its last argument. */
+	prg = ccl_program_new_from_source(
+		ctx, CCL_TEST_STREAM_KERNEL_CONTENT, &err);
+	g_assert_no_error(err);
+
+	ccl_program_build(prg, NULL, &err);
+	g_assert_no_error(err);
+
+	krnl = ccl_program_get_kernel(prg, CCL_TEST_STREAM_KERNEL_NAME, &err);
+	g_assert_no_error(err);
+
+	ccl_kernel_set_arg(krnl, 2, ccl_arg_priv(x, cl_uint));
+
+	/* Create stream. */
+	stream = ccl_stream_new(ctx, dev, krnl, 1, &gws, NULL, chunk_size,
+		chunk_size, CCL_TEST_STREAM_DEPTH, CL_QUEUE_PROFILING_ENABLE, &err);
+	g_assert_no_error(err);
+	g_assert(ccl_stream_can_push(stream));
+
+	/* The stream keeps a reference to the kernel, in addition to the
+	 * one kept by the program. */
+	g_assert_cmpuint(ccl_wrapper_ref_count((CCLWrapper*) krnl), ==, 2);
+	g_assert_cmpuint(ccl_stream_get_num_pending(stream), ==, 0);
+
+	/* Initialize input. */
+	for (cl_uint c = 0; c < CCL_TEST_STREAM_NUM_CHUNKS; ++c)
+		for (cl_uint i = 0; i < CCL_TEST_STREAM_CHUNK_SIZE; ++i)
+			hin[c][i] = (cl_uint) g_test_rand_int_range(0, 0xFFFF);
+
+	/* Push all chunks, pulling results when the stream is full. */
+	for (cl_uint c = 0; c < CCL_TEST_STREAM_NUM_CHUNKS; ++c) {
+
+		if (!ccl_stream_can_push(stream)) {
+			g_assert_cmpuint(ccl_stream_get_num_pending(stream), ==,
+				CCL_TEST_STREAM_DEPTH);
+			status = ccl_stream_pull(stream, hout[pulled++], &err);
+			g_assert_no_error(err);
+			g_assert(status);
+		}
+
+		status = ccl_stream_push(stream, hin[c], chunk_size, &err);
+		g_assert_no_error(err);
+		g_assert(status);
+
+	}
+
+	/* Pull remaining results. */
+	g_assert_cmpuint(ccl_stream_get_num_pending(stream), ==,
+		CCL_TEST_STREAM_DEPTH);
+	while (ccl_stream_get_num_pending(stream) > 0) {
+		status = ccl_stream_pull(stream, hout[pulled++], &err);
+		g_assert_no_error(err);
+		g_assert(status);
+	}
+	g_assert_cmpuint(pulled, ==, CCL_TEST_STREAM_NUM_CHUNKS);
+
+#ifndef OPENCL_STUB
+
+	/* Check results. */
+	for (cl_uint c = 0; c < CCL_TEST_STREAM_NUM_CHUNKS; ++c)
+		for (cl_uint i = 0; i < CCL_TEST_STREAM_CHUNK_SIZE; ++i)
+			g_assert_cmpuint(hout[c][i], ==, hin[c][i] + x);
+
+#endif
+
+	/* Check that all stages were profiled. */
+	prof = ccl_prof_new();
+	ccl_stream_add_to_prof(stream, prof);
+	status = ccl_prof_calc(prof, &err);
+	g_assert_no_error(err);
+	g_assert(status);
+	g_assert(ccl_prof_get_agg(prof, "STREAM_WRITE") != NULL);
+	g_assert(ccl_prof_get_agg(prof, "STREAM_EXEC") != NULL);
+	g_assert(ccl_prof_get_agg(prof, "STREAM_READ") != NULL);
+	ccl_prof_destroy(prof);
+
+	/* Release wrappers and stream. The kernel is kept alive by the
+	 * stream after the program is destroyed. */
+	ccl_program_destroy(prg);
+	g_assert_cmpuint(ccl_wrapper_ref_count((CCLWrapper*) krnl), ==, 1);
+	ccl_stream_destroy(stream);
+	ccl_context_destroy(ctx);
+
+	/* Confirm that memory allocated by wrappers has been properly
+	 * freed. */
+	g_assert(ccl_wrapper_memcheck());
+
+}
+
+/**
+ * Main function.
+ * @param[in] argc Number of command line arguments.
+ * @param[in] argv Command line arguments.
+ * @return Result of test run.
+ * */
+int main(int argc, char** argv) {
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func(
+		"/stream/push-pull",
+		push_pull_test);
+
+	return g_test_run();
+}